@@ -0,0 +1,199 @@
+#pragma once
+#include "ASTNodeKind.hpp"
+#include "Type.hpp"
+#include "nova/Basic/Arena.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nova {
+namespace ast {
+
+/// Owns the memory of one AST.
+///
+/// Nodes, their child arrays, trailing objects and copied strings are all
+/// bump-allocated from one Arena and released together when the context is
+/// destroyed; nodes are never freed individually, so they must be trivially
+/// destructible. Every allocation is counted by node kind so the footprint of
+/// large inputs can be tracked (print_stats()).
+///
+/// Node classes name their kind with `static constexpr ASTNodeKind kKind`.
+///
+/// The context also owns the semantic types. The get_*_type() factories
+/// hash-cons them in a uniquing table, so each distinct type is allocated
+/// once: comparing two types is a pointer compare and spelling `&[i64]` a
+/// thousand times costs no memory after the first. Types live in their own
+/// arena behind a mutex, so the factories (unlike node creation) may be
+/// called from several threads at once.
+///
+/// To build nodes on several threads, give each thread a shard
+/// (`ASTContext shard(&parent)`): the shard allocates nodes from its own
+/// arena and interns types in the parent. parent.adopt(shard) then moves the
+/// shard's memory and statistics into the parent.
+class ASTContext {
+public:
+    struct NodeStats {
+        size_t count = 0;
+        size_t bytes = 0;
+    };
+
+    ASTContext();
+    /// Shard of `parent` (see above); `parent` must outlive it.
+    explicit ASTContext(ASTContext* parent);
+
+    ASTContext(const ASTContext&) = delete;
+    ASTContext& operator=(const ASTContext&) = delete;
+
+    /// Raw node memory, counted against `kind`.
+    void* allocate(size_t size, size_t align, ASTNodeKind kind) {
+        NodeStats& stats = node_stats_[static_cast<size_t>(kind)];
+        ++stats.count;
+        stats.bytes += size;
+        return arena_.allocate(size, align);
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "AST nodes are never destroyed");
+        return new (allocate(sizeof(T), alignof(T), T::kKind)) T(std::forward<Args>(args)...);
+    }
+
+    /// Node followed by `trailing_count` objects of type Trailing in the same
+    /// allocation (reachable as `reinterpret_cast<Trailing*>(node + 1)`).
+    template <typename T, typename Trailing, typename... Args>
+    T* create_with_trailing(size_t trailing_count, Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "AST nodes are never destroyed");
+        static_assert(std::is_trivially_destructible_v<Trailing>,
+                      "trailing objects are never destroyed");
+        static_assert(alignof(Trailing) <= alignof(T) && sizeof(T) % alignof(Trailing) == 0,
+                      "trailing objects must be aligned directly after the node");
+        void* mem =
+            allocate(sizeof(T) + trailing_count * sizeof(Trailing), alignof(T), T::kKind);
+        return new (mem) T(std::forward<Args>(args)...);
+    }
+
+    /// Uninitialized array for a node's children.
+    template <typename T>
+    T* allocate_array(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "AST arrays are never destroyed");
+        array_bytes_ += count * sizeof(T);
+        return static_cast<T*>(arena_.allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// Copy of [data, data + count) in the arena.
+    template <typename T>
+    T* copy_array(const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "copied with memcpy");
+        T* out = allocate_array<T>(count);
+        if (count != 0) {
+            std::memcpy(out, data, count * sizeof(T));
+        }
+        return out;
+    }
+
+    /// Copy of `text` that lives as long as the context.
+    std::string_view copy_string(std::string_view text);
+
+    /// Take over the memory of `shard`, a shard of this context (or of this
+    /// context's parent), so its nodes live as long as this context. Must
+    /// not run concurrently with allocation in either context.
+    void adopt(ASTContext& shard);
+
+    // Types
+    const BuiltinType* get_builtin_type(BuiltinType::Kind kind) const {
+        return builtin_types_[static_cast<size_t>(kind)];
+    }
+    const BuiltinType* get_unit_type() const { return get_builtin_type(BuiltinType::Kind::Unit); }
+    const BuiltinType* get_bool_type() const { return get_builtin_type(BuiltinType::Kind::Bool); }
+    const BuiltinType* get_i64_type() const { return get_builtin_type(BuiltinType::Kind::I64); }
+    const BuiltinType* get_u64_type() const { return get_builtin_type(BuiltinType::Kind::U64); }
+    const BuiltinType* get_f64_type() const { return get_builtin_type(BuiltinType::Kind::F64); }
+    const StrType* get_str_type() const { return str_type_; }
+    const StringType* get_string_type() const { return string_type_; }
+
+    const PointerType* get_pointer_type(const Type* pointee, bool is_mutable);
+    const ReferenceType* get_reference_type(const Type* pointee, bool is_mutable);
+    const ArrayType* get_array_type(const Type* element, uint64_t size);
+    const SliceType* get_slice_type(const Type* element);
+    /// The empty tuple is the unit type.
+    const Type* get_tuple_type(std::span<const Type* const> elements);
+    const FunctionType* get_function_type(std::span<const Type* const> params,
+                                          const Type* result);
+    /// Nominal types are uniqued by (name, declaration); `decl` may be null
+    /// while the name is unresolved.
+    const StructType* get_struct_type(IdentifierInfo* name, const Decl* decl);
+    const EnumType* get_enum_type(IdentifierInfo* name, const Decl* decl);
+    const ClassType* get_class_type(IdentifierInfo* name, const Decl* decl);
+    const TraitType* get_trait_type(IdentifierInfo* name, const Decl* decl);
+    const GenericType* get_generic_type(IdentifierInfo* name, uint32_t index);
+
+    // Statistics
+    const NodeStats& get_node_stats(ASTNodeKind kind) const {
+        return node_stats_[static_cast<size_t>(kind)];
+    }
+    /// Nodes created so far, of every kind.
+    size_t node_count() const;
+    size_t array_bytes() const { return array_bytes_; }
+    size_t string_bytes() const { return string_bytes_; }
+    size_t bytes_allocated() const { return arena_.bytes_allocated(); }
+    size_t bytes_reserved() const { return arena_.bytes_reserved(); }
+    size_t slab_count() const { return arena_.slab_count(); }
+    /// Distinct types, including the builtins.
+    size_t type_count() const;
+    /// Bytes of type storage (excluding the uniquing table).
+    size_t type_bytes() const;
+
+    /// Table of node counts and bytes per kind, child arrays, strings and
+    /// slabs; kinds that were never allocated are left out.
+    void print_stats(std::FILE* out) const;
+
+private:
+    // open addressing with linear probing, like IdentifierTable
+    struct TypeSlot {
+        const Type* type;
+        uint64_t hash;
+    };
+
+    // placement-new here rather than Arena::create: type constructors are
+    // private to ASTContext
+    template <typename T, typename... Args>
+    T* create_type(size_t trailing_bytes, Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "types are never destroyed");
+        // trailing type lists need pointer alignment even after a 4-byte
+        // aligned node
+        constexpr size_t align = alignof(T) > alignof(Type*) ? alignof(T) : alignof(Type*);
+        void* mem = type_root_->type_arena_.allocate(sizeof(T) + trailing_bytes, align);
+        return new (mem) T(std::forward<Args>(args)...);
+    }
+    template <typename T, typename Match, typename Make>
+    const T* intern_type(uint64_t hash, Match match, Make make);
+    template <typename T>
+    const T* get_nominal_type(TypeKind kind, IdentifierInfo* name, const Decl* decl);
+    void grow_type_table();
+
+    Arena arena_;
+    std::array<NodeStats, static_cast<size_t>(ASTNodeKind::count)> node_stats_{};
+    size_t array_bytes_ = 0;
+    size_t string_bytes_ = 0;
+
+    mutable std::mutex type_mutex_;
+    Arena type_arena_;
+    std::vector<TypeSlot> type_slots_;
+    size_t type_count_ = 0;
+    // context that owns the types: this one, or the parent of a shard
+    ASTContext* type_root_ = this;
+    std::array<const BuiltinType*, BuiltinType::kKindCount> builtin_types_{};
+    const StrType* str_type_ = nullptr;
+    const StringType* string_type_ = nullptr;
+};
+
+} // namespace ast
+} // namespace nova
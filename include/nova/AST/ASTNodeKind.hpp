@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+namespace nova {
+namespace ast {
+
+/// Concrete AST node classes, from ASTNodes.def.
+enum class ASTNodeKind : uint8_t {
+#define NOVA_DECL(name, snake_name) name,
+#define NOVA_STMT(name, snake_name) name,
+#define NOVA_EXPR(name, snake_name) name,
+#include "nova/AST/ASTNodes.def"
+#undef NOVA_EXPR
+#undef NOVA_STMT
+#undef NOVA_DECL
+    count,
+};
+
+/// Class name of a node kind (e.g. "BinaryExpr").
+const char* get_ast_node_kind_name(ASTNodeKind kind);
+
+} // namespace ast
+} // namespace nova
@@ -1,17 +1,172 @@
 #pragma once
 
-// TODO: Implement AST visitor pattern
+#include "Decl.hpp"
+#include "Expr.hpp"
+#include "Stmt.hpp"
 
 namespace nova {
 namespace ast {
 
-class Decl;
-class Stmt;
-class Expr;
-class Type;
+/// CRTP visitor dispatching on the node kind tag with one switch.
+///
+/// Derived classes define `visit_<node>(Node*)` for the nodes they care
+/// about (e.g. visit_binary_expr); the rest fall back to visit_expr,
+/// visit_stmt or visit_decl, which return RetTy(). The calls are resolved
+/// statically, so there is no virtual dispatch.
+template <typename Derived, typename RetTy = void>
+class ASTVisitor {
+public:
+    RetTy visit(Expr* node) {
+        switch (node->get_kind()) {
+#define NOVA_DECL(name, snake_name)
+#define NOVA_STMT(name, snake_name)
+#define NOVA_EXPR(name, snake_name)                                                            \
+    case ASTNodeKind::name:                                                                    \
+        return derived().visit_##snake_name(static_cast<name*>(node));
+#include "nova/AST/ASTNodes.def"
+#undef NOVA_EXPR
+#undef NOVA_STMT
+#undef NOVA_DECL
+        default:
+            break;
+        }
+        return RetTy();
+    }
 
-class ASTVisitor;
-class ASTWalker;
+    RetTy visit(Stmt* node) {
+        switch (node->get_kind()) {
+#define NOVA_DECL(name, snake_name)
+#define NOVA_STMT(name, snake_name)                                                            \
+    case ASTNodeKind::name:                                                                    \
+        return derived().visit_##snake_name(static_cast<name*>(node));
+#define NOVA_EXPR(name, snake_name)
+#include "nova/AST/ASTNodes.def"
+#undef NOVA_EXPR
+#undef NOVA_STMT
+#undef NOVA_DECL
+        default:
+            break;
+        }
+        return RetTy();
+    }
+
+    RetTy visit(Decl* node) {
+        switch (node->get_kind()) {
+#define NOVA_DECL(name, snake_name)                                                            \
+    case ASTNodeKind::name:                                                                    \
+        return derived().visit_##snake_name(static_cast<name*>(node));
+#define NOVA_STMT(name, snake_name)
+#define NOVA_EXPR(name, snake_name)
+#include "nova/AST/ASTNodes.def"
+#undef NOVA_EXPR
+#undef NOVA_STMT
+#undef NOVA_DECL
+        default:
+            break;
+        }
+        return RetTy();
+    }
+
+    // Fallbacks for nodes the derived class does not handle.
+    RetTy visit_expr(Expr*) { return RetTy(); }
+    RetTy visit_stmt(Stmt*) { return RetTy(); }
+    RetTy visit_decl(Decl*) { return RetTy(); }
+
+#define NOVA_DECL(name, snake_name)                                                            \
+    RetTy visit_##snake_name(name* node) { return derived().visit_decl(node); }
+#define NOVA_STMT(name, snake_name)                                                            \
+    RetTy visit_##snake_name(name* node) { return derived().visit_stmt(node); }
+#define NOVA_EXPR(name, snake_name)                                                            \
+    RetTy visit_##snake_name(name* node) { return derived().visit_expr(node); }
+#include "nova/AST/ASTNodes.def"
+#undef NOVA_EXPR
+#undef NOVA_STMT
+#undef NOVA_DECL
+
+protected:
+    Derived& derived() { return *static_cast<Derived*>(this); }
+};
+
+/// Visitor whose defaults walk every child in source order.
+///
+/// Children are visited through visit(), so they reach the derived class's
+/// overrides; an override calls `ASTWalker::visit_<node>(node)` to keep
+/// descending.
+template <typename Derived>
+class ASTWalker : public ASTVisitor<Derived> {
+    using Base = ASTVisitor<Derived>;
+
+public:
+    using Base::visit;
+
+    void visit_module_decl(ModuleDecl* node) {
+        for (Decl* item : node->get_items()) {
+            visit(item);
+        }
+    }
+    void visit_use_decl(UseDecl*) {}
+    void visit_func_decl(FuncDecl* node) {
+        for (ParamDecl* param : node->get_params()) {
+            visit(param);
+        }
+        if (node->get_body()) {
+            visit(node->get_body());
+        }
+    }
+    void visit_param_decl(ParamDecl*) {}
+    void visit_var_decl(VarDecl* node) {
+        if (node->get_init()) {
+            visit(node->get_init());
+        }
+    }
+
+    void visit_decl_stmt(DeclStmt* node) { visit(node->get_decl()); }
+    void visit_expr_stmt(ExprStmt* node) { visit(node->get_expr()); }
+    void visit_return_stmt(ReturnStmt* node) {
+        if (node->get_value()) {
+            visit(node->get_value());
+        }
+    }
+    void visit_while_stmt(WhileStmt* node) {
+        visit(node->get_cond());
+        visit(node->get_body());
+    }
+    void visit_break_stmt(BreakStmt*) {}
+    void visit_continue_stmt(ContinueStmt*) {}
+
+    void visit_literal_expr(LiteralExpr*) {}
+    void visit_identifier_expr(IdentifierExpr*) {}
+    void visit_binary_expr(BinaryExpr* node) {
+        visit(node->get_lhs());
+        visit(node->get_rhs());
+    }
+    void visit_unary_expr(UnaryExpr* node) { visit(node->get_operand()); }
+    void visit_assign_expr(AssignExpr* node) {
+        visit(node->get_target());
+        visit(node->get_value());
+    }
+    void visit_call_expr(CallExpr* node) {
+        visit(node->get_callee());
+        for (Expr* arg : node->get_args()) {
+            visit(arg);
+        }
+    }
+    void visit_if_expr(IfExpr* node) {
+        visit(node->get_cond());
+        visit(node->get_then());
+        if (node->get_else()) {
+            visit(node->get_else());
+        }
+    }
+    void visit_block_expr(BlockExpr* node) {
+        for (Stmt* stmt : node->get_stmts()) {
+            visit(stmt);
+        }
+        if (node->get_result()) {
+            visit(node->get_result());
+        }
+    }
+};
 
 } // namespace ast
 } // namespace nova
@@ -1,24 +1,191 @@
 #pragma once
 
-// TODO: Implement declaration AST nodes
-
+#include "ASTNodeKind.hpp"
+#include "nova/Basic/Casting.hpp"
 #include "nova/Basic/SourceLocation.hpp"
+#include <cstdint>
+#include <span>
 
 namespace nova {
+
+class IdentifierInfo;
+
 namespace ast {
 
-class Decl;
-class VarDecl;
-class FuncDecl;
-class ParamDecl;
+class ASTContext;
+class BlockExpr;
+class Expr;
+class Type;
+
+// Nova Core declarations are implemented below; these are extensions.
 class ClassDecl;
 class StructDecl;
 class EnumDecl;
 class TraitDecl;
 class ImplDecl;
-class ModuleDecl;
-class UseDecl;
 class TypeAliasDecl;
 
+/// Root of the declaration nodes: a 1-byte kind tag, 1 byte of per-kind
+/// bits, a SourceLocation and the declared name.
+class Decl {
+private:
+    ASTNodeKind kind_;
+
+protected:
+    uint8_t bits_ = 0;
+    SourceLocation loc_;
+    IdentifierInfo* name_;
+
+    Decl(ASTNodeKind kind, SourceLocation loc, IdentifierInfo* name)
+        : kind_(kind), loc_(loc), name_(name) {}
+
+public:
+    ASTNodeKind get_kind() const { return kind_; }
+    /// Location of the name (or of the introducing keyword if unnamed).
+    SourceLocation get_location() const { return loc_; }
+    IdentifierInfo* get_name() const { return name_; }
+
+    static bool classof(const Decl*) { return true; }
+};
+
+/// `let [mut] name [: type] [= init];`
+class VarDecl : public Decl {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::VarDecl;
+
+private:
+    // written type, null if inferred
+    const Type* declared_type_;
+    Expr* init_;
+
+public:
+    VarDecl(SourceLocation loc, IdentifierInfo* name, bool is_mutable, const Type* declared_type,
+            Expr* init)
+        : Decl(kKind, loc, name), declared_type_(declared_type), init_(init) {
+        bits_ = is_mutable ? 1 : 0;
+    }
+
+    bool is_mutable() const { return bits_ & 1; }
+    const Type* get_declared_type() const { return declared_type_; }
+    Expr* get_init() const { return init_; }
+
+    static bool classof(const Decl* d) { return d->get_kind() == kKind; }
+};
+
+/// `name: type` in a function signature.
+class ParamDecl : public Decl {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::ParamDecl;
+
+private:
+    const Type* type_;
+
+public:
+    ParamDecl(SourceLocation loc, IdentifierInfo* name, const Type* type)
+        : Decl(kKind, loc, name), type_(type) {}
+
+    const Type* get_type() const { return type_; }
+
+    static bool classof(const Decl* d) { return d->get_kind() == kKind; }
+};
+
+/// `func name(params...) [-> type] body`; the parameters trail the node.
+class FuncDecl : public Decl {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::FuncDecl;
+
+private:
+    // null when omitted (the function returns ())
+    const Type* return_type_;
+    BlockExpr* body_ = nullptr;
+    static constexpr uint32_t kNoBodyToken = UINT32_MAX;
+
+    uint32_t param_count_;
+    // token index of the '{' of a body the parser skipped, or kNoBodyToken
+    uint32_t body_token_ = kNoBodyToken;
+
+    FuncDecl(SourceLocation loc, IdentifierInfo* name, uint32_t param_count,
+             const Type* return_type)
+        : Decl(kKind, loc, name), return_type_(return_type), param_count_(param_count) {}
+
+    friend class ASTContext;
+
+public:
+    static FuncDecl* create(ASTContext& ctx, SourceLocation loc, IdentifierInfo* name,
+                            std::span<ParamDecl* const> params, const Type* return_type);
+
+    std::span<ParamDecl* const> get_params() const {
+        return {reinterpret_cast<ParamDecl* const*>(this + 1), param_count_};
+    }
+    const Type* get_return_type() const { return return_type_; }
+    BlockExpr* get_body() const { return body_; }
+    void set_body(BlockExpr* body) {
+        body_ = body;
+        body_token_ = kNoBodyToken;
+    }
+
+    /// True when the parser skipped the body; Parser::parse_function_body
+    /// parses it on demand.
+    bool has_skipped_body() const { return body_token_ != kNoBodyToken; }
+    /// Token index of the skipped body's '{'.
+    uint32_t get_body_token_index() const { return body_token_; }
+    void set_skipped_body(uint32_t token_index) {
+        body_ = nullptr;
+        body_token_ = token_index;
+    }
+
+    static bool classof(const Decl* d) { return d->get_kind() == kKind; }
+};
+
+/// `use a::b::c;`; the path segments trail the node and the last one is the
+/// declared name.
+class UseDecl : public Decl {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::UseDecl;
+
+private:
+    uint32_t segment_count_;
+
+    UseDecl(SourceLocation loc, IdentifierInfo* name, uint32_t segment_count)
+        : Decl(kKind, loc, name), segment_count_(segment_count) {}
+
+    friend class ASTContext;
+
+public:
+    /// `path` must not be empty.
+    static UseDecl* create(ASTContext& ctx, SourceLocation loc,
+                           std::span<IdentifierInfo* const> path);
+
+    std::span<IdentifierInfo* const> get_path() const {
+        return {reinterpret_cast<IdentifierInfo* const*>(this + 1), segment_count_};
+    }
+
+    static bool classof(const Decl* d) { return d->get_kind() == kKind; }
+};
+
+/// One source file: its top-level items trail the node.
+class ModuleDecl : public Decl {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::ModuleDecl;
+
+private:
+    uint32_t item_count_;
+
+    ModuleDecl(SourceLocation loc, IdentifierInfo* name, uint32_t item_count)
+        : Decl(kKind, loc, name), item_count_(item_count) {}
+
+    friend class ASTContext;
+
+public:
+    static ModuleDecl* create(ASTContext& ctx, SourceLocation loc, IdentifierInfo* name,
+                              std::span<Decl* const> items);
+
+    std::span<Decl* const> get_items() const {
+        return {reinterpret_cast<Decl* const*>(this + 1), item_count_};
+    }
+
+    static bool classof(const Decl* d) { return d->get_kind() == kKind; }
+};
+
 } // namespace ast
 } // namespace nova
@@ -1,31 +1,284 @@
 #pragma once
 
-// TODO: Implement expression AST nodes
-
+#include "ASTNodeKind.hpp"
+#include "nova/Basic/Casting.hpp"
 #include "nova/Basic/SourceLocation.hpp"
+#include <cstdint>
+#include <span>
+#include <string_view>
 
 namespace nova {
+
+class IdentifierInfo;
+
 namespace ast {
 
-class Expr;
-class LiteralExpr;
-class IdentifierExpr;
-class BinaryExpr;
-class UnaryExpr;
-class CallExpr;
+class ASTContext;
+class Decl;
+class Stmt;
+class Type;
+
+// Nova Core expressions are implemented below; these are extensions.
 class MethodCallExpr;
 class MemberExpr;
 class IndexExpr;
 class CastExpr;
-class IfExpr;
 class MatchExpr;
-class BlockExpr;
 class LambdaExpr;
 class TupleExpr;
 class ArrayExpr;
 class StructExpr;
 class RangeExpr;
-class AssignExpr;
+
+/// Root of the expression nodes.
+///
+/// Every node starts with an 8-byte header (1-byte kind tag, 1 byte of
+/// per-kind bits, SourceLocation) followed by the type Sema assigns. Nodes
+/// live in an ASTContext and are trivially destructible: child lists are
+/// trailing arrays, never std::vector.
+class Expr {
+private:
+    ASTNodeKind kind_;
+
+protected:
+    // per-kind payload (operator, literal kind, ...)
+    uint8_t bits_ = 0;
+    SourceLocation loc_;
+    const Type* type_ = nullptr;
+
+    Expr(ASTNodeKind kind, SourceLocation loc) : kind_(kind), loc_(loc) {}
+
+public:
+    ASTNodeKind get_kind() const { return kind_; }
+    SourceLocation get_location() const { return loc_; }
+
+    /// Type assigned by Sema, null before type checking.
+    const Type* get_type() const { return type_; }
+    void set_type(const Type* type) { type_ = type; }
+
+    static bool classof(const Expr*) { return true; }
+};
+
+class LiteralExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::LiteralExpr;
+
+    enum class LiteralKind : uint8_t { Integer, Float, String, Char, Bool };
+
+private:
+    union {
+        uint64_t integer_;
+        double floating_;
+        uint32_t character_;
+        bool boolean_;
+    };
+    // source spelling, including quotes for strings and chars
+    const char* spelling_;
+    uint32_t spelling_length_;
+
+    LiteralExpr(SourceLocation loc, LiteralKind kind, std::string_view spelling)
+        : Expr(kKind, loc), integer_(0), spelling_(spelling.data()),
+          spelling_length_(static_cast<uint32_t>(spelling.size())) {
+        bits_ = static_cast<uint8_t>(kind);
+    }
+
+    friend class ASTContext;
+
+public:
+    static LiteralExpr* create_integer(ASTContext& ctx, SourceLocation loc,
+                                       std::string_view spelling, uint64_t value);
+    static LiteralExpr* create_float(ASTContext& ctx, SourceLocation loc,
+                                     std::string_view spelling, double value);
+    static LiteralExpr* create_bool(ASTContext& ctx, SourceLocation loc, bool value);
+    static LiteralExpr* create_char(ASTContext& ctx, SourceLocation loc,
+                                    std::string_view spelling, uint32_t value);
+    /// `spelling` is the literal as written; escapes are decoded by consumers.
+    static LiteralExpr* create_string(ASTContext& ctx, SourceLocation loc,
+                                      std::string_view spelling);
+
+    LiteralKind get_literal_kind() const { return static_cast<LiteralKind>(bits_); }
+    uint64_t get_integer() const { return integer_; }
+    double get_float() const { return floating_; }
+    uint32_t get_char() const { return character_; }
+    bool get_bool() const { return boolean_; }
+    std::string_view get_spelling() const { return std::string_view(spelling_, spelling_length_); }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+class IdentifierExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::IdentifierExpr;
+
+private:
+    IdentifierInfo* name_;
+    // set by name resolution
+    Decl* decl_ = nullptr;
+
+public:
+    IdentifierExpr(SourceLocation loc, IdentifierInfo* name) : Expr(kKind, loc), name_(name) {}
+
+    IdentifierInfo* get_name() const { return name_; }
+    Decl* get_decl() const { return decl_; }
+    void set_decl(Decl* decl) { decl_ = decl; }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+enum class BinaryOp : uint8_t {
+    Mul, Div, Rem,
+    Add, Sub,
+    Lt, Le, Gt, Ge,
+    Eq, Ne,
+    LogicalAnd,
+    LogicalOr,
+};
+
+enum class UnaryOp : uint8_t { Neg, Not };
+
+const char* get_binary_op_spelling(BinaryOp op);
+const char* get_unary_op_spelling(UnaryOp op);
+
+class BinaryExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::BinaryExpr;
+
+private:
+    Expr* lhs_;
+    Expr* rhs_;
+
+public:
+    /// `loc` is the operator's location.
+    BinaryExpr(SourceLocation loc, BinaryOp op, Expr* lhs, Expr* rhs)
+        : Expr(kKind, loc), lhs_(lhs), rhs_(rhs) {
+        bits_ = static_cast<uint8_t>(op);
+    }
+
+    BinaryOp get_op() const { return static_cast<BinaryOp>(bits_); }
+    Expr* get_lhs() const { return lhs_; }
+    Expr* get_rhs() const { return rhs_; }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+class UnaryExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::UnaryExpr;
+
+private:
+    Expr* operand_;
+
+public:
+    UnaryExpr(SourceLocation loc, UnaryOp op, Expr* operand)
+        : Expr(kKind, loc), operand_(operand) {
+        bits_ = static_cast<uint8_t>(op);
+    }
+
+    UnaryOp get_op() const { return static_cast<UnaryOp>(bits_); }
+    Expr* get_operand() const { return operand_; }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+class AssignExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::AssignExpr;
+
+private:
+    Expr* target_;
+    Expr* value_;
+
+public:
+    /// `loc` is the location of '='.
+    AssignExpr(SourceLocation loc, Expr* target, Expr* value)
+        : Expr(kKind, loc), target_(target), value_(value) {}
+
+    Expr* get_target() const { return target_; }
+    Expr* get_value() const { return value_; }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+/// `callee(args...)`; the arguments trail the node.
+class CallExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::CallExpr;
+
+private:
+    Expr* callee_;
+    uint32_t arg_count_;
+    SourceLocation r_paren_loc_;
+
+    CallExpr(SourceLocation loc, Expr* callee, uint32_t arg_count, SourceLocation r_paren_loc)
+        : Expr(kKind, loc), callee_(callee), arg_count_(arg_count), r_paren_loc_(r_paren_loc) {}
+
+    friend class ASTContext;
+
+public:
+    /// `loc` is the location of '('.
+    static CallExpr* create(ASTContext& ctx, SourceLocation loc, Expr* callee,
+                            std::span<Expr* const> args, SourceLocation r_paren_loc);
+
+    Expr* get_callee() const { return callee_; }
+    SourceLocation get_r_paren_location() const { return r_paren_loc_; }
+    std::span<Expr* const> get_args() const {
+        return {reinterpret_cast<Expr* const*>(this + 1), arg_count_};
+    }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+/// `{ stmts... result? }`; the statements trail the node and `result` is the
+/// optional tail expression that gives the block its value.
+class BlockExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::BlockExpr;
+
+private:
+    Expr* result_;
+    uint32_t stmt_count_;
+    SourceLocation r_brace_loc_;
+
+    BlockExpr(SourceLocation loc, uint32_t stmt_count, Expr* result, SourceLocation r_brace_loc)
+        : Expr(kKind, loc), result_(result), stmt_count_(stmt_count), r_brace_loc_(r_brace_loc) {}
+
+    friend class ASTContext;
+
+public:
+    /// `loc` is the location of '{'.
+    static BlockExpr* create(ASTContext& ctx, SourceLocation loc, std::span<Stmt* const> stmts,
+                             Expr* result, SourceLocation r_brace_loc);
+
+    std::span<Stmt* const> get_stmts() const {
+        return {reinterpret_cast<Stmt* const*>(this + 1), stmt_count_};
+    }
+    Expr* get_result() const { return result_; }
+    SourceLocation get_r_brace_location() const { return r_brace_loc_; }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
+
+/// `if cond { ... } else ...`; the else branch is a BlockExpr, an IfExpr or
+/// null.
+class IfExpr : public Expr {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::IfExpr;
+
+private:
+    Expr* cond_;
+    BlockExpr* then_;
+    Expr* else_;
+
+public:
+    IfExpr(SourceLocation loc, Expr* cond, BlockExpr* then_block, Expr* else_branch)
+        : Expr(kKind, loc), cond_(cond), then_(then_block), else_(else_branch) {}
+
+    Expr* get_cond() const { return cond_; }
+    BlockExpr* get_then() const { return then_; }
+    Expr* get_else() const { return else_; }
+
+    static bool classof(const Expr* e) { return e->get_kind() == kKind; }
+};
 
 } // namespace ast
 } // namespace nova
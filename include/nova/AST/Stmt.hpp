@@ -1,24 +1,130 @@
 #pragma once
 
-// TODO: Implement statement AST nodes
-
+#include "ASTNodeKind.hpp"
+#include "nova/Basic/Casting.hpp"
 #include "nova/Basic/SourceLocation.hpp"
 
 namespace nova {
 namespace ast {
 
-class Stmt;
+class BlockExpr;
+class Expr;
+class VarDecl;
+
+// Nova Core statements are implemented below; these are extensions (in
+// Nova Core, `if` and blocks are expressions wrapped in an ExprStmt).
 class CompoundStmt;
-class DeclStmt;
-class ExprStmt;
-class ReturnStmt;
 class IfStmt;
-class WhileStmt;
 class ForStmt;
 class LoopStmt;
-class BreakStmt;
-class ContinueStmt;
 class MatchStmt;
 
+/// Root of the statement nodes: a 1-byte kind tag, 1 byte of per-kind bits
+/// and a SourceLocation, like Expr (without a type).
+class Stmt {
+private:
+    ASTNodeKind kind_;
+
+protected:
+    uint8_t bits_ = 0;
+    SourceLocation loc_;
+
+    Stmt(ASTNodeKind kind, SourceLocation loc) : kind_(kind), loc_(loc) {}
+
+public:
+    ASTNodeKind get_kind() const { return kind_; }
+    SourceLocation get_location() const { return loc_; }
+
+    static bool classof(const Stmt*) { return true; }
+};
+
+/// `let` statement.
+class DeclStmt : public Stmt {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::DeclStmt;
+
+private:
+    VarDecl* decl_;
+
+public:
+    DeclStmt(SourceLocation loc, VarDecl* decl) : Stmt(kKind, loc), decl_(decl) {}
+
+    VarDecl* get_decl() const { return decl_; }
+
+    static bool classof(const Stmt* s) { return s->get_kind() == kKind; }
+};
+
+/// Expression evaluated for its effects. Block-like expressions (blocks,
+/// `if`) may appear without a trailing ';'.
+class ExprStmt : public Stmt {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::ExprStmt;
+
+private:
+    Expr* expr_;
+
+public:
+    ExprStmt(SourceLocation loc, Expr* expr, bool has_semicolon) : Stmt(kKind, loc), expr_(expr) {
+        bits_ = has_semicolon ? 1 : 0;
+    }
+
+    Expr* get_expr() const { return expr_; }
+    bool has_semicolon() const { return bits_ & 1; }
+
+    static bool classof(const Stmt* s) { return s->get_kind() == kKind; }
+};
+
+class ReturnStmt : public Stmt {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::ReturnStmt;
+
+private:
+    Expr* value_;
+
+public:
+    /// `value` is null for a bare `return;`.
+    ReturnStmt(SourceLocation loc, Expr* value) : Stmt(kKind, loc), value_(value) {}
+
+    Expr* get_value() const { return value_; }
+
+    static bool classof(const Stmt* s) { return s->get_kind() == kKind; }
+};
+
+class WhileStmt : public Stmt {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::WhileStmt;
+
+private:
+    Expr* cond_;
+    BlockExpr* body_;
+
+public:
+    WhileStmt(SourceLocation loc, Expr* cond, BlockExpr* body)
+        : Stmt(kKind, loc), cond_(cond), body_(body) {}
+
+    Expr* get_cond() const { return cond_; }
+    BlockExpr* get_body() const { return body_; }
+
+    static bool classof(const Stmt* s) { return s->get_kind() == kKind; }
+};
+
+class BreakStmt : public Stmt {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::BreakStmt;
+
+    explicit BreakStmt(SourceLocation loc) : Stmt(kKind, loc) {}
+
+    static bool classof(const Stmt* s) { return s->get_kind() == kKind; }
+};
+
+class ContinueStmt : public Stmt {
+public:
+    static constexpr ASTNodeKind kKind = ASTNodeKind::ContinueStmt;
+
+    explicit ContinueStmt(SourceLocation loc) : Stmt(kKind, loc) {}
+
+    static bool classof(const Stmt* s) { return s->get_kind() == kKind; }
+};
+
 } // namespace ast
 } // namespace nova
@@ -1,84 +1,294 @@
 #pragma once
-
-// TODO: Implement type AST nodes
+#include "nova/Basic/Casting.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
 
 namespace nova {
+
+class IdentifierInfo;
+
 namespace ast {
-//virtual base class for all types
+
+class ASTContext;
+class Decl;
+
+enum class TypeKind : uint8_t {
+    Builtin,
+    Str,
+    String,
+    Pointer,
+    Reference,
+    Array,
+    Slice,
+    Tuple,
+    Function,
+    // nominal types, keep contiguous (see NominalType::classof)
+    Struct,
+    Enum,
+    Class,
+    Trait,
+    Generic,
+};
+
+/// Root of the semantic types.
+///
+/// Types carry a TypeKind tag instead of a vtable; use isa/cast/dyn_cast.
+/// Every type is created by an ASTContext factory that hash-conses it, so
+/// each distinct type exists once and two types are equal exactly when their
+/// pointers are. Types are never destroyed individually.
 class Type {
-    public:
-    virtual ~Type() = default;
+private:
+    TypeKind kind_;
+
+protected:
+    // per-kind payload (builtin kind, mutability, ...)
+    uint8_t bits_ = 0;
+
+    explicit Type(TypeKind kind) : kind_(kind) {}
+
+public:
+    TypeKind get_kind() const { return kind_; }
+
+    static bool classof(const Type*) { return true; }
 };
 
+/// Spelling of `type` as written in source (e.g. "&mut [i64]").
+std::string get_type_name(const Type* type);
+
 class BuiltinType : public Type {
-    enum class Kind {
+public:
+    enum class Kind : uint8_t {
         Char,
         Bool,
-        I8,I16,I32,I64,
-        U8,U16,U32,U64,
-        F32,F64,
+        I8, I16, I32, I64,
+        U8, U16, U32, U64,
+        F32, F64,
         Unit,
         Never,
         //add more builtin types if needed
     };
-    Kind kind_;
+    static constexpr unsigned kKindCount = static_cast<unsigned>(Kind::Never) + 1;
+
+private:
+    explicit BuiltinType(Kind k) : Type(TypeKind::Builtin) { bits_ = static_cast<uint8_t>(k); }
+
+    friend class ASTContext;
+
 public:
-    BuiltinType(Kind k) : kind_(k) {}
+    Kind get_builtin_kind() const { return static_cast<Kind>(bits_); }
+    bool is_integer() const { return get_builtin_kind() >= Kind::I8 && get_builtin_kind() <= Kind::U64; }
+    bool is_float() const { return get_builtin_kind() == Kind::F32 || get_builtin_kind() == Kind::F64; }
 
-    Kind get_kind() const { return kind_; }
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Builtin; }
 };
 
 class StrType : public Type {
     //string slice type &str
+    StrType() : Type(TypeKind::Str) {}
+
+    friend class ASTContext;
+
+public:
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Str; }
 };
 
 class StringType : public Type {
     //owned string type String
+    StringType() : Type(TypeKind::String) {}
+
+    friend class ASTContext;
 
+public:
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::String; }
 };
 
 class PointerType : public Type {
     //pointer type *const T, *mut T
+private:
+    const Type* pointee_;
+
+    PointerType(const Type* pointee, bool is_mutable) : Type(TypeKind::Pointer), pointee_(pointee) {
+        bits_ = is_mutable ? 1 : 0;
+    }
+
+    friend class ASTContext;
+
+public:
+    const Type* get_pointee() const { return pointee_; }
+    bool is_mutable() const { return bits_ & 1; }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Pointer; }
 };
 
 class ReferenceType : public Type {
     //reference type &T, &mut T
+private:
+    const Type* pointee_;
+
+    ReferenceType(const Type* pointee, bool is_mutable)
+        : Type(TypeKind::Reference), pointee_(pointee) {
+        bits_ = is_mutable ? 1 : 0;
+    }
+
+    friend class ASTContext;
+
+public:
+    const Type* get_pointee() const { return pointee_; }
+    bool is_mutable() const { return bits_ & 1; }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Reference; }
 };
 
 class ArrayType : public Type {
     //array type [T; N]
+private:
+    const Type* element_;
+    uint64_t size_;
+
+    ArrayType(const Type* element, uint64_t size)
+        : Type(TypeKind::Array), element_(element), size_(size) {}
+
+    friend class ASTContext;
+
+public:
+    const Type* get_element() const { return element_; }
+    uint64_t get_size() const { return size_; }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Array; }
 };
 
 class SliceType : public Type {
     //slice type [T]
+private:
+    const Type* element_;
+
+    explicit SliceType(const Type* element) : Type(TypeKind::Slice), element_(element) {}
+
+    friend class ASTContext;
+
+public:
+    const Type* get_element() const { return element_; }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Slice; }
 };
 
 class TupleType : public Type {
-    //tuple type (T1, T2, ...)
+    //tuple type (T1, T2, ...); the element types trail the node, and the
+    //empty tuple is BuiltinType Unit
+private:
+    uint32_t element_count_;
+
+    explicit TupleType(uint32_t element_count)
+        : Type(TypeKind::Tuple), element_count_(element_count) {}
+
+    friend class ASTContext;
+
+public:
+    std::span<const Type* const> get_elements() const {
+        return {reinterpret_cast<const Type* const*>(this + 1), element_count_};
+    }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Tuple; }
 };
 
 class FunctionType : public Type {
-    //function type fn(T1, T2, ...) -> R
+    //function type fn(T1, T2, ...) -> R; the parameter types trail the node
+private:
+    uint32_t param_count_;
+    const Type* result_;
+
+    FunctionType(uint32_t param_count, const Type* result)
+        : Type(TypeKind::Function), param_count_(param_count), result_(result) {}
+
+    friend class ASTContext;
+
+public:
+    std::span<const Type* const> get_params() const {
+        return {reinterpret_cast<const Type* const*>(this + 1), param_count_};
+    }
+    const Type* get_result() const { return result_; }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Function; }
 };
 
-class StructType : public Type {
+/// Types identified by their declaration rather than their structure.
+class NominalType : public Type {
+private:
+    IdentifierInfo* name_;
+    const Decl* decl_;
+
+protected:
+    NominalType(TypeKind kind, IdentifierInfo* name, const Decl* decl)
+        : Type(kind), name_(name), decl_(decl) {}
+
+public:
+    IdentifierInfo* get_name() const { return name_; }
+    /// Declaring node; null for types that have not been resolved yet.
+    const Decl* get_decl() const { return decl_; }
+
+    static bool classof(const Type* t) {
+        return t->get_kind() >= TypeKind::Struct && t->get_kind() <= TypeKind::Trait;
+    }
+};
+
+class StructType : public NominalType {
     //struct type
+    StructType(IdentifierInfo* name, const Decl* decl) : NominalType(TypeKind::Struct, name, decl) {}
+
+    friend class ASTContext;
+
+public:
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Struct; }
 };
 
-class EnumType : public Type {
+class EnumType : public NominalType {
     //enum type
+    EnumType(IdentifierInfo* name, const Decl* decl) : NominalType(TypeKind::Enum, name, decl) {}
+
+    friend class ASTContext;
+
+public:
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Enum; }
 };
 
-class ClassType : public Type {
+class ClassType : public NominalType {
     //class type
+    ClassType(IdentifierInfo* name, const Decl* decl) : NominalType(TypeKind::Class, name, decl) {}
+
+    friend class ASTContext;
+
+public:
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Class; }
 };
 
-class TraitType : public Type {
+class TraitType : public NominalType {
     //trait type
+    TraitType(IdentifierInfo* name, const Decl* decl) : NominalType(TypeKind::Trait, name, decl) {}
+
+    friend class ASTContext;
+
+public:
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Trait; }
 };
 
 class GenericType : public Type {
-    //generic type parameter
+    //generic type parameter, identified by name and position in its
+    //parameter list
+private:
+    IdentifierInfo* name_;
+    uint32_t index_;
+
+    GenericType(IdentifierInfo* name, uint32_t index)
+        : Type(TypeKind::Generic), name_(name), index_(index) {}
+
+    friend class ASTContext;
+
+public:
+    IdentifierInfo* get_name() const { return name_; }
+    uint32_t get_index() const { return index_; }
+
+    static bool classof(const Type* t) { return t->get_kind() == TypeKind::Generic; }
 };
 
 } // namespace ast
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "nova/Basic/Diagnostic.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nova {
+
+class DiagnosticEngine;
+class ThreadPool;
+
+namespace ast {
+class FuncDecl;
+class ModuleDecl;
+}
+
+namespace analysis {
+
+/// What checking one function reported. Locations are byte offsets from the
+/// function's name, so a result stays valid when code above the function
+/// moves.
+struct BorrowCheckResult {
+    struct Diagnostic {
+        DiagnosticID id;
+        int64_t offset;
+        std::string message;
+    };
+
+    std::vector<Diagnostic> diagnostics;
+    uint32_t error_count = 0;
+};
+
+/// Borrow check results of the functions of a module, kept across builds.
+///
+/// Each entry is stored under the function's name together with the key
+/// BorrowChecker::hash_function() computed for it: a hash of the typed body
+/// (node kinds, names, literals, every expression's type and each node's
+/// offset in the function) and of the signature, which also covers the
+/// signatures of the functions it calls. A later build reuses the result
+/// when the key is unchanged and re-checks the function otherwise. The
+/// cache holds no AST pointers, so it outlives the ASTContext it was filled
+/// from.
+class BorrowCheckCache {
+private:
+    struct Entry {
+        uint64_t key;
+        BorrowCheckResult result;
+    };
+    std::unordered_map<std::string, Entry> entries_;
+
+public:
+    /// Result stored for `name` under `key`, or null.
+    const BorrowCheckResult* lookup(const std::string& name, uint64_t key) const {
+        auto it = entries_.find(name);
+        return it != entries_.end() && it->second.key == key ? &it->second.result : nullptr;
+    }
+    void store(const std::string& name, uint64_t key, BorrowCheckResult result) {
+        entries_[name] = Entry{key, std::move(result)};
+    }
+    size_t size() const { return entries_.size(); }
+    void clear() { entries_.clear(); }
+};
+
+/// Ownership and initialization checks for a type-checked module, one
+/// function at a time.
+///
+/// Nova Core has no references or moves yet, so the only check is that a
+/// variable is definitely initialized (docs/language-spec.md §3) wherever it
+/// is read; it runs on the CFG with compute_definite_initialization(). Moves
+/// and borrows add their own analyses here as the language grows.
+///
+/// Functions are checked independently, optionally on a ThreadPool. With a
+/// BorrowCheckCache, functions whose key is unchanged are not re-checked;
+/// their stored diagnostics are reported again. Either way diagnostics are
+/// reported in source order, so the output does not depend on the thread
+/// count or on what was cached.
+class BorrowChecker {
+private:
+    DiagnosticEngine& diags_;
+    BorrowCheckCache* cache_;
+    uint32_t error_count_ = 0;
+    uint32_t checked_count_ = 0;
+    uint32_t reused_count_ = 0;
+
+public:
+    explicit BorrowChecker(DiagnosticEngine& diags, BorrowCheckCache* cache = nullptr)
+        : diags_(diags), cache_(cache) {}
+
+    BorrowChecker(const BorrowChecker&) = delete;
+    BorrowChecker& operator=(const BorrowChecker&) = delete;
+
+    /// Check `module` on the calling thread.
+    void check_module(ast::ModuleDecl* module);
+    /// Check `module` with the functions checked on `pool`.
+    void check_module(ast::ModuleDecl* module, ThreadPool& pool);
+
+    /// Check one function without reporting anything. Safe to call
+    /// concurrently for different functions.
+    static BorrowCheckResult check_function(const ast::FuncDecl* func);
+    /// Cache key of `func`.
+    static uint64_t hash_function(const ast::FuncDecl* func);
+
+    /// Errors reported by the check_module() calls, cached ones included.
+    uint32_t get_error_count() const { return error_count_; }
+    /// Functions checked, and functions whose cached result was reused.
+    uint32_t get_checked_count() const { return checked_count_; }
+    uint32_t get_reused_count() const { return reused_count_; }
+
+private:
+    void check_functions(ast::ModuleDecl* module, ThreadPool* pool);
+};
+
+} // namespace analysis
+} // namespace nova
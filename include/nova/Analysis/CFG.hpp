@@ -1,19 +1,135 @@
 #pragma once
 
-// TODO: Implement Control Flow Graph
+#include <cstdint>
+#include <span>
+#include <vector>
 
 namespace nova {
 namespace ast {
 class Stmt;
 class Expr;
 class FuncDecl;
+class VarDecl;
 }
 
 namespace analysis {
 
-class CFGBlock;
-class CFG;
-class CFGBuilder;
+/// One step of a basic block: the evaluation of an expression, or the
+/// binding of a `let` once its initializer has been evaluated.
+///
+/// Expressions are listed in evaluation order, operands before the node
+/// that uses them. The target of an assignment is not listed as a read;
+/// the AssignExpr element is the write. Blocks, `if`, `&&` and `||` appear
+/// where their value is produced, after the control flow that computes it.
+class CFGElement {
+public:
+    enum class Kind : uint8_t { Expr, Decl };
+
+private:
+    Kind kind_;
+    union {
+        ast::Expr* expr_;
+        ast::VarDecl* decl_;
+    };
+
+public:
+    explicit CFGElement(ast::Expr* expr) : kind_(Kind::Expr), expr_(expr) {}
+    explicit CFGElement(ast::VarDecl* decl) : kind_(Kind::Decl), decl_(decl) {}
+
+    Kind get_kind() const { return kind_; }
+    /// The expression evaluated; null for a Decl element.
+    ast::Expr* get_expr() const { return kind_ == Kind::Expr ? expr_ : nullptr; }
+    /// The variable bound; null for an Expr element.
+    ast::VarDecl* get_decl() const { return kind_ == Kind::Decl ? decl_ : nullptr; }
+};
+
+/// A basic block: straight-line elements, then at most two successors.
+///
+/// A block with two successors ends in a branch on get_branch_condition();
+/// the first successor is taken when it is true, the second when false.
+class CFGBlock {
+private:
+    uint32_t id_;
+    ast::Expr* branch_condition_ = nullptr;
+    std::vector<CFGElement> elements_;
+    std::vector<uint32_t> succs_;
+    std::vector<uint32_t> preds_;
+
+    friend class CFG;
+    friend class CFGBuilder;
+
+public:
+    explicit CFGBlock(uint32_t id) : id_(id) {}
+
+    uint32_t get_id() const { return id_; }
+    std::span<const CFGElement> get_elements() const { return elements_; }
+    std::span<const uint32_t> get_succs() const { return succs_; }
+    std::span<const uint32_t> get_preds() const { return preds_; }
+    ast::Expr* get_branch_condition() const { return branch_condition_; }
+};
+
+/// Control flow graph of one function body, owned by value.
+///
+/// Blocks are numbered densely in creation order so analyses can keep
+/// per-block state in plain vectors. Block kEntry has no predecessors and
+/// every return reaches block kExit, which has no successors and no
+/// elements. Code after a return, break or continue lands in blocks that
+/// are unreachable from the entry.
+class CFG {
+private:
+    std::vector<CFGBlock> blocks_;
+    const ast::FuncDecl* func_ = nullptr;
+
+    friend class CFGBuilder;
+
+public:
+    static constexpr uint32_t kEntry = 0;
+    static constexpr uint32_t kExit = 1;
+
+    CFG() = default;
+
+    const ast::FuncDecl* get_function() const { return func_; }
+    uint32_t size() const { return static_cast<uint32_t>(blocks_.size()); }
+    const CFGBlock& get_block(uint32_t id) const { return blocks_[id]; }
+    std::span<const CFGBlock> blocks() const { return blocks_; }
+    const CFGBlock& get_entry() const { return blocks_[kEntry]; }
+    const CFGBlock& get_exit() const { return blocks_[kExit]; }
+
+    /// Ids of the blocks reachable from the entry, in reverse postorder:
+    /// every block comes before its successors except along back edges.
+    std::vector<uint32_t> compute_reverse_postorder() const;
+};
+
+/// Builds the CFG of a type-checked function body.
+///
+/// Nova Core control flow is `if`, `while`, `break`, `continue`, `return`
+/// and the short-circuit operators; everything else is straight-line.
+class CFGBuilder {
+private:
+    struct LoopTargets {
+        uint32_t continue_block;
+        uint32_t break_block;
+    };
+
+    CFG cfg_;
+    uint32_t current_ = CFG::kEntry;
+    std::vector<LoopTargets> loops_;
+
+public:
+    /// CFG of `func`, which must have a body.
+    static CFG build(const ast::FuncDecl* func);
+
+private:
+    uint32_t create_block();
+    void add_edge(uint32_t from, uint32_t to);
+    void branch(ast::Expr* cond, uint32_t then_block, uint32_t else_block);
+    // ends the current block with a jump; what follows is unreachable
+    void jump_away(uint32_t to);
+
+    void build_stmt(ast::Stmt* stmt);
+    void build_expr(ast::Expr* expr);
+    void append(ast::Expr* expr) { cfg_.blocks_[current_].elements_.emplace_back(expr); }
+};
 
 } // namespace analysis
 } // namespace nova
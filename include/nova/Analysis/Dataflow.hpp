@@ -0,0 +1,151 @@
+#pragma once
+
+#include "CFG.hpp"
+#include "nova/Basic/BitVector.hpp"
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace nova {
+namespace ast {
+class Decl;
+class FuncDecl;
+}
+
+namespace analysis {
+
+enum class DataflowDirection : uint8_t { Forward, Backward };
+
+/// How the states flowing into a block are combined: Union for "on some
+/// path" problems (liveness), Intersection for "on every path" problems
+/// (definite initialization).
+enum class DataflowMeet : uint8_t { Union, Intersection };
+
+/// A gen/kill transfer function: out = gen | (in & ~kill).
+///
+/// gen() and kill() apply one more step after the current function, so
+/// calling them element by element in flow order composes a whole block.
+class GenKillSet {
+private:
+    BitVector gen_;
+    BitVector kill_;
+
+public:
+    GenKillSet() = default;
+    explicit GenKillSet(size_t num_bits) : gen_(num_bits), kill_(num_bits) {}
+
+    void gen(size_t bit) {
+        gen_.set(bit);
+        kill_.reset(bit);
+    }
+    void kill(size_t bit) {
+        kill_.set(bit);
+        gen_.reset(bit);
+    }
+
+    const BitVector& get_gen() const { return gen_; }
+    const BitVector& get_kill() const { return kill_; }
+};
+
+struct DataflowProblem {
+    DataflowDirection direction = DataflowDirection::Forward;
+    DataflowMeet meet = DataflowMeet::Union;
+    uint32_t num_bits = 0;
+    /// State at the entry (forward) or exit (backward) of the function.
+    BitVector boundary;
+};
+
+/// Fixed point of a DataflowProblem: the state at the start and at the end
+/// of every block, in program order whatever the direction. Blocks that are
+/// unreachable from the entry keep the initial state (empty for Union, full
+/// for Intersection).
+class DataflowResult {
+private:
+    std::vector<BitVector> block_entry_;
+    std::vector<BitVector> block_exit_;
+    uint64_t visit_count_ = 0;
+
+    friend DataflowResult solve_dataflow(const CFG&, const DataflowProblem&,
+                                         std::span<const GenKillSet>);
+
+public:
+    const BitVector& get_block_entry(uint32_t block) const { return block_entry_[block]; }
+    const BitVector& get_block_exit(uint32_t block) const { return block_exit_[block]; }
+    /// Number of block transfer functions applied until the fixed point.
+    uint64_t get_visit_count() const { return visit_count_; }
+};
+
+/// Compose the transfer function of each block once from
+/// `transfer(const CFGElement&, GenKillSet&)`, which records what one element
+/// generates and kills. Elements are visited in flow order, so backward
+/// problems see each block bottom-up.
+template <typename ElementTransfer>
+std::vector<GenKillSet> build_block_transfers(const CFG& cfg, DataflowDirection direction,
+                                              uint32_t num_bits, ElementTransfer&& transfer) {
+    std::vector<GenKillSet> blocks;
+    blocks.reserve(cfg.size());
+    for (const CFGBlock& block : cfg.blocks()) {
+        GenKillSet& set = blocks.emplace_back(num_bits);
+        std::span<const CFGElement> elements = block.get_elements();
+        if (direction == DataflowDirection::Forward) {
+            for (const CFGElement& element : elements) {
+                transfer(element, set);
+            }
+        } else {
+            for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+                transfer(*it, set);
+            }
+        }
+    }
+    return blocks;
+}
+
+/// Solve `problem` on `cfg` given one transfer function per block.
+///
+/// A worklist visits pending blocks in reverse postorder (postorder for
+/// backward problems), so an acyclic region settles in one pass and each
+/// loop takes as many passes as its nesting depth needs. Every step is a
+/// whole-word bit vector operation.
+DataflowResult solve_dataflow(const CFG& cfg, const DataflowProblem& problem,
+                              std::span<const GenKillSet> transfers);
+
+template <typename ElementTransfer>
+DataflowResult solve_dataflow(const CFG& cfg, const DataflowProblem& problem,
+                              ElementTransfer&& transfer) {
+    const std::vector<GenKillSet> transfers =
+        build_block_transfers(cfg, problem.direction, problem.num_bits, transfer);
+    return solve_dataflow(cfg, problem, std::span<const GenKillSet>(transfers));
+}
+
+/// Dense numbering of the local variables of a function: its parameters in
+/// order, then its `let` bindings in CFG block order.
+class VariableIndex {
+private:
+    std::unordered_map<const ast::Decl*, uint32_t> bits_;
+    std::vector<const ast::Decl*> decls_;
+
+public:
+    VariableIndex(const ast::FuncDecl* func, const CFG& cfg);
+
+    uint32_t size() const { return static_cast<uint32_t>(decls_.size()); }
+    /// Bit of `decl`, or -1 if it is not a local variable of the function.
+    int64_t lookup(const ast::Decl* decl) const {
+        auto it = bits_.find(decl);
+        return it == bits_.end() ? -1 : static_cast<int64_t>(it->second);
+    }
+    const ast::Decl* get_decl(uint32_t bit) const { return decls_[bit]; }
+};
+
+/// Variables whose current value may still be read: backward, Union. A read
+/// generates, an assignment or `let` kills. Needs a type-checked body, since
+/// reads are matched to variables through IdentifierExpr::get_decl().
+DataflowResult compute_liveness(const CFG& cfg, const VariableIndex& vars);
+
+/// Variables assigned on every path: forward, Intersection. Parameters start
+/// initialized; a `let` with an initializer or an assignment generates, a
+/// `let` without one kills (a loop re-entering its scope rebinds it).
+DataflowResult compute_definite_initialization(const CFG& cfg, const VariableIndex& vars);
+
+} // namespace analysis
+} // namespace nova
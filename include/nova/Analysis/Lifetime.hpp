@@ -1,13 +1,107 @@
 #pragma once
 
-// TODO: Implement lifetime analysis
+#include "nova/Basic/BitVector.hpp"
+#include "nova/Basic/SourceLocation.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace nova {
 namespace analysis {
 
-class Lifetime;
-class LifetimeConstraint;
+/// A lifetime (region) variable: the set of program points where a
+/// reference must stay valid. The value is computed by LifetimeSolver.
+class Lifetime {
+private:
+    uint32_t id_ = UINT32_MAX;
+
+public:
+    Lifetime() = default;
+    explicit Lifetime(uint32_t id) : id_(id) {}
+
+    uint32_t get_id() const { return id_; }
+    bool is_valid() const { return id_ != UINT32_MAX; }
+
+    bool operator==(const Lifetime& other) const = default;
+};
+
+/// `longer: shorter`: `longer` outlives `shorter`, so it contains every
+/// point of `shorter`.
+struct LifetimeConstraint {
+    Lifetime longer;
+    Lifetime shorter;
+    /// Where the constraint came from, for diagnostics.
+    SourceLocation loc;
+};
+
+// Lexical scopes of named lifetimes; an extension.
 class LifetimeScope;
 
+/// Region inference: the smallest value of each lifetime that contains its
+/// live points and satisfies every outlives constraint.
+///
+/// Instead of iterating the constraints to a fixed point, which costs a pass
+/// over every constraint per step of the longest chain, the solver merges
+/// lifetimes that must be equal with union-find (add_equal() and every cycle
+/// of outlives constraints, found as strongly connected components), then
+/// propagates points once over the condensed DAG in topological order. The
+/// time is linear in the number of lifetimes and constraints, times the
+/// words of a point set.
+class LifetimeSolver {
+private:
+    uint32_t num_points_;
+    std::vector<std::pair<uint32_t, uint32_t>> live_points_; // lifetime, point
+    std::vector<LifetimeConstraint> constraints_;
+
+    // union-find over lifetimes: parent links with path halving, union by size
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> size_;
+
+    // after solve(): each lifetime's component, the components in topological
+    // order, and one point set per component
+    std::vector<uint32_t> component_;
+    std::vector<BitVector> values_;
+    bool solved_ = false;
+
+public:
+    explicit LifetimeSolver(uint32_t num_points) : num_points_(num_points) {}
+
+    LifetimeSolver(const LifetimeSolver&) = delete;
+    LifetimeSolver& operator=(const LifetimeSolver&) = delete;
+
+    Lifetime create_lifetime();
+    uint32_t get_lifetime_count() const { return static_cast<uint32_t>(parent_.size()); }
+    uint32_t get_point_count() const { return num_points_; }
+
+    /// `lifetime` must contain `point`.
+    void add_live_point(Lifetime lifetime, uint32_t point) {
+        live_points_.emplace_back(lifetime.get_id(), point);
+    }
+    void add_outlives(Lifetime longer, Lifetime shorter, SourceLocation loc = {}) {
+        constraints_.push_back({longer, shorter, loc});
+    }
+    /// `a` and `b` are the same lifetime (e.g. both sides of an invariant
+    /// type parameter); merged right away.
+    void add_equal(Lifetime a, Lifetime b);
+    std::span<const LifetimeConstraint> get_constraints() const { return constraints_; }
+
+    /// Compute every lifetime's value. Constraints added afterwards need
+    /// another solve().
+    void solve();
+
+    /// Points of `lifetime`; shared by every lifetime it was merged with.
+    const BitVector& get_value(Lifetime lifetime) const;
+    /// True when `a` and `b` were merged: equal, or on a cycle of outlives
+    /// constraints.
+    bool are_merged(Lifetime a, Lifetime b) const;
+    /// Number of distinct values after solve().
+    uint32_t get_component_count() const { return static_cast<uint32_t>(values_.size()); }
+
+private:
+    uint32_t find(uint32_t id);
+    void unite(uint32_t a, uint32_t b);
+};
+
 } // namespace analysis
 } // namespace nova
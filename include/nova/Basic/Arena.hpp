@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nova {
+
+/// Bump-pointer allocator.
+///
+/// Memory is carved out of slabs that start at kInitialSlabSize bytes and
+/// double up to kMaxSlabSize; requests larger than half a slab get a slab of
+/// their own. Nothing is freed individually: all memory is released when the
+/// arena is destroyed or reset(). Destructors are never run, so only
+/// trivially destructible objects may be created in an arena.
+class Arena {
+public:
+    static constexpr size_t kInitialSlabSize = 4096;
+    static constexpr size_t kMaxSlabSize = 1 << 20;
+
+    Arena() = default;
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    /// Allocate `size` bytes aligned to `align` (a power of two).
+    void* allocate(size_t size, size_t align) {
+        const auto cur = reinterpret_cast<uintptr_t>(cur_);
+        const uintptr_t aligned = (cur + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        if (cur_ && aligned + size <= reinterpret_cast<uintptr_t>(end_)) {
+            cur_ = reinterpret_cast<char*>(aligned + size);
+            bytes_allocated_ += size;
+            return reinterpret_cast<void*>(aligned);
+        }
+        return allocate_slow(size, align);
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// Release every slab.
+    void reset();
+
+    /// Take over `other`'s slabs: objects allocated there stay valid until
+    /// this arena is destroyed or reset(). `other` is left empty; allocation
+    /// here continues in this arena's current slab.
+    void adopt(Arena&& other);
+
+    /// Bytes handed out by allocate() (excluding alignment padding).
+    size_t bytes_allocated() const { return bytes_allocated_; }
+    /// Bytes obtained from the system for slabs.
+    size_t bytes_reserved() const { return bytes_reserved_; }
+    size_t slab_count() const { return slabs_.size(); }
+
+private:
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    std::vector<char*> slabs_;
+    size_t next_slab_size_ = kInitialSlabSize;
+    size_t bytes_allocated_ = 0;
+    size_t bytes_reserved_ = 0;
+
+    void* allocate_slow(size_t size, size_t align);
+};
+
+} // namespace nova
@@ -0,0 +1,132 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nova {
+
+/// Fixed-size dense bit set over 64-bit words.
+///
+/// The set operations are straight loops over the word arrays with no
+/// per-bit work, so the compiler vectorizes them; dataflow analyses spend
+/// most of their time here. Bits past size() are always zero, so count()
+/// and operator== can work on whole words.
+class BitVector {
+private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+
+    static size_t word_count(size_t bits) { return (bits + 63) / 64; }
+    void clear_unused_bits() {
+        if (size_ % 64 != 0) {
+            words_.back() &= (uint64_t{1} << (size_ % 64)) - 1;
+        }
+    }
+
+public:
+    BitVector() = default;
+    explicit BitVector(size_t size, bool value = false)
+        : words_(word_count(size), value ? ~uint64_t{0} : 0), size_(size) {
+        clear_unused_bits();
+    }
+
+    size_t size() const { return size_; }
+
+    bool test(size_t index) const {
+        assert(index < size_ && "bit index out of range");
+        return (words_[index / 64] >> (index % 64)) & 1;
+    }
+    void set(size_t index) {
+        assert(index < size_ && "bit index out of range");
+        words_[index / 64] |= uint64_t{1} << (index % 64);
+    }
+    void reset(size_t index) {
+        assert(index < size_ && "bit index out of range");
+        words_[index / 64] &= ~(uint64_t{1} << (index % 64));
+    }
+    void set_all() {
+        for (uint64_t& word : words_) {
+            word = ~uint64_t{0};
+        }
+        clear_unused_bits();
+    }
+    void reset_all() {
+        for (uint64_t& word : words_) {
+            word = 0;
+        }
+    }
+
+    size_t count() const {
+        size_t bits = 0;
+        for (uint64_t word : words_) {
+            bits += static_cast<size_t>(std::popcount(word));
+        }
+        return bits;
+    }
+    bool any() const {
+        uint64_t bits = 0;
+        for (uint64_t word : words_) {
+            bits |= word;
+        }
+        return bits != 0;
+    }
+
+    /// this |= other; true if a bit changed.
+    bool union_with(const BitVector& other) {
+        assert(size_ == other.size_ && "bit vectors of different sizes");
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words_.size(); ++i) {
+            const uint64_t word = words_[i] | other.words_[i];
+            changed |= word ^ words_[i];
+            words_[i] = word;
+        }
+        return changed != 0;
+    }
+    /// this &= other; true if a bit changed.
+    bool intersect_with(const BitVector& other) {
+        assert(size_ == other.size_ && "bit vectors of different sizes");
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words_.size(); ++i) {
+            const uint64_t word = words_[i] & other.words_[i];
+            changed |= word ^ words_[i];
+            words_[i] = word;
+        }
+        return changed != 0;
+    }
+    /// this &= ~other.
+    void subtract(const BitVector& other) {
+        assert(size_ == other.size_ && "bit vectors of different sizes");
+        for (size_t i = 0; i < words_.size(); ++i) {
+            words_[i] &= ~other.words_[i];
+        }
+    }
+    /// this = gen | (in & ~kill), the gen/kill transfer function; true if a
+    /// bit changed.
+    bool assign_transfer(const BitVector& gen, const BitVector& in, const BitVector& kill) {
+        assert(size_ == gen.size_ && size_ == in.size_ && size_ == kill.size_ &&
+               "bit vectors of different sizes");
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words_.size(); ++i) {
+            const uint64_t word = gen.words_[i] | (in.words_[i] & ~kill.words_[i]);
+            changed |= word ^ words_[i];
+            words_[i] = word;
+        }
+        return changed != 0;
+    }
+
+    /// Call fn(index) for every set bit, in increasing order.
+    template <typename Fn>
+    void for_each_set_bit(Fn&& fn) const {
+        for (size_t i = 0; i < words_.size(); ++i) {
+            for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+                fn(i * 64 + static_cast<size_t>(std::countr_zero(word)));
+            }
+        }
+    }
+
+    bool operator==(const BitVector& other) const = default;
+};
+
+} // namespace nova
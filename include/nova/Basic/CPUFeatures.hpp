@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+namespace nova {
+
+/// Instruction-set levels understood by the vectorized scanning kernels.
+/// Levels are ordered: a CPU supporting a level supports all lower ones.
+enum class SIMDLevel : uint8_t {
+    Scalar,
+    SSE2,   // 16 bytes per step
+    AVX2,   // 32 bytes per step
+};
+
+/// Highest level supported by the host CPU (and OS), detected once.
+SIMDLevel get_host_simd_level();
+
+/// Level the scanning kernels currently dispatch to.
+/// Defaults to the host level.
+SIMDLevel get_active_simd_level();
+
+/// Force kernels to dispatch to `level` (clamped to the host level).
+/// Intended for benchmarks and tests; returns the level actually selected.
+SIMDLevel set_active_simd_level(SIMDLevel level);
+
+/// Human-readable level name ("scalar", "sse2", "avx2").
+const char* get_simd_level_name(SIMDLevel level);
+
+} // namespace nova
@@ -0,0 +1,39 @@
+#pragma once
+#include <cassert>
+#include <type_traits>
+
+namespace nova {
+
+/// LLVM-style RTTI over a kind tag.
+///
+/// A class hierarchy opts in by giving every class a
+/// `static bool classof(const Root*)` that tests the tag; no vtables are
+/// involved. The pointer passed to isa/cast/dyn_cast must not be null (use
+/// dyn_cast_if_present for nullable pointers).
+
+template <typename... To, typename From>
+bool isa(const From* value) {
+    assert(value && "isa<> on a null pointer");
+    return (To::classof(value) || ...);
+}
+
+template <typename To, typename From>
+auto* cast(From* value) {
+    assert(isa<To>(value) && "cast<> to an incompatible type");
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+    return static_cast<Result*>(value);
+}
+
+template <typename To, typename From>
+auto* dyn_cast(From* value) {
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+    return isa<To>(value) ? static_cast<Result*>(value) : nullptr;
+}
+
+template <typename To, typename From>
+auto* dyn_cast_if_present(From* value) {
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+    return value && isa<To>(value) ? static_cast<Result*>(value) : nullptr;
+}
+
+} // namespace nova
@@ -1,15 +1,22 @@
 #pragma once
+#include "Arena.hpp"
 #include "Diagnostic.hpp"
 #include "SourceLocation.hpp"
 #include "SourceManager.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <thread>
+#include <unordered_set>
 
 namespace nova {
 
+class DiagnosticSink;
 
 /// A single diagnostic message with location and arguments
 struct DiagnosticMessage {
@@ -20,14 +27,81 @@ struct DiagnosticMessage {
     std::vector<SourceRange> ranges;  // Additional source ranges to highlight
 };
 
+/// One argument of a deferred diagnostic. Strings and ranges point into the
+/// recording thread's DiagnosticBuffer arena.
+struct DiagnosticArgument {
+    enum class Kind : uint8_t { String, Integer, Range };
+
+    Kind kind = Kind::Integer;
+    uint32_t length = 0; // string length
+    union {
+        int64_t integer;
+        const char* string;
+        const SourceRange* range;
+    };
+
+    DiagnosticArgument() : integer(0) {}
+};
+
+/// Compact, unformatted diagnostic recorded in deferred mode.
+///
+/// The first kInlineArguments arguments live in the record itself; longer
+/// argument lists move to an arena-allocated array.
+struct DiagnosticRecord {
+    static constexpr uint32_t kInlineArguments = 4;
+
+    DiagnosticID id = DiagnosticID::count;
+    DiagnosticSeverity severity = DiagnosticSeverity::Error;
+    SourceLocation location;
+    // hash of (id, location, arguments), for deduplication and sorting
+    uint64_t hash = 0;
+    // index (in the same buffer) of the diagnostic a note belongs to
+    uint32_t group = 0;
+    uint32_t argument_count = 0;
+    uint32_t argument_capacity = kInlineArguments;
+    DiagnosticArgument* overflow = nullptr;
+    DiagnosticArgument inline_arguments[kInlineArguments];
+
+    const DiagnosticArgument* arguments() const {
+        return overflow ? overflow : inline_arguments;
+    }
+};
+
+/// Diagnostics recorded by one thread in deferred mode.
+struct DiagnosticBuffer {
+    static constexpr uint32_t kNoGroup = UINT32_MAX;
+    static constexpr uint32_t kDroppedGroup = UINT32_MAX - 1;
+
+    std::thread::id owner;
+    DiagnosticBuffer* next = nullptr;
+    std::vector<DiagnosticRecord> records;
+    // group that the next note joins; kDroppedGroup after a suppressed
+    // warning, so its notes are dropped too
+    uint32_t current_group = kNoGroup;
+    // deduplication applied while recording, so repeated diagnostics never
+    // reach the record vector; per-ID limits are applied by flush()
+    std::unordered_set<uint64_t> seen;
+    // string arguments, ranges and overflowing argument arrays
+    Arena arena;
+};
+
 /// Builder for constructing diagnostics with arguments
 class DiagnosticBuilder {
 private:
     //use* to avoid circular dependency
     class DiagnosticEngine* engine_;
     DiagnosticMessage diag_;
+    // deferred mode: arguments go into record_, with storage from buffer_
+    DiagnosticBuffer* buffer_ = nullptr;
+    DiagnosticRecord record_;
+    // key for deduplication, accumulated as arguments arrive
+    uint64_t hash_ = 0;
+    // already over its per-ID limit: arguments are dropped unseen
+    bool suppressed_ = false;
     bool emitted_ = false;
 
+    DiagnosticArgument& add_argument();
+
 public:
     DiagnosticBuilder(DiagnosticEngine* engine, DiagnosticID id, 
                       DiagnosticSeverity severity, SourceLocation loc);
@@ -63,19 +137,51 @@ public:
 private:
     const SourceManager* source_manager_;
     DiagnosticHandler handler_;
+    DiagnosticSink* sink_ = nullptr;
     
-    uint32_t error_count_ = 0;
-    uint32_t warning_count_ = 0;
+    std::atomic<uint32_t> error_count_{0};
+    std::atomic<uint32_t> warning_count_{0};
     
     bool warnings_as_errors_ = false;
     bool suppress_warnings_ = false;
+    bool deferred_ = false;
     uint32_t error_limit_ = 20;  // Stop after this many errors
 
+    // deferred mode: one buffer per reporting thread, pushed lock-free
+    std::atomic<DiagnosticBuffer*> buffers_{nullptr};
+    // distinguishes engines in the per-thread buffer cache
+    const uint64_t serial_;
+
+    static constexpr size_t kDiagnosticCount = static_cast<size_t>(DiagnosticID::count);
+    static constexpr uint32_t kNoLimit = UINT32_MAX;
+    // rate limiting; filtering_ is set once any limit or deduplication is on
+    bool filtering_ = false;
+    bool deduplicate_ = false;
+    std::array<uint32_t, kDiagnosticCount> limits_;
+    std::array<std::atomic<uint32_t>, kDiagnosticCount> shown_{};
+    std::array<std::atomic<uint32_t>, kDiagnosticCount> suppressed_{};
+    // immediate mode: keys seen so far and whether the last non-note was
+    // dropped (its notes go with it)
+    std::mutex filter_mutex_;
+    std::unordered_set<uint64_t> seen_;
+    bool last_suppressed_ = false;
+    // suppressed total already reported by a summary line
+    uint32_t summarized_ = 0;
+
 public:
     explicit DiagnosticEngine(const SourceManager* sm);
+    ~DiagnosticEngine();
+
+    DiagnosticEngine(const DiagnosticEngine&) = delete;
+    DiagnosticEngine& operator=(const DiagnosticEngine&) = delete;
     
     /// Set custom diagnostic handler (default prints to stderr)
     void set_handler(DiagnosticHandler handler);
+
+    /// Send diagnostics to a machine-readable sink instead of stderr text.
+    /// Unlike a custom handler, the engine keeps counting errors and warnings.
+    /// A handler, if set, still takes precedence.
+    void set_sink(DiagnosticSink* sink) { sink_ = sink; }
     
     /// Report a diagnostic at a location
     DiagnosticBuilder report(DiagnosticID id, SourceLocation loc);
@@ -90,19 +196,70 @@ public:
     void set_warnings_as_errors(bool enable) { warnings_as_errors_ = enable; }
     void set_suppress_warnings(bool enable) { suppress_warnings_ = enable; }
     void set_error_limit(uint32_t limit) { error_limit_ = limit; }
+
+    /// Show at most `limit` diagnostics per ID (0 = unlimited); later ones are
+    /// counted but not formatted. In deferred mode "later" means later in
+    /// location order, whichever thread reported them. Notes follow the diagnostic they belong to.
+    void set_diagnostic_limit(uint32_t limit);
+    void set_diagnostic_limit(DiagnosticID id, uint32_t limit);
+    /// Drop diagnostics whose (id, location, arguments) were already shown.
+    void set_deduplicate(bool enable);
+    /// Diagnostics dropped by limits or deduplication.
+    uint32_t suppressed_count() const;
+    uint32_t suppressed_count(DiagnosticID id) const {
+        return suppressed_[static_cast<size_t>(id)].load(std::memory_order_relaxed);
+    }
+
+    /// Deferred mode: report() records compact DiagnosticRecords into a
+    /// per-thread buffer without building strings or taking locks, and
+    /// nothing is printed until flush(). Counts are still updated when a
+    /// diagnostic is recorded, so should_stop() works while reporting.
+    /// Fatal diagnostics are always emitted immediately. As the default
+    /// handler then terminates, it first flushes the diagnostics pending in
+    /// the reporting thread's buffer; those of other threads are lost.
+    void set_deferred(bool enable) { deferred_ = enable; }
+    bool is_deferred() const { return deferred_; }
+
+    /// Format and emit every deferred diagnostic, sorted by location (notes
+    /// stay after the diagnostic they were reported with), so the output does
+    /// not depend on which thread reported what. Then, in either mode, emit a
+    /// note_diagnostics_suppressed summary if diagnostics were suppressed
+    /// since the last one. Must not run concurrently with report().
+    void flush();
+    /// Deferred diagnostics waiting for flush().
+    size_t pending_count() const;
     
     // Query state
-    uint32_t error_count() const { return error_count_; }
-    uint32_t warning_count() const { return warning_count_; }
-    bool has_errors() const { return error_count_ > 0; }
-    bool should_stop() const { return error_count_ >= error_limit_; }
+    uint32_t error_count() const { return error_count_.load(std::memory_order_relaxed); }
+    uint32_t warning_count() const { return warning_count_.load(std::memory_order_relaxed); }
+    bool has_errors() const { return error_count() > 0; }
+    bool should_stop() const { return error_count() >= error_limit_; }
     
     // Access source manager
     const SourceManager* source_manager() const { return source_manager_; }
 
 private:
+    friend class DiagnosticBuilder;
+
     void default_handler(const DiagnosticMessage& diag);
     std::string format_diagnostic(const DiagnosticMessage& diag) const;
+    // update the counts for a diagnostic about to be shown; false if it is
+    // a suppressed warning
+    bool count(DiagnosticSeverity severity);
+    // false if a diagnostic about to be shown immediately is filtered out
+    bool admit(DiagnosticID id, DiagnosticSeverity severity, uint64_t hash, bool over_limit);
+    bool at_limit(DiagnosticID id) const;
+    void emit(const DiagnosticMessage& diag, uint64_t hash, bool over_limit);
+    void emit_summary(std::string& out);
+    void print(const DiagnosticMessage& diag, std::string& out) const;
+    // hand a counted diagnostic to the handler, the sink, or `out` as text
+    void deliver(const DiagnosticMessage& diag, std::string& out) const;
+
+    DiagnosticBuffer* get_thread_buffer();
+    void record(DiagnosticBuffer* buffer, const DiagnosticRecord& record);
+    // flush() restricted to `only` unless it is null
+    void flush_buffers(DiagnosticBuffer* only);
+    DiagnosticMessage materialize(const DiagnosticRecord& record) const;
 };
 
 } // namespace nova
@@ -0,0 +1,71 @@
+#pragma once
+#include "DiagnosticEngine.hpp"
+#include "SourceManager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace nova {
+
+/// Machine-readable diagnostic output for tools and build farms.
+///
+/// Diagnostics are encoded into an in-memory buffer that is written with a
+/// single fwrite() whenever it exceeds kBufferSize and on flush() or
+/// destruction, so bulk output costs one syscall per buffer, not per message.
+/// Locations are resolved to file, line and column once, at write time.
+///
+/// Json writes one object per line:
+///   {"code":"E0002","severity":"error","message":"...","file":"a.nova",
+///    "line":3,"column":12,"ranges":[{"line":3,"column":12,"end_line":3,
+///    "end_column":16}]}
+/// "file", "line" and "column" are omitted for diagnostics without a location.
+///
+/// Binary starts with the 8-byte magic "NOVADIAG" and a u32 version, followed
+/// by one record per diagnostic. All integers are little-endian:
+///   u32 record size (bytes after this field)
+///   u8  severity (DiagnosticSeverity)
+///   u8  code length, code bytes
+///   u16 file name length, file name bytes
+///   u32 line, u32 column (0 without a location)
+///   u32 message length, message bytes
+///   u16 range count, then per range u32 line, column, end line, end column
+///   (ranges past the first 65535 are dropped)
+class DiagnosticSink {
+public:
+    enum class Format : uint8_t { Json, Binary };
+
+    static constexpr size_t kBufferSize = 64 * 1024;
+    static constexpr uint32_t kBinaryVersion = 1;
+
+    DiagnosticSink(const SourceManager* sm, std::FILE* out, Format format);
+    ~DiagnosticSink();
+
+    DiagnosticSink(const DiagnosticSink&) = delete;
+    DiagnosticSink& operator=(const DiagnosticSink&) = delete;
+
+    Format get_format() const { return format_; }
+
+    /// Encode one diagnostic; thread-safe.
+    void write(const DiagnosticMessage& diag);
+    /// Write out everything buffered so far.
+    void flush();
+
+    /// Diagnostics written since construction.
+    size_t written_count() const { return written_; }
+
+private:
+    const SourceManager* source_manager_;
+    std::FILE* out_;
+    Format format_;
+    std::mutex mutex_;
+    std::string buffer_;
+    size_t written_ = 0;
+
+    void write_json(const DiagnosticMessage& diag);
+    void write_binary(const DiagnosticMessage& diag);
+    void flush_locked();
+};
+
+} // namespace nova
@@ -1,53 +1,119 @@
 #pragma once
+#include "nova/Basic/Arena.hpp"
 #include "nova/Lex/TokenKinds.hpp"
-#include <string>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string_view>
-#include <unordered_map>
 #include <vector>
-#include <memory>
 
 namespace nova {
 
-// C++20 transparent hash for heterogeneous lookup
-struct StringHash {
-    using is_transparent = void;
-    
-    [[nodiscard]] std::size_t operator()(std::string_view sv) const noexcept {
-        return std::hash<std::string_view>{}(sv);
-    }
-};
-
-struct StringEqual {
-    using is_transparent = void;
-    
-    [[nodiscard]] bool operator()(std::string_view lhs, std::string_view rhs) const noexcept {
-        return lhs == rhs;
-    }
-};
-
+/// Interned identifier. Allocated in the IdentifierTable arena with its
+/// characters (plus a '\0') stored directly after the struct, so two infos
+/// are the same identifier iff they are the same pointer.
 struct IdentifierInfo {
-    std::string name;
     TokenKind token_kind;
     bool is_keyword;
+    uint32_t length;
+    // dense index (0..size()-1), usable as a key for side tables; in
+    // single-threaded mode it follows interning order
+    uint32_t id;
 
-    IdentifierInfo(std::string n, TokenKind kind, bool keyword)
-        : name(std::move(n)), token_kind(kind), is_keyword(keyword) {}
+    IdentifierInfo(TokenKind kind, bool keyword, uint32_t len, uint32_t ident_id)
+        : token_kind(kind), is_keyword(keyword), length(len), id(ident_id) {}
+
+    const char* get_name_data() const { return reinterpret_cast<const char*>(this + 1); }
+    std::string_view get_name() const { return {get_name_data(), length}; }
 };
 
+/// Identifier interning table.
+///
+/// A table constructed with `concurrent = true` may be shared by threads that
+/// lex different files at the same time. It is split into kConcurrentShards
+/// lock-striped shards selected by the high bits of the hash; each shard owns
+/// its slots and arena, so IdentifierInfo pointers stay stable and there is
+/// exactly one info per name across all threads. The default table has one
+/// shard and takes no locks.
 class IdentifierTable {
+public:
+    static constexpr unsigned kConcurrentShards = 16;
+
 private:
-    // Use std::string as key (owns the data), with transparent lookup
-    std::unordered_map<std::string, IdentifierInfo*, StringHash, StringEqual> table_;
-    std::vector<std::unique_ptr<IdentifierInfo>> storage_;
+    // open addressing with linear probing; the full hash is kept next to the
+    // pointer so probes and rehashing never touch the name
+    struct Slot {
+        IdentifierInfo* info;
+        uint64_t hash;
+    };
+    // own cache line each, so threads on different shards do not false-share
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<Slot> slots;
+        size_t size = 0;
+        Arena arena;
+    };
+    std::unique_ptr<Shard[]> shards_;
+    unsigned shard_count_;
+    bool concurrent_;
+    std::atomic<uint32_t> next_id_{0};
+    // id -> info, in segments of doubling size (segment k holds
+    // kFirstIdSegment << k entries) so published entries never move
+    static constexpr uint32_t kFirstIdSegment = 1024;
+    static constexpr unsigned kIdSegments = 22;
+    std::array<std::atomic<std::atomic<IdentifierInfo*>*>, kIdSegments> id_segments_{};
+    // keyword infos indexed by TokenKind, so the lexer never hashes a keyword
+    std::array<IdentifierInfo*, static_cast<size_t>(TokenKind::count)> keyword_infos_{};
 
 public:
-    IdentifierTable();
+    explicit IdentifierTable(bool concurrent = false);
+    ~IdentifierTable();
+
+    IdentifierTable(const IdentifierTable&) = delete;
+    IdentifierTable& operator=(const IdentifierTable&) = delete;
+
+    bool is_concurrent() const { return concurrent_; }
+
+    /// Hash used by the table; callers that already have it can use the
+    /// two-argument intern().
+    static uint64_t hash(std::string_view name);
+
+    /// Return the unique info for `name`, creating it on first use.
+    IdentifierInfo* intern(std::string_view name) { return intern(name, hash(name)); }
+    IdentifierInfo* intern(std::string_view name, uint64_t name_hash);
 
-    [[nodiscard]] IdentifierInfo* get(std::string_view name);
-    void add_identifier(std::string_view name);
+    /// Lookup only; nullptr if `name` was never interned.
+    [[nodiscard]] IdentifierInfo* get(std::string_view name) const;
+
+    /// Info with the given id, nullptr if no such id was handed out yet.
+    [[nodiscard]] IdentifierInfo* get_identifier(uint32_t id) const;
+
+    // info for a keyword kind (see get_keyword_kind), nullptr for other kinds
+    [[nodiscard]] IdentifierInfo* get_keyword_info(TokenKind kind) const {
+        return keyword_infos_[static_cast<size_t>(kind)];
+    }
+
+    /// Number of interned identifiers, keywords included.
+    size_t size() const { return next_id_.load(std::memory_order_relaxed); }
+    /// Heap bytes used by the hash tables and arenas. Not synchronized with
+    /// concurrent intern() calls.
+    size_t memory_bytes() const;
 
 private:
+    Shard& get_shard(uint64_t name_hash) const;
+    // lock `shard` if the table is shared between threads
+    std::unique_lock<std::mutex> lock(Shard& shard) const {
+        return concurrent_ ? std::unique_lock<std::mutex>(shard.mutex)
+                           : std::unique_lock<std::mutex>();
+    }
     void add_keyword(const char* name, TokenKind kind);
+    IdentifierInfo* create_info(Shard& shard, std::string_view name);
+    static void grow(Shard& shard);
+    static void locate_id(uint32_t id, unsigned& segment, size_t& index);
+    void publish_id(IdentifierInfo* info);
 };
 
 } // namespace nova
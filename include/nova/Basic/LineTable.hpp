@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace nova {
+
+/// Compact table of line start offsets for one file.
+///
+/// Lines are grouped in chunks of kLinesPerChunk. Each chunk stores the
+/// absolute offset of its first line (a sparse index that is binary searched);
+/// every other line is a 16-bit delta from the previous line start. Lines
+/// longer than 0xFFFE bytes store 0xFFFF and spill the real delta to
+/// `long_deltas_`, in order, starting at the chunk's `first_long_delta`.
+///
+/// This needs ~2 bytes per line instead of 4, and a lookup touches one small
+/// index plus at most one chunk of deltas.
+class LineTable {
+public:
+    static constexpr uint32_t kLinesPerChunk = 64;
+
+    LineTable() = default;
+
+    /// Build the table for `text`; newlines are located with SIMD kernels.
+    static LineTable build(std::string_view text);
+
+    uint32_t line_count() const { return static_cast<uint32_t>(deltas_.size()); }
+
+    /// Offset of the first byte of line `line_index` (0-based).
+    uint32_t get_line_start(uint32_t line_index) const;
+
+    /// Map a byte offset to a 1-based line and column.
+    void get_line_column(uint32_t offset, uint32_t& line, uint32_t& column) const;
+
+    /// Heap bytes used by the table.
+    size_t memory_bytes() const;
+
+private:
+    struct Chunk {
+        uint32_t first_offset;
+        uint32_t first_long_delta;
+    };
+    static constexpr uint16_t kLongDelta = 0xFFFF;
+
+    std::vector<Chunk> chunks_;
+    // one entry per line; the entry of a chunk's first line is unused (0)
+    std::vector<uint16_t> deltas_;
+    std::vector<uint32_t> long_deltas_;
+
+    void append_line(uint32_t offset, uint32_t& previous);
+};
+
+} // namespace nova
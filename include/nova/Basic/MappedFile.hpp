@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace nova {
+
+/// Read-only, private memory mapping of a whole file.
+///
+/// A mapping is only established when the byte following the file contents is
+/// guaranteed to be a '\0' sentinel, i.e. when the file size is not a multiple
+/// of the page size (the kernel zero-fills the rest of the last page).
+/// Otherwise map() fails with `needs_fallback()` set so that the caller can
+/// read the file into an owned buffer instead. Binary data that is read in
+/// place, without a sentinel, is mapped with `needs_sentinel` false.
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool needs_fallback_ = false;
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Map `path`. Returns false if the file cannot be opened, or if it cannot
+    /// be mapped (with a sentinel, if `needs_sentinel`); then needs_fallback()
+    /// is true.
+    bool map(const std::string& path, bool needs_sentinel = true);
+
+    bool is_mapped() const { return data_ != nullptr; }
+    bool needs_fallback() const { return needs_fallback_; }
+    std::string_view contents() const { return std::string_view(data_, size_); }
+
+    /// Read the whole file into `out`. Returns false if it cannot be read.
+    static bool read_file(const std::string& path, std::string& out);
+
+private:
+    void unmap();
+};
+
+} // namespace nova
@@ -3,40 +3,50 @@
 
 namespace nova {
 
-/// Compact source location (32-bit encoded)
-//offset range from 0 to 1MB - 1 (20 bits)
-//0 offset and 0 file_id is reserved for invalid location
+/// File identifier handed out by SourceManager (1-based, 0 is invalid)
+using FileID = uint32_t;
+
+/// Compact source location
+//a location is an address in one global "source address space":
+//SourceManager gives every file a contiguous range [start, start + size]
+//(the extra address is the EOF position) and finds the file of a location
+//by binary search over the range starts.
+//address 0 is reserved for invalid location
 class SourceLocation {
-private:
-    //such design to save memory usage
-    //assuming max 4096 files 12 bits, and file size not exceeding 1MB 20bits
-    //this variables is [file_id|offset]
-    uint32_t raw_encoding_;
+public:
+    //32 bits cover 4 GiB of input in total, which is enough for almost every
+    //build; configure with NOVA_LARGE_SOURCE_LOCATIONS=ON for 64-bit addresses
+#if defined(NOVA_LARGE_SOURCE_LOCATIONS)
+    using RawType = uint64_t;
+#else
+    using RawType = uint32_t;
+#endif
 
-    static constexpr uint32_t OFFSET_BITS = 20;
-    static constexpr uint32_t FILE_ID_BITS = 12;
-    //20 bits for offset, 12 bits for file id
-    static constexpr uint32_t OFFSET_MASK = (1U << OFFSET_BITS) - 1;
+private:
+    RawType raw_encoding_;
 
 public:
     SourceLocation() : raw_encoding_(0) {}
 
-    static SourceLocation create(uint16_t file_id, uint32_t offset);
-
-    uint16_t get_file_id() const { return raw_encoding_ >> OFFSET_BITS; }
-    uint32_t get_offset() const { return raw_encoding_ & OFFSET_MASK; }
-    uint32_t get_raw_encoding() const { return raw_encoding_; }
+    static SourceLocation from_raw_encoding(RawType raw) {
+        SourceLocation loc;
+        loc.raw_encoding_ = raw;
+        return loc;
+    }
+    RawType get_raw_encoding() const { return raw_encoding_; }
 
     bool is_valid() const { return raw_encoding_ != 0; }
     bool is_invalid() const { return raw_encoding_ == 0; }
-    // get a new SourceLocation with the same file_id but different offset
+    // get a new SourceLocation `offset` bytes away in the same file
     //use for sourcerange begin/end location calculation
-    SourceLocation get_offset_location(int32_t offset) const;
+    SourceLocation get_offset_location(int64_t offset) const;
 
     bool operator==(SourceLocation other) const {
         return raw_encoding_ == other.raw_encoding_;
     }
     bool operator!=(SourceLocation other) const { return !(*this == other); }
+    //locations in the same file compare by offset; files compare by the
+    //order they were added to the SourceManager
     bool operator<(SourceLocation other) const {
         return raw_encoding_ < other.raw_encoding_;
     }
@@ -1,5 +1,9 @@
 #pragma once
 #include "SourceLocation.hpp"
+#include "MappedFile.hpp"
+#include "LineTable.hpp"
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -7,29 +11,95 @@
 
 namespace nova {
 
+/// Replace `removed_length` bytes at `offset` with `inserted_text`.
+struct TextEdit {
+    uint32_t offset = 0;
+    uint32_t removed_length = 0;
+    std::string_view inserted_text;
+};
+
 struct FileEntry {
     std::string filename;
-    std::string content;
-    // every line's starting offset in content
-    std::vector<uint32_t> line_offsets;
-    uint16_t file_id;
+    // non-owning view of the file bytes (owned string or mmap'ed pages)
+    // content.data()[content.size()] is always a '\0' sentinel
+    std::string_view content;
+    FileID file_id;
+    // address of offset 0; the file owns [start_loc, start_loc + content.size()]
+    SourceLocation start_loc;
+
+    FileEntry(FileID id, SourceLocation start, std::string name, std::string data);
+    FileEntry(FileID id, SourceLocation start, std::string name,
+              std::unique_ptr<MappedFile> mapped);
+
+    SourceLocation get_location(uint32_t offset) const {
+        return start_loc.get_offset_location(offset);
+    }
+
+    // content points into this entry
+    FileEntry(const FileEntry&) = delete;
+    FileEntry& operator=(const FileEntry&) = delete;
+
+    bool is_mapped() const { return mapped_ != nullptr; }
 
-    FileEntry(uint16_t id, std::string name, std::string data);
+    // line starts are only needed for diagnostics, so the table is built on
+    // first use; safe to call from several threads
+    const LineTable& get_line_table() const;
+    bool has_line_table() const { return line_table_built_.load(std::memory_order_acquire); }
 
 private:
-    void compute_line_offsets();
+    friend class SourceManager;
+
+    std::string owned_content_;
+    std::unique_ptr<MappedFile> mapped_;
+
+    mutable std::once_flag line_table_once_;
+    mutable std::atomic<bool> line_table_built_{false};
+    mutable LineTable line_table_;
 };
 // manages all source files and provides utilities to query source locations
 class SourceManager {
 private:
+    // an address range handed to a file; edited files may own more addresses
+    // than they have bytes, so they can grow in place
+    struct AddressRange {
+        SourceLocation::RawType start;
+        SourceLocation::RawType size;
+        FileID file_id;
+    };
+
     std::vector<std::unique_ptr<FileEntry>> files_;
+    // live ranges, sorted by start; an edited file that outgrows its range
+    // moves to a new one at the end and its old addresses resolve to no file
+    std::vector<AddressRange> ranges_;
+    // next free address; 0 is the invalid location
+    SourceLocation::RawType next_address_ = 1;
+    // most recent get_file_id answer; consecutive queries are usually local
+    mutable std::atomic<FileID> last_lookup_{0};
 
 public:
     SourceManager() = default;
     ~SourceManager() = default;
 
-    uint16_t add_file(std::string filename, std::string content);
-    const FileEntry* get_file(uint16_t file_id) const;
+    // returns 0 if the file does not fit in the address space (or a single
+    // file exceeds 4 GiB)
+    FileID add_file(std::string filename, std::string content);
+    // load `path` without copying: mmap when possible, otherwise read into an
+    // owned buffer. Returns 0 if the file cannot be read.
+    FileID add_file_mapped(const std::string& path);
+    const FileEntry* get_file(FileID file_id) const;
+    // apply `edit` to the text of `file_id` in place, keeping its FileID.
+    // The file keeps its addresses while it fits in them (ranges of edited
+    // files are over-allocated), so repeated edits neither copy the file nor
+    // use up the address space. Invalidates FileEntry pointers of the file.
+    // Returns false if the edit is outside the text or the address space is
+    // full.
+    bool apply_edit(FileID file_id, const TextEdit& edit);
+    size_t file_count() const { return files_.size(); }
+
+    // location <-> (file, offset)
+    SourceLocation get_location(FileID file_id, uint32_t offset) const;
+    FileID get_file_id(SourceLocation loc) const;
+    uint32_t get_file_offset(SourceLocation loc) const;
 
     char get_char(SourceLocation loc) const;
     std::string_view get_text(SourceRange range) const;
@@ -38,6 +108,11 @@ public:
     std::string_view get_filename(SourceLocation loc) const;
     std::string format_location(SourceLocation loc) const;
 
+private:
+    bool allocate_range(size_t size, FileID file_id, SourceLocation& start);
+    const FileEntry* get_file_for(SourceLocation loc) const {
+        return get_file(get_file_id(loc));
+    }
 };
 
 } // namespace nova
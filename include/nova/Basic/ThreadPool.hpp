@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nova {
+
+/// Fixed set of worker threads fed from one FIFO queue.
+///
+/// The thread calling wait() or parallel_for() also runs queued tasks, so a
+/// pool created with one thread (or with zero workers on a single-core host)
+/// still makes progress.
+class ThreadPool {
+public:
+    /// `threads` is the total parallelism including the calling thread;
+    /// 0 means std::thread::hardware_concurrency().
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Total parallelism (workers + the calling thread).
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    void submit(std::function<void()> task);
+    /// Run queued tasks on this thread until every submitted task finished.
+    /// Must not be called from inside a task.
+    void wait();
+
+    /// Call fn(i) for i in [0, count); indices are handed out dynamically so
+    /// uneven items balance across threads. Returns when all calls finished;
+    /// may be called from inside a task.
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    size_t pending_ = 0;
+    bool stopping_ = false;
+    // sleeping uses C++20 atomic wait/notify on counters that are bumped
+    // whenever work is queued or a task finishes; a sleeper reads the counter
+    // before checking its condition, so a concurrent bump wakes it
+    std::atomic<uint32_t> work_epoch_{0};
+    std::atomic<uint32_t> done_epoch_{0};
+
+    void worker_loop();
+    // pop and run one task; false if the queue was empty
+    bool run_one(std::unique_lock<std::mutex>& lock);
+    void wait_for_done(std::unique_lock<std::mutex>& lock, uint32_t epoch);
+};
+
+} // namespace nova
@@ -0,0 +1,118 @@
+#pragma once
+#include "nova/Basic/MappedFile.hpp"
+#include "nova/IR/Module.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nova {
+namespace ir {
+
+/// Binary form of a Module, for caching IR between builds and loading it
+/// without the front end.
+///
+/// The file starts with the 8-byte magic "NOVAIRMD" and five little-endian
+/// u32s: version, string count, type count, function count, and the size of
+/// the string data. Then:
+///   u32 offsets[string count + 1] into the string data, then the data;
+///     string 0 is the module name
+///   the type table: per function signature, u8 return type, varint
+///     parameter count, u8 per parameter type
+///   the function table: per function, varint name (string index), varint
+///     signature (type index), varint body size in bytes
+///   the function bodies, in function table order
+///
+/// Varints are unsigned LEB128; signed numbers are zigzag encoded first. A
+/// body is a varint block count, a varint label (string index) per block,
+/// then per block a varint instruction count and its instructions. An
+/// instruction is one byte, opcode | type << 5, followed by:
+///   ConstI64: signed varint       ConstU64: varint
+///   ConstF64: 8 bytes (IEEE 754)  ConstBool: 1 byte
+///   Add .. FDiv: 2 operands       ICmp, FCmp: u8 predicate, 2 operands
+///   Call: varint callee (function index), varint count, operands
+///   Phi: varint count, then per incoming value an operand and a block
+///   Ret: varint count (0 or 1), operands
+///   Br: block                     CondBr: operand, 2 blocks
+/// An operand is zigzag(user ID - operand ID) + 1, or 0 for a missing
+/// value; a block is its index + 1, or 0 for a missing block. Value IDs are
+/// renumbered in layout order, arguments first, so erased instructions leave
+/// no gaps.
+///
+/// A function without blocks is written as a declaration.
+constexpr uint32_t kModuleFormatVersion = 1;
+
+/// Append the binary form of `module` to `out`.
+void write_module(const Module& module, std::string& out);
+/// Write the binary form of `module` to `path`. Returns false if the file
+/// cannot be written.
+bool write_module_file(const Module& module, const std::string& path);
+
+/// Loads a module written by write_module().
+///
+/// load_file() maps the file and reads only the header and the string, type
+/// and function tables. It creates every function with its signature, so
+/// calls can refer to functions whose bodies are not loaded. A body is
+/// decoded on the first materialize() of its function; until then the
+/// function has no blocks. Functions that are never materialized cost no
+/// decoding, and their pages of the file are never touched.
+///
+/// Malformed input is rejected with an error instead of crashing. A
+/// function that fails to decode is left without blocks.
+class ModuleReader {
+private:
+    struct Body {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        bool materialized = false;
+    };
+
+    MappedFile file_;
+    // the contents when the file cannot be mapped
+    std::string buffer_;
+    std::string_view data_;
+    std::unique_ptr<Module> module_;
+    uint32_t string_count_ = 0;
+    uint64_t string_offsets_ = 0;
+    uint64_t string_data_ = 0;
+    uint64_t string_data_size_ = 0;
+    std::vector<Body> bodies_; // by function index
+    uint32_t materialized_count_ = 0;
+    std::string error_;
+
+public:
+    ModuleReader() = default;
+
+    ModuleReader(const ModuleReader&) = delete;
+    ModuleReader& operator=(const ModuleReader&) = delete;
+
+    /// Map and load `path`. Returns false with get_error() set on failure.
+    bool load_file(const std::string& path);
+    /// Load from an owned buffer instead of a file.
+    bool load_buffer(std::string contents);
+
+    /// The loaded module; null before a successful load.
+    Module* get_module() const { return module_.get(); }
+
+    bool is_materialized(const Function* func) const {
+        return bodies_[func->get_index()].materialized;
+    }
+    /// Decode the body of `func` if it is not loaded yet. Returns false with
+    /// get_error() set if the body is malformed.
+    bool materialize(Function* func);
+    /// Materialize every function; needed before writing a loaded module.
+    bool materialize_all();
+    uint32_t get_materialized_count() const { return materialized_count_; }
+
+    const std::string& get_error() const { return error_; }
+
+private:
+    bool load();
+    bool fail(std::string message);
+    std::string_view get_string(uint32_t index) const;
+    bool decode_body(Function* func, std::string_view bytes);
+};
+
+} // namespace ir
+} // namespace nova
@@ -0,0 +1,444 @@
+#pragma once
+#include "nova/Basic/Arena.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nova {
+namespace ir {
+
+class BasicBlock;
+class Function;
+class Instruction;
+class Module;
+class Value;
+
+/// Nova IR v0 value types (docs/ir-spec.md, section 2).
+enum class Type : uint8_t {
+    I64,
+    U64,
+    F64,
+    Bool,
+    Unit,
+};
+
+/// Spelling of `type` in the textual IR (e.g. "i64").
+const char* get_type_name(Type type);
+
+/// Instruction opcodes, from Instructions.def.
+enum class Opcode : uint8_t {
+#define NOVA_IR_CONST(name, spelling) name,
+#define NOVA_IR_INST(name, spelling) name,
+#define NOVA_IR_TERMINATOR(name, spelling) name,
+#include "nova/IR/Instructions.def"
+#undef NOVA_IR_TERMINATOR
+#undef NOVA_IR_INST
+#undef NOVA_IR_CONST
+    count,
+};
+
+/// Mnemonic of `opcode` (e.g. "add").
+const char* get_opcode_name(Opcode opcode);
+
+/// Predicates of ICmp (Eq through Uge) and FCmp (Oeq through Oge). Float
+/// comparisons are ordered: they are false if either operand is NaN.
+enum class CmpPredicate : uint8_t {
+    Eq,
+    Ne,
+    Slt,
+    Sle,
+    Sgt,
+    Sge,
+    Ult,
+    Ule,
+    Ugt,
+    Uge,
+    Oeq,
+    One,
+    Olt,
+    Ole,
+    Ogt,
+    Oge,
+};
+
+/// Spelling of `pred` in the textual IR (e.g. "slt").
+const char* get_predicate_name(CmpPredicate pred);
+
+/// Forward range over an intrusive singly linked chain: `T::get_next()`
+/// returns the next node or null.
+template <typename T>
+class IntrusiveRange {
+private:
+    T* first_;
+
+public:
+    class iterator {
+    private:
+        T* node_ = nullptr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T**;
+        using reference = T*;
+
+        iterator() = default;
+        explicit iterator(T* node) : node_(node) {}
+
+        T* operator*() const { return node_; }
+        iterator& operator++() {
+            node_ = node_->get_next();
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const iterator& other) const = default;
+    };
+
+    explicit IntrusiveRange(T* first) : first_(first) {}
+
+    iterator begin() const { return iterator(first_); }
+    iterator end() const { return iterator(); }
+    bool empty() const { return first_ == nullptr; }
+};
+
+/// One operand slot of an instruction.
+///
+/// Every use of a value is threaded onto that value's use list, so the users
+/// of a value are found without scanning the function. `prev_` points at the
+/// link that points at this use (the list head or the previous use's
+/// `next_`), which unlinks a use in O(1).
+class Use {
+private:
+    Value* value_ = nullptr;
+    Use* next_ = nullptr;
+    Use** prev_ = nullptr;
+    Instruction* user_;
+
+    explicit Use(Instruction* user) : user_(user) {}
+
+    friend class Instruction;
+    friend class Function;
+    friend class Value;
+
+public:
+    Use(const Use&) = delete;
+    Use& operator=(const Use&) = delete;
+
+    Value* get() const { return value_; }
+    Instruction* get_user() const { return user_; }
+    /// Next use of the same value.
+    Use* get_next() const { return next_; }
+    /// Index of this operand in its user.
+    uint32_t get_operand_no() const;
+
+    /// Point this operand at `value` (may be null), moving it between use
+    /// lists.
+    void set(Value* value);
+};
+
+/// Concrete Value classes.
+enum class ValueKind : uint8_t {
+    Argument,
+    Instruction,
+};
+
+/// Anything an operand can refer to: a function argument or the result of an
+/// instruction.
+///
+/// Values are numbered densely per function in creation order (arguments
+/// first), so passes keep per-value state in plain vectors indexed by
+/// get_id(); Function::get_value() maps an ID back. Values carry no vtable:
+/// the kind tag serves isa/cast/dyn_cast.
+class Value {
+private:
+    Use* uses_ = nullptr;
+    uint32_t id_;
+    ValueKind kind_;
+    Type type_;
+
+protected:
+    /// Spare bits for subclasses (an instruction's opcode and predicate).
+    uint16_t subclass_data_ = 0;
+
+    Value(ValueKind kind, Type type, uint32_t id) : id_(id), kind_(kind), type_(type) {}
+
+    friend class Use;
+
+public:
+    Value(const Value&) = delete;
+    Value& operator=(const Value&) = delete;
+
+    ValueKind get_kind() const { return kind_; }
+    Type get_type() const { return type_; }
+    uint32_t get_id() const { return id_; }
+
+    /// Uses of this value, most recently added first.
+    IntrusiveRange<Use> get_uses() const { return IntrusiveRange<Use>(uses_); }
+    bool has_uses() const { return uses_ != nullptr; }
+    bool has_one_use() const { return uses_ && !uses_->next_; }
+    uint32_t get_use_count() const;
+
+    /// Make every use of this value use `other` instead. The cost is one
+    /// step per use: the whole use list is spliced onto `other`'s.
+    void replace_all_uses_with(Value* other);
+};
+
+inline void Use::set(Value* value) {
+    if (value_) {
+        *prev_ = next_;
+        if (next_) {
+            next_->prev_ = prev_;
+        }
+    }
+    value_ = value;
+    if (value) {
+        next_ = value->uses_;
+        if (next_) {
+            next_->prev_ = &next_;
+        }
+        prev_ = &value->uses_;
+        value->uses_ = this;
+    }
+}
+
+/// A parameter of a function; its ID is its position.
+class Argument : public Value {
+public:
+    static constexpr ValueKind kKind = ValueKind::Argument;
+
+private:
+    Function* parent_;
+
+    Argument(Function* parent, Type type, uint32_t index)
+        : Value(kKind, type, index), parent_(parent) {}
+
+    friend class Function;
+
+public:
+    Function* get_parent() const { return parent_; }
+    uint32_t get_index() const { return get_id(); }
+
+    static bool classof(const Value* v) { return v->get_kind() == kKind; }
+};
+
+/// One IR instruction.
+///
+/// Instructions are allocated from their function's arena with their
+/// operands inline: `operand_count` Use slots trail the instruction, followed
+/// by `block_count` block pointers (the successors of a branch, or the
+/// incoming blocks of a phi, one per operand). Within a block they form an
+/// intrusive doubly linked list, so inserting and erasing are O(1).
+///
+/// Constants hold their value and calls their callee in the instruction.
+/// Terminators and calls of unit functions have type Unit.
+class Instruction : public Value {
+public:
+    static constexpr ValueKind kKind = ValueKind::Instruction;
+
+private:
+    uint32_t operand_count_;
+    uint32_t block_count_;
+    BasicBlock* parent_ = nullptr;
+    Instruction* prev_ = nullptr;
+    Instruction* next_ = nullptr;
+    union {
+        int64_t i64;
+        uint64_t u64;
+        double f64;
+        bool boolean;
+        Function* callee;
+    } payload_;
+
+    Instruction(Opcode opcode, Type type, uint32_t id, uint32_t operand_count,
+                uint32_t block_count)
+        : Value(kKind, type, id), operand_count_(operand_count), block_count_(block_count) {
+        subclass_data_ = static_cast<uint16_t>(opcode);
+        payload_.u64 = 0;
+    }
+
+    Use* op_begin() { return reinterpret_cast<Use*>(this + 1); }
+    const Use* op_begin() const { return reinterpret_cast<const Use*>(this + 1); }
+    BasicBlock** block_begin() {
+        return reinterpret_cast<BasicBlock**>(op_begin() + operand_count_);
+    }
+    BasicBlock* const* block_begin() const {
+        return reinterpret_cast<BasicBlock* const*>(op_begin() + operand_count_);
+    }
+
+    friend class BasicBlock;
+    friend class Function;
+    friend class IRBuilder;
+    friend class ModuleReader;
+
+public:
+    Opcode get_opcode() const { return static_cast<Opcode>(subclass_data_ & 0xff); }
+    bool is_constant() const { return get_opcode() <= Opcode::ConstUnit; }
+    bool is_terminator() const { return get_opcode() >= Opcode::Ret; }
+
+    BasicBlock* get_parent() const { return parent_; }
+    Function* get_function() const;
+    Instruction* get_prev() const { return prev_; }
+    Instruction* get_next() const { return next_; }
+
+    uint32_t get_operand_count() const { return operand_count_; }
+    Value* get_operand(uint32_t i) const {
+        assert(i < operand_count_ && "operand index out of range");
+        return op_begin()[i].get();
+    }
+    void set_operand(uint32_t i, Value* value) {
+        assert(i < operand_count_ && "operand index out of range");
+        op_begin()[i].set(value);
+    }
+    std::span<Use> get_operands() { return {op_begin(), operand_count_}; }
+    std::span<const Use> get_operands() const { return {op_begin(), operand_count_}; }
+
+    /// Successors of a branch, or incoming blocks of a phi.
+    std::span<BasicBlock* const> get_blocks() const { return {block_begin(), block_count_}; }
+    void set_block(uint32_t i, BasicBlock* block) {
+        assert(i < block_count_ && "block index out of range");
+        block_begin()[i] = block;
+    }
+
+    // Constants
+    int64_t get_i64() const { return payload_.i64; }
+    uint64_t get_u64() const { return payload_.u64; }
+    double get_f64() const { return payload_.f64; }
+    bool get_bool() const { return payload_.boolean; }
+
+    /// ICmp and FCmp only.
+    CmpPredicate get_predicate() const { return static_cast<CmpPredicate>(subclass_data_ >> 8); }
+    /// Call only.
+    Function* get_callee() const { return payload_.callee; }
+
+    /// Phi only: `value` flows in from `block`.
+    uint32_t get_incoming_count() const { return operand_count_; }
+    Value* get_incoming_value(uint32_t i) const { return get_operand(i); }
+    BasicBlock* get_incoming_block(uint32_t i) const { return get_blocks()[i]; }
+    void set_incoming(uint32_t i, Value* value, BasicBlock* block) {
+        set_operand(i, value);
+        set_block(i, block);
+    }
+
+    /// Clear every operand, leaving this instruction out of all use lists.
+    void drop_operands();
+    /// Unlink and drop this instruction; it must have no uses. Its memory
+    /// stays in the arena and its ID is not reused.
+    void erase_from_parent();
+
+    static bool classof(const Value* v) { return v->get_kind() == kKind; }
+};
+
+/// A labelled, straight-line run of instructions ending in a terminator.
+class BasicBlock {
+private:
+    Function* parent_;
+    std::string_view label_;
+    uint32_t index_;
+    Instruction* first_ = nullptr;
+    Instruction* last_ = nullptr;
+
+    BasicBlock(Function* parent, std::string_view label, uint32_t index)
+        : parent_(parent), label_(label), index_(index) {}
+
+    friend class Function;
+
+public:
+    BasicBlock(const BasicBlock&) = delete;
+    BasicBlock& operator=(const BasicBlock&) = delete;
+
+    Function* get_parent() const { return parent_; }
+    std::string_view get_label() const { return label_; }
+    /// Position in the function's block list.
+    uint32_t get_index() const { return index_; }
+
+    IntrusiveRange<Instruction> get_instructions() const {
+        return IntrusiveRange<Instruction>(first_);
+    }
+    Instruction* get_first() const { return first_; }
+    Instruction* get_last() const { return last_; }
+    bool empty() const { return first_ == nullptr; }
+
+    /// The last instruction, if it is a terminator.
+    Instruction* get_terminator() const {
+        return last_ && last_->is_terminator() ? last_ : nullptr;
+    }
+    std::span<BasicBlock* const> get_successors() const;
+
+    /// Link `inst` before `before`, or at the end when `before` is null.
+    void insert(Instruction* inst, Instruction* before = nullptr);
+    /// Unlink `inst` without touching its operands.
+    void remove(Instruction* inst);
+};
+
+/// A function of a module: its signature, blocks and values, and the arena
+/// they are allocated from. The first block is the entry.
+class Function {
+private:
+    Module* parent_;
+    uint32_t index_;
+    std::string name_;
+    std::vector<Type> param_types_;
+    Type return_type_;
+    Arena arena_;
+    std::vector<Argument*> args_;
+    std::vector<BasicBlock*> blocks_;
+    // indexed by value ID; erased instructions leave a null slot
+    std::vector<Value*> values_;
+
+    friend class Instruction;
+
+public:
+    /// Function number `index` of `parent`.
+    Function(Module* parent, uint32_t index, std::string name,
+             std::span<const Type> param_types, Type return_type);
+
+    Function(const Function&) = delete;
+    Function& operator=(const Function&) = delete;
+
+    Module* get_parent() const { return parent_; }
+    /// Position in the module's function list.
+    uint32_t get_index() const { return index_; }
+    std::string_view get_name() const { return name_; }
+    std::span<const Type> get_param_types() const { return param_types_; }
+    Type get_return_type() const { return return_type_; }
+
+    std::span<Argument* const> get_args() const { return args_; }
+    Argument* get_arg(uint32_t i) const { return args_[i]; }
+
+    std::span<BasicBlock* const> get_blocks() const { return blocks_; }
+    BasicBlock* get_entry_block() const { return blocks_.empty() ? nullptr : blocks_.front(); }
+    /// Append a block; `label` is copied into the arena.
+    BasicBlock* create_block(std::string_view label);
+
+    /// Drop every block and instruction; the arguments stay. The memory is
+    /// released with the function.
+    void clear_body();
+
+    /// A new, unlinked instruction with the next value ID. Its operands are
+    /// set to `operands` and its blocks are null.
+    Instruction* create_instruction(Opcode opcode, Type type, std::span<Value* const> operands,
+                                    uint32_t block_count = 0);
+
+    /// One past the highest value ID: the size of a per-value side table.
+    uint32_t get_value_count() const { return static_cast<uint32_t>(values_.size()); }
+    /// The value numbered `id`, or null if it was erased.
+    Value* get_value(uint32_t id) const { return values_[id]; }
+
+    /// Bytes of IR allocated in this function's arena.
+    size_t get_bytes_allocated() const { return arena_.bytes_allocated(); }
+
+    /// Append the textual form of this function to `out`.
+    void print(std::string& out) const;
+};
+
+} // namespace ir
+} // namespace nova
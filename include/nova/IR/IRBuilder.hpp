@@ -0,0 +1,78 @@
+#pragma once
+#include "nova/IR/IR.hpp"
+#include <cstdint>
+#include <span>
+
+namespace nova {
+namespace ir {
+
+/// Creates instructions at an insertion point: the end of a block, or just
+/// before an instruction. Operand types are checked with assertions.
+class IRBuilder {
+private:
+    BasicBlock* block_ = nullptr;
+    Instruction* before_ = nullptr;
+
+public:
+    IRBuilder() = default;
+    explicit IRBuilder(BasicBlock* block) : block_(block) {}
+
+    /// Insert at the end of `block`.
+    void set_insert_point(BasicBlock* block) {
+        block_ = block;
+        before_ = nullptr;
+    }
+    /// Insert before `before`, in its block.
+    void set_insert_point(Instruction* before) {
+        block_ = before->get_parent();
+        before_ = before;
+    }
+    BasicBlock* get_insert_block() const { return block_; }
+
+    Instruction* create_const_i64(int64_t value);
+    Instruction* create_const_u64(uint64_t value);
+    Instruction* create_const_f64(double value);
+    Instruction* create_const_bool(bool value);
+    Instruction* create_const_unit();
+
+    /// Add through FDiv; both operands have the result type.
+    Instruction* create_binary(Opcode opcode, Value* lhs, Value* rhs);
+    Instruction* create_add(Value* lhs, Value* rhs) { return create_binary(Opcode::Add, lhs, rhs); }
+    Instruction* create_sub(Value* lhs, Value* rhs) { return create_binary(Opcode::Sub, lhs, rhs); }
+    Instruction* create_mul(Value* lhs, Value* rhs) { return create_binary(Opcode::Mul, lhs, rhs); }
+    Instruction* create_fadd(Value* lhs, Value* rhs) {
+        return create_binary(Opcode::FAdd, lhs, rhs);
+    }
+    Instruction* create_fsub(Value* lhs, Value* rhs) {
+        return create_binary(Opcode::FSub, lhs, rhs);
+    }
+    Instruction* create_fmul(Value* lhs, Value* rhs) {
+        return create_binary(Opcode::FMul, lhs, rhs);
+    }
+    Instruction* create_fdiv(Value* lhs, Value* rhs) {
+        return create_binary(Opcode::FDiv, lhs, rhs);
+    }
+
+    Instruction* create_icmp(CmpPredicate pred, Value* lhs, Value* rhs);
+    Instruction* create_fcmp(CmpPredicate pred, Value* lhs, Value* rhs);
+
+    Instruction* create_call(Function* callee, std::span<Value* const> args);
+
+    /// A phi with `incoming_count` empty slots, filled with set_incoming()
+    /// once the values of back edges exist.
+    Instruction* create_phi(Type type, uint32_t incoming_count);
+
+    /// `value` is null for a unit return.
+    Instruction* create_ret(Value* value = nullptr);
+    Instruction* create_br(BasicBlock* dest);
+    Instruction* create_cond_br(Value* cond, BasicBlock* then_block, BasicBlock* else_block);
+    Instruction* create_unreachable();
+
+private:
+    Instruction* insert(Opcode opcode, Type type, std::span<Value* const> operands,
+                        uint32_t block_count = 0);
+    Instruction* create_cmp(Opcode opcode, CmpPredicate pred, Value* lhs, Value* rhs);
+};
+
+} // namespace ir
+} // namespace nova
@@ -0,0 +1,41 @@
+#pragma once
+#include "nova/IR/IR.hpp"
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace nova {
+namespace ir {
+
+/// A Nova IR module: a set of functions with distinct names, kept in creation
+/// order. Each function owns the arena its blocks and instructions live in.
+class Module {
+private:
+    std::string name_;
+    std::vector<std::unique_ptr<Function>> functions_;
+    // keys view the functions' own names
+    std::unordered_map<std::string_view, Function*> by_name_;
+
+public:
+    explicit Module(std::string name) : name_(std::move(name)) {}
+
+    Module(const Module&) = delete;
+    Module& operator=(const Module&) = delete;
+
+    std::string_view get_name() const { return name_; }
+
+    /// A new function without blocks, or null if `name` is taken.
+    Function* create_function(std::string name, std::span<const Type> param_types,
+                              Type return_type);
+    Function* get_function(std::string_view name) const;
+    const std::vector<std::unique_ptr<Function>>& get_functions() const { return functions_; }
+
+    /// The textual form of every function, in creation order.
+    std::string print() const;
+};
+
+} // namespace ir
+} // namespace nova
@@ -0,0 +1,40 @@
+#pragma once
+#include "TokenBuffer.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Basic/SourceManager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace nova {
+
+/// Apply `edit` to `text`; the edit must lie inside the text.
+std::string apply_text_edit(std::string_view text, const TextEdit& edit);
+
+struct RelexStats {
+    // tokens copied unchanged from before the edit
+    size_t reused_prefix = 0;
+    // tokens produced by the lexer
+    size_t relexed = 0;
+    // tokens copied (with shifted offsets) after resynchronizing
+    size_t reused_suffix = 0;
+};
+
+/// Tokens for `file_id`, whose text is the text `old_tokens` were lexed from
+/// with `edit` applied, re-lexing only the damaged region. Editors apply the
+/// edit with SourceManager::apply_edit and pass the same FileID; a new file
+/// holding the edited text works too.
+///
+/// Lexing restarts at a token that starts comfortably before the edit (so
+/// lookahead of earlier tokens never reached the edit). It stops as soon as
+/// a new token past the edit starts where an old token started, shifted by
+/// the edit, with the same kind and flags: from there on the text and the
+/// lexer state are identical, so the remaining old tokens are reused. Edits
+/// that open a block comment or string literal simply keep lexing until the
+/// comment or literal closes and the streams line up again (or until eof).
+TokenBuffer relex_after_edit(const TokenBuffer& old_tokens, const SourceManager& sm,
+                             IdentifierTable& ids, FileID file_id, const TextEdit& edit,
+                             RelexStats* stats = nullptr);
+
+} // namespace nova
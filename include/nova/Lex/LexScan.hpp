@@ -0,0 +1,37 @@
+#pragma once
+#include "nova/Basic/CPUFeatures.hpp"
+
+namespace nova {
+
+/// Character-run scanning kernels used by the Lexer.
+///
+/// Every kernel starts at `cur`, never reads at or beyond `end`, and returns a
+/// pointer to the first byte that does not belong to the run (or `end`).
+/// One table exists per SIMDLevel; the vector variants classify 16 (SSE2) or
+/// 32 (AVX2) bytes per step and finish the tail with the scalar loop.
+struct LexScanKernels {
+    /// Skip ' ', '\t', '\n', '\r'. Sets `saw_newline` if the run contains '\n'
+    /// (it is never cleared, so callers can accumulate across calls).
+    const char* (*scan_whitespace)(const char* cur, const char* end, bool& saw_newline);
+
+    /// Skip [A-Za-z0-9_].
+    const char* (*scan_identifier)(const char* cur, const char* end);
+
+    /// Skip [0-9].
+    const char* (*scan_digits)(const char* cur, const char* end);
+
+    /// Find the next `quote` or '\\' inside a string/char literal body.
+    const char* (*scan_string_body)(const char* cur, const char* end, char quote);
+
+    SIMDLevel level;
+};
+
+/// Kernel table for a specific level (clamped to what the host supports).
+const LexScanKernels& get_lex_scan_kernels(SIMDLevel level);
+
+/// Kernel table for the currently active level (see set_active_simd_level).
+inline const LexScanKernels& get_lex_scan_kernels() {
+    return get_lex_scan_kernels(get_active_simd_level());
+}
+
+} // namespace nova
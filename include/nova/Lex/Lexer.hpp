@@ -1,5 +1,6 @@
 #pragma once
 #include "Token.hpp"
+#include "LexScan.hpp"
 #include "nova/Basic/SourceManager.hpp"
 #include "nova/Basic/IdentifierTable.hpp"
 
@@ -10,11 +11,16 @@ private:
     const SourceManager& source_manager_;
     IdentifierTable& identifier_table_;
 
-    uint16_t file_id_;
+    FileID file_id_;
+    // location of offset 0 in this file
+    SourceLocation file_start_;
     const char* buffer_start_;
     const char* buffer_ptr_;
     const char* buffer_end_;
 
+    // run-scanning kernels selected at construction (scalar/SSE2/AVX2)
+    const LexScanKernels* scan_;
+
     //at the start of a new line means previous char is '\n' 
     //use such flag to set Token::at_start_of_line flag
     bool at_start_of_line_;
@@ -24,7 +30,11 @@ private:
     bool seen_space_;
 
 public:
-    Lexer(const SourceManager& sm, IdentifierTable& id_table, uint16_t file_id);
+    Lexer(const SourceManager& sm, IdentifierTable& id_table, FileID file_id);
+    // start lexing at `offset`, which must be the start of a token (or of
+    // whitespace before one); used to re-lex single tokens and edited ranges.
+    // The first token's at_start_of_line flag is only set when offset is 0
+    Lexer(const SourceManager& sm, IdentifierTable& id_table, FileID file_id, uint32_t offset);
 
     void lex(Token& result);
 
@@ -0,0 +1,131 @@
+#pragma once
+#include "Token.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Basic/SourceManager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nova {
+
+class TokenBuffer;
+
+/// Lightweight view of one token in a TokenBuffer; mirrors the Token API.
+class TokenRef {
+private:
+    const TokenBuffer* buffer_;
+    uint32_t index_;
+
+public:
+    TokenRef(const TokenBuffer* buffer, uint32_t index) : buffer_(buffer), index_(index) {}
+
+    uint32_t get_index() const { return index_; }
+
+    TokenKind get_kind() const;
+    SourceLocation get_location() const;
+    uint32_t get_length() const;
+    SourceRange get_source_range() const {
+        return SourceRange(get_location(), get_location().get_offset_location(get_length()));
+    }
+    IdentifierInfo* get_identifier_info() const;
+    bool at_start_of_line() const;
+    bool has_leading_space() const;
+
+    bool is(TokenKind k) const { return get_kind() == k; }
+    bool is_not(TokenKind k) const { return get_kind() != k; }
+    template <typename... Ts>
+    bool is_one_of(TokenKind k1, Ts... ks) const {
+        const TokenKind kind = get_kind();
+        return kind == k1 || ((kind == ks) || ...);
+    }
+    bool is_literal() const {
+        return is_one_of(TokenKind::numeric_constant, TokenKind::string_literal,
+                         TokenKind::char_constant, TokenKind::floating_constant);
+    }
+
+    /// Materialize a full Token.
+    Token to_token() const;
+};
+
+/// Tokens of one file in structure-of-arrays form.
+///
+/// Each token costs 10 bytes: a 1-byte kind, 1 byte of flags, a 4-byte file
+/// offset and a 4-byte identifier id (see IdentifierTable::get_identifier).
+/// Lengths are not stored: keywords and punctuation have a fixed spelling,
+/// identifiers know their length, and literals are re-lexed on demand.
+/// The kind array is contiguous, so scans for a kind (find_kind) go through
+/// memchr.
+class TokenBuffer {
+public:
+    static constexpr uint32_t kNoIdentifier = UINT32_MAX;
+
+private:
+    const SourceManager* source_manager_ = nullptr;
+    IdentifierTable* identifier_table_ = nullptr;
+    FileID file_id_ = 0;
+    SourceLocation file_start_;
+
+    std::vector<uint8_t> kinds_;
+    std::vector<uint8_t> flags_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> identifiers_;
+
+    enum : uint8_t { kAtStartOfLine = 1, kHasLeadingSpace = 2 };
+
+public:
+    TokenBuffer() = default;
+    TokenBuffer(const SourceManager& sm, IdentifierTable& ids, FileID file_id);
+
+    FileID get_file_id() const { return file_id_; }
+    const SourceManager* get_source_manager() const { return source_manager_; }
+    IdentifierTable* get_identifier_table() const { return identifier_table_; }
+
+    size_t size() const { return kinds_.size(); }
+    bool empty() const { return kinds_.empty(); }
+
+    void reserve(size_t count);
+    void shrink_to_fit();
+    void clear();
+    /// Append a token lexed from this buffer's file.
+    void push_back(const Token& tok);
+    /// Append tokens [begin, end) of `other`, shifting their offsets by
+    /// `offset_delta` (both buffers must share the IdentifierTable).
+    void append(const TokenBuffer& other, size_t begin, size_t end, int64_t offset_delta);
+
+    TokenKind get_kind(size_t index) const { return static_cast<TokenKind>(kinds_[index]); }
+    uint32_t get_offset(size_t index) const { return offsets_[index]; }
+    SourceLocation get_location(size_t index) const {
+        return file_start_.get_offset_location(offsets_[index]);
+    }
+    uint32_t get_length(size_t index) const;
+    IdentifierInfo* get_identifier_info(size_t index) const {
+        return identifiers_[index] == kNoIdentifier
+                   ? nullptr
+                   : identifier_table_->get_identifier(identifiers_[index]);
+    }
+    bool at_start_of_line(size_t index) const { return flags_[index] & kAtStartOfLine; }
+    bool has_leading_space(size_t index) const { return flags_[index] & kHasLeadingSpace; }
+
+    TokenRef operator[](size_t index) const { return TokenRef(this, static_cast<uint32_t>(index)); }
+
+    /// Index of the first token of `kind` at or after `from`, or size().
+    size_t find_kind(TokenKind kind, size_t from) const;
+    /// Index of the first token starting at or after `offset`, or size().
+    size_t find_offset(uint32_t offset) const;
+
+    const uint8_t* kind_data() const { return kinds_.data(); }
+
+    /// Heap bytes held by the arrays.
+    size_t memory_bytes() const;
+};
+
+inline TokenKind TokenRef::get_kind() const { return buffer_->get_kind(index_); }
+inline SourceLocation TokenRef::get_location() const { return buffer_->get_location(index_); }
+inline uint32_t TokenRef::get_length() const { return buffer_->get_length(index_); }
+inline IdentifierInfo* TokenRef::get_identifier_info() const {
+    return buffer_->get_identifier_info(index_);
+}
+inline bool TokenRef::at_start_of_line() const { return buffer_->at_start_of_line(index_); }
+inline bool TokenRef::has_leading_space() const { return buffer_->has_leading_space(index_); }
+
+} // namespace nova
@@ -1,4 +1,5 @@
 #pragma once
+#include <string_view>
 
 namespace nova {
 
@@ -20,5 +21,19 @@ enum class TokenKind {
 const char* get_token_name(TokenKind kind);
 //this is punctuation of the token
 const char* get_punctuation_spelling(TokenKind kind);
+//length of a keyword or punctuation token, 0 for tokens without a fixed spelling
+unsigned get_fixed_token_length(TokenKind kind);
+
+/// Classify an identifier spelling as a keyword without a hash lookup.
+/// Returns TokenKind::identifier for non-keywords.
+//the body is a switch on length then first character, generated by
+//scripts/keyword_gen.py from the NOVA_KEYWORD/NOVA_TYPE_KEYWORD entries
+constexpr TokenKind get_keyword_kind(std::string_view text) {
+    if (text.empty()) {
+        return TokenKind::identifier;
+    }
+#include "nova/Lex/Keywords.inc"
+    return TokenKind::identifier;
+}
 
 } // namespace nova
@@ -0,0 +1,66 @@
+#pragma once
+#include "Token.hpp"
+#include "TokenBuffer.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Basic/SourceManager.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace nova {
+
+/// All tokens of one file, lexed up front into a TokenBuffer.
+///
+/// The last token is always eof, and get() clamps to it, so a parser can
+/// look ahead by index without bounds checks.
+class TokenStream {
+private:
+    TokenBuffer tokens_;
+
+public:
+    TokenStream() = default;
+
+    static TokenStream lex(const SourceManager& sm, IdentifierTable& ids, FileID file_id);
+
+    FileID get_file_id() const { return tokens_.get_file_id(); }
+    bool empty() const { return tokens_.empty(); }
+    /// Token count including the trailing eof.
+    size_t size() const { return tokens_.size(); }
+
+    TokenRef get(size_t index) const {
+        return tokens_[index < tokens_.size() ? index : tokens_.size() - 1];
+    }
+    TokenRef operator[](size_t index) const { return tokens_[index]; }
+
+    const TokenBuffer& get_buffer() const { return tokens_; }
+};
+
+/// TokenStreams for every file registered in a SourceManager.
+///
+/// lex_all() lexes the files that are not cached yet, one file per task on a
+/// ThreadPool. Files run in parallel only if the IdentifierTable is
+/// concurrent; otherwise they are lexed on the calling thread. Files must not
+/// be added to the SourceManager while lex_all() runs.
+class TokenStreamCache {
+private:
+    const SourceManager& source_manager_;
+    IdentifierTable& identifier_table_;
+    // indexed by FileID - 1
+    std::vector<TokenStream> streams_;
+
+public:
+    TokenStreamCache(const SourceManager& sm, IdentifierTable& ids)
+        : source_manager_(sm), identifier_table_(ids) {}
+
+    void lex_all(ThreadPool& pool);
+
+    /// nullptr if the file was not lexed yet.
+    const TokenStream* get(FileID file_id) const;
+
+    /// Tokens across all cached files.
+    size_t token_count() const;
+    /// Heap bytes held by the cached token buffers.
+    size_t memory_bytes() const;
+};
+
+} // namespace nova
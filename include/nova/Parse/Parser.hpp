@@ -1,4 +1,162 @@
-#pragma once 
+#pragma once
+#include "nova/AST/ASTContext.hpp"
+#include "nova/AST/Decl.hpp"
+#include "nova/AST/Expr.hpp"
+#include "nova/AST/Stmt.hpp"
+#include "nova/Basic/DiagnosticEngine.hpp"
+#include "nova/Lex/TokenStream.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
 namespace nova {
-    
-}
\ No newline at end of file
+
+class ThreadPool;
+
+/// Binding power of a binary operator (docs/language-spec.md §4); higher
+/// binds tighter. Unary operators and calls bind tighter than all of these.
+enum class BinaryPrecedence : uint8_t {
+    None,
+    Assignment,     // =       right
+    LogicalOr,      // ||      left
+    LogicalAnd,     // &&      left
+    Equality,       // == !=   left
+    Relational,     // < <= > >=
+    Additive,       // + -
+    Multiplicative, // * / %
+};
+
+/// Precedence of `kind` used as a binary operator, or None.
+BinaryPrecedence get_binary_precedence(TokenKind kind);
+
+/// Parser for Nova Core over a pre-lexed TokenStream.
+///
+/// The cursor is an index into the stream: peek(n) is an array read at any
+/// distance, and a saved index (get_position/set_position) rewinds the
+/// parser without re-lexing anything. Expressions are parsed by precedence
+/// climbing over get_binary_precedence(). Nodes go into the ASTContext;
+/// errors are reported to the DiagnosticEngine and the parser resynchronizes
+/// at the next ';', '}' or item keyword, so one pass reports every error.
+///
+/// With set_skip_function_bodies(true), parse_module() only parses item
+/// signatures: a function body is skipped by brace matching over the token
+/// kinds and its '{' index recorded in the FuncDecl. Skipped bodies are
+/// parsed later, one at a time (parse_function_body) or all at once on a
+/// ThreadPool (parse_function_bodies).
+class Parser {
+private:
+    const TokenStream& tokens_;
+    const TokenBuffer& buffer_;
+    ast::ASTContext& context_;
+    DiagnosticEngine& diags_;
+    // file text, for literal spellings
+    std::string_view source_;
+
+    size_t index_ = 0;
+    uint32_t error_count_ = 0;
+    bool skip_function_bodies_ = false;
+
+    // children of the nodes under construction; a node collects its children
+    // above the current size and truncates back, so nested lists share one
+    // allocation
+    std::vector<ast::Stmt*> stmt_stack_;
+    std::vector<ast::Expr*> expr_stack_;
+
+public:
+    Parser(const TokenStream& tokens, ast::ASTContext& context, DiagnosticEngine& diags);
+
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+
+    /// Parse the whole file as a module named `name` (may be null).
+    ast::ModuleDecl* parse_module(IdentifierInfo* name);
+    /// Parse one item (`func` or `use`); null on error.
+    ast::Decl* parse_item();
+    /// Parse one expression; null on error.
+    ast::Expr* parse_expression();
+    /// Parse one statement of a block; null on error.
+    ast::Stmt* parse_statement();
+    /// Parse a type; null on error.
+    const ast::Type* parse_type();
+
+    /// Skip function bodies in parse_func_decl (see above). A body whose
+    /// braces do not balance is parsed normally so its errors are reported.
+    void set_skip_function_bodies(bool skip) { skip_function_bodies_ = skip; }
+    /// Parse the skipped body of `func` and attach it; returns the body. A
+    /// body with errors is still attached, with the statements that failed to
+    /// parse dropped. The position is preserved.
+    ast::BlockExpr* parse_function_body(ast::FuncDecl* func);
+    /// Parse every skipped body in `funcs` on `pool`. Contiguous chunks of
+    /// `funcs` are parsed into shards of the ASTContext, which are adopted in
+    /// order afterwards. Diagnostics are reported from several threads; use
+    /// a deferred DiagnosticEngine to get them in a deterministic order.
+    void parse_function_bodies(std::span<ast::FuncDecl* const> funcs, ThreadPool& pool);
+
+    /// Index of the next token. Restoring a saved position backtracks.
+    size_t get_position() const { return index_; }
+    void set_position(size_t index) { index_ = index; }
+    bool at_end() const { return peek().is(TokenKind::eof); }
+
+    /// Errors reported by this parser.
+    uint32_t get_error_count() const { return error_count_; }
+
+private:
+    // Token access. The stream ends with eof and get() clamps to it, so any
+    // lookahead distance is valid.
+    TokenRef peek(size_t n = 0) const { return tokens_.get(index_ + n); }
+    TokenKind peek_kind(size_t n = 0) const { return peek(n).get_kind(); }
+    SourceLocation current_location() const { return peek().get_location(); }
+    SourceLocation consume() {
+        const SourceLocation loc = current_location();
+        if (!at_end()) {
+            ++index_;
+        }
+        return loc;
+    }
+    bool try_consume(TokenKind kind) {
+        if (peek_kind() != kind) {
+            return false;
+        }
+        ++index_;
+        return true;
+    }
+    /// Consume `kind` or report it as expected.
+    bool expect(TokenKind kind);
+    std::string_view get_spelling(const TokenRef& tok) const;
+
+    // Items
+    ast::FuncDecl* parse_func_decl();
+    ast::UseDecl* parse_use_decl();
+    ast::ParamDecl* parse_param_decl();
+
+    // Statements
+    ast::BlockExpr* parse_block();
+    ast::DeclStmt* parse_let_stmt();
+    ast::ReturnStmt* parse_return_stmt();
+    ast::WhileStmt* parse_while_stmt();
+
+    // Expressions
+    ast::Expr* parse_assignment();
+    ast::Expr* parse_binary(BinaryPrecedence min_precedence);
+    ast::Expr* parse_unary();
+    ast::Expr* parse_postfix(ast::Expr* base);
+    ast::Expr* parse_primary();
+    ast::Expr* parse_if_expr();
+    ast::Expr* parse_literal();
+
+    // Error handling
+    DiagnosticBuilder report(DiagnosticID id, SourceLocation loc);
+    void report_expected(TokenKind kind);
+    /// Skip past the next ';' at this nesting level, or up to (not past) the
+    /// '}' closing the current block.
+    void skip_to_statement_end();
+    /// Skip to the next `func` or `use` at brace depth 0.
+    void skip_to_next_item();
+    /// Index of the '}' matching the '{' at `open`, or the token count if
+    /// the file ends first.
+    size_t find_matching_brace(size_t open) const;
+};
+
+} // namespace nova
@@ -1,12 +1,67 @@
 #pragma once
 
-// TODO: Implement scope management
+#include "Symbol.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include <cstdint>
+#include <vector>
 
 namespace nova {
 namespace sema {
 
-class Symbol;
-class Scope;
+/// Every binding visible in a function body, as one flat table.
+///
+/// Instead of a chain of per-scope maps, the stack keeps the innermost
+/// binding of each identifier in a slot indexed by IdentifierInfo::id, and
+/// each Symbol links to the binding it shadows. Lookup is one load; entering
+/// a scope records the length of an undo log, and leaving it restores the
+/// shadowed bindings of the symbols declared since, newest first.
+///
+/// The slots live here rather than in IdentifierInfo because the infos are
+/// shared by every thread that checks a body; each checking thread owns its
+/// ScopeStack. The table grows to the largest id bound and is reused across
+/// functions: it is all null again once every scope has been popped.
+class ScopeStack {
+private:
+    // innermost binding per IdentifierInfo::id
+    std::vector<Symbol*> bindings_;
+    // symbols in declaration order; a scope owns those above its mark
+    std::vector<Symbol*> undo_log_;
+    std::vector<uint32_t> scope_marks_;
+
+public:
+    ScopeStack() = default;
+
+    ScopeStack(const ScopeStack&) = delete;
+    ScopeStack& operator=(const ScopeStack&) = delete;
+
+    void push_scope() { scope_marks_.push_back(static_cast<uint32_t>(undo_log_.size())); }
+    /// Leave the innermost scope, unbinding everything it declared.
+    void pop_scope();
+    /// Number of open scopes.
+    uint32_t get_depth() const { return static_cast<uint32_t>(scope_marks_.size()); }
+
+    /// Innermost visible symbol named `name`, or null.
+    Symbol* lookup(const IdentifierInfo* name) const {
+        return name->id < bindings_.size() ? bindings_[name->id] : nullptr;
+    }
+    /// Declare `symbol` in the innermost scope. If that scope already
+    /// declares its name, nothing is added and the existing symbol is
+    /// returned; otherwise null.
+    Symbol* insert(Symbol* symbol);
+};
+
+/// RAII lexical scope on a ScopeStack: the parameter list or a block.
+class Scope {
+private:
+    ScopeStack& stack_;
+
+public:
+    explicit Scope(ScopeStack& stack) : stack_(stack) { stack_.push_scope(); }
+    ~Scope() { stack_.pop_scope(); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
 
 } // namespace sema
 } // namespace nova
@@ -1,10 +1,12 @@
 #pragma once
 
-// TODO: Implement symbol table
-
 #include "nova/Basic/SourceLocation.hpp"
+#include <cstdint>
 
 namespace nova {
+
+struct IdentifierInfo;
+
 namespace ast {
 class Decl;
 class Type;
@@ -12,11 +14,54 @@ class Type;
 
 namespace sema {
 
-class Symbol;
-class VarSymbol;
-class FuncSymbol;
+// Nova Core only binds values; these are extensions.
 class TypeSymbol;
 class TraitSymbol;
 
+/// A name bound in a Scope: a local variable, a parameter or a function.
+/// Symbols are created by the TypeChecker in an arena and never destroyed.
+class Symbol {
+public:
+    enum class Kind : uint8_t { Var, Param, Func };
+
+private:
+    Kind kind_;
+    bool mutable_;
+    // set by ScopeStack::insert: the depth of the declaring scope and the
+    // binding of the same name this one hides
+    uint32_t scope_depth_ = 0;
+    IdentifierInfo* name_;
+    ast::Decl* decl_;
+    const ast::Type* type_;
+    Symbol* shadowed_ = nullptr;
+
+    void bind(Symbol* shadowed, uint32_t scope_depth) {
+        shadowed_ = shadowed;
+        scope_depth_ = scope_depth;
+    }
+
+    friend class ScopeStack;
+
+public:
+    Symbol(Kind kind, IdentifierInfo* name, ast::Decl* decl, const ast::Type* type,
+           bool is_mutable = false)
+        : kind_(kind), mutable_(is_mutable), name_(name), decl_(decl), type_(type) {}
+
+    Kind get_kind() const { return kind_; }
+    bool is_mutable() const { return mutable_; }
+    IdentifierInfo* get_name() const { return name_; }
+    /// VarDecl, ParamDecl or FuncDecl that introduced the name.
+    ast::Decl* get_decl() const { return decl_; }
+    /// Type of the binding; a FunctionType for functions. Null if the
+    /// declaration had a type error.
+    const ast::Type* get_type() const { return type_; }
+
+    /// Binding of the same name in an enclosing scope that this one hides
+    /// while its scope is open, or null.
+    Symbol* get_shadowed() const { return shadowed_; }
+    /// Number of scopes open when this symbol was declared (0 for functions).
+    uint32_t get_scope_depth() const { return scope_depth_; }
+};
+
 } // namespace sema
 } // namespace nova
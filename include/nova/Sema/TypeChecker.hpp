@@ -1,21 +1,88 @@
 #pragma once
 
-// TODO: Implement type checking
+#include "Symbol.hpp"
+#include "nova/AST/ASTContext.hpp"
+#include "nova/AST/Decl.hpp"
+#include "nova/Basic/Arena.hpp"
+#include "nova/Basic/DiagnosticEngine.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include <cstdint>
+#include <vector>
 
 namespace nova {
+
+class ThreadPool;
+
 namespace ast {
 class Expr;
 class Stmt;
-class Decl;
-class Type;
 }
 
-class DiagnosticEngine;
-
 namespace sema {
 
-class Scope;
-class TypeChecker;
+/// Type checker for Nova Core (docs/language-spec.md §5-6).
+///
+/// Checking runs in two phases. collect_signatures() declares every
+/// function of the module and builds its FunctionType; after that the
+/// function table is read-only. check_function() then resolves names and
+/// assigns a type to every expression of one body, using a ScopeStack and
+/// symbols local to the call, so bodies may be checked on several threads
+/// at once. check_module() does both phases, optionally checking bodies on
+/// a ThreadPool.
+///
+/// Errors are reported to the DiagnosticEngine; an expression with an error
+/// gets no type and does not cause further errors in its parents. When
+/// bodies are checked in parallel, use a deferred DiagnosticEngine so the
+/// output is the same as for a serial run.
+class TypeChecker {
+private:
+    ast::ASTContext& context_;
+    DiagnosticEngine& diags_;
+
+    // module-level functions by IdentifierInfo::id, filled by
+    // collect_signatures(); local bindings live in each body's ScopeStack
+    Arena symbol_arena_;
+    std::vector<Symbol*> functions_;
+    uint32_t error_count_ = 0;
+
+    // types the bodies use, interned up front so checking takes no locks
+    const ast::Type* unit_type_;
+    const ast::Type* str_ref_type_;
+
+public:
+    TypeChecker(ast::ASTContext& context, DiagnosticEngine& diags);
+
+    TypeChecker(const TypeChecker&) = delete;
+    TypeChecker& operator=(const TypeChecker&) = delete;
+
+    /// Check `module` on the calling thread.
+    void check_module(ast::ModuleDecl* module);
+    /// Check `module`, with the function bodies checked on `pool`. The
+    /// per-function results are merged in source order.
+    void check_module(ast::ModuleDecl* module, ThreadPool& pool);
+
+    /// Declare the functions of `module`, reporting redefinitions and unknown
+    /// types in their signatures.
+    void collect_signatures(ast::ModuleDecl* module);
+    /// Check the body of `func` and return the number of errors reported. May
+    /// run concurrently with other check_function() calls. Functions without
+    /// a body (parse errors or skipped bodies) are not checked.
+    uint32_t check_function(ast::FuncDecl* func) const;
+
+    /// Function named `name` declared in the module, or null.
+    Symbol* lookup_function(const IdentifierInfo* name) const {
+        return name->id < functions_.size() ? functions_[name->id] : nullptr;
+    }
+
+    /// Errors reported by collect_signatures() and the check_module() calls.
+    uint32_t get_error_count() const { return error_count_; }
+
+    ast::ASTContext& get_context() const { return context_; }
+    DiagnosticEngine& get_diagnostics() const { return diags_; }
+    const ast::Type* get_unit_type() const { return unit_type_; }
+    /// Type of a string literal.
+    const ast::Type* get_str_ref_type() const { return str_ref_type_; }
+};
 
 } // namespace sema
 } // namespace nova
@@ -1,4 +1,279 @@
-// TODO: Implement AST
+#include "nova/AST/ASTContext.hpp"
+#include <algorithm>
+#include <cassert>
+
 namespace nova {
-    // Placeholder
+namespace ast {
+namespace {
+
+static constexpr const char* kNodeKindNames[] = {
+#define NOVA_DECL(name, snake_name) #name,
+#define NOVA_STMT(name, snake_name) #name,
+#define NOVA_EXPR(name, snake_name) #name,
+#include "nova/AST/ASTNodes.def"
+#undef NOVA_EXPR
+#undef NOVA_STMT
+#undef NOVA_DECL
+};
+
+static_assert(sizeof(kNodeKindNames) / sizeof(kNodeKindNames[0]) ==
+                  static_cast<size_t>(ASTNodeKind::count),
+              "node kind table size must match ASTNodeKind::count");
+
+constexpr size_t kInitialTypeSlots = 256;
+
+static_assert(sizeof(TupleType) % alignof(const Type*) == 0 &&
+                  sizeof(FunctionType) % alignof(const Type*) == 0,
+              "trailing type lists must be aligned directly after the node");
+
+uint64_t mix_type_key(uint64_t h, uint64_t value) {
+    h ^= value + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h *= 0xbf58476d1ce4e5b9ull;
+    return h ^ (h >> 32);
 }
+
+uint64_t mix_type_key(uint64_t h, const void* pointer) {
+    return mix_type_key(h, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)));
+}
+
+uint64_t seed_type_key(TypeKind kind) {
+    return mix_type_key(0, static_cast<uint64_t>(kind));
+}
+
+uint64_t hash_type_list(uint64_t h, std::span<const Type* const> types) {
+    h = mix_type_key(h, static_cast<uint64_t>(types.size()));
+    for (const Type* type : types) {
+        h = mix_type_key(h, type);
+    }
+    return h;
+}
+
+bool equal_type_lists(std::span<const Type* const> a, std::span<const Type* const> b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+} // namespace
+
+const char* get_ast_node_kind_name(ASTNodeKind kind) {
+    const auto index = static_cast<size_t>(kind);
+    if (index >= static_cast<size_t>(ASTNodeKind::count)) {
+        return "<unknown node>";
+    }
+    return kNodeKindNames[index];
+}
+
+ASTContext::ASTContext() : type_slots_(kInitialTypeSlots, TypeSlot{nullptr, 0}) {
+    // builtins and the string types are singletons; they never enter the
+    // uniquing table
+    for (unsigned i = 0; i < BuiltinType::kKindCount; ++i) {
+        builtin_types_[i] = create_type<BuiltinType>(0, static_cast<BuiltinType::Kind>(i));
+    }
+    str_type_ = create_type<StrType>(0);
+    string_type_ = create_type<StringType>(0);
+}
+
+ASTContext::ASTContext(ASTContext* parent)
+    : type_root_(parent->type_root_), builtin_types_(parent->builtin_types_),
+      str_type_(parent->str_type_), string_type_(parent->string_type_) {}
+
+void ASTContext::adopt(ASTContext& shard) {
+    assert(shard.type_root_ == type_root_ && "adopting a context with other types");
+    arena_.adopt(std::move(shard.arena_));
+    for (size_t i = 0; i < node_stats_.size(); ++i) {
+        node_stats_[i].count += shard.node_stats_[i].count;
+        node_stats_[i].bytes += shard.node_stats_[i].bytes;
+        shard.node_stats_[i] = NodeStats{};
+    }
+    array_bytes_ += std::exchange(shard.array_bytes_, 0);
+    string_bytes_ += std::exchange(shard.string_bytes_, 0);
+}
+
+template <typename T, typename Match, typename Make>
+const T* ASTContext::intern_type(uint64_t hash, Match match, Make make) {
+    ASTContext& root = *type_root_;
+    std::lock_guard<std::mutex> guard(root.type_mutex_);
+    const size_t mask = root.type_slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        TypeSlot& slot = root.type_slots_[i];
+        if (!slot.type) {
+            const T* type = make();
+            slot = TypeSlot{type, hash};
+            // keep the load factor at or below 3/4
+            if (++root.type_count_ * 4 > root.type_slots_.size() * 3) {
+                root.grow_type_table();
+            }
+            return type;
+        }
+        if (slot.hash == hash && T::classof(slot.type) &&
+            match(static_cast<const T*>(slot.type))) {
+            return static_cast<const T*>(slot.type);
+        }
+    }
+}
+
+void ASTContext::grow_type_table() {
+    std::vector<TypeSlot> old(type_slots_.size() * 2, TypeSlot{nullptr, 0});
+    old.swap(type_slots_);
+    const size_t mask = type_slots_.size() - 1;
+    for (const TypeSlot& slot : old) {
+        if (!slot.type) {
+            continue;
+        }
+        size_t i = slot.hash & mask;
+        while (type_slots_[i].type) {
+            i = (i + 1) & mask;
+        }
+        type_slots_[i] = slot;
+    }
+}
+
+const PointerType* ASTContext::get_pointer_type(const Type* pointee, bool is_mutable) {
+    const uint64_t hash =
+        mix_type_key(mix_type_key(seed_type_key(TypeKind::Pointer), pointee), is_mutable);
+    return intern_type<PointerType>(
+        hash,
+        [&](const PointerType* t) {
+            return t->get_pointee() == pointee && t->is_mutable() == is_mutable;
+        },
+        [&] { return create_type<PointerType>(0, pointee, is_mutable); });
+}
+
+const ReferenceType* ASTContext::get_reference_type(const Type* pointee, bool is_mutable) {
+    const uint64_t hash =
+        mix_type_key(mix_type_key(seed_type_key(TypeKind::Reference), pointee), is_mutable);
+    return intern_type<ReferenceType>(
+        hash,
+        [&](const ReferenceType* t) {
+            return t->get_pointee() == pointee && t->is_mutable() == is_mutable;
+        },
+        [&] { return create_type<ReferenceType>(0, pointee, is_mutable); });
+}
+
+const ArrayType* ASTContext::get_array_type(const Type* element, uint64_t size) {
+    const uint64_t hash = mix_type_key(mix_type_key(seed_type_key(TypeKind::Array), element), size);
+    return intern_type<ArrayType>(
+        hash,
+        [&](const ArrayType* t) { return t->get_element() == element && t->get_size() == size; },
+        [&] { return create_type<ArrayType>(0, element, size); });
+}
+
+const SliceType* ASTContext::get_slice_type(const Type* element) {
+    const uint64_t hash = mix_type_key(seed_type_key(TypeKind::Slice), element);
+    return intern_type<SliceType>(
+        hash, [&](const SliceType* t) { return t->get_element() == element; },
+        [&] { return create_type<SliceType>(0, element); });
+}
+
+const Type* ASTContext::get_tuple_type(std::span<const Type* const> elements) {
+    if (elements.empty()) {
+        return get_unit_type();
+    }
+    const uint64_t hash = hash_type_list(seed_type_key(TypeKind::Tuple), elements);
+    return intern_type<TupleType>(
+        hash, [&](const TupleType* t) { return equal_type_lists(t->get_elements(), elements); },
+        [&] {
+            auto* type = create_type<TupleType>(elements.size() * sizeof(const Type*),
+                                                static_cast<uint32_t>(elements.size()));
+            std::copy(elements.begin(), elements.end(), reinterpret_cast<const Type**>(type + 1));
+            return type;
+        });
+}
+
+const FunctionType* ASTContext::get_function_type(std::span<const Type* const> params,
+                                                  const Type* result) {
+    const uint64_t hash =
+        mix_type_key(hash_type_list(seed_type_key(TypeKind::Function), params), result);
+    return intern_type<FunctionType>(
+        hash,
+        [&](const FunctionType* t) {
+            return t->get_result() == result && equal_type_lists(t->get_params(), params);
+        },
+        [&] {
+            auto* type = create_type<FunctionType>(params.size() * sizeof(const Type*),
+                                                   static_cast<uint32_t>(params.size()), result);
+            std::copy(params.begin(), params.end(), reinterpret_cast<const Type**>(type + 1));
+            return type;
+        });
+}
+
+template <typename T>
+const T* ASTContext::get_nominal_type(TypeKind kind, IdentifierInfo* name, const Decl* decl) {
+    const uint64_t hash = mix_type_key(mix_type_key(seed_type_key(kind), name), decl);
+    return intern_type<T>(
+        hash, [&](const T* t) { return t->get_name() == name && t->get_decl() == decl; },
+        [&] { return create_type<T>(0, name, decl); });
+}
+
+const StructType* ASTContext::get_struct_type(IdentifierInfo* name, const Decl* decl) {
+    return get_nominal_type<StructType>(TypeKind::Struct, name, decl);
+}
+
+const EnumType* ASTContext::get_enum_type(IdentifierInfo* name, const Decl* decl) {
+    return get_nominal_type<EnumType>(TypeKind::Enum, name, decl);
+}
+
+const ClassType* ASTContext::get_class_type(IdentifierInfo* name, const Decl* decl) {
+    return get_nominal_type<ClassType>(TypeKind::Class, name, decl);
+}
+
+const TraitType* ASTContext::get_trait_type(IdentifierInfo* name, const Decl* decl) {
+    return get_nominal_type<TraitType>(TypeKind::Trait, name, decl);
+}
+
+const GenericType* ASTContext::get_generic_type(IdentifierInfo* name, uint32_t index) {
+    const uint64_t hash = mix_type_key(mix_type_key(seed_type_key(TypeKind::Generic), name), index);
+    return intern_type<GenericType>(
+        hash, [&](const GenericType* t) { return t->get_name() == name && t->get_index() == index; },
+        [&] { return create_type<GenericType>(0, name, index); });
+}
+
+size_t ASTContext::type_count() const {
+    std::lock_guard<std::mutex> guard(type_root_->type_mutex_);
+    return type_root_->type_count_ + BuiltinType::kKindCount + 2;
+}
+
+size_t ASTContext::type_bytes() const {
+    std::lock_guard<std::mutex> guard(type_root_->type_mutex_);
+    return type_root_->type_arena_.bytes_allocated();
+}
+
+std::string_view ASTContext::copy_string(std::string_view text) {
+    string_bytes_ += text.size();
+    char* data = static_cast<char*>(arena_.allocate(text.size(), 1));
+    if (!text.empty()) {
+        std::memcpy(data, text.data(), text.size());
+    }
+    return std::string_view(data, text.size());
+}
+
+size_t ASTContext::node_count() const {
+    size_t total = 0;
+    for (const NodeStats& stats : node_stats_) {
+        total += stats.count;
+    }
+    return total;
+}
+
+void ASTContext::print_stats(std::FILE* out) const {
+    std::fprintf(out, "AST memory: %zu bytes allocated, %zu reserved in %zu slabs\n",
+                 bytes_allocated(), bytes_reserved(), slab_count());
+    std::fprintf(out, "  %-20s %10s %12s\n", "kind", "count", "bytes");
+    size_t node_bytes = 0;
+    for (size_t i = 0; i < node_stats_.size(); ++i) {
+        const NodeStats& stats = node_stats_[i];
+        if (stats.count == 0) {
+            continue;
+        }
+        node_bytes += stats.bytes;
+        std::fprintf(out, "  %-20s %10zu %12zu\n",
+                     get_ast_node_kind_name(static_cast<ASTNodeKind>(i)), stats.count,
+                     stats.bytes);
+    }
+    std::fprintf(out, "  %-20s %10zu %12zu\n", "(all nodes)", node_count(), node_bytes);
+    std::fprintf(out, "  %-20s %10s %12zu\n", "(child arrays)", "", array_bytes_);
+    std::fprintf(out, "  %-20s %10s %12zu\n", "(strings)", "", string_bytes_);
+    std::fprintf(out, "  %-20s %10zu %12zu\n", "(types)", type_count(), type_bytes());
+}
+
+} // namespace ast
+} // namespace nova
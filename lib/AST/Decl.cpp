@@ -0,0 +1,36 @@
+#include "nova/AST/Decl.hpp"
+#include "nova/AST/ASTContext.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace nova {
+namespace ast {
+
+FuncDecl* FuncDecl::create(ASTContext& ctx, SourceLocation loc, IdentifierInfo* name,
+                           std::span<ParamDecl* const> params, const Type* return_type) {
+    FuncDecl* func = ctx.create_with_trailing<FuncDecl, ParamDecl*>(
+        params.size(), loc, name, static_cast<uint32_t>(params.size()), return_type);
+    std::copy(params.begin(), params.end(), reinterpret_cast<ParamDecl**>(func + 1));
+    return func;
+}
+
+UseDecl* UseDecl::create(ASTContext& ctx, SourceLocation loc,
+                         std::span<IdentifierInfo* const> path) {
+    assert(!path.empty() && "use path without segments");
+    UseDecl* use = ctx.create_with_trailing<UseDecl, IdentifierInfo*>(
+        path.size(), loc, path.back(), static_cast<uint32_t>(path.size()));
+    std::copy(path.begin(), path.end(), reinterpret_cast<IdentifierInfo**>(use + 1));
+    return use;
+}
+
+ModuleDecl* ModuleDecl::create(ASTContext& ctx, SourceLocation loc, IdentifierInfo* name,
+                               std::span<Decl* const> items) {
+    ModuleDecl* module = ctx.create_with_trailing<ModuleDecl, Decl*>(
+        items.size(), loc, name, static_cast<uint32_t>(items.size()));
+    std::copy(items.begin(), items.end(), reinterpret_cast<Decl**>(module + 1));
+    return module;
+}
+
+} // namespace ast
+} // namespace nova
@@ -0,0 +1,86 @@
+#include "nova/AST/Expr.hpp"
+#include "nova/AST/ASTContext.hpp"
+
+#include <algorithm>
+
+namespace nova {
+namespace ast {
+
+const char* get_binary_op_spelling(BinaryOp op) {
+    switch (op) {
+    case BinaryOp::Mul: return "*";
+    case BinaryOp::Div: return "/";
+    case BinaryOp::Rem: return "%";
+    case BinaryOp::Add: return "+";
+    case BinaryOp::Sub: return "-";
+    case BinaryOp::Lt: return "<";
+    case BinaryOp::Le: return "<=";
+    case BinaryOp::Gt: return ">";
+    case BinaryOp::Ge: return ">=";
+    case BinaryOp::Eq: return "==";
+    case BinaryOp::Ne: return "!=";
+    case BinaryOp::LogicalAnd: return "&&";
+    case BinaryOp::LogicalOr: return "||";
+    }
+    return "?";
+}
+
+const char* get_unary_op_spelling(UnaryOp op) {
+    switch (op) {
+    case UnaryOp::Neg: return "-";
+    case UnaryOp::Not: return "!";
+    }
+    return "?";
+}
+
+LiteralExpr* LiteralExpr::create_integer(ASTContext& ctx, SourceLocation loc,
+                                         std::string_view spelling, uint64_t value) {
+    LiteralExpr* lit = ctx.create<LiteralExpr>(loc, LiteralKind::Integer, spelling);
+    lit->integer_ = value;
+    return lit;
+}
+
+LiteralExpr* LiteralExpr::create_float(ASTContext& ctx, SourceLocation loc,
+                                       std::string_view spelling, double value) {
+    LiteralExpr* lit = ctx.create<LiteralExpr>(loc, LiteralKind::Float, spelling);
+    lit->floating_ = value;
+    return lit;
+}
+
+LiteralExpr* LiteralExpr::create_bool(ASTContext& ctx, SourceLocation loc, bool value) {
+    LiteralExpr* lit =
+        ctx.create<LiteralExpr>(loc, LiteralKind::Bool, value ? "true" : "false");
+    lit->boolean_ = value;
+    return lit;
+}
+
+LiteralExpr* LiteralExpr::create_char(ASTContext& ctx, SourceLocation loc,
+                                      std::string_view spelling, uint32_t value) {
+    LiteralExpr* lit = ctx.create<LiteralExpr>(loc, LiteralKind::Char, spelling);
+    lit->character_ = value;
+    return lit;
+}
+
+LiteralExpr* LiteralExpr::create_string(ASTContext& ctx, SourceLocation loc,
+                                        std::string_view spelling) {
+    return ctx.create<LiteralExpr>(loc, LiteralKind::String, spelling);
+}
+
+CallExpr* CallExpr::create(ASTContext& ctx, SourceLocation loc, Expr* callee,
+                           std::span<Expr* const> args, SourceLocation r_paren_loc) {
+    CallExpr* call = ctx.create_with_trailing<CallExpr, Expr*>(
+        args.size(), loc, callee, static_cast<uint32_t>(args.size()), r_paren_loc);
+    std::copy(args.begin(), args.end(), reinterpret_cast<Expr**>(call + 1));
+    return call;
+}
+
+BlockExpr* BlockExpr::create(ASTContext& ctx, SourceLocation loc, std::span<Stmt* const> stmts,
+                             Expr* result, SourceLocation r_brace_loc) {
+    BlockExpr* block = ctx.create_with_trailing<BlockExpr, Stmt*>(
+        stmts.size(), loc, static_cast<uint32_t>(stmts.size()), result, r_brace_loc);
+    std::copy(stmts.begin(), stmts.end(), reinterpret_cast<Stmt**>(block + 1));
+    return block;
+}
+
+} // namespace ast
+} // namespace nova
@@ -0,0 +1,120 @@
+#include "nova/AST/Type.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+
+namespace nova {
+namespace ast {
+namespace {
+
+const char* get_builtin_type_name(BuiltinType::Kind kind) {
+    switch (kind) {
+    case BuiltinType::Kind::Char: return "char";
+    case BuiltinType::Kind::Bool: return "bool";
+    case BuiltinType::Kind::I8: return "i8";
+    case BuiltinType::Kind::I16: return "i16";
+    case BuiltinType::Kind::I32: return "i32";
+    case BuiltinType::Kind::I64: return "i64";
+    case BuiltinType::Kind::U8: return "u8";
+    case BuiltinType::Kind::U16: return "u16";
+    case BuiltinType::Kind::U32: return "u32";
+    case BuiltinType::Kind::U64: return "u64";
+    case BuiltinType::Kind::F32: return "f32";
+    case BuiltinType::Kind::F64: return "f64";
+    case BuiltinType::Kind::Unit: return "()";
+    case BuiltinType::Kind::Never: return "!";
+    }
+    return "?";
+}
+
+void append_type_name(const Type* type, std::string& out);
+
+void append_type_list(std::span<const Type* const> types, std::string& out) {
+    for (size_t i = 0; i < types.size(); ++i) {
+        if (i != 0) {
+            out += ", ";
+        }
+        append_type_name(types[i], out);
+    }
+}
+
+void append_type_name(const Type* type, std::string& out) {
+    if (!type) {
+        out += "<null>";
+        return;
+    }
+    switch (type->get_kind()) {
+    case TypeKind::Builtin:
+        out += get_builtin_type_name(cast<BuiltinType>(type)->get_builtin_kind());
+        return;
+    case TypeKind::Str:
+        out += "str";
+        return;
+    case TypeKind::String:
+        out += "String";
+        return;
+    case TypeKind::Pointer: {
+        const auto* pointer = cast<PointerType>(type);
+        out += pointer->is_mutable() ? "*mut " : "*const ";
+        append_type_name(pointer->get_pointee(), out);
+        return;
+    }
+    case TypeKind::Reference: {
+        const auto* reference = cast<ReferenceType>(type);
+        out += reference->is_mutable() ? "&mut " : "&";
+        append_type_name(reference->get_pointee(), out);
+        return;
+    }
+    case TypeKind::Array: {
+        const auto* array = cast<ArrayType>(type);
+        out += '[';
+        append_type_name(array->get_element(), out);
+        out += "; ";
+        out += std::to_string(array->get_size());
+        out += ']';
+        return;
+    }
+    case TypeKind::Slice:
+        out += '[';
+        append_type_name(cast<SliceType>(type)->get_element(), out);
+        out += ']';
+        return;
+    case TypeKind::Tuple: {
+        const auto elements = cast<TupleType>(type)->get_elements();
+        out += '(';
+        append_type_list(elements, out);
+        // a one-element tuple keeps its comma: (T,)
+        if (elements.size() == 1) {
+            out += ',';
+        }
+        out += ')';
+        return;
+    }
+    case TypeKind::Function: {
+        const auto* function = cast<FunctionType>(type);
+        out += "fn(";
+        append_type_list(function->get_params(), out);
+        out += ") -> ";
+        append_type_name(function->get_result(), out);
+        return;
+    }
+    case TypeKind::Struct:
+    case TypeKind::Enum:
+    case TypeKind::Class:
+    case TypeKind::Trait:
+        out += cast<NominalType>(type)->get_name()->get_name();
+        return;
+    case TypeKind::Generic:
+        out += cast<GenericType>(type)->get_name()->get_name();
+        return;
+    }
+}
+
+} // namespace
+
+std::string get_type_name(const Type* type) {
+    std::string name;
+    append_type_name(type, name);
+    return name;
+}
+
+} // namespace ast
+} // namespace nova
@@ -0,0 +1,331 @@
+#include "nova/Analysis/BorrowChecker.hpp"
+#include "nova/AST/Decl.hpp"
+#include "nova/AST/Expr.hpp"
+#include "nova/AST/Stmt.hpp"
+#include "nova/AST/Type.hpp"
+#include "nova/Analysis/CFG.hpp"
+#include "nova/Analysis/Dataflow.hpp"
+#include "nova/Basic/DiagnosticEngine.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include <string_view>
+
+namespace nova {
+namespace analysis {
+
+using namespace ast;
+
+namespace {
+
+// FNV-1a, so keys do not depend on the standard library's hash
+uint64_t hash_spelling(std::string_view text) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (char c : text) {
+        h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+// Hash of everything in a function that the result of checking it can depend
+// on. Types and names are hashed by spelling, not by pointer, so the key of
+// an unchanged function is the same in a fresh ASTContext.
+class FunctionHasher {
+private:
+    uint64_t hash_ = 0;
+    SourceLocation base_;
+    // types are interned, so each distinct type is spelled once
+    std::unordered_map<const Type*, uint64_t> type_hashes_;
+
+public:
+    explicit FunctionHasher(SourceLocation base) : base_(base) {}
+
+    uint64_t get_hash() const { return hash_; }
+
+    void mix(uint64_t value) {
+        hash_ ^= value + 0x9e3779b97f4a7c15ull + (hash_ << 6) + (hash_ >> 2);
+        hash_ *= 0xbf58476d1ce4e5b9ull;
+        hash_ ^= hash_ >> 32;
+    }
+    void mix_string(std::string_view text) {
+        mix(hash_spelling(text));
+        mix(text.size());
+    }
+    void mix_name(const IdentifierInfo* name) { mix_string(name ? name->get_name() : ""); }
+    void mix_location(SourceLocation loc) {
+        mix(static_cast<uint64_t>(loc.get_raw_encoding()) -
+            static_cast<uint64_t>(base_.get_raw_encoding()));
+    }
+    void mix_type(const Type* type) {
+        if (!type) {
+            mix(0);
+            return;
+        }
+        auto [it, inserted] = type_hashes_.try_emplace(type, 0);
+        if (inserted) {
+            it->second = hash_spelling(get_type_name(type));
+        }
+        mix(it->second);
+    }
+
+    void mix_func(const FuncDecl* func) {
+        mix_name(func->get_name());
+        mix(func->get_params().size());
+        for (const ParamDecl* param : func->get_params()) {
+            mix_location(param->get_location());
+            mix_name(param->get_name());
+            mix_type(param->get_type());
+        }
+        mix_type(func->get_return_type());
+        mix_expr(func->get_body());
+    }
+
+    void mix_stmt(const Stmt* stmt) {
+        mix(static_cast<uint64_t>(stmt->get_kind()));
+        mix_location(stmt->get_location());
+        switch (stmt->get_kind()) {
+        case ASTNodeKind::DeclStmt: {
+            const VarDecl* var = cast<DeclStmt>(stmt)->get_decl();
+            mix_location(var->get_location());
+            mix_name(var->get_name());
+            mix(var->is_mutable());
+            mix_type(var->get_declared_type());
+            mix_optional(var->get_init());
+            break;
+        }
+        case ASTNodeKind::ExprStmt:
+            mix_expr(cast<ExprStmt>(stmt)->get_expr());
+            break;
+        case ASTNodeKind::ReturnStmt:
+            mix_optional(cast<ReturnStmt>(stmt)->get_value());
+            break;
+        case ASTNodeKind::WhileStmt:
+            mix_expr(cast<WhileStmt>(stmt)->get_cond());
+            mix_expr(cast<WhileStmt>(stmt)->get_body());
+            break;
+        default:
+            break;
+        }
+    }
+
+    void mix_optional(const Expr* expr) {
+        mix(expr != nullptr);
+        if (expr) {
+            mix_expr(expr);
+        }
+    }
+
+    void mix_expr(const Expr* expr) {
+        mix(static_cast<uint64_t>(expr->get_kind()));
+        mix_location(expr->get_location());
+        mix_type(expr->get_type());
+        switch (expr->get_kind()) {
+        case ASTNodeKind::LiteralExpr: {
+            const auto* lit = cast<LiteralExpr>(expr);
+            mix(static_cast<uint64_t>(lit->get_literal_kind()));
+            mix_string(lit->get_spelling());
+            break;
+        }
+        case ASTNodeKind::IdentifierExpr:
+            mix_name(cast<IdentifierExpr>(expr)->get_name());
+            break;
+        case ASTNodeKind::BinaryExpr: {
+            const auto* bin = cast<BinaryExpr>(expr);
+            mix(static_cast<uint64_t>(bin->get_op()));
+            mix_expr(bin->get_lhs());
+            mix_expr(bin->get_rhs());
+            break;
+        }
+        case ASTNodeKind::UnaryExpr: {
+            const auto* un = cast<UnaryExpr>(expr);
+            mix(static_cast<uint64_t>(un->get_op()));
+            mix_expr(un->get_operand());
+            break;
+        }
+        case ASTNodeKind::AssignExpr:
+            mix_expr(cast<AssignExpr>(expr)->get_target());
+            mix_expr(cast<AssignExpr>(expr)->get_value());
+            break;
+        case ASTNodeKind::CallExpr: {
+            const auto* call = cast<CallExpr>(expr);
+            mix_expr(call->get_callee());
+            mix(call->get_args().size());
+            for (const Expr* arg : call->get_args()) {
+                mix_expr(arg);
+            }
+            break;
+        }
+        case ASTNodeKind::IfExpr: {
+            const auto* if_expr = cast<IfExpr>(expr);
+            mix_expr(if_expr->get_cond());
+            mix_expr(if_expr->get_then());
+            mix_optional(if_expr->get_else());
+            break;
+        }
+        case ASTNodeKind::BlockExpr: {
+            const auto* block = cast<BlockExpr>(expr);
+            mix(block->get_stmts().size());
+            for (const Stmt* stmt : block->get_stmts()) {
+                mix_stmt(stmt);
+            }
+            mix_optional(block->get_result());
+            break;
+        }
+        default:
+            break;
+        }
+    }
+};
+
+// Records diagnostics relative to the function instead of reporting them.
+class ResultBuilder {
+private:
+    BorrowCheckResult& result_;
+    SourceLocation base_;
+
+public:
+    ResultBuilder(BorrowCheckResult& result, SourceLocation base) : result_(result), base_(base) {}
+
+    void add(DiagnosticID id, SourceLocation loc, std::string message = {}) {
+        if (get_default_severity(id) >= DiagnosticSeverity::Error) {
+            ++result_.error_count;
+        }
+        result_.diagnostics.push_back(
+            {id,
+             static_cast<int64_t>(loc.get_raw_encoding()) -
+                 static_cast<int64_t>(base_.get_raw_encoding()),
+             std::move(message)});
+    }
+};
+
+// A read of a `let` binding that is not assigned on every path to it.
+void check_initialization(const CFG& cfg, ResultBuilder& out) {
+    const VariableIndex vars(cfg.get_function(), cfg);
+    if (vars.size() == 0) {
+        return;
+    }
+    const DataflowResult init = compute_definite_initialization(cfg, vars);
+    BitVector state(vars.size());
+    for (uint32_t id : cfg.compute_reverse_postorder()) {
+        // replay the block from its entry state to find the offending reads
+        state = init.get_block_entry(id);
+        for (const CFGElement& element : cfg.get_block(id).get_elements()) {
+            if (const VarDecl* var = element.get_decl()) {
+                const auto bit = static_cast<size_t>(vars.lookup(var));
+                if (var->get_init()) {
+                    state.set(bit);
+                } else {
+                    state.reset(bit);
+                }
+                continue;
+            }
+            const Expr* expr = element.get_expr();
+            if (const auto* assign = dyn_cast<AssignExpr>(expr)) {
+                const auto* target = dyn_cast<IdentifierExpr>(assign->get_target());
+                const int64_t bit = target ? vars.lookup(target->get_decl()) : -1;
+                if (bit >= 0) {
+                    state.set(static_cast<size_t>(bit));
+                }
+            } else if (const auto* ident = dyn_cast<IdentifierExpr>(expr)) {
+                const int64_t bit = vars.lookup(ident->get_decl());
+                if (bit >= 0 && !state.test(static_cast<size_t>(bit))) {
+                    const std::string name(ident->get_name()->get_name());
+                    out.add(DiagnosticID::err_use_of_uninitialized, ident->get_location(),
+                            ": '" + name + "'");
+                    out.add(DiagnosticID::note_declared_here, ident->get_decl()->get_location(),
+                            ": '" + name + "' declared here");
+                    // one error per variable and block is enough
+                    state.set(static_cast<size_t>(bit));
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+uint64_t BorrowChecker::hash_function(const FuncDecl* func) {
+    FunctionHasher hasher(func->get_location());
+    if (func->get_body()) {
+        hasher.mix_func(func);
+    }
+    return hasher.get_hash();
+}
+
+BorrowCheckResult BorrowChecker::check_function(const FuncDecl* func) {
+    BorrowCheckResult result;
+    if (!func->get_body()) {
+        return result;
+    }
+    ResultBuilder out(result, func->get_location());
+    const CFG cfg = CFGBuilder::build(func);
+    check_initialization(cfg, out);
+    return result;
+}
+
+void BorrowChecker::check_module(ModuleDecl* module) { check_functions(module, nullptr); }
+
+void BorrowChecker::check_module(ModuleDecl* module, ThreadPool& pool) {
+    check_functions(module, &pool);
+}
+
+void BorrowChecker::check_functions(ModuleDecl* module, ThreadPool* pool) {
+    std::vector<const FuncDecl*> funcs;
+    for (Decl* item : module->get_items()) {
+        if (const auto* func = dyn_cast<FuncDecl>(item)) {
+            funcs.push_back(func);
+        }
+    }
+
+    // Hashing and checking touch nothing shared; the cache is only read
+    // here and written below, on this thread.
+    std::vector<uint64_t> keys(funcs.size(), 0);
+    std::vector<const BorrowCheckResult*> cached(funcs.size(), nullptr);
+    std::vector<BorrowCheckResult> fresh(funcs.size());
+    auto check_one = [&](size_t i) {
+        if (cache_) {
+            keys[i] = hash_function(funcs[i]);
+            cached[i] = cache_->lookup(std::string(funcs[i]->get_name()->get_name()), keys[i]);
+            if (cached[i]) {
+                return;
+            }
+        }
+        fresh[i] = check_function(funcs[i]);
+    };
+    if (pool) {
+        pool->parallel_for(funcs.size(), check_one);
+    } else {
+        for (size_t i = 0; i < funcs.size(); ++i) {
+            check_one(i);
+        }
+    }
+
+    // report in source order, then remember the new results
+    for (size_t i = 0; i < funcs.size(); ++i) {
+        const BorrowCheckResult& result = cached[i] ? *cached[i] : fresh[i];
+        const SourceLocation base = funcs[i]->get_location();
+        for (const BorrowCheckResult::Diagnostic& diag : result.diagnostics) {
+            DiagnosticBuilder builder =
+                diags_.report(diag.id, base.get_offset_location(diag.offset));
+            if (!diag.message.empty()) {
+                builder << diag.message;
+            }
+        }
+        error_count_ += result.error_count;
+        if (cached[i]) {
+            ++reused_count_;
+        } else {
+            ++checked_count_;
+        }
+    }
+    if (cache_) {
+        for (size_t i = 0; i < funcs.size(); ++i) {
+            if (!cached[i]) {
+                cache_->store(std::string(funcs[i]->get_name()->get_name()), keys[i],
+                              std::move(fresh[i]));
+            }
+        }
+    }
+}
+
+} // namespace analysis
+} // namespace nova
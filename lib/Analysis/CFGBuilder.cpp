@@ -0,0 +1,199 @@
+#include "nova/Analysis/CFG.hpp"
+#include "nova/AST/Decl.hpp"
+#include "nova/AST/Expr.hpp"
+#include "nova/AST/Stmt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace nova {
+namespace analysis {
+
+using namespace ast;
+
+std::vector<uint32_t> CFG::compute_reverse_postorder() const {
+    // iterative DFS: a function with thousands of blocks must not recurse
+    std::vector<uint32_t> postorder;
+    postorder.reserve(blocks_.size());
+    std::vector<bool> visited(blocks_.size(), false);
+    std::vector<std::pair<uint32_t, uint32_t>> stack; // block, next successor
+    visited[kEntry] = true;
+    stack.emplace_back(kEntry, 0);
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        const std::vector<uint32_t>& succs = blocks_[block].succs_;
+        if (next < succs.size()) {
+            const uint32_t succ = succs[next++];
+            if (!visited[succ]) {
+                visited[succ] = true;
+                stack.emplace_back(succ, 0);
+            }
+            continue;
+        }
+        postorder.push_back(block);
+        stack.pop_back();
+    }
+    std::reverse(postorder.begin(), postorder.end());
+    return postorder;
+}
+
+CFG CFGBuilder::build(const FuncDecl* func) {
+    assert(func->get_body() && "building the CFG of a function without a body");
+    CFGBuilder builder;
+    builder.cfg_.func_ = func;
+    builder.create_block(); // kEntry
+    builder.create_block(); // kExit
+    builder.current_ = CFG::kEntry;
+    builder.build_expr(func->get_body());
+    builder.add_edge(builder.current_, CFG::kExit);
+    return std::move(builder.cfg_);
+}
+
+uint32_t CFGBuilder::create_block() {
+    const auto id = static_cast<uint32_t>(cfg_.blocks_.size());
+    cfg_.blocks_.emplace_back(id);
+    return id;
+}
+
+void CFGBuilder::add_edge(uint32_t from, uint32_t to) {
+    cfg_.blocks_[from].succs_.push_back(to);
+    cfg_.blocks_[to].preds_.push_back(from);
+}
+
+void CFGBuilder::branch(Expr* cond, uint32_t then_block, uint32_t else_block) {
+    cfg_.blocks_[current_].branch_condition_ = cond;
+    add_edge(current_, then_block);
+    add_edge(current_, else_block);
+}
+
+void CFGBuilder::jump_away(uint32_t to) {
+    add_edge(current_, to);
+    current_ = create_block();
+}
+
+void CFGBuilder::build_stmt(Stmt* stmt) {
+    switch (stmt->get_kind()) {
+    case ASTNodeKind::DeclStmt: {
+        VarDecl* var = cast<DeclStmt>(stmt)->get_decl();
+        if (var->get_init()) {
+            build_expr(var->get_init());
+        }
+        cfg_.blocks_[current_].elements_.emplace_back(var);
+        break;
+    }
+    case ASTNodeKind::ExprStmt:
+        build_expr(cast<ExprStmt>(stmt)->get_expr());
+        break;
+    case ASTNodeKind::ReturnStmt:
+        if (Expr* value = cast<ReturnStmt>(stmt)->get_value()) {
+            build_expr(value);
+        }
+        jump_away(CFG::kExit);
+        break;
+    case ASTNodeKind::WhileStmt: {
+        auto* loop = cast<WhileStmt>(stmt);
+        // the condition gets its own blocks so `continue` re-evaluates it
+        const uint32_t header = create_block();
+        add_edge(current_, header);
+        current_ = header;
+        build_expr(loop->get_cond());
+        const uint32_t body = create_block();
+        const uint32_t exit = create_block();
+        branch(loop->get_cond(), body, exit);
+        loops_.push_back({header, exit});
+        current_ = body;
+        build_expr(loop->get_body());
+        add_edge(current_, header);
+        loops_.pop_back();
+        current_ = exit;
+        break;
+    }
+    case ASTNodeKind::BreakStmt:
+        // outside a loop the checker has already reported E0404
+        if (!loops_.empty()) {
+            jump_away(loops_.back().break_block);
+        }
+        break;
+    case ASTNodeKind::ContinueStmt:
+        if (!loops_.empty()) {
+            jump_away(loops_.back().continue_block);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void CFGBuilder::build_expr(Expr* expr) {
+    switch (expr->get_kind()) {
+    case ASTNodeKind::BinaryExpr: {
+        auto* bin = cast<BinaryExpr>(expr);
+        build_expr(bin->get_lhs());
+        if (bin->get_op() == BinaryOp::LogicalAnd || bin->get_op() == BinaryOp::LogicalOr) {
+            const uint32_t rhs = create_block();
+            const uint32_t join = create_block();
+            if (bin->get_op() == BinaryOp::LogicalAnd) {
+                branch(bin->get_lhs(), rhs, join);
+            } else {
+                branch(bin->get_lhs(), join, rhs);
+            }
+            current_ = rhs;
+            build_expr(bin->get_rhs());
+            add_edge(current_, join);
+            current_ = join;
+        } else {
+            build_expr(bin->get_rhs());
+        }
+        break;
+    }
+    case ASTNodeKind::UnaryExpr:
+        build_expr(cast<UnaryExpr>(expr)->get_operand());
+        break;
+    case ASTNodeKind::AssignExpr:
+        // the target is written, not read
+        build_expr(cast<AssignExpr>(expr)->get_value());
+        break;
+    case ASTNodeKind::CallExpr: {
+        auto* call = cast<CallExpr>(expr);
+        build_expr(call->get_callee());
+        for (Expr* arg : call->get_args()) {
+            build_expr(arg);
+        }
+        break;
+    }
+    case ASTNodeKind::IfExpr: {
+        auto* if_expr = cast<IfExpr>(expr);
+        build_expr(if_expr->get_cond());
+        const uint32_t then_block = create_block();
+        const uint32_t else_block = if_expr->get_else() ? create_block() : 0;
+        const uint32_t join = create_block();
+        branch(if_expr->get_cond(), then_block, if_expr->get_else() ? else_block : join);
+        current_ = then_block;
+        build_expr(if_expr->get_then());
+        add_edge(current_, join);
+        if (if_expr->get_else()) {
+            current_ = else_block;
+            build_expr(if_expr->get_else());
+            add_edge(current_, join);
+        }
+        current_ = join;
+        break;
+    }
+    case ASTNodeKind::BlockExpr: {
+        auto* block = cast<BlockExpr>(expr);
+        for (Stmt* stmt : block->get_stmts()) {
+            build_stmt(stmt);
+        }
+        if (block->get_result()) {
+            build_expr(block->get_result());
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    append(expr);
+}
+
+} // namespace analysis
+} // namespace nova
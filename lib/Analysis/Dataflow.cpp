@@ -0,0 +1,171 @@
+#include "nova/Analysis/Dataflow.hpp"
+#include "nova/AST/Decl.hpp"
+#include "nova/AST/Expr.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace nova {
+namespace analysis {
+
+using namespace ast;
+
+namespace {
+
+constexpr uint32_t kUnreachable = UINT32_MAX;
+
+// Bit of the variable an element reads, or -1.
+int64_t read_variable(const CFGElement& element, const VariableIndex& vars) {
+    const auto* id = dyn_cast_if_present<IdentifierExpr>(element.get_expr());
+    return id && id->get_decl() ? vars.lookup(id->get_decl()) : -1;
+}
+
+// Bit of the variable an element assigns, or -1.
+int64_t assigned_variable(const CFGElement& element, const VariableIndex& vars) {
+    const auto* assign = dyn_cast_if_present<AssignExpr>(element.get_expr());
+    if (!assign) {
+        return -1;
+    }
+    const auto* target = dyn_cast<IdentifierExpr>(assign->get_target());
+    return target && target->get_decl() ? vars.lookup(target->get_decl()) : -1;
+}
+
+} // namespace
+
+DataflowResult solve_dataflow(const CFG& cfg, const DataflowProblem& problem,
+                              std::span<const GenKillSet> transfers) {
+    assert(transfers.size() == cfg.size() && "one transfer function per block");
+    assert(problem.boundary.size() == problem.num_bits && "boundary of the wrong size");
+    const bool forward = problem.direction == DataflowDirection::Forward;
+    const bool is_union = problem.meet == DataflowMeet::Union;
+
+    DataflowResult result;
+    const BitVector initial(problem.num_bits, /*value=*/!is_union);
+    result.block_entry_.assign(cfg.size(), initial);
+    result.block_exit_.assign(cfg.size(), initial);
+    // `before` is where predecessors meet, `after` what the transfer produces
+    std::vector<BitVector>& before = forward ? result.block_entry_ : result.block_exit_;
+    std::vector<BitVector>& after = forward ? result.block_exit_ : result.block_entry_;
+    const uint32_t boundary_block = forward ? CFG::kEntry : CFG::kExit;
+
+    std::vector<uint32_t> order = cfg.compute_reverse_postorder();
+    if (!forward) {
+        std::reverse(order.begin(), order.end());
+    }
+    std::vector<uint32_t> position(cfg.size(), kUnreachable);
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
+
+    // The worklist is a bit per position in `order`; each pass visits the
+    // pending blocks in order, and a change only forces another pass when it
+    // reaches a block the pass has already gone by (a back edge).
+    BitVector pending(order.size(), /*value=*/true);
+    bool again = true;
+    while (again) {
+        again = false;
+        for (uint32_t i = 0; i < order.size(); ++i) {
+            if (!pending.test(i)) {
+                continue;
+            }
+            pending.reset(i);
+            const uint32_t id = order[i];
+            const CFGBlock& block = cfg.get_block(id);
+
+            BitVector& in = before[id];
+            if (id == boundary_block) {
+                in = problem.boundary;
+            } else {
+                bool first = true;
+                for (uint32_t source : forward ? block.get_preds() : block.get_succs()) {
+                    if (position[source] == kUnreachable) {
+                        continue;
+                    }
+                    if (first) {
+                        in = after[source];
+                        first = false;
+                    } else if (is_union) {
+                        in.union_with(after[source]);
+                    } else {
+                        in.intersect_with(after[source]);
+                    }
+                }
+            }
+
+            ++result.visit_count_;
+            const GenKillSet& transfer = transfers[id];
+            if (!after[id].assign_transfer(transfer.get_gen(), in, transfer.get_kill())) {
+                continue;
+            }
+            for (uint32_t target : forward ? block.get_succs() : block.get_preds()) {
+                const uint32_t target_position = position[target];
+                if (target_position == kUnreachable) {
+                    continue;
+                }
+                pending.set(target_position);
+                again |= target_position <= i;
+            }
+        }
+    }
+    return result;
+}
+
+VariableIndex::VariableIndex(const FuncDecl* func, const CFG& cfg) {
+    auto add = [this](const Decl* decl) {
+        bits_.emplace(decl, static_cast<uint32_t>(decls_.size()));
+        decls_.push_back(decl);
+    };
+    for (const ParamDecl* param : func->get_params()) {
+        add(param);
+    }
+    for (const CFGBlock& block : cfg.blocks()) {
+        for (const CFGElement& element : block.get_elements()) {
+            if (const VarDecl* var = element.get_decl()) {
+                add(var);
+            }
+        }
+    }
+}
+
+DataflowResult compute_liveness(const CFG& cfg, const VariableIndex& vars) {
+    DataflowProblem problem;
+    problem.direction = DataflowDirection::Backward;
+    problem.meet = DataflowMeet::Union;
+    problem.num_bits = vars.size();
+    problem.boundary = BitVector(vars.size());
+    return solve_dataflow(cfg, problem, [&vars](const CFGElement& element, GenKillSet& set) {
+        if (const VarDecl* var = element.get_decl()) {
+            set.kill(static_cast<size_t>(vars.lookup(var)));
+        } else if (int64_t bit = assigned_variable(element, vars); bit >= 0) {
+            set.kill(static_cast<size_t>(bit));
+        } else if (int64_t bit = read_variable(element, vars); bit >= 0) {
+            set.gen(static_cast<size_t>(bit));
+        }
+    });
+}
+
+DataflowResult compute_definite_initialization(const CFG& cfg, const VariableIndex& vars) {
+    DataflowProblem problem;
+    problem.direction = DataflowDirection::Forward;
+    problem.meet = DataflowMeet::Intersection;
+    problem.num_bits = vars.size();
+    problem.boundary = BitVector(vars.size());
+    const FuncDecl* func = cfg.get_function();
+    for (size_t i = 0; i < func->get_params().size(); ++i) {
+        problem.boundary.set(i);
+    }
+    return solve_dataflow(cfg, problem, [&vars](const CFGElement& element, GenKillSet& set) {
+        if (const VarDecl* var = element.get_decl()) {
+            const auto bit = static_cast<size_t>(vars.lookup(var));
+            if (var->get_init()) {
+                set.gen(bit);
+            } else {
+                set.kill(bit);
+            }
+        } else if (int64_t bit = assigned_variable(element, vars); bit >= 0) {
+            set.gen(static_cast<size_t>(bit));
+        }
+    });
+}
+
+} // namespace analysis
+} // namespace nova
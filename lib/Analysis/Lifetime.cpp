@@ -0,0 +1,181 @@
+#include "nova/Analysis/Lifetime.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace nova {
+namespace analysis {
+
+namespace {
+
+constexpr uint32_t kUnset = UINT32_MAX;
+
+// Adjacency lists of `count` nodes in one array: the successors of node n are
+// targets[begin[n], begin[n + 1]).
+struct EdgeList {
+    std::vector<uint32_t> begin;
+    std::vector<uint32_t> targets;
+
+    EdgeList(uint32_t count, std::span<const std::pair<uint32_t, uint32_t>> edges)
+        : begin(static_cast<size_t>(count) + 1, 0), targets(edges.size()) {
+        for (const auto& edge : edges) {
+            ++begin[edge.first + 1];
+        }
+        for (uint32_t n = 0; n < count; ++n) {
+            begin[n + 1] += begin[n];
+        }
+        std::vector<uint32_t> next(begin.begin(), begin.end() - 1);
+        for (const auto& edge : edges) {
+            targets[next[edge.first]++] = edge.second;
+        }
+    }
+
+    std::span<const uint32_t> successors(uint32_t n) const {
+        return std::span<const uint32_t>(targets).subspan(begin[n], begin[n + 1] - begin[n]);
+    }
+};
+
+} // namespace
+
+Lifetime LifetimeSolver::create_lifetime() {
+    const auto id = static_cast<uint32_t>(parent_.size());
+    parent_.push_back(id);
+    size_.push_back(1);
+    solved_ = false;
+    return Lifetime(id);
+}
+
+void LifetimeSolver::add_equal(Lifetime a, Lifetime b) {
+    unite(a.get_id(), b.get_id());
+    solved_ = false;
+}
+
+uint32_t LifetimeSolver::find(uint32_t id) {
+    while (parent_[id] != id) {
+        parent_[id] = parent_[parent_[id]];
+        id = parent_[id];
+    }
+    return id;
+}
+
+void LifetimeSolver::unite(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+        return;
+    }
+    if (size_[a] < size_[b]) {
+        std::swap(a, b);
+    }
+    parent_[b] = a;
+    size_[a] += size_[b];
+}
+
+void LifetimeSolver::solve() {
+    const auto count = static_cast<uint32_t>(parent_.size());
+
+    // Points flow from the shorter lifetime to the longer one. Edges join
+    // union-find roots, so lifetimes already known equal are one node.
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(constraints_.size());
+    for (const LifetimeConstraint& constraint : constraints_) {
+        const uint32_t from = find(constraint.shorter.get_id());
+        const uint32_t to = find(constraint.longer.get_id());
+        if (from != to) {
+            edges.emplace_back(from, to);
+        }
+    }
+    const EdgeList graph(count, edges);
+
+    // Tarjan's algorithm with an explicit call stack: constraint chains can
+    // be far deeper than the native stack. A component is numbered when it
+    // is complete, after every component reachable from it, so numbering
+    // them from the back gives a topological order.
+    std::vector<uint32_t> index(count, kUnset);
+    std::vector<uint32_t> low(count, 0);
+    std::vector<uint32_t> scc(count, kUnset);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> calls; // node, next successor
+    uint32_t next_index = 0;
+    uint32_t scc_count = 0;
+    for (uint32_t start = 0; start < count; ++start) {
+        if (parent_[start] != start || index[start] != kUnset) {
+            continue;
+        }
+        index[start] = low[start] = next_index++;
+        stack.push_back(start);
+        calls.emplace_back(start, 0);
+        while (!calls.empty()) {
+            const uint32_t node = calls.back().first;
+            const std::span<const uint32_t> succs = graph.successors(node);
+            if (calls.back().second < succs.size()) {
+                const uint32_t succ = succs[calls.back().second++];
+                if (index[succ] == kUnset) {
+                    index[succ] = low[succ] = next_index++;
+                    stack.push_back(succ);
+                    calls.emplace_back(succ, 0);
+                } else if (scc[succ] == kUnset) {
+                    // visited and unassigned: still on the stack
+                    low[node] = std::min(low[node], index[succ]);
+                }
+                continue;
+            }
+            calls.pop_back();
+            if (!calls.empty()) {
+                const uint32_t caller = calls.back().first;
+                low[caller] = std::min(low[caller], low[node]);
+            }
+            if (low[node] != index[node]) {
+                continue;
+            }
+            // `node` roots a component; every member has the same value
+            uint32_t member = kUnset;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                scc[member] = scc_count;
+                unite(node, member);
+            } while (member != node);
+            ++scc_count;
+        }
+    }
+
+    // components in topological order: sources first
+    component_.assign(count, kUnset);
+    for (uint32_t id = 0; id < count; ++id) {
+        component_[id] = scc_count - 1 - scc[find(id)];
+    }
+    values_.assign(scc_count, BitVector(num_points_));
+    for (const auto& [lifetime, point] : live_points_) {
+        values_[component_[lifetime]].set(point);
+    }
+
+    // one union per edge of the condensed DAG
+    std::vector<std::pair<uint32_t, uint32_t>> dag_edges;
+    dag_edges.reserve(edges.size());
+    for (const auto& [from, to] : edges) {
+        if (component_[from] != component_[to]) {
+            dag_edges.emplace_back(component_[from], component_[to]);
+        }
+    }
+    const EdgeList dag(scc_count, dag_edges);
+    for (uint32_t c = 0; c < scc_count; ++c) {
+        for (uint32_t succ : dag.successors(c)) {
+            assert(succ > c && "condensed graph is not in topological order");
+            values_[succ].union_with(values_[c]);
+        }
+    }
+    solved_ = true;
+}
+
+const BitVector& LifetimeSolver::get_value(Lifetime lifetime) const {
+    assert(solved_ && "lifetime values read before solve()");
+    return values_[component_[lifetime.get_id()]];
+}
+
+bool LifetimeSolver::are_merged(Lifetime a, Lifetime b) const {
+    assert(solved_ && "lifetimes compared before solve()");
+    return component_[a.get_id()] == component_[b.get_id()];
+}
+
+} // namespace analysis
+} // namespace nova
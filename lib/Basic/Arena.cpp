@@ -0,0 +1,85 @@
+#include "nova/Basic/Arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace nova {
+
+Arena::~Arena() { reset(); }
+
+Arena::Arena(Arena&& other) noexcept
+    : cur_(other.cur_), end_(other.end_), slabs_(std::move(other.slabs_)),
+      next_slab_size_(other.next_slab_size_), bytes_allocated_(other.bytes_allocated_),
+      bytes_reserved_(other.bytes_reserved_) {
+    other.cur_ = nullptr;
+    other.end_ = nullptr;
+    other.slabs_.clear();
+    other.next_slab_size_ = kInitialSlabSize;
+    other.bytes_allocated_ = 0;
+    other.bytes_reserved_ = 0;
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(cur_, other.cur_);
+        std::swap(end_, other.end_);
+        std::swap(slabs_, other.slabs_);
+        std::swap(next_slab_size_, other.next_slab_size_);
+        std::swap(bytes_allocated_, other.bytes_allocated_);
+        std::swap(bytes_reserved_, other.bytes_reserved_);
+    }
+    return *this;
+}
+
+void Arena::reset() {
+    for (char* slab : slabs_) {
+        ::operator delete(slab);
+    }
+    slabs_.clear();
+    cur_ = nullptr;
+    end_ = nullptr;
+    next_slab_size_ = kInitialSlabSize;
+    bytes_allocated_ = 0;
+    bytes_reserved_ = 0;
+}
+
+void Arena::adopt(Arena&& other) {
+    slabs_.insert(slabs_.end(), other.slabs_.begin(), other.slabs_.end());
+    bytes_allocated_ += other.bytes_allocated_;
+    bytes_reserved_ += other.bytes_reserved_;
+    other.slabs_.clear();
+    other.cur_ = nullptr;
+    other.end_ = nullptr;
+    other.next_slab_size_ = kInitialSlabSize;
+    other.bytes_allocated_ = 0;
+    other.bytes_reserved_ = 0;
+}
+
+void* Arena::allocate_slow(size_t size, size_t align) {
+    assert(align != 0 && (align & (align - 1)) == 0 && "alignment must be a power of two");
+    // operator new returns memory aligned for any fundamental type; only
+    // over-aligned requests need padding at the start of a fresh slab
+    const size_t padded = size + (align > alignof(std::max_align_t) ? align : 0);
+
+    if (padded > next_slab_size_ / 2) {
+        // dedicated slab; keep bumping in the current one
+        char* slab = static_cast<char*>(::operator new(padded));
+        slabs_.push_back(slab);
+        bytes_reserved_ += padded;
+        bytes_allocated_ += size;
+        const auto base = reinterpret_cast<uintptr_t>(slab);
+        return reinterpret_cast<void*>((base + align - 1) & ~static_cast<uintptr_t>(align - 1));
+    }
+
+    const size_t slab_size = next_slab_size_;
+    next_slab_size_ = std::min(next_slab_size_ * 2, kMaxSlabSize);
+    char* slab = static_cast<char*>(::operator new(slab_size));
+    slabs_.push_back(slab);
+    bytes_reserved_ += slab_size;
+    cur_ = slab;
+    end_ = slab + slab_size;
+    return allocate(size, align);
+}
+
+} // namespace nova
@@ -0,0 +1,86 @@
+#include "nova/Basic/CPUFeatures.hpp"
+
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace nova {
+namespace {
+
+SIMDLevel detect_host_simd_level() {
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+    // __builtin_cpu_supports also checks that the OS saves the YMM state.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMDLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SIMDLevel::SSE2;
+    }
+#endif
+    return SIMDLevel::Scalar;
+#elif defined(_M_X64) || defined(_M_IX86)
+    int regs[4] = {};
+    __cpuid(regs, 0);
+    const int max_leaf = regs[0];
+    __cpuid(regs, 1);
+    const bool has_sse2 = (regs[3] & (1 << 26)) != 0;
+    const bool has_osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool has_avx = (regs[2] & (1 << 28)) != 0;
+    if (max_leaf >= 7 && has_osxsave && has_avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(regs, 7, 0);
+        if (regs[1] & (1 << 5)) {
+            return SIMDLevel::AVX2;
+        }
+    }
+    return has_sse2 ? SIMDLevel::SSE2 : SIMDLevel::Scalar;
+#else
+    return SIMDLevel::Scalar;
+#endif
+}
+
+// Active level; initialized lazily from the host level.
+std::atomic<int> g_active_level{-1};
+
+} // namespace
+
+SIMDLevel get_host_simd_level() {
+    static const SIMDLevel host = detect_host_simd_level();
+    return host;
+}
+
+SIMDLevel get_active_simd_level() {
+    int level = g_active_level.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = static_cast<int>(get_host_simd_level());
+        g_active_level.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<SIMDLevel>(level);
+}
+
+SIMDLevel set_active_simd_level(SIMDLevel level) {
+    const SIMDLevel host = get_host_simd_level();
+    if (static_cast<uint8_t>(level) > static_cast<uint8_t>(host)) {
+        level = host;
+    }
+    g_active_level.store(static_cast<int>(level), std::memory_order_relaxed);
+    return level;
+}
+
+const char* get_simd_level_name(SIMDLevel level) {
+    switch (level) {
+    case SIMDLevel::Scalar:
+        return "scalar";
+    case SIMDLevel::SSE2:
+        return "sse2";
+    case SIMDLevel::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+} // namespace nova
@@ -1,8 +1,38 @@
 // TODO: Implement diagnostic engine
 #include "nova/Basic/DiagnosticEngine.hpp"
+#include "nova/Basic/DiagnosticSink.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 
 namespace nova {
-    // Placeholder
+namespace {
+
+std::atomic<uint64_t> next_engine_serial{1};
+
+// the deferred buffer this thread used last
+struct ThreadBufferCache {
+    uint64_t engine_serial = 0;
+    DiagnosticBuffer* buffer = nullptr;
+};
+thread_local ThreadBufferCache thread_buffer_cache;
+
+// deduplication key: (id, location, arguments) folded one value at a time
+uint64_t mix_key(uint64_t key, uint64_t value) {
+    key ^= value + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    key *= 0xff51afd7ed558ccdULL;
+    return key ^ (key >> 32);
+}
+
+uint64_t seed_key(DiagnosticID id, SourceLocation loc) {
+    return mix_key(static_cast<uint64_t>(id), static_cast<uint64_t>(loc.get_raw_encoding()));
+}
+
+} // namespace
+
     DiagnosticBuilder::DiagnosticBuilder(DiagnosticEngine* engine, DiagnosticID id,
                                         DiagnosticSeverity severity, SourceLocation loc)
                                         : engine_(engine),diag_({
@@ -11,9 +41,25 @@ namespace nova {
                                             loc,
                                             {},
                                             {}
-                                        }){}
+                                        }), hash_(seed_key(id, loc)){
+        if(engine_ && engine_->deferred_ && severity != DiagnosticSeverity::Fatal){
+            buffer_ = engine_->get_thread_buffer();
+            record_.id = id;
+            record_.severity = severity;
+            record_.location = loc;
+        }
+        // checked up front so a capped diagnostic never stores its arguments.
+        // Deferred diagnostics are capped in flush(), once they are in
+        // location order: which ones come first is not known while recording
+        if(engine_ && engine_->filtering_ && !buffer_ && severity != DiagnosticSeverity::Note &&
+           severity != DiagnosticSeverity::Fatal){
+            suppressed_ = engine_->at_limit(id);
+        }
+    }
     DiagnosticBuilder::DiagnosticBuilder(DiagnosticBuilder&& other) noexcept
-        : engine_(other.engine_), diag_(std::move(other.diag_)), emitted_(other.emitted_) {
+        : engine_(other.engine_), diag_(std::move(other.diag_)), buffer_(other.buffer_),
+          record_(other.record_), hash_(other.hash_), suppressed_(other.suppressed_),
+          emitted_(other.emitted_) {
             other.emitted_ = true;
             other.engine_ = nullptr;
         }
@@ -22,6 +68,10 @@ namespace nova {
         if (this != &other) {
             engine_ = other.engine_;
             diag_ = std::move(other.diag_);
+            buffer_ = other.buffer_;
+            record_ = other.record_;
+            hash_ = other.hash_;
+            suppressed_ = other.suppressed_;
             emitted_ = other.emitted_;
             other.emitted_ = true;
             other.engine_ = nullptr;
@@ -34,30 +84,94 @@ namespace nova {
             emit();
         }
     }
+    // grow into an arena array once the inline slots are used up
+    DiagnosticArgument& DiagnosticBuilder::add_argument() {
+        if(record_.argument_count == record_.argument_capacity){
+            const uint32_t capacity = record_.argument_capacity * 2;
+            auto* grown = static_cast<DiagnosticArgument*>(buffer_->arena.allocate(
+                capacity * sizeof(DiagnosticArgument), alignof(DiagnosticArgument)));
+            std::copy_n(record_.arguments(), record_.argument_count, grown);
+            record_.overflow = grown;
+            record_.argument_capacity = capacity;
+        }
+        DiagnosticArgument* args = record_.overflow ? record_.overflow : record_.inline_arguments;
+        return args[record_.argument_count++];
+    }
+
     DiagnosticBuilder& DiagnosticBuilder::operator<<(std::string_view arg) {
+        if(suppressed_){
+            return *this;
+        }
+        hash_ = mix_key(hash_, IdentifierTable::hash(arg));
+        if(buffer_){
+            // copied: the caller's string may not outlive the flush
+            char* data = static_cast<char*>(buffer_->arena.allocate(arg.size(), 1));
+            std::memcpy(data, arg.data(), arg.size());
+            DiagnosticArgument& out = add_argument();
+            out.kind = DiagnosticArgument::Kind::String;
+            out.string = data;
+            out.length = static_cast<uint32_t>(arg.size());
+            return *this;
+        }
         diag_.message += std::string(arg);
         return *this;
     }
 
     DiagnosticBuilder& DiagnosticBuilder::operator<<(int64_t arg) {
+        if(suppressed_){
+            return *this;
+        }
+        hash_ = mix_key(hash_, static_cast<uint64_t>(arg));
+        if(buffer_){
+            DiagnosticArgument& out = add_argument();
+            out.kind = DiagnosticArgument::Kind::Integer;
+            out.integer = arg;
+            return *this;
+        }
         diag_.message += std::to_string(arg);
         return *this;
     }
 
     DiagnosticBuilder& DiagnosticBuilder::operator<<(SourceRange range) {
+        if(suppressed_){
+            return *this;
+        }
+        if(buffer_){
+            DiagnosticArgument& out = add_argument();
+            out.kind = DiagnosticArgument::Kind::Range;
+            out.range = buffer_->arena.create<SourceRange>(range);
+            return *this;
+        }
         diag_.ranges.push_back(range);
         return *this;
     }
 
     void DiagnosticBuilder::emit() {
         if(engine_) {
-            engine_->emit(diag_);
+            if(buffer_){
+                record_.hash = hash_;
+                engine_->record(buffer_, record_);
+            } else {
+                engine_->emit(diag_, hash_, suppressed_);
+            }
             emitted_ = true;
         }
     }
 
     DiagnosticEngine::DiagnosticEngine(const SourceManager* sm)
-        : source_manager_(sm) {}
+        : source_manager_(sm),
+          serial_(next_engine_serial.fetch_add(1, std::memory_order_relaxed)) {
+        limits_.fill(kNoLimit);
+    }
+
+    DiagnosticEngine::~DiagnosticEngine() {
+        DiagnosticBuffer* buffer = buffers_.load(std::memory_order_acquire);
+        while(buffer){
+            DiagnosticBuffer* next = buffer->next;
+            delete buffer;
+            buffer = next;
+        }
+    }
 
     void DiagnosticEngine::set_handler(DiagnosticHandler handler) {
         handler_ = std::move(handler);
@@ -75,8 +189,76 @@ namespace nova {
     DiagnosticBuilder DiagnosticEngine::report(DiagnosticID id){
         return report(id, SourceLocation::invalid());
     }
+    void DiagnosticEngine::set_diagnostic_limit(uint32_t limit) {
+        limits_.fill(limit == 0 ? kNoLimit : limit);
+        filtering_ = deduplicate_ || limit != 0;
+    }
+
+    void DiagnosticEngine::set_diagnostic_limit(DiagnosticID id, uint32_t limit) {
+        limits_[static_cast<size_t>(id)] = limit == 0 ? kNoLimit : limit;
+        filtering_ = deduplicate_ ||
+                     std::any_of(limits_.begin(), limits_.end(),
+                                 [](uint32_t l) { return l != kNoLimit; });
+    }
+
+    void DiagnosticEngine::set_deduplicate(bool enable) {
+        deduplicate_ = enable;
+        filtering_ = deduplicate_ ||
+                     std::any_of(limits_.begin(), limits_.end(),
+                                 [](uint32_t l) { return l != kNoLimit; });
+    }
+
+    uint32_t DiagnosticEngine::suppressed_count() const {
+        uint32_t total = 0;
+        for(const auto& n : suppressed_){
+            total += n.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    bool DiagnosticEngine::at_limit(DiagnosticID id) const {
+        const auto index = static_cast<size_t>(id);
+        if(limits_[index] == kNoLimit){
+            return false;
+        }
+        return shown_[index].load(std::memory_order_relaxed) >= limits_[index];
+    }
+
+    // filtering for immediate mode; only a hash probe, nothing is formatted
+    bool DiagnosticEngine::admit(DiagnosticID id, DiagnosticSeverity severity, uint64_t hash,
+                                 bool over_limit) {
+        std::lock_guard<std::mutex> lock(filter_mutex_);
+        if(severity == DiagnosticSeverity::Note){
+            return !last_suppressed_;
+        }
+        const auto index = static_cast<size_t>(id);
+        if(severity != DiagnosticSeverity::Fatal){
+            if(over_limit || (deduplicate_ && !seen_.insert(hash).second) ||
+               shown_[index].load(std::memory_order_relaxed) >= limits_[index]){
+                suppressed_[index].fetch_add(1, std::memory_order_relaxed);
+                last_suppressed_ = true;
+                return false;
+            }
+        }
+        shown_[index].fetch_add(1, std::memory_order_relaxed);
+        last_suppressed_ = false;
+        return true;
+    }
+
     // emit a pre-built diagnostic to the handler
     void DiagnosticEngine::emit(const DiagnosticMessage& diag) {
+        emit(diag, mix_key(seed_key(diag.id, diag.location), IdentifierTable::hash(diag.message)),
+             false);
+    }
+
+    void DiagnosticEngine::emit(const DiagnosticMessage& diag, uint64_t hash, bool over_limit) {
+        if(filtering_ && !admit(diag.id, diag.severity, hash, over_limit)) {
+            // still an error for has_errors(), just not shown
+            if(!handler_) {
+                count(diag.severity);
+            }
+            return;
+        }
         if(!handler_) {
             default_handler(diag);
         } else {
@@ -84,31 +266,267 @@ namespace nova {
         }
     }
     void DiagnosticEngine::default_handler(const DiagnosticMessage& diag) {
-        std::string formatted = format_diagnostic(diag);
-        switch (diag.severity) {
+        if(diag.severity == DiagnosticSeverity::Fatal && deferred_) {
+            // the process is about to end: print what this thread recorded
+            // (and the suppression summary) ahead of the fatal, or it is lost.
+            // Other threads may still be appending to their buffers, so
+            // those are left alone.
+            flush_buffers(get_thread_buffer());
+        }
+        if(count(diag.severity)) {
+            if(sink_) {
+                sink_->write(diag);
+            } else {
+                std::string line;
+                print(diag, line);
+                fputs(line.c_str(), stderr);
+            }
+        }
+        if(diag.severity == DiagnosticSeverity::Fatal) {
+            // the sink buffers; nothing left in it survives std::terminate
+            if(sink_) {
+                sink_->flush();
+            }
+            //terminate the program
+            std::terminate();
+        }
+    }
+
+    bool DiagnosticEngine::count(DiagnosticSeverity severity) {
+        switch (severity) {
             case DiagnosticSeverity::Note:
-                fprintf(stderr, "Note %s: %s\n", get_diagnostic_code(diag.id),formatted.c_str());
-                break;
+            case DiagnosticSeverity::Fatal:
+                return true;
             case DiagnosticSeverity::Warning:
                 if(!suppress_warnings_ && !warnings_as_errors_) {
-                    fprintf(stderr, "Warning %s: %s\n", get_diagnostic_code(diag.id), formatted.c_str());
-                    warning_count_++;
-                }else if(warnings_as_errors_) {
-                    fprintf(stderr, "Error (from warning) %s: %s\n", get_diagnostic_code(diag.id), formatted.c_str());
-                    error_count_++;
+                    warning_count_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
                 }
-                break;
+                if(warnings_as_errors_) {
+                    error_count_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                return false;
             case DiagnosticSeverity::Error:
-                fprintf(stderr, "Error %s: %s\n", get_diagnostic_code(diag.id), formatted.c_str());
-                error_count_++;
+                error_count_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+        }
+        return true;
+    }
+
+    // append one rendered line to `out`
+    void DiagnosticEngine::print(const DiagnosticMessage& diag, std::string& out) const {
+        const char* label = "Error";
+        switch (diag.severity) {
+            case DiagnosticSeverity::Note: label = "Note"; break;
+            case DiagnosticSeverity::Warning:
+                label = warnings_as_errors_ ? "Error (from warning)" : "Warning";
                 break;
-            case DiagnosticSeverity::Fatal:
-                fprintf(stderr, "Fatal Error %s: %s\n", get_diagnostic_code(diag.id), formatted.c_str());
-                //terminate the program
-                std::terminate();
+            case DiagnosticSeverity::Error: label = "Error"; break;
+            case DiagnosticSeverity::Fatal: label = "Fatal Error"; break;
+        }
+        out += label;
+        out += ' ';
+        out += get_diagnostic_code(diag.id);
+        out += ": ";
+        out += format_diagnostic(diag);
+        out += '\n';
+    }
+
+    DiagnosticBuffer* DiagnosticEngine::get_thread_buffer() {
+        ThreadBufferCache& cache = thread_buffer_cache;
+        if(cache.engine_serial == serial_){
+            return cache.buffer;
+        }
+        // the thread may have reported to this engine before switching to
+        // another one; buffers are never unlinked, so walking is safe
+        const std::thread::id self = std::this_thread::get_id();
+        DiagnosticBuffer* head = buffers_.load(std::memory_order_acquire);
+        DiagnosticBuffer* found = nullptr;
+        for(DiagnosticBuffer* b = head; b; b = b->next){
+            if(b->owner == self){
+                found = b;
                 break;
+            }
+        }
+        if(!found){
+            found = new DiagnosticBuffer();
+            found->owner = self;
+            found->next = head;
+            while(!buffers_.compare_exchange_weak(found->next, found, std::memory_order_release,
+                                                  std::memory_order_acquire)){
+            }
+        }
+        cache.engine_serial = serial_;
+        cache.buffer = found;
+        return found;
+    }
+
+    void DiagnosticEngine::record(DiagnosticBuffer* buffer, const DiagnosticRecord& record) {
+        const auto index = static_cast<uint32_t>(buffer->records.size());
+        if(record.severity == DiagnosticSeverity::Note){
+            if(buffer->current_group == DiagnosticBuffer::kDroppedGroup){
+                return;
+            }
+            if(buffer->current_group == DiagnosticBuffer::kNoGroup){
+                // a note without a diagnostic before it stands on its own
+                buffer->current_group = index;
+            }
+        } else if(!count(record.severity)){
+            buffer->current_group = DiagnosticBuffer::kDroppedGroup;
+            return;
+        } else if(deduplicate_ && !buffer->seen.insert(record.hash).second){
+            // a duplicate is dropped whichever copy survives; limits wait
+            // for flush(), as the kept diagnostics must not depend on how
+            // the work was split across threads
+            suppressed_[static_cast<size_t>(record.id)].fetch_add(1, std::memory_order_relaxed);
+            buffer->current_group = DiagnosticBuffer::kDroppedGroup;
+            return;
+        } else {
+            buffer->current_group = index;
+        }
+        buffer->records.push_back(record);
+        buffer->records.back().group = buffer->current_group;
+    }
+
+    DiagnosticMessage DiagnosticEngine::materialize(const DiagnosticRecord& record) const {
+        DiagnosticMessage diag{record.id, record.severity, record.location, {}, {}};
+        const DiagnosticArgument* args = record.arguments();
+        for(uint32_t i = 0; i < record.argument_count; ++i){
+            switch (args[i].kind) {
+                case DiagnosticArgument::Kind::String:
+                    diag.message.append(args[i].string, args[i].length);
+                    break;
+                case DiagnosticArgument::Kind::Integer:
+                    diag.message += std::to_string(args[i].integer);
+                    break;
+                case DiagnosticArgument::Kind::Range:
+                    diag.ranges.push_back(*args[i].range);
+                    break;
+            }
         }
+        return diag;
     }
+
+    size_t DiagnosticEngine::pending_count() const {
+        size_t total = 0;
+        for(DiagnosticBuffer* b = buffers_.load(std::memory_order_acquire); b; b = b->next){
+            total += b->records.size();
+        }
+        return total;
+    }
+
+    void DiagnosticEngine::flush() {
+        flush_buffers(nullptr);
+    }
+
+    // every buffer, or only `only`
+    void DiagnosticEngine::flush_buffers(DiagnosticBuffer* only) {
+        struct Entry {
+            const DiagnosticRecord* record;
+            // the group's primary diagnostic, for sorting
+            const DiagnosticRecord* primary;
+            uint32_t index;
+        };
+        std::vector<Entry> entries;
+        entries.reserve(only ? only->records.size() : pending_count());
+        for(DiagnosticBuffer* b = buffers_.load(std::memory_order_acquire); b; b = b->next){
+            if(only && b != only){
+                continue;
+            }
+            for(uint32_t i = 0; i < b->records.size(); ++i){
+                const DiagnosticRecord& rec = b->records[i];
+                entries.push_back({&rec, &b->records[rec.group], i});
+            }
+        }
+        // location first (file order, then offset); ties fall back to the
+        // diagnostic and its argument hash so thread scheduling never shows
+        // through, and nothing has to be formatted to sort
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            if(a.primary != b.primary){
+                const auto a_loc = a.primary->location.get_raw_encoding();
+                const auto b_loc = b.primary->location.get_raw_encoding();
+                if(a_loc != b_loc) return a_loc < b_loc;
+                if(a.primary->id != b.primary->id) return a.primary->id < b.primary->id;
+                if(a.primary->hash != b.primary->hash) return a.primary->hash < b.primary->hash;
+                return std::less<>()(a.primary, b.primary);
+            }
+            return a.index < b.index;
+        });
+
+        std::string out;
+        bool group_shown = true;
+        for(const Entry& entry : entries){
+            if(entry.record == entry.primary){
+                group_shown = true;
+                // second filtering pass, now across threads and in output order
+                const auto id_index = static_cast<size_t>(entry.record->id);
+                if(filtering_ && entry.record->severity != DiagnosticSeverity::Note){
+                    if((deduplicate_ && !seen_.insert(entry.record->hash).second) ||
+                       shown_[id_index].load(std::memory_order_relaxed) >= limits_[id_index]){
+                        suppressed_[id_index].fetch_add(1, std::memory_order_relaxed);
+                        group_shown = false;
+                    } else {
+                        shown_[id_index].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+            if(!group_shown){
+                continue;
+            }
+            deliver(materialize(*entry.record), out);
+        }
+        emit_summary(out);
+        // one write for the whole batch
+        if(!out.empty()){
+            fwrite(out.data(), 1, out.size(), stderr);
+        }
+        if(sink_ && !handler_){
+            sink_->flush();
+        }
+        for(DiagnosticBuffer* b = buffers_.load(std::memory_order_acquire); b; b = b->next){
+            if(only && b != only){
+                continue;
+            }
+            b->records.clear();
+            b->arena.reset();
+            b->current_group = DiagnosticBuffer::kNoGroup;
+        }
+    }
+
+    // "<n> diagnostics suppressed: W0901 x120, E0002 x3"
+    void DiagnosticEngine::emit_summary(std::string& out) {
+        const uint32_t total = suppressed_count();
+        if(total == summarized_){
+            return;
+        }
+        summarized_ = total;
+        DiagnosticMessage summary{DiagnosticID::note_diagnostics_suppressed,
+                                  DiagnosticSeverity::Note, SourceLocation::invalid(), {}, {}};
+        summary.message = std::to_string(total) + " diagnostics suppressed:";
+        const char* separator = " ";
+        for(size_t i = 0; i < kDiagnosticCount; ++i){
+            const uint32_t n = suppressed_[i].load(std::memory_order_relaxed);
+            if(n != 0){
+                summary.message += separator;
+                summary.message += get_diagnostic_code(static_cast<DiagnosticID>(i));
+                summary.message += " x" + std::to_string(n);
+                separator = ", ";
+            }
+        }
+        deliver(summary, out);
+    }
+
+    void DiagnosticEngine::deliver(const DiagnosticMessage& diag, std::string& out) const {
+        if(handler_){
+            handler_(diag);
+        } else if(sink_){
+            sink_->write(diag);
+        } else {
+            print(diag, out);
+        }
+    }
+
     // format: [file:] message at row:col
     std::string DiagnosticEngine::format_diagnostic(const DiagnosticMessage& diag) const {
         std::string result;
@@ -0,0 +1,192 @@
+#include "nova/Basic/DiagnosticSink.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nova {
+namespace {
+
+struct ResolvedLocation {
+    std::string_view file;
+    uint32_t line = 0;
+    uint32_t column = 0;
+};
+
+ResolvedLocation resolve(const SourceManager* sm, SourceLocation loc) {
+    ResolvedLocation out;
+    if (sm && loc.is_valid()) {
+        out.file = sm->get_filename(loc);
+        sm->get_line_column(loc, out.line, out.column);
+    }
+    return out;
+}
+
+const char* severity_name(DiagnosticSeverity severity) {
+    switch (severity) {
+    case DiagnosticSeverity::Note:
+        return "note";
+    case DiagnosticSeverity::Warning:
+        return "warning";
+    case DiagnosticSeverity::Error:
+        return "error";
+    case DiagnosticSeverity::Fatal:
+        return "fatal";
+    }
+    return "error";
+}
+
+void append_json_string(std::string& out, std::string_view text) {
+    static const char kHex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += "\\u00";
+                out += kHex[(c >> 4) & 0xF];
+                out += kHex[c & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void append_json_field(std::string& out, const char* name, uint32_t value) {
+    out += ",\"";
+    out += name;
+    out += "\":";
+    out += std::to_string(value);
+}
+
+template <typename T>
+void append_le(std::string& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out += static_cast<char>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+}
+
+} // namespace
+
+DiagnosticSink::DiagnosticSink(const SourceManager* sm, std::FILE* out, Format format)
+    : source_manager_(sm), out_(out), format_(format) {
+    buffer_.reserve(kBufferSize);
+    if (format_ == Format::Binary) {
+        buffer_.append("NOVADIAG", 8);
+        append_le<uint32_t>(buffer_, kBinaryVersion);
+    }
+}
+
+DiagnosticSink::~DiagnosticSink() { flush(); }
+
+void DiagnosticSink::write(const DiagnosticMessage& diag) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (format_ == Format::Json) {
+        write_json(diag);
+    } else {
+        write_binary(diag);
+    }
+    ++written_;
+    if (buffer_.size() >= kBufferSize) {
+        flush_locked();
+    }
+}
+
+void DiagnosticSink::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_locked();
+}
+
+void DiagnosticSink::flush_locked() {
+    if (!buffer_.empty() && out_) {
+        std::fwrite(buffer_.data(), 1, buffer_.size(), out_);
+        std::fflush(out_);
+    }
+    buffer_.clear();
+}
+
+void DiagnosticSink::write_json(const DiagnosticMessage& diag) {
+    std::string& out = buffer_;
+    out += "{\"code\":";
+    append_json_string(out, get_diagnostic_code(diag.id));
+    out += ",\"severity\":";
+    append_json_string(out, severity_name(diag.severity));
+    out += ",\"message\":";
+    append_json_string(out, diag.message);
+    if (diag.location.is_valid() && source_manager_) {
+        const ResolvedLocation loc = resolve(source_manager_, diag.location);
+        out += ",\"file\":";
+        append_json_string(out, loc.file);
+        append_json_field(out, "line", loc.line);
+        append_json_field(out, "column", loc.column);
+    }
+    out += ",\"ranges\":[";
+    for (size_t i = 0; i < diag.ranges.size(); ++i) {
+        const ResolvedLocation begin = resolve(source_manager_, diag.ranges[i].begin());
+        const ResolvedLocation end = resolve(source_manager_, diag.ranges[i].end());
+        out += i == 0 ? "{" : ",{";
+        // append_json_field leads with a comma
+        out += "\"line\":" + std::to_string(begin.line);
+        append_json_field(out, "column", begin.column);
+        append_json_field(out, "end_line", end.line);
+        append_json_field(out, "end_column", end.column);
+        out += '}';
+    }
+    out += "]}\n";
+}
+
+void DiagnosticSink::write_binary(const DiagnosticMessage& diag) {
+    std::string& out = buffer_;
+    const size_t size_at = out.size();
+    append_le<uint32_t>(out, 0); // patched below
+
+    const char* code = get_diagnostic_code(diag.id);
+    const size_t code_length = std::strlen(code);
+    const ResolvedLocation loc = resolve(source_manager_, diag.location);
+    append_le<uint8_t>(out, static_cast<uint8_t>(diag.severity));
+    append_le<uint8_t>(out, static_cast<uint8_t>(code_length));
+    out.append(code, code_length);
+    const auto file_length = static_cast<uint16_t>(std::min<size_t>(loc.file.size(), UINT16_MAX));
+    append_le<uint16_t>(out, file_length);
+    out.append(loc.file.data(), file_length);
+    append_le<uint32_t>(out, loc.line);
+    append_le<uint32_t>(out, loc.column);
+    append_le<uint32_t>(out, static_cast<uint32_t>(diag.message.size()));
+    out += diag.message;
+    // clamped like the file name, so the count always matches the payload
+    const auto range_count =
+        static_cast<uint16_t>(std::min<size_t>(diag.ranges.size(), UINT16_MAX));
+    append_le<uint16_t>(out, range_count);
+    for (size_t i = 0; i < range_count; ++i) {
+        const SourceRange& range = diag.ranges[i];
+        const ResolvedLocation begin = resolve(source_manager_, range.begin());
+        const ResolvedLocation end = resolve(source_manager_, range.end());
+        append_le<uint32_t>(out, begin.line);
+        append_le<uint32_t>(out, begin.column);
+        append_le<uint32_t>(out, end.line);
+        append_le<uint32_t>(out, end.column);
+    }
+
+    const auto record_size = static_cast<uint32_t>(out.size() - size_at - sizeof(uint32_t));
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        out[size_at + i] = static_cast<char>(record_size >> (8 * i));
+    }
+}
+
+} // namespace nova
@@ -1,15 +1,146 @@
 #include "nova/Basic/IdentifierTable.hpp"
 #include "nova/Lex/TokenKinds.hpp"
+#include <bit>
+#include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <limits>
 
 namespace nova {
+namespace {
+
+constexpr size_t kInitialCapacity = 256;
+
+uint64_t load64(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint64_t load32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// the last 1-7 bytes, read with (possibly overlapping) fixed-size loads
+// instead of a variable-length copy
+uint64_t load_tail(const char* p, size_t n) {
+    if (n >= 4) {
+        return (load32(p) << 32) | load32(p + n - 4);
+    }
+    return (static_cast<uint64_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint64_t>(static_cast<unsigned char>(p[n >> 1])) << 8) |
+           static_cast<unsigned char>(p[n - 1]);
+}
+
+uint64_t mix(uint64_t h, uint64_t mul) {
+    h *= mul;
+    return h ^ (h >> 32);
+}
+
+} // namespace
+
+    // identifiers are short: consume 8 bytes per step and mix once per step
+    uint64_t IdentifierTable::hash(std::string_view name) {
+        constexpr uint64_t kSeed = 0x9e3779b97f4a7c15ull;
+        constexpr uint64_t kMul = 0xbf58476d1ce4e5b9ull;
+        const char* p = name.data();
+        size_t n = name.size();
+        uint64_t h = kSeed ^ n;
+        for (; n > 8; n -= 8, p += 8) {
+            h = mix(h ^ load64(p), kMul);
+        }
+        if (n == 8) {
+            h = mix(h ^ load64(p), kMul);
+        } else if (n > 0) {
+            h = mix(h ^ load_tail(p, n), kMul);
+        }
+        return mix(h, kSeed);
+    }
+
+    IdentifierTable::Shard& IdentifierTable::get_shard(uint64_t name_hash) const {
+        // high bits pick the shard, low bits the slot inside it
+        return shards_[shard_count_ == 1 ? 0 : (name_hash >> 60) % shard_count_];
+    }
+
+    IdentifierInfo* IdentifierTable::create_info(Shard& shard, std::string_view name) {
+        assert(name.size() < std::numeric_limits<uint32_t>::max() && "identifier too long");
+        const uint32_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+        void* mem = shard.arena.allocate(sizeof(IdentifierInfo) + name.size() + 1,
+                                         alignof(IdentifierInfo));
+        auto* info = new (mem) IdentifierInfo(TokenKind::identifier, false,
+                                              static_cast<uint32_t>(name.size()), id);
+        char* chars = reinterpret_cast<char*>(info + 1);
+        std::memcpy(chars, name.data(), name.size());
+        chars[name.size()] = '\0';
+        publish_id(info);
+        return info;
+    }
+
+    void IdentifierTable::locate_id(uint32_t id, unsigned& segment, size_t& index) {
+        // segment k starts at kFirstIdSegment * (2^k - 1)
+        const uint64_t scaled = static_cast<uint64_t>(id) / kFirstIdSegment + 1;
+        segment = static_cast<unsigned>(std::bit_width(scaled) - 1);
+        index = id - kFirstIdSegment * ((uint64_t{1} << segment) - 1);
+    }
+
+    void IdentifierTable::publish_id(IdentifierInfo* info) {
+        unsigned segment = 0;
+        size_t index = 0;
+        locate_id(info->id, segment, index);
+        assert(segment < kIdSegments && "identifier id space exhausted");
+        std::atomic<IdentifierInfo*>* entries = id_segments_[segment].load(std::memory_order_acquire);
+        if (!entries) {
+            // several shards may race to create the segment; one wins
+            const size_t count = static_cast<size_t>(kFirstIdSegment) << segment;
+            auto* fresh = new std::atomic<IdentifierInfo*>[count];
+            for (size_t i = 0; i < count; ++i) {
+                fresh[i].store(nullptr, std::memory_order_relaxed);
+            }
+            if (id_segments_[segment].compare_exchange_strong(entries, fresh,
+                                                              std::memory_order_acq_rel)) {
+                entries = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        entries[index].store(info, std::memory_order_release);
+    }
+
+    IdentifierInfo* IdentifierTable::get_identifier(uint32_t id) const {
+        if (id >= next_id_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        unsigned segment = 0;
+        size_t index = 0;
+        locate_id(id, segment, index);
+        std::atomic<IdentifierInfo*>* entries = id_segments_[segment].load(std::memory_order_acquire);
+        return entries ? entries[index].load(std::memory_order_acquire) : nullptr;
+    }
+
+    IdentifierTable::~IdentifierTable() {
+        for (auto& segment : id_segments_) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    // runs before the table can be shared, so updating the info is safe
     void IdentifierTable::add_keyword(const char* name, TokenKind kind) {
-        auto info = std::make_unique<IdentifierInfo>(name, kind, true);
-        table_.emplace(info->name, info.get());  // Use string as key
-        storage_.push_back(std::move(info));
+        IdentifierInfo* info = intern(name);
+        info->token_kind = kind;
+        info->is_keyword = true;
+        keyword_infos_[static_cast<size_t>(kind)] = info;
     }
 
-    IdentifierTable::IdentifierTable() {
+    IdentifierTable::IdentifierTable(bool concurrent)
+        : shard_count_(concurrent ? kConcurrentShards : 1), concurrent_(concurrent) {
+        static_assert((kConcurrentShards & (kConcurrentShards - 1)) == 0 &&
+                      kConcurrentShards <= 16, "shard index uses the top 4 hash bits");
+        shards_ = std::make_unique<Shard[]>(shard_count_);
+        for (unsigned i = 0; i < shard_count_; ++i) {
+            shards_[i].slots.assign(kInitialCapacity / shard_count_, Slot{nullptr, 0});
+        }
         // Seed the table with reserved keywords/type-keywords.
 #define NOVA_KEYWORD(name, spelling) add_keyword(spelling, TokenKind::name);
 #define NOVA_TYPE_KEYWORD(name, spelling) add_keyword(spelling, TokenKind::name);
@@ -24,18 +155,69 @@ namespace nova {
 #undef NOVA_KEYWORD
 	    }
 
-    void IdentifierTable::add_identifier(std::string_view name) {
-        auto info = std::make_unique<IdentifierInfo>(std::string(name), TokenKind::identifier, false);
-        table_.emplace(info->name, info.get());
-        storage_.push_back(std::move(info));
+    IdentifierInfo* IdentifierTable::intern(std::string_view name, uint64_t name_hash) {
+        Shard& shard = get_shard(name_hash);
+        auto guard = lock(shard);
+        const size_t mask = shard.slots.size() - 1;
+        for (size_t i = name_hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = shard.slots[i];
+            if (!slot.info) {
+                IdentifierInfo* info = create_info(shard, name);
+                slot = Slot{info, name_hash};
+                // keep the load factor at or below 3/4
+                if (++shard.size * 4 > shard.slots.size() * 3) {
+                    grow(shard);
+                }
+                return info;
+            }
+            if (slot.hash == name_hash && slot.info->get_name() == name) {
+                return slot.info;
+            }
+        }
+    }
+
+    IdentifierInfo* IdentifierTable::get(std::string_view name) const {
+        const uint64_t name_hash = hash(name);
+        Shard& shard = get_shard(name_hash);
+        auto guard = lock(shard);
+        const size_t mask = shard.slots.size() - 1;
+        for (size_t i = name_hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = shard.slots[i];
+            if (!slot.info) {
+                return nullptr;
+            }
+            if (slot.hash == name_hash && slot.info->get_name() == name) {
+                return slot.info;
+            }
+        }
+    }
+
+    void IdentifierTable::grow(Shard& shard) {
+        std::vector<Slot> old(shard.slots.size() * 2, Slot{nullptr, 0});
+        old.swap(shard.slots);
+        const size_t mask = shard.slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (!slot.info) {
+                continue;
+            }
+            size_t i = slot.hash & mask;
+            while (shard.slots[i].info) {
+                i = (i + 1) & mask;
+            }
+            shard.slots[i] = slot;
+        }
     }
-    //
-    IdentifierInfo* IdentifierTable::get(std::string_view name) {
-        // C++20 transparent lookup - can search with string_view in string map
-        auto it = table_.find(name);
-        if (it != table_.end()) {
-            return it->second;
+
+    size_t IdentifierTable::memory_bytes() const {
+        size_t bytes = shard_count_ * sizeof(Shard);
+        for (unsigned i = 0; i < kIdSegments; ++i) {
+            if (id_segments_[i].load(std::memory_order_relaxed)) {
+                bytes += (static_cast<size_t>(kFirstIdSegment) << i) * sizeof(IdentifierInfo*);
+            }
+        }
+        for (unsigned i = 0; i < shard_count_; ++i) {
+            bytes += shards_[i].slots.capacity() * sizeof(Slot) + shards_[i].arena.bytes_reserved();
         }
-        return nullptr;
+        return bytes;
     }
 }
@@ -0,0 +1,166 @@
+#include "nova/Basic/LineTable.hpp"
+#include "nova/Basic/CPUFeatures.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define NOVA_LINE_TABLE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NOVA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NOVA_TARGET_AVX2
+#endif
+
+namespace nova {
+namespace {
+
+// Bit i of the result is set if p[i] == '\n', for a 64-byte block.
+using NewlineMaskFn = uint64_t (*)(const char* p);
+
+uint64_t newline_mask_scalar(const char* p) {
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 64; ++i) {
+        mask |= static_cast<uint64_t>(p[i] == '\n') << i;
+    }
+    return mask;
+}
+
+#if defined(NOVA_LINE_TABLE_X86)
+uint64_t newline_mask_sse2(const char* p) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        const auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+        mask |= static_cast<uint64_t>(bits) << (i * 16);
+    }
+    return mask;
+}
+
+NOVA_TARGET_AVX2 uint64_t newline_mask_avx2(const char* p) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    const auto lo_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, nl)));
+    const auto hi_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, nl)));
+    return static_cast<uint64_t>(lo_bits) | (static_cast<uint64_t>(hi_bits) << 32);
+}
+#endif
+
+NewlineMaskFn select_newline_kernel() {
+    switch (get_active_simd_level()) {
+#if defined(NOVA_LINE_TABLE_X86)
+    case SIMDLevel::AVX2:
+        return newline_mask_avx2;
+    case SIMDLevel::SSE2:
+        return newline_mask_sse2;
+#endif
+    default:
+        return newline_mask_scalar;
+    }
+}
+
+} // namespace
+
+void LineTable::append_line(uint32_t offset, uint32_t& previous) {
+    if (deltas_.size() % kLinesPerChunk == 0) {
+        chunks_.push_back({offset, static_cast<uint32_t>(long_deltas_.size())});
+        deltas_.push_back(0);
+    } else {
+        const uint32_t delta = offset - previous;
+        if (delta >= kLongDelta) {
+            deltas_.push_back(kLongDelta);
+            long_deltas_.push_back(delta);
+        } else {
+            deltas_.push_back(static_cast<uint16_t>(delta));
+        }
+    }
+    previous = offset;
+}
+
+LineTable LineTable::build(std::string_view text) {
+    LineTable table;
+    const NewlineMaskFn newline_mask = select_newline_kernel();
+    uint32_t previous = 0;
+    // first line starts at offset 0
+    table.append_line(0, previous);
+
+    const char* base = text.data();
+    const size_t size = text.size();
+    size_t pos = 0;
+    for (; pos + 64 <= size; pos += 64) {
+        uint64_t mask = newline_mask(base + pos);
+        while (mask) {
+            const auto bit = static_cast<uint32_t>(std::countr_zero(mask));
+            table.append_line(static_cast<uint32_t>(pos + bit + 1), previous);
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < size; ++pos) {
+        if (base[pos] == '\n') {
+            table.append_line(static_cast<uint32_t>(pos + 1), previous);
+        }
+    }
+
+    table.chunks_.shrink_to_fit();
+    table.deltas_.shrink_to_fit();
+    table.long_deltas_.shrink_to_fit();
+    return table;
+}
+
+uint32_t LineTable::get_line_start(uint32_t line_index) const {
+    if (line_index >= line_count()) {
+        return 0;
+    }
+    const Chunk& chunk = chunks_[line_index / kLinesPerChunk];
+    const uint32_t first_line = line_index / kLinesPerChunk * kLinesPerChunk;
+    uint32_t start = chunk.first_offset;
+    uint32_t long_index = chunk.first_long_delta;
+    for (uint32_t i = first_line + 1; i <= line_index; ++i) {
+        const uint16_t delta = deltas_[i];
+        start += (delta == kLongDelta) ? long_deltas_[long_index++] : delta;
+    }
+    return start;
+}
+
+void LineTable::get_line_column(uint32_t offset, uint32_t& line, uint32_t& column) const {
+    if (chunks_.empty()) {
+        line = 1;
+        column = offset + 1;
+        return;
+    }
+    // last chunk whose first line starts at or before offset
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), offset,
+                               [](uint32_t value, const Chunk& chunk) {
+                                   return value < chunk.first_offset;
+                               });
+    const auto chunk_index = static_cast<uint32_t>((it - chunks_.begin()) - 1);
+    const Chunk& chunk = chunks_[chunk_index];
+
+    uint32_t line_index = chunk_index * kLinesPerChunk;
+    const uint32_t chunk_end = std::min(line_index + kLinesPerChunk, line_count());
+    uint32_t start = chunk.first_offset;
+    uint32_t long_index = chunk.first_long_delta;
+    for (uint32_t i = line_index + 1; i < chunk_end; ++i) {
+        const uint16_t delta = deltas_[i];
+        const uint32_t next = start + ((delta == kLongDelta) ? long_deltas_[long_index++] : delta);
+        if (next > offset) {
+            break;
+        }
+        start = next;
+        line_index = i;
+    }
+    line = line_index + 1; //line number is 1-based
+    column = offset - start + 1; //column number is 1-based
+}
+
+size_t LineTable::memory_bytes() const {
+    return chunks_.capacity() * sizeof(Chunk) + deltas_.capacity() * sizeof(uint16_t) +
+           long_deltas_.capacity() * sizeof(uint32_t);
+}
+
+} // namespace nova
@@ -0,0 +1,89 @@
+#include "nova/Basic/MappedFile.hpp"
+
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NOVA_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nova {
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+void MappedFile::unmap() {
+#if defined(NOVA_HAS_MMAP)
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool MappedFile::map(const std::string& path, bool needs_sentinel) {
+    unmap();
+    needs_fallback_ = false;
+#if defined(NOVA_HAS_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    // no room for the sentinel in the last page (this includes empty files);
+    // empty files cannot be mapped either way
+    if (size == 0 || (needs_sentinel && size % page_size == 0)) {
+        ::close(fd);
+        needs_fallback_ = true;
+        return false;
+    }
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        needs_fallback_ = true;
+        return false;
+    }
+    if (needs_sentinel) {
+        // the lexer walks the buffer front to back exactly once
+        ::madvise(addr, size, MADV_SEQUENTIAL);
+    }
+    data_ = static_cast<const char*>(addr);
+    size_ = size;
+    return true;
+#else
+    (void)path;
+    (void)needs_sentinel;
+    needs_fallback_ = true;
+    return false;
+#endif
+}
+
+bool MappedFile::read_file(const std::string& path, std::string& out) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    out.clear();
+    char buffer[64 * 1024];
+    size_t n = 0;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        out.append(buffer, n);
+    }
+    const bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace nova
@@ -1,29 +1,112 @@
 #include "nova/Basic/SourceManager.hpp"
 #include "nova/Basic/SourceLocation.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <limits>
 namespace nova {
-    FileEntry::FileEntry(uint16_t id, std::string name, std::string data)
-        : filename(std::move(name)), content(std::move(data)),file_id(id) {
-            compute_line_offsets();
+    FileEntry::FileEntry(FileID id, SourceLocation start, std::string name, std::string data)
+        : filename(std::move(name)), file_id(id), start_loc(start),
+          owned_content_(std::move(data)) {
+            // std::string keeps a '\0' after its last character
+            content = owned_content_;
     }
-    void FileEntry::compute_line_offsets(){
-        line_offsets.clear();
-        // first line starts at offset 0
-        line_offsets.push_back(0);
-        for(size_t i=0;i<content.size();++i){
-            if(content[i]=='\n'){
-                line_offsets.push_back(static_cast<uint32_t>(i+1));
-            }
+    FileEntry::FileEntry(FileID id, SourceLocation start, std::string name,
+                         std::unique_ptr<MappedFile> mapped)
+        : filename(std::move(name)), file_id(id), start_loc(start), mapped_(std::move(mapped)) {
+            // MappedFile only maps files whose last page holds the sentinel
+            content = mapped_->contents();
+    }
+    const LineTable& FileEntry::get_line_table() const{
+        std::call_once(line_table_once_,[this]{
+            line_table_ = LineTable::build(content);
+            line_table_built_.store(true,std::memory_order_release);
+        });
+        return line_table_;
+    }
+
+    // reserve size + 1 addresses (the last one is the EOF location) for
+    // `file_id`; new ranges are always the highest, so ranges_ stays sorted
+    bool SourceManager::allocate_range(size_t size, FileID file_id, SourceLocation& start){
+        using RawType = SourceLocation::RawType;
+        if(size >= std::numeric_limits<uint32_t>::max()){
+            return false;
         }
+        const RawType remaining = std::numeric_limits<RawType>::max() - next_address_;
+        if(static_cast<uint64_t>(size) >= remaining){
+            return false;
+        }
+        start = SourceLocation::from_raw_encoding(next_address_);
+        next_address_ += static_cast<RawType>(size) + 1;
+        ranges_.push_back({start.get_raw_encoding(), static_cast<RawType>(size), file_id});
+        return true;
     }
 
-    uint16_t SourceManager::add_file(std::string filename, std::string content){
-        uint16_t file_id =static_cast<uint16_t>(files_.size()+1);
-        files_.emplace_back(std::make_unique<FileEntry>(file_id,std::move(filename),std::move(content)));
+    FileID SourceManager::add_file(std::string filename, std::string content){
+        SourceLocation start;
+        FileID file_id =static_cast<FileID>(files_.size()+1);
+        if(!allocate_range(content.size(),file_id,start)){
+            return 0;
+        }
+        files_.emplace_back(std::make_unique<FileEntry>(file_id,start,std::move(filename),std::move(content)));
         return file_id;
     } 
-    const FileEntry* SourceManager::get_file(uint16_t file_id) const{
+    FileID SourceManager::add_file_mapped(const std::string& path){
+        auto mapped = std::make_unique<MappedFile>();
+        if(mapped->map(path)){
+            SourceLocation start;
+            FileID file_id = static_cast<FileID>(files_.size()+1);
+            if(!allocate_range(mapped->contents().size(),file_id,start)){
+                return 0;
+            }
+            files_.emplace_back(std::make_unique<FileEntry>(file_id,start,path,std::move(mapped)));
+            return file_id;
+        }
+        if(!mapped->needs_fallback()){
+            return 0;
+        }
+        std::string content;
+        if(!MappedFile::read_file(path,content)){
+            return 0;
+        }
+        return add_file(path,std::move(content));
+    }
+    bool SourceManager::apply_edit(FileID file_id, const TextEdit& edit){
+        const FileEntry* file = get_file(file_id);
+        if(!file || static_cast<uint64_t>(edit.offset) + edit.removed_length > file->content.size()){
+            return false;
+        }
+        const uint64_t new_size =
+            file->content.size() - edit.removed_length + edit.inserted_text.size();
+        const auto raw_start = file->start_loc.get_raw_encoding();
+        auto range = std::lower_bound(ranges_.begin(), ranges_.end(), raw_start,
+                                      [](const AddressRange& r, SourceLocation::RawType raw){
+                                          return r.start < raw;
+                                      });
+        const size_t range_index = static_cast<size_t>(range - ranges_.begin());
+        SourceLocation start = file->start_loc;
+        if(new_size > range->size){
+            // outgrown: move to new addresses with room to grow, so a run of
+            // insertions moves the file a logarithmic number of times
+            if(!allocate_range(new_size + new_size / 2 + 4096,file_id,start) &&
+               !allocate_range(new_size,file_id,start)){
+                return false;
+            }
+            ranges_.erase(ranges_.begin() + static_cast<std::ptrdiff_t>(range_index));
+        }
+        std::unique_ptr<FileEntry>& entry = files_[file_id-1];
+        // a mapped file gets an owned copy on its first edit; after that the
+        // text is edited in place
+        std::string content = entry->is_mapped() ? std::string(entry->content)
+                                                 : std::move(entry->owned_content_);
+        content.replace(edit.offset,edit.removed_length,edit.inserted_text);
+        // a new entry, as the line table of the old text cannot be reset
+        entry = std::make_unique<FileEntry>(file_id,start,std::move(entry->filename),
+                                            std::move(content));
+        return true;
+    }
+    const FileEntry* SourceManager::get_file(FileID file_id) const{
         if(file_id==0 || file_id > files_.size()){
             return nullptr;
         } 
@@ -31,25 +114,75 @@ namespace nova {
         //while files_ is 0-based index
         return files_[file_id-1].get();
     }
+
+    SourceLocation SourceManager::get_location(FileID file_id, uint32_t offset) const{
+        const FileEntry* file = get_file(file_id);
+        if(!file || offset > file->content.size()){
+            return SourceLocation::invalid();
+        }
+        return file->get_location(offset);
+    }
+    // find the file whose address range contains loc
+    FileID SourceManager::get_file_id(SourceLocation loc) const{
+        const auto raw = loc.get_raw_encoding();
+        if(loc.is_invalid() || raw >= next_address_){
+            return 0;
+        }
+        FileID cached = last_lookup_.load(std::memory_order_relaxed);
+        if(cached != 0 && cached <= files_.size()){
+            const FileEntry* file = files_[cached-1].get();
+            const auto start = file->start_loc.get_raw_encoding();
+            if(raw >= start && raw - start <= file->content.size()){
+                return cached;
+            }
+        }
+        //last range start <= raw
+        auto it = std::upper_bound(ranges_.begin(), ranges_.end(), raw,
+                                   [](SourceLocation::RawType raw, const AddressRange& r){
+                                       return raw < r.start;
+                                   });
+        if(it == ranges_.begin()){
+            return 0;
+        }
+        --it;
+        //addresses moved away from by an edited file, or not used by it yet
+        if(raw - it->start > files_[it->file_id-1]->content.size()){
+            return 0;
+        }
+        last_lookup_.store(it->file_id, std::memory_order_relaxed);
+        return it->file_id;
+    }
+    uint32_t SourceManager::get_file_offset(SourceLocation loc) const{
+        const FileEntry* file = get_file_for(loc);
+        if(!file){
+            return 0;
+        }
+        return static_cast<uint32_t>(loc.get_raw_encoding() - file->start_loc.get_raw_encoding());
+    }
     // get char at source location from source file
     char SourceManager::get_char(SourceLocation loc) const{
-        const FileEntry* file = get_file(loc.get_file_id());
+        const FileEntry* file = get_file_for(loc);
         if(!file){
             return '\0';
         }
-        uint32_t offset = loc.get_offset();
+        uint32_t offset = get_file_offset(loc);
         if(offset >= file->content.size()){
             return '\0';
         }
         return file->content[offset];
     }
     std::string_view SourceManager::get_text(SourceRange range) const{
-        const FileEntry* file = get_file(range.begin().get_file_id());
+        const FileEntry* file = get_file_for(range.begin());
         if(!file){
             return {};
         }
-        uint32_t begin_offset = range.begin().get_offset();
-        uint32_t end_offset = range.end().get_offset();
+        //the range must stay inside one file
+        if(range.end() < range.begin() ||
+           range.end().get_raw_encoding() - file->start_loc.get_raw_encoding() > file->content.size()){
+            return {};
+        }
+        uint32_t begin_offset = get_file_offset(range.begin());
+        uint32_t end_offset = get_file_offset(range.end());
         //end of string is '
         if(begin_offset >= file->content.size() || end_offset > file->content.size()|| begin_offset > end_offset){
             return {};
@@ -58,34 +191,17 @@ namespace nova {
     }
 
     void SourceManager::get_line_column(SourceLocation loc, uint32_t& line, uint32_t& column) const{
-        const FileEntry* file =get_file(loc.get_file_id());
+        const FileEntry* file =get_file_for(loc);
         if(!file){
             line = 0;
             column = 0;
             return;
         }
-        uint32_t offset = loc.get_offset();
-        //binary search for line number
-        //find the largest line_offsets[i] <= offset
-        //size_t is too large for comparison with uint32_t
-        uint32_t left=0;
-        uint32_t right = static_cast<uint32_t>(file->line_offsets.size());
-        uint32_t pos = 0;
-        while(left < right){
-            uint32_t mid = left + (right - left)/2;
-            if(file->line_offsets[mid] <= offset){
-                pos = mid;
-                left = mid + 1;
-            }else {
-                right = mid;
-            }
-        }
-        line = pos + 1; //line number is 1-based
-        column = offset - file->line_offsets[pos] + 1; //column number is 1-based
+        file->get_line_table().get_line_column(get_file_offset(loc), line, column);
     }
 
     std::string_view SourceManager::get_filename(SourceLocation loc) const{
-        const FileEntry* file =get_file(loc.get_file_id());
+        const FileEntry* file =get_file_for(loc);
         if(!file){
             return {};
         }
@@ -93,7 +209,7 @@ namespace nova {
     }
     //format source location as "filename:line:column"
     std::string SourceManager::format_location(SourceLocation loc) const{
-        const FileEntry* file =get_file(loc.get_file_id());
+        const FileEntry* file =get_file_for(loc);
         if(!file){
             return "<invalid location>";
         }
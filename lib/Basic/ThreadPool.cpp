@@ -0,0 +1,132 @@
+#include "nova/Basic/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace nova {
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_epoch_.fetch_add(1, std::memory_order_release);
+    work_epoch_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+        ++pending_;
+    }
+    work_epoch_.fetch_add(1, std::memory_order_release);
+    work_epoch_.notify_one();
+}
+
+bool ThreadPool::run_one(std::unique_lock<std::mutex>& lock) {
+    if (queue_.empty()) {
+        return false;
+    }
+    std::function<void()> task = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+    --pending_;
+    // parallel_for callers wait for their own tasks, not for an empty pool
+    done_epoch_.fetch_add(1, std::memory_order_release);
+    done_epoch_.notify_all();
+    return true;
+}
+
+void ThreadPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (run_one(lock)) {
+            continue;
+        }
+        if (stopping_) {
+            return;
+        }
+        const uint32_t epoch = work_epoch_.load(std::memory_order_acquire);
+        lock.unlock();
+        work_epoch_.wait(epoch, std::memory_order_acquire);
+        lock.lock();
+    }
+}
+
+// sleep until a task finishes unless one already did after `epoch` was read
+void ThreadPool::wait_for_done(std::unique_lock<std::mutex>& lock, uint32_t epoch) {
+    lock.unlock();
+    done_epoch_.wait(epoch, std::memory_order_acquire);
+    lock.lock();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        const uint32_t epoch = done_epoch_.load(std::memory_order_acquire);
+        if (run_one(lock)) {
+            continue;
+        }
+        if (pending_ == 0) {
+            return;
+        }
+        wait_for_done(lock, epoch);
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    auto drain = [&] {
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            fn(i);
+        }
+    };
+    // only this call's helpers are awaited, so parallel_for may be nested
+    // inside a pool task without waiting on itself
+    const size_t helpers = std::min(workers_.size(), count - 1);
+    size_t finished = 0; // guarded by mutex_
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([&] {
+            drain();
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++finished;
+        });
+    }
+    drain();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (finished < helpers) {
+        const uint32_t epoch = done_epoch_.load(std::memory_order_acquire);
+        if (!run_one(lock) && finished < helpers) {
+            wait_for_done(lock, epoch);
+        }
+    }
+}
+
+} // namespace nova
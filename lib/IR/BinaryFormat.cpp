@@ -0,0 +1,668 @@
+#include "nova/IR/BinaryFormat.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace nova {
+namespace ir {
+
+namespace {
+
+constexpr char kMagic[8] = {'N', 'O', 'V', 'A', 'I', 'R', 'M', 'D'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + 5 * sizeof(uint32_t);
+constexpr uint32_t kTypeCount = static_cast<uint32_t>(Type::Unit) + 1;
+static_assert(static_cast<uint32_t>(Opcode::count) <= 32 && kTypeCount <= 8,
+              "an opcode and a type must share one byte");
+
+template <typename T>
+void append_le(std::string& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out += static_cast<char>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+}
+
+void append_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Strings in order of first use; equal strings share one entry.
+class StringTable {
+private:
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, uint32_t> index_;
+
+public:
+    uint32_t intern(std::string_view text) {
+        const auto [it, inserted] =
+            index_.try_emplace(text, static_cast<uint32_t>(strings_.size()));
+        if (inserted) {
+            strings_.push_back(text);
+        }
+        return it->second;
+    }
+    const std::vector<std::string_view>& get_strings() const { return strings_; }
+};
+
+// Encodes one function body, with value IDs renumbered in layout order.
+class BodyWriter {
+private:
+    std::string& out_;
+    StringTable& strings_;
+    std::vector<uint32_t> ids_; // by value ID in the function
+
+public:
+    BodyWriter(std::string& out, StringTable& strings) : out_(out), strings_(strings) {}
+
+    void write(const Function& func) {
+        ids_.assign(func.get_value_count(), 0);
+        uint32_t next = 0;
+        for (const Argument* arg : func.get_args()) {
+            ids_[arg->get_id()] = next++;
+        }
+        for (const BasicBlock* block : func.get_blocks()) {
+            for (const Instruction* inst : block->get_instructions()) {
+                ids_[inst->get_id()] = next++;
+            }
+        }
+
+        append_varint(out_, func.get_blocks().size());
+        for (const BasicBlock* block : func.get_blocks()) {
+            append_varint(out_, strings_.intern(block->get_label()));
+        }
+        for (const BasicBlock* block : func.get_blocks()) {
+            uint32_t count = 0;
+            for (const Instruction* inst : block->get_instructions()) {
+                (void)inst;
+                ++count;
+            }
+            append_varint(out_, count);
+            for (const Instruction* inst : block->get_instructions()) {
+                write_instruction(inst);
+            }
+        }
+    }
+
+private:
+    void write_operand(const Instruction* user, const Value* value) {
+        if (!value) {
+            out_ += '\0';
+            return;
+        }
+        const int64_t delta = static_cast<int64_t>(ids_[user->get_id()]) -
+                              static_cast<int64_t>(ids_[value->get_id()]);
+        append_varint(out_, zigzag(delta) + 1);
+    }
+
+    void write_block(const BasicBlock* block) {
+        append_varint(out_, block ? static_cast<uint64_t>(block->get_index()) + 1 : 0);
+    }
+
+    void write_operands(const Instruction* inst) {
+        for (const Use& use : inst->get_operands()) {
+            write_operand(inst, use.get());
+        }
+    }
+
+    void write_instruction(const Instruction* inst) {
+        out_ += static_cast<char>(static_cast<uint8_t>(inst->get_opcode()) |
+                                  static_cast<uint8_t>(inst->get_type()) << 5);
+        switch (inst->get_opcode()) {
+        case Opcode::ConstI64:
+            append_varint(out_, zigzag(inst->get_i64()));
+            break;
+        case Opcode::ConstU64:
+            append_varint(out_, inst->get_u64());
+            break;
+        case Opcode::ConstF64: {
+            uint64_t bits = 0;
+            const double value = inst->get_f64();
+            std::memcpy(&bits, &value, sizeof(bits));
+            append_le<uint64_t>(out_, bits);
+            break;
+        }
+        case Opcode::ConstBool:
+            out_ += static_cast<char>(inst->get_bool());
+            break;
+        case Opcode::ConstUnit:
+        case Opcode::Unreachable:
+            break;
+        case Opcode::ICmp:
+        case Opcode::FCmp:
+            out_ += static_cast<char>(inst->get_predicate());
+            write_operands(inst);
+            break;
+        case Opcode::Call:
+            append_varint(out_, inst->get_callee()->get_index());
+            append_varint(out_, inst->get_operand_count());
+            write_operands(inst);
+            break;
+        case Opcode::Phi:
+            append_varint(out_, inst->get_incoming_count());
+            for (uint32_t i = 0; i < inst->get_incoming_count(); ++i) {
+                write_operand(inst, inst->get_incoming_value(i));
+                write_block(inst->get_incoming_block(i));
+            }
+            break;
+        case Opcode::Ret:
+            append_varint(out_, inst->get_operand_count());
+            write_operands(inst);
+            break;
+        case Opcode::Br:
+            write_block(inst->get_blocks()[0]);
+            break;
+        case Opcode::CondBr:
+            write_operands(inst);
+            write_block(inst->get_blocks()[0]);
+            write_block(inst->get_blocks()[1]);
+            break;
+        default:
+            // binary arithmetic
+            write_operands(inst);
+            break;
+        }
+    }
+};
+
+// Bounds-checked reads; after the first read past the end every read
+// returns 0 and ok() is false.
+class Cursor {
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    bool ok_ = true;
+
+public:
+    explicit Cursor(std::string_view data)
+        : pos_(reinterpret_cast<const uint8_t*>(data.data())), end_(pos_ + data.size()) {}
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+
+    bool fail() {
+        ok_ = false;
+        pos_ = end_;
+        return false;
+    }
+    bool skip(uint64_t count) {
+        if (count > remaining()) {
+            return fail();
+        }
+        pos_ += count;
+        return true;
+    }
+
+    uint8_t read_u8() {
+        if (pos_ == end_) {
+            fail();
+            return 0;
+        }
+        return *pos_++;
+    }
+    template <typename T>
+    T read_le() {
+        if (remaining() < sizeof(T)) {
+            fail();
+            return 0;
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<uint64_t>(pos_[i]) << (8 * i);
+        }
+        pos_ += sizeof(T);
+        return static_cast<T>(value);
+    }
+    uint64_t read_varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = read_u8();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        fail();
+        return 0;
+    }
+    uint32_t read_varint32() {
+        const uint64_t value = read_varint();
+        if (value > UINT32_MAX) {
+            fail();
+            return 0;
+        }
+        return static_cast<uint32_t>(value);
+    }
+    /// A count of items of at least one byte each, so a corrupt count cannot
+    /// ask for more memory than the input could describe.
+    uint32_t read_count() {
+        const uint32_t count = read_varint32();
+        if (count > remaining()) {
+            fail();
+            return 0;
+        }
+        return count;
+    }
+};
+
+} // namespace
+
+void write_module(const Module& module, std::string& out) {
+    StringTable strings;
+    strings.intern(module.get_name());
+
+    // one type table entry per distinct signature
+    std::unordered_map<std::string, uint32_t> signatures;
+    std::string types;
+    std::string functions;
+    std::string bodies;
+    BodyWriter body_writer(bodies, strings);
+    for (const auto& func : module.get_functions()) {
+        std::string key(1, static_cast<char>(func->get_return_type()));
+        for (Type type : func->get_param_types()) {
+            key += static_cast<char>(type);
+        }
+        const auto [it, inserted] =
+            signatures.try_emplace(std::move(key), static_cast<uint32_t>(signatures.size()));
+        if (inserted) {
+            types += static_cast<char>(func->get_return_type());
+            append_varint(types, func->get_param_types().size());
+            for (Type type : func->get_param_types()) {
+                types += static_cast<char>(type);
+            }
+        }
+        const size_t start = bodies.size();
+        body_writer.write(*func);
+        append_varint(functions, strings.intern(func->get_name()));
+        append_varint(functions, it->second);
+        append_varint(functions, bodies.size() - start);
+    }
+
+    size_t string_data_size = 0;
+    for (std::string_view text : strings.get_strings()) {
+        string_data_size += text.size();
+    }
+    assert(string_data_size <= UINT32_MAX && "string table too large");
+
+    out.append(kMagic, sizeof(kMagic));
+    append_le<uint32_t>(out, kModuleFormatVersion);
+    append_le<uint32_t>(out, static_cast<uint32_t>(strings.get_strings().size()));
+    append_le<uint32_t>(out, static_cast<uint32_t>(signatures.size()));
+    append_le<uint32_t>(out, static_cast<uint32_t>(module.get_functions().size()));
+    append_le<uint32_t>(out, static_cast<uint32_t>(string_data_size));
+    uint32_t offset = 0;
+    append_le<uint32_t>(out, offset);
+    for (std::string_view text : strings.get_strings()) {
+        offset += static_cast<uint32_t>(text.size());
+        append_le<uint32_t>(out, offset);
+    }
+    for (std::string_view text : strings.get_strings()) {
+        out += text;
+    }
+    out += types;
+    out += functions;
+    out += bodies;
+}
+
+bool write_module_file(const Module& module, const std::string& path) {
+    std::string bytes;
+    write_module(module, bytes);
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+bool ModuleReader::fail(std::string message) {
+    error_ = std::move(message);
+    return false;
+}
+
+bool ModuleReader::load_file(const std::string& path) {
+    buffer_.clear();
+    if (file_.map(path, /*needs_sentinel=*/false)) {
+        data_ = file_.contents();
+    } else if (file_.needs_fallback() && MappedFile::read_file(path, buffer_)) {
+        data_ = buffer_;
+    } else {
+        return fail("cannot read '" + path + "'");
+    }
+    return load();
+}
+
+bool ModuleReader::load_buffer(std::string contents) {
+    buffer_ = std::move(contents);
+    data_ = buffer_;
+    return load();
+}
+
+std::string_view ModuleReader::get_string(uint32_t index) const {
+    // the offsets were checked by load()
+    Cursor offsets(data_.substr(string_offsets_ + static_cast<uint64_t>(index) * 4, 8));
+    const uint32_t begin = offsets.read_le<uint32_t>();
+    const uint32_t end = offsets.read_le<uint32_t>();
+    return data_.substr(string_data_ + begin, end - begin);
+}
+
+bool ModuleReader::load() {
+    module_.reset();
+    bodies_.clear();
+    materialized_count_ = 0;
+    error_.clear();
+
+    if (data_.size() < kHeaderSize || std::memcmp(data_.data(), kMagic, sizeof(kMagic)) != 0) {
+        return fail("not a Nova IR module");
+    }
+    Cursor in(data_);
+    in.skip(sizeof(kMagic));
+    const auto version = in.read_le<uint32_t>();
+    if (version != kModuleFormatVersion) {
+        return fail("unsupported Nova IR module version " + std::to_string(version));
+    }
+    string_count_ = in.read_le<uint32_t>();
+    const auto type_count = in.read_le<uint32_t>();
+    const auto function_count = in.read_le<uint32_t>();
+    string_data_size_ = in.read_le<uint32_t>();
+
+    // string table: offsets, then the data
+    string_offsets_ = kHeaderSize;
+    if (string_count_ == 0 || !in.skip((static_cast<uint64_t>(string_count_) + 1) * 4)) {
+        return fail("truncated string table");
+    }
+    string_data_ = string_offsets_ + (static_cast<uint64_t>(string_count_) + 1) * 4;
+    if (!in.skip(string_data_size_)) {
+        return fail("truncated string table");
+    }
+    Cursor offsets(data_.substr(string_offsets_));
+    uint32_t previous = offsets.read_le<uint32_t>();
+    if (previous != 0) {
+        return fail("malformed string table");
+    }
+    for (uint32_t i = 0; i < string_count_; ++i) {
+        const uint32_t next = offsets.read_le<uint32_t>();
+        if (next < previous || next > string_data_size_) {
+            return fail("malformed string table");
+        }
+        previous = next;
+    }
+
+    struct Signature {
+        Type return_type;
+        std::vector<Type> params;
+    };
+    std::vector<Signature> signatures(type_count <= in.remaining() ? type_count : 0);
+    if (signatures.size() != type_count) {
+        return fail("truncated type table");
+    }
+    for (Signature& signature : signatures) {
+        const uint8_t return_type = in.read_u8();
+        const uint32_t param_count = in.read_count();
+        if (return_type >= kTypeCount) {
+            return fail("malformed type table");
+        }
+        signature.return_type = static_cast<Type>(return_type);
+        for (uint32_t i = 0; i < param_count; ++i) {
+            const uint8_t type = in.read_u8();
+            if (type >= kTypeCount) {
+                return fail("malformed type table");
+            }
+            signature.params.push_back(static_cast<Type>(type));
+        }
+    }
+    if (!in.ok()) {
+        return fail("truncated type table");
+    }
+
+    module_ = std::make_unique<Module>(std::string(get_string(0)));
+    if (function_count > in.remaining()) {
+        return fail("truncated function table");
+    }
+    bodies_.resize(function_count);
+    uint64_t body_offset = 0;
+    for (Body& body : bodies_) {
+        const uint32_t name = in.read_varint32();
+        const uint32_t type = in.read_varint32();
+        body.offset = body_offset;
+        body.size = in.read_varint();
+        if (!in.ok() || name >= string_count_ || type >= type_count ||
+            body.size > data_.size() - body_offset) {
+            return fail("malformed function table");
+        }
+        body_offset += body.size;
+        const Signature& signature = signatures[type];
+        if (!module_->create_function(std::string(get_string(name)), signature.params,
+                                      signature.return_type)) {
+            return fail("duplicate function '" + std::string(get_string(name)) + "'");
+        }
+    }
+    const uint64_t body_base = data_.size() - in.remaining();
+    if (body_offset != in.remaining()) {
+        return fail("function bodies do not match the function table");
+    }
+    for (Body& body : bodies_) {
+        body.offset += body_base;
+    }
+    return true;
+}
+
+bool ModuleReader::materialize(Function* func) {
+    assert(func->get_parent() == module_.get() && "function of another module");
+    Body& body = bodies_[func->get_index()];
+    if (body.materialized) {
+        return true;
+    }
+    if (!decode_body(func, data_.substr(body.offset, body.size))) {
+        func->clear_body();
+        return fail("malformed body of function '" + std::string(func->get_name()) + "'");
+    }
+    body.materialized = true;
+    ++materialized_count_;
+    return true;
+}
+
+bool ModuleReader::materialize_all() {
+    if (!module_) {
+        return false;
+    }
+    for (const auto& func : module_->get_functions()) {
+        if (!materialize(func.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModuleReader::decode_body(Function* func, std::string_view bytes) {
+    Cursor in(bytes);
+    const uint32_t block_count = in.read_count();
+    std::vector<BasicBlock*> blocks;
+    blocks.reserve(block_count);
+    for (uint32_t i = 0; i < block_count; ++i) {
+        const uint32_t label = in.read_varint32();
+        if (!in.ok() || label >= string_count_) {
+            return false;
+        }
+        blocks.push_back(func->create_block(get_string(label)));
+    }
+
+    // operands that refer to values decoded later (phis of loops)
+    struct Fixup {
+        Instruction* inst;
+        uint32_t slot;
+        uint32_t id;
+    };
+    std::vector<Fixup> fixups;
+    std::vector<Value*> operands;
+    std::vector<BasicBlock*> targets;
+    std::vector<std::pair<uint32_t, uint32_t>> forward; // slot, ID
+    uint32_t user = 0;
+
+    auto read_operand = [&]() {
+        const uint64_t encoded = in.read_varint();
+        if (encoded == 0) {
+            operands.push_back(nullptr);
+            return;
+        }
+        const int64_t id = static_cast<int64_t>(user) - unzigzag(encoded - 1);
+        if (id < 0 || id > UINT32_MAX) {
+            in.fail();
+        } else if (id < static_cast<int64_t>(func->get_value_count())) {
+            operands.push_back(func->get_value(static_cast<uint32_t>(id)));
+            return;
+        } else {
+            forward.emplace_back(static_cast<uint32_t>(operands.size()),
+                                 static_cast<uint32_t>(id));
+        }
+        operands.push_back(nullptr);
+    };
+    auto read_block = [&]() {
+        const uint32_t index = in.read_varint32();
+        if (index > block_count) {
+            in.fail();
+        }
+        targets.push_back(index == 0 || !in.ok() ? nullptr : blocks[index - 1]);
+    };
+
+    for (BasicBlock* block : blocks) {
+        const uint32_t count = in.read_count();
+        for (uint32_t k = 0; k < count && in.ok(); ++k) {
+            const uint8_t byte = in.read_u8();
+            const auto opcode = static_cast<Opcode>(byte & 31);
+            const uint8_t type = byte >> 5;
+            if (opcode >= Opcode::count || type >= kTypeCount) {
+                return false;
+            }
+            user = func->get_value_count();
+            operands.clear();
+            targets.clear();
+            forward.clear();
+            uint64_t payload = 0;
+            uint8_t predicate = 0;
+            Function* callee = nullptr;
+            switch (opcode) {
+            case Opcode::ConstI64:
+                payload = static_cast<uint64_t>(unzigzag(in.read_varint()));
+                break;
+            case Opcode::ConstU64:
+                payload = in.read_varint();
+                break;
+            case Opcode::ConstF64:
+                payload = in.read_le<uint64_t>();
+                break;
+            case Opcode::ConstBool:
+                payload = in.read_u8() != 0;
+                break;
+            case Opcode::ConstUnit:
+            case Opcode::Unreachable:
+                break;
+            case Opcode::ICmp:
+            case Opcode::FCmp:
+                predicate = in.read_u8();
+                if (predicate > static_cast<uint8_t>(CmpPredicate::Oge)) {
+                    return false;
+                }
+                read_operand();
+                read_operand();
+                break;
+            case Opcode::Call: {
+                const uint32_t index = in.read_varint32();
+                const uint32_t arg_count = in.read_count();
+                if (!in.ok() || index >= module_->get_functions().size()) {
+                    return false;
+                }
+                callee = module_->get_functions()[index].get();
+                if (arg_count != callee->get_param_types().size() ||
+                    static_cast<Type>(type) != callee->get_return_type()) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < arg_count; ++i) {
+                    read_operand();
+                }
+                break;
+            }
+            case Opcode::Phi: {
+                const uint32_t incoming_count = in.read_count();
+                for (uint32_t i = 0; i < incoming_count && in.ok(); ++i) {
+                    read_operand();
+                    read_block();
+                }
+                break;
+            }
+            case Opcode::Ret: {
+                const uint32_t value_count = in.read_varint32();
+                if (value_count > 1) {
+                    return false;
+                }
+                if (value_count) {
+                    read_operand();
+                }
+                break;
+            }
+            case Opcode::Br:
+                read_block();
+                break;
+            case Opcode::CondBr:
+                read_operand();
+                read_block();
+                read_block();
+                break;
+            default:
+                read_operand();
+                read_operand();
+                break;
+            }
+            if (!in.ok()) {
+                return false;
+            }
+
+            Instruction* inst =
+                func->create_instruction(opcode, static_cast<Type>(type), operands,
+                                         static_cast<uint32_t>(targets.size()));
+            inst->subclass_data_ |= static_cast<uint16_t>(predicate << 8);
+            if (opcode == Opcode::ConstI64) {
+                inst->payload_.i64 = static_cast<int64_t>(payload);
+            } else if (opcode == Opcode::ConstU64) {
+                inst->payload_.u64 = payload;
+            } else if (opcode == Opcode::ConstF64) {
+                std::memcpy(&inst->payload_.f64, &payload, sizeof(payload));
+            } else if (opcode == Opcode::ConstBool) {
+                inst->payload_.boolean = payload != 0;
+            } else if (opcode == Opcode::Call) {
+                inst->payload_.callee = callee;
+            }
+            for (uint32_t i = 0; i < targets.size(); ++i) {
+                inst->set_block(i, targets[i]);
+            }
+            for (const auto& [slot, id] : forward) {
+                fixups.push_back({inst, slot, id});
+            }
+            block->insert(inst);
+        }
+    }
+    if (!in.ok() || in.remaining() != 0) {
+        return false;
+    }
+    for (const Fixup& fixup : fixups) {
+        if (fixup.id >= func->get_value_count()) {
+            return false;
+        }
+        fixup.inst->set_operand(fixup.slot, func->get_value(fixup.id));
+    }
+    return true;
+}
+
+} // namespace ir
+} // namespace nova
@@ -0,0 +1,331 @@
+#include "nova/IR/IR.hpp"
+#include <charconv>
+#include <cstring>
+#include <type_traits>
+
+namespace nova {
+namespace ir {
+
+namespace {
+
+constexpr const char* kOpcodeNames[] = {
+#define NOVA_IR_CONST(name, spelling) spelling,
+#define NOVA_IR_INST(name, spelling) spelling,
+#define NOVA_IR_TERMINATOR(name, spelling) spelling,
+#include "nova/IR/Instructions.def"
+#undef NOVA_IR_TERMINATOR
+#undef NOVA_IR_INST
+#undef NOVA_IR_CONST
+};
+static_assert(std::size(kOpcodeNames) == static_cast<size_t>(Opcode::count),
+              "opcode table must match Opcode::count");
+
+constexpr const char* kPredicateNames[] = {"eq",  "ne",  "slt", "sle", "sgt", "sge",
+                                           "ult", "ule", "ugt", "uge", "oeq", "one",
+                                           "olt", "ole", "ogt", "oge"};
+
+void print_value(std::string& out, const Value* value) {
+    if (!value) {
+        out += "null";
+        return;
+    }
+    out += '%';
+    out += std::to_string(value->get_id());
+}
+
+void print_label(std::string& out, const BasicBlock* block) {
+    if (!block) {
+        out += "null";
+    } else if (block->get_label().empty()) {
+        out += "bb";
+        out += std::to_string(block->get_index());
+    } else {
+        out += block->get_label();
+    }
+}
+
+void print_instruction(std::string& out, const Instruction* inst) {
+    out += "  ";
+    if (!inst->is_terminator()) {
+        print_value(out, inst);
+        out += " = ";
+    }
+    out += get_opcode_name(inst->get_opcode());
+    switch (inst->get_opcode()) {
+    case Opcode::ConstI64:
+        out += " i64 ";
+        out += std::to_string(inst->get_i64());
+        return;
+    case Opcode::ConstU64:
+        out += " u64 ";
+        out += std::to_string(inst->get_u64());
+        return;
+    case Opcode::ConstF64: {
+        // shortest form that reads back as the same double
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), inst->get_f64());
+        out += " f64 ";
+        out.append(buffer, result.ptr);
+        return;
+    }
+    case Opcode::ConstBool:
+        out += inst->get_bool() ? " bool true" : " bool false";
+        return;
+    case Opcode::ConstUnit:
+        out += " unit";
+        return;
+    case Opcode::ICmp:
+    case Opcode::FCmp:
+        out += ' ';
+        out += get_predicate_name(inst->get_predicate());
+        break;
+    case Opcode::Call:
+        out += ' ';
+        out += get_type_name(inst->get_type());
+        out += " @";
+        out += inst->get_callee()->get_name();
+        out += '(';
+        for (uint32_t i = 0; i < inst->get_operand_count(); ++i) {
+            out += i ? ", " : "";
+            print_value(out, inst->get_operand(i));
+        }
+        out += ')';
+        return;
+    case Opcode::Phi:
+        out += ' ';
+        out += get_type_name(inst->get_type());
+        for (uint32_t i = 0; i < inst->get_incoming_count(); ++i) {
+            out += i ? ", [" : " [";
+            print_value(out, inst->get_incoming_value(i));
+            out += ", ";
+            print_label(out, inst->get_incoming_block(i));
+            out += ']';
+        }
+        return;
+    case Opcode::Ret:
+    case Opcode::Br:
+    case Opcode::CondBr:
+    case Opcode::Unreachable:
+        break;
+    default:
+        out += ' ';
+        out += get_type_name(inst->get_type());
+        break;
+    }
+    // operands, then successor labels
+    const char* separator = " ";
+    for (uint32_t i = 0; i < inst->get_operand_count(); ++i) {
+        out += separator;
+        print_value(out, inst->get_operand(i));
+        separator = ", ";
+    }
+    for (BasicBlock* block : inst->get_blocks()) {
+        out += separator;
+        print_label(out, block);
+        separator = ", ";
+    }
+}
+
+} // namespace
+
+const char* get_type_name(Type type) {
+    switch (type) {
+    case Type::I64:
+        return "i64";
+    case Type::U64:
+        return "u64";
+    case Type::F64:
+        return "f64";
+    case Type::Bool:
+        return "bool";
+    case Type::Unit:
+        return "unit";
+    }
+    return "<invalid>";
+}
+
+const char* get_opcode_name(Opcode opcode) {
+    return kOpcodeNames[static_cast<size_t>(opcode)];
+}
+
+const char* get_predicate_name(CmpPredicate pred) {
+    return kPredicateNames[static_cast<size_t>(pred)];
+}
+
+uint32_t Use::get_operand_no() const {
+    return static_cast<uint32_t>(this - user_->get_operands().data());
+}
+
+uint32_t Value::get_use_count() const {
+    uint32_t count = 0;
+    for (const Use* use = uses_; use; use = use->next_) {
+        ++count;
+    }
+    return count;
+}
+
+void Value::replace_all_uses_with(Value* other) {
+    assert(other != this && "replacing a value with itself");
+    assert(other->get_type() == type_ && "replacement has a different type");
+    if (!uses_) {
+        return;
+    }
+    Use* last = nullptr;
+    for (Use* use = uses_; use; use = use->next_) {
+        use->value_ = other;
+        last = use;
+    }
+    // splice the whole list in front of `other`'s uses
+    last->next_ = other->uses_;
+    if (other->uses_) {
+        other->uses_->prev_ = &last->next_;
+    }
+    uses_->prev_ = &other->uses_;
+    other->uses_ = uses_;
+    uses_ = nullptr;
+}
+
+Function* Instruction::get_function() const { return parent_ ? parent_->get_parent() : nullptr; }
+
+void Instruction::drop_operands() {
+    for (Use& use : get_operands()) {
+        use.set(nullptr);
+    }
+}
+
+void Instruction::erase_from_parent() {
+    assert(!has_uses() && "erasing an instruction that is still used");
+    assert(parent_ && "erasing an unlinked instruction");
+    drop_operands();
+    Function* func = get_function();
+    parent_->remove(this);
+    func->values_[get_id()] = nullptr;
+}
+
+std::span<BasicBlock* const> BasicBlock::get_successors() const {
+    const Instruction* term = get_terminator();
+    return term ? term->get_blocks() : std::span<BasicBlock* const>();
+}
+
+void BasicBlock::insert(Instruction* inst, Instruction* before) {
+    assert(!inst->parent_ && "instruction is already in a block");
+    assert((!before || before->parent_ == this) && "insertion point is in another block");
+    inst->parent_ = this;
+    inst->next_ = before;
+    inst->prev_ = before ? before->prev_ : last_;
+    if (inst->prev_) {
+        inst->prev_->next_ = inst;
+    } else {
+        first_ = inst;
+    }
+    if (before) {
+        before->prev_ = inst;
+    } else {
+        last_ = inst;
+    }
+}
+
+void BasicBlock::remove(Instruction* inst) {
+    assert(inst->parent_ == this && "instruction is not in this block");
+    if (inst->prev_) {
+        inst->prev_->next_ = inst->next_;
+    } else {
+        first_ = inst->next_;
+    }
+    if (inst->next_) {
+        inst->next_->prev_ = inst->prev_;
+    } else {
+        last_ = inst->prev_;
+    }
+    inst->parent_ = nullptr;
+    inst->prev_ = nullptr;
+    inst->next_ = nullptr;
+}
+
+Function::Function(Module* parent, uint32_t index, std::string name,
+                   std::span<const Type> param_types, Type return_type)
+    : parent_(parent), index_(index), name_(std::move(name)),
+      param_types_(param_types.begin(), param_types.end()), return_type_(return_type) {
+    args_.reserve(param_types.size());
+    for (Type type : param_types) {
+        const auto index = static_cast<uint32_t>(args_.size());
+        Argument* arg = new (arena_.allocate(sizeof(Argument), alignof(Argument)))
+            Argument(this, type, index);
+        args_.push_back(arg);
+        values_.push_back(arg);
+    }
+}
+
+BasicBlock* Function::create_block(std::string_view label) {
+    char* text = static_cast<char*>(arena_.allocate(label.size(), 1));
+    std::memcpy(text, label.data(), label.size());
+    auto* block = new (arena_.allocate(sizeof(BasicBlock), alignof(BasicBlock)))
+        BasicBlock(this, std::string_view(text, label.size()),
+                   static_cast<uint32_t>(blocks_.size()));
+    blocks_.push_back(block);
+    return block;
+}
+
+void Function::clear_body() {
+    for (size_t id = args_.size(); id < values_.size(); ++id) {
+        if (auto* inst = static_cast<Instruction*>(values_[id])) {
+            inst->drop_operands();
+        }
+    }
+    blocks_.clear();
+    values_.resize(args_.size());
+}
+
+Instruction* Function::create_instruction(Opcode opcode, Type type,
+                                          std::span<Value* const> operands,
+                                          uint32_t block_count) {
+    static_assert(std::is_trivially_destructible_v<Instruction> &&
+                      std::is_trivially_destructible_v<Use>,
+                  "instructions are never destroyed");
+    static_assert(alignof(Use) <= alignof(Instruction) && sizeof(Instruction) % alignof(Use) == 0,
+                  "operands must be aligned directly after the instruction");
+    const auto operand_count = static_cast<uint32_t>(operands.size());
+    const size_t size =
+        sizeof(Instruction) + operand_count * sizeof(Use) + block_count * sizeof(BasicBlock*);
+    auto* inst = new (arena_.allocate(size, alignof(Instruction)))
+        Instruction(opcode, type, static_cast<uint32_t>(values_.size()), operand_count,
+                    block_count);
+    Use* ops = inst->op_begin();
+    for (uint32_t i = 0; i < operand_count; ++i) {
+        new (&ops[i]) Use(inst);
+        ops[i].set(operands[i]);
+    }
+    BasicBlock** blocks = inst->block_begin();
+    for (uint32_t i = 0; i < block_count; ++i) {
+        blocks[i] = nullptr;
+    }
+    values_.push_back(inst);
+    return inst;
+}
+
+void Function::print(std::string& out) const {
+    out += "func @";
+    out += name_;
+    out += '(';
+    for (const Argument* arg : args_) {
+        out += arg->get_index() ? ", " : "";
+        print_value(out, arg);
+        out += ": ";
+        out += get_type_name(arg->get_type());
+    }
+    out += ") -> ";
+    out += get_type_name(return_type_);
+    out += " {\n";
+    for (const BasicBlock* block : blocks_) {
+        print_label(out, block);
+        out += ":\n";
+        for (const Instruction* inst : block->get_instructions()) {
+            print_instruction(out, inst);
+            out += '\n';
+        }
+    }
+    out += "}\n";
+}
+
+} // namespace ir
+} // namespace nova
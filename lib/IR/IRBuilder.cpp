@@ -0,0 +1,115 @@
+#include "nova/IR/IRBuilder.hpp"
+#include <vector>
+
+namespace nova {
+namespace ir {
+
+Instruction* IRBuilder::insert(Opcode opcode, Type type, std::span<Value* const> operands,
+                               uint32_t block_count) {
+    assert(block_ && "no insertion point");
+    assert((before_ || !block_->get_terminator()) && "block already has a terminator");
+    Instruction* inst =
+        block_->get_parent()->create_instruction(opcode, type, operands, block_count);
+    block_->insert(inst, before_);
+    return inst;
+}
+
+Instruction* IRBuilder::create_const_i64(int64_t value) {
+    Instruction* inst = insert(Opcode::ConstI64, Type::I64, {});
+    inst->payload_.i64 = value;
+    return inst;
+}
+
+Instruction* IRBuilder::create_const_u64(uint64_t value) {
+    Instruction* inst = insert(Opcode::ConstU64, Type::U64, {});
+    inst->payload_.u64 = value;
+    return inst;
+}
+
+Instruction* IRBuilder::create_const_f64(double value) {
+    Instruction* inst = insert(Opcode::ConstF64, Type::F64, {});
+    inst->payload_.f64 = value;
+    return inst;
+}
+
+Instruction* IRBuilder::create_const_bool(bool value) {
+    Instruction* inst = insert(Opcode::ConstBool, Type::Bool, {});
+    inst->payload_.boolean = value;
+    return inst;
+}
+
+Instruction* IRBuilder::create_const_unit() { return insert(Opcode::ConstUnit, Type::Unit, {}); }
+
+Instruction* IRBuilder::create_binary(Opcode opcode, Value* lhs, Value* rhs) {
+    assert(opcode >= Opcode::Add && opcode <= Opcode::FDiv && "not a binary opcode");
+    assert(lhs->get_type() == rhs->get_type() && "operand types differ");
+    assert((opcode >= Opcode::FAdd) == (lhs->get_type() == Type::F64) &&
+           "integer and float arithmetic mixed up");
+    Value* operands[] = {lhs, rhs};
+    return insert(opcode, lhs->get_type(), operands);
+}
+
+Instruction* IRBuilder::create_cmp(Opcode opcode, CmpPredicate pred, Value* lhs, Value* rhs) {
+    assert(lhs->get_type() == rhs->get_type() && "operand types differ");
+    Value* operands[] = {lhs, rhs};
+    Instruction* inst = insert(opcode, Type::Bool, operands);
+    inst->subclass_data_ |= static_cast<uint16_t>(static_cast<uint16_t>(pred) << 8);
+    return inst;
+}
+
+Instruction* IRBuilder::create_icmp(CmpPredicate pred, Value* lhs, Value* rhs) {
+    assert(pred <= CmpPredicate::Uge && "not an integer predicate");
+    return create_cmp(Opcode::ICmp, pred, lhs, rhs);
+}
+
+Instruction* IRBuilder::create_fcmp(CmpPredicate pred, Value* lhs, Value* rhs) {
+    assert(pred >= CmpPredicate::Oeq && "not a float predicate");
+    return create_cmp(Opcode::FCmp, pred, lhs, rhs);
+}
+
+Instruction* IRBuilder::create_call(Function* callee, std::span<Value* const> args) {
+    assert(args.size() == callee->get_param_types().size() && "wrong number of arguments");
+    for (size_t i = 0; i < args.size(); ++i) {
+        assert(args[i]->get_type() == callee->get_param_types()[i] && "argument type mismatch");
+    }
+    Instruction* inst = insert(Opcode::Call, callee->get_return_type(), args);
+    inst->payload_.callee = callee;
+    return inst;
+}
+
+Instruction* IRBuilder::create_phi(Type type, uint32_t incoming_count) {
+    // operands start out null; set_incoming() fills them in
+    std::vector<Value*> operands(incoming_count, nullptr);
+    return insert(Opcode::Phi, type, operands, incoming_count);
+}
+
+Instruction* IRBuilder::create_ret(Value* value) {
+    if (!value) {
+        return insert(Opcode::Ret, Type::Unit, {});
+    }
+    Value* operands[] = {value};
+    return insert(Opcode::Ret, Type::Unit, operands);
+}
+
+Instruction* IRBuilder::create_br(BasicBlock* dest) {
+    Instruction* inst = insert(Opcode::Br, Type::Unit, {}, 1);
+    inst->set_block(0, dest);
+    return inst;
+}
+
+Instruction* IRBuilder::create_cond_br(Value* cond, BasicBlock* then_block,
+                                       BasicBlock* else_block) {
+    assert(cond->get_type() == Type::Bool && "branch condition is not a bool");
+    Value* operands[] = {cond};
+    Instruction* inst = insert(Opcode::CondBr, Type::Unit, operands, 2);
+    inst->set_block(0, then_block);
+    inst->set_block(1, else_block);
+    return inst;
+}
+
+Instruction* IRBuilder::create_unreachable() {
+    return insert(Opcode::Unreachable, Type::Unit, {});
+}
+
+} // namespace ir
+} // namespace nova
@@ -0,0 +1,36 @@
+#include "nova/IR/Module.hpp"
+
+namespace nova {
+namespace ir {
+
+Function* Module::create_function(std::string name, std::span<const Type> param_types,
+                                  Type return_type) {
+    if (by_name_.count(name)) {
+        return nullptr;
+    }
+    functions_.push_back(
+        std::make_unique<Function>(this, static_cast<uint32_t>(functions_.size()),
+                                   std::move(name), param_types, return_type));
+    Function* func = functions_.back().get();
+    by_name_.emplace(func->get_name(), func);
+    return func;
+}
+
+Function* Module::get_function(std::string_view name) const {
+    const auto it = by_name_.find(name);
+    return it == by_name_.end() ? nullptr : it->second;
+}
+
+std::string Module::print() const {
+    std::string out;
+    for (size_t i = 0; i < functions_.size(); ++i) {
+        if (i) {
+            out += '\n';
+        }
+        functions_[i]->print(out);
+    }
+    return out;
+}
+
+} // namespace ir
+} // namespace nova
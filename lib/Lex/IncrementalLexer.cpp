@@ -0,0 +1,97 @@
+#include "nova/Lex/IncrementalLexer.hpp"
+#include "nova/Lex/Lexer.hpp"
+#include <cassert>
+
+namespace nova {
+namespace {
+
+// bytes the lexer may look at past the end of a token (e.g. the '=' of "+=")
+constexpr uint32_t kLookaheadMargin = 2;
+
+} // namespace
+
+    std::string apply_text_edit(std::string_view text, const TextEdit& edit) {
+        assert(static_cast<size_t>(edit.offset) + edit.removed_length <= text.size() &&
+               "edit outside of the text");
+        std::string out;
+        out.reserve(text.size() - edit.removed_length + edit.inserted_text.size());
+        out.append(text.substr(0, edit.offset));
+        out.append(edit.inserted_text);
+        out.append(text.substr(edit.offset + edit.removed_length));
+        return out;
+    }
+
+    TokenBuffer relex_after_edit(const TokenBuffer& old_tokens, const SourceManager& sm,
+                                 IdentifierTable& ids, FileID file_id, const TextEdit& edit,
+                                 RelexStats* stats) {
+        RelexStats local;
+        RelexStats& st = stats ? *stats : local;
+        st = RelexStats();
+
+        TokenBuffer tokens(sm, ids, file_id);
+        const FileEntry* file = sm.get_file(file_id);
+        if(!file){
+            return tokens;
+        }
+        tokens.reserve(old_tokens.size() + edit.inserted_text.size() / 4 + 8);
+        const int64_t delta = static_cast<int64_t>(edit.inserted_text.size()) -
+                              static_cast<int64_t>(edit.removed_length);
+        const SourceLocation::RawType new_start = file->start_loc.get_raw_encoding();
+
+        // restart at the last token that starts at least kLookaheadMargin bytes
+        // before the edit: every token before it was lexed without reading
+        // the edited bytes, and the whitespace before it is unchanged
+        size_t restart = 0;
+        if(!old_tokens.empty() && edit.offset >= kLookaheadMargin){
+            const size_t safe = old_tokens.find_offset(edit.offset - kLookaheadMargin + 1);
+            restart = safe > 0 ? safe - 1 : 0;
+        }
+        // without such a token, lex from the top: the first token may start
+        // after the edit (e.g. behind a comment the edit splits)
+        const uint32_t restart_offset = restart == 0 ? 0 : old_tokens.get_offset(restart);
+        tokens.append(old_tokens, 0, restart, 0);
+        st.reused_prefix = restart;
+
+        const uint64_t edit_end_new = static_cast<uint64_t>(edit.offset) + edit.inserted_text.size();
+        // old tokens starting at or after the end of the removed range
+        size_t old_index = old_tokens.find_offset(edit.offset + edit.removed_length);
+
+        Lexer lexer(sm, ids, file_id, restart_offset);
+        Token tok;
+        bool first = true;
+        while(true){
+            tok = Token();
+            lexer.lex(tok);
+            if(first && restart_offset != 0){
+                // the lexer did not see the whitespace before the restart token
+                if(old_tokens.at_start_of_line(restart)) tok.set_flag_at_start_of_line();
+                if(old_tokens.has_leading_space(restart)) tok.set_flag_has_leading_space();
+            }
+            first = false;
+
+            const uint64_t new_offset = tok.get_location().get_raw_encoding() - new_start;
+            if(new_offset >= edit_end_new){
+                const auto old_offset = static_cast<int64_t>(new_offset) - delta;
+                while(old_index < old_tokens.size() &&
+                      static_cast<int64_t>(old_tokens.get_offset(old_index)) < old_offset){
+                    ++old_index;
+                }
+                if(old_index < old_tokens.size() &&
+                   static_cast<int64_t>(old_tokens.get_offset(old_index)) == old_offset &&
+                   old_tokens.get_kind(old_index) == tok.get_kind() &&
+                   old_tokens.at_start_of_line(old_index) == tok.at_start_of_line() &&
+                   old_tokens.has_leading_space(old_index) == tok.has_leading_space()){
+                    tokens.append(old_tokens, old_index, old_tokens.size(), delta);
+                    st.reused_suffix = old_tokens.size() - old_index;
+                    break;
+                }
+            }
+            tokens.push_back(tok);
+            ++st.relexed;
+            if(tok.is(TokenKind::eof)){
+                break;
+            }
+        }
+        return tokens;
+    }
+}
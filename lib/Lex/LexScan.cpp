@@ -0,0 +1,274 @@
+#include "nova/Lex/LexScan.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define NOVA_LEX_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NOVA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NOVA_TARGET_AVX2
+#endif
+
+namespace nova {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Scalar kernels (also used for the tail of the vector kernels)
+//===----------------------------------------------------------------------===//
+
+inline bool is_whitespace_byte(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool is_identifier_byte(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool is_digit_byte(char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* scan_whitespace_scalar(const char* cur, const char* end, bool& saw_newline) {
+    while (cur < end && is_whitespace_byte(*cur)) {
+        if (*cur == '\n') {
+            saw_newline = true;
+        }
+        ++cur;
+    }
+    return cur;
+}
+
+const char* scan_identifier_scalar(const char* cur, const char* end) {
+    while (cur < end && is_identifier_byte(*cur)) {
+        ++cur;
+    }
+    return cur;
+}
+
+const char* scan_digits_scalar(const char* cur, const char* end) {
+    while (cur < end && is_digit_byte(*cur)) {
+        ++cur;
+    }
+    return cur;
+}
+
+const char* scan_string_body_scalar(const char* cur, const char* end, char quote) {
+    while (cur < end && *cur != quote && *cur != '\\') {
+        ++cur;
+    }
+    return cur;
+}
+
+constexpr LexScanKernels kScalarKernels = {
+    scan_whitespace_scalar, scan_identifier_scalar, scan_digits_scalar,
+    scan_string_body_scalar, SIMDLevel::Scalar,
+};
+
+#if defined(NOVA_LEX_SCAN_X86)
+
+//===----------------------------------------------------------------------===//
+// SSE2 kernels (16 bytes per step)
+//===----------------------------------------------------------------------===//
+// Range checks use signed byte compares; bytes >= 0x80 are negative and
+// therefore never fall inside an ASCII range.
+
+inline __m128i in_range_sse2(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+const char* scan_whitespace_sse2(const char* cur, const char* end, bool& saw_newline) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end - cur >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        const __m128i nl = _mm_cmpeq_epi8(v, newline);
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                        _mm_or_si128(nl, _mm_cmpeq_epi8(v, cr)));
+        const uint32_t ws_mask = static_cast<uint32_t>(_mm_movemask_epi8(ws));
+        const uint32_t nl_mask = static_cast<uint32_t>(_mm_movemask_epi8(nl));
+        if (ws_mask != 0xFFFFu) {
+            const int run = std::countr_zero(~ws_mask);
+            if (nl_mask & ((1u << run) - 1)) {
+                saw_newline = true;
+            }
+            return cur + run;
+        }
+        if (nl_mask) {
+            saw_newline = true;
+        }
+        cur += 16;
+    }
+    return scan_whitespace_scalar(cur, end, saw_newline);
+}
+
+inline __m128i identifier_mask_sse2(__m128i v) {
+    const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i alpha = in_range_sse2(lower, 'a', 'z');
+    const __m128i digit = in_range_sse2(v, '0', '9');
+    const __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), under);
+}
+
+const char* scan_identifier_sse2(const char* cur, const char* end) {
+    while (end - cur >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(identifier_mask_sse2(v)));
+        if (mask != 0xFFFFu) {
+            return cur + std::countr_zero(~mask);
+        }
+        cur += 16;
+    }
+    return scan_identifier_scalar(cur, end);
+}
+
+const char* scan_digits_sse2(const char* cur, const char* end) {
+    while (end - cur >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(in_range_sse2(v, '0', '9')));
+        if (mask != 0xFFFFu) {
+            return cur + std::countr_zero(~mask);
+        }
+        cur += 16;
+    }
+    return scan_digits_scalar(cur, end);
+}
+
+const char* scan_string_body_sse2(const char* cur, const char* end, char quote) {
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - cur >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(v, backslash));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (mask) {
+            return cur + std::countr_zero(mask);
+        }
+        cur += 16;
+    }
+    return scan_string_body_scalar(cur, end, quote);
+}
+
+constexpr LexScanKernels kSSE2Kernels = {
+    scan_whitespace_sse2, scan_identifier_sse2, scan_digits_sse2,
+    scan_string_body_sse2, SIMDLevel::SSE2,
+};
+
+//===----------------------------------------------------------------------===//
+// AVX2 kernels (32 bytes per step, only reached after runtime detection)
+//===----------------------------------------------------------------------===//
+
+NOVA_TARGET_AVX2 inline __m256i in_range_avx2(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+NOVA_TARGET_AVX2
+const char* scan_whitespace_avx2(const char* cur, const char* end, bool& saw_newline) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    while (end - cur >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        const __m256i nl = _mm256_cmpeq_epi8(v, newline);
+        const __m256i ws =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                            _mm256_or_si256(nl, _mm256_cmpeq_epi8(v, cr)));
+        const uint32_t ws_mask = static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        const uint32_t nl_mask = static_cast<uint32_t>(_mm256_movemask_epi8(nl));
+        if (ws_mask != 0xFFFFFFFFu) {
+            const int run = std::countr_zero(~ws_mask);
+            if (nl_mask & ((1u << run) - 1)) {
+                saw_newline = true;
+            }
+            return cur + run;
+        }
+        if (nl_mask) {
+            saw_newline = true;
+        }
+        cur += 32;
+    }
+    return scan_whitespace_sse2(cur, end, saw_newline);
+}
+
+NOVA_TARGET_AVX2
+const char* scan_identifier_avx2(const char* cur, const char* end) {
+    while (end - cur >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        const __m256i ident =
+            _mm256_or_si256(_mm256_or_si256(in_range_avx2(lower, 'a', 'z'), in_range_avx2(v, '0', '9')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(ident));
+        if (mask != 0xFFFFFFFFu) {
+            return cur + std::countr_zero(~mask);
+        }
+        cur += 32;
+    }
+    return scan_identifier_sse2(cur, end);
+}
+
+NOVA_TARGET_AVX2
+const char* scan_digits_avx2(const char* cur, const char* end) {
+    while (end - cur >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(in_range_avx2(v, '0', '9')));
+        if (mask != 0xFFFFFFFFu) {
+            return cur + std::countr_zero(~mask);
+        }
+        cur += 32;
+    }
+    return scan_digits_sse2(cur, end);
+}
+
+NOVA_TARGET_AVX2
+const char* scan_string_body_avx2(const char* cur, const char* end, char quote) {
+    const __m256i q = _mm256_set1_epi8(quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    while (end - cur >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        const __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, q), _mm256_cmpeq_epi8(v, backslash));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (mask) {
+            return cur + std::countr_zero(mask);
+        }
+        cur += 32;
+    }
+    return scan_string_body_sse2(cur, end, quote);
+}
+
+constexpr LexScanKernels kAVX2Kernels = {
+    scan_whitespace_avx2, scan_identifier_avx2, scan_digits_avx2,
+    scan_string_body_avx2, SIMDLevel::AVX2,
+};
+
+#endif // NOVA_LEX_SCAN_X86
+
+} // namespace
+
+const LexScanKernels& get_lex_scan_kernels(SIMDLevel level) {
+    const SIMDLevel host = get_host_simd_level();
+    if (static_cast<uint8_t>(level) > static_cast<uint8_t>(host)) {
+        level = host;
+    }
+    switch (level) {
+#if defined(NOVA_LEX_SCAN_X86)
+    case SIMDLevel::AVX2:
+        return kAVX2Kernels;
+    case SIMDLevel::SSE2:
+        return kSSE2Kernels;
+#endif
+    default:
+        return kScalarKernels;
+    }
+}
+
+} // namespace nova
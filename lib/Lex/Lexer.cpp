@@ -1,13 +1,15 @@
 #include "nova/Lex/Lexer.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace nova {
-    Lexer::Lexer(const SourceManager& sm,IdentifierTable& id_table,uint16_t file_id)
+    Lexer::Lexer(const SourceManager& sm,IdentifierTable& id_table,FileID file_id)
         :source_manager_(sm),identifier_table_(id_table),file_id_(file_id),
-            at_start_of_line_(true),seen_space_(false) {
+            scan_(&get_lex_scan_kernels()),at_start_of_line_(true),seen_space_(false) {
                 const FileEntry* file = source_manager_.get_file(file_id_);
                 if(file){
+                    file_start_ = file->start_loc;
                     buffer_start_ = file->content.data();
                     buffer_ptr_ = buffer_start_;
                     buffer_end_ = buffer_start_ + file->content.size();
@@ -17,16 +19,25 @@ namespace nova {
                     buffer_end_ = nullptr;
                 }
             }
+    Lexer::Lexer(const SourceManager& sm,IdentifierTable& id_table,FileID file_id,uint32_t offset)
+        :Lexer(sm,id_table,file_id) {
+            if(buffer_start_){
+                buffer_ptr_ = buffer_start_ + std::min<size_t>(offset, static_cast<size_t>(buffer_end_ - buffer_start_));
+                at_start_of_line_ = (buffer_ptr_ == buffer_start_);
+            }
+        }
     // lex token and store result in 'result'
     // token include identifiers, keywords, literals, punctuations
     void Lexer::lex(Token& result){
+        // callers reuse one Token; form_token only ever sets flags
+        result = Token();
         skip_whitespace_and_comments();
         if(buffer_ptr_ >= buffer_end_) {
-            form_token(result,TokenKind::eof,buffer_ptr_,SourceLocation::create(file_id_,static_cast<uint32_t>(buffer_ptr_ - buffer_start_)));
+            form_token(result,TokenKind::eof,buffer_ptr_,file_start_.get_offset_location(get_current_offset()));
             return;
         }
         const char current_char = peek();
-        SourceLocation loc = SourceLocation::create(file_id_,get_current_offset());
+        SourceLocation loc = file_start_.get_offset_location(get_current_offset());
         const char* start = buffer_ptr_;
         if(is_identifier_start(current_char)) {
             lex_identifier(result,start,loc);
@@ -56,6 +67,13 @@ namespace nova {
                 if(*cur == '\n')
                     at_start_of_line_ = true;
                 ++cur;
+                // single separators are the common case; only runs go to the kernel
+                if(cur < end && is_whitespace(*cur)) {
+                    bool saw_newline = false;
+                    cur = scan_->scan_whitespace(cur, end, saw_newline);
+                    if(saw_newline)
+                        at_start_of_line_ = true;
+                }
             }else if(*cur == '/' && (cur + 1) < end){
                 if(*(cur + 1) == '/'){
                     // single line comment
@@ -139,27 +157,20 @@ namespace nova {
     }
 
     void Lexer::lex_identifier(Token& result,const char* start,SourceLocation loc) {
-        const char* cur = buffer_ptr_;
-        const char* end = buffer_end_;
-        while(cur < end && is_identifier_continue(*cur)) 
-            ++cur;
+        // first char was already checked by is_identifier_start
+        const char* cur = scan_->scan_identifier(buffer_ptr_ + 1, buffer_end_);
         std::string_view ident_text(start,static_cast<size_t>(cur - start));
-        //check if it's a keyword
-        IdentifierInfo* info = identifier_table_.get(ident_text);
         buffer_ptr_ = cur;
-        if(info && info->is_keyword){
-            form_token(result,info->token_kind,start,loc);
-            result.set_identifier_info(info);
-        }else if(!info){
-            identifier_table_.add_identifier(ident_text);
-            info = identifier_table_.get(ident_text);
-            form_token(result,TokenKind::identifier,start,loc);
-            result.set_identifier_info(info);
-        }else {
-            //this identifier already exists but not a keyword
-            form_token(result,TokenKind::identifier,start,loc);
-            result.set_identifier_info(info);
+        //keywords are classified by a generated switch, not the hash table
+        const TokenKind keyword = get_keyword_kind(ident_text);
+        if(keyword != TokenKind::identifier){
+            form_token(result,keyword,start,loc);
+            result.set_identifier_info(identifier_table_.get_keyword_info(keyword));
+            return;
         }
+        IdentifierInfo* info = identifier_table_.intern(ident_text);
+        form_token(result,TokenKind::identifier,start,loc);
+        result.set_identifier_info(info);
     }
 
     void Lexer::lex_number(Token& result,const char* start,SourceLocation loc){
@@ -168,30 +179,27 @@ namespace nova {
         bool is_float = false;
         const char* cur = buffer_ptr_;
         const char* end = buffer_end_;
-        if(*cur == '0' && (cur + 1) < end) {
-            char next_char = *(cur + 1);
-            if(next_char == 'x' || next_char == 'X') {
-                cur += 2;
-                while(cur < end && is_hex_digit(*cur)) 
-                    ++cur;   
-            }else if(next_char == 'b' || next_char == 'B') {
-                cur += 2;
-                while(cur < end && is_binary_digit(*cur)) 
-                    ++cur;
-            }else if(next_char == 'o' || next_char == 'O') {
-                cur += 2;
-                while(cur < end && is_octal_digit(*cur)) 
-                    ++cur;
-            }
-        }else {
-            while(cur < end && is_digit(*cur))
+        const char next_char = (cur + 1) < end ? *(cur + 1) : '\0';
+        if(*cur == '0' && (next_char == 'x' || next_char == 'X')) {
+            cur += 2;
+            while(cur < end && is_hex_digit(*cur)) 
+                ++cur;   
+        }else if(*cur == '0' && (next_char == 'b' || next_char == 'B')) {
+            cur += 2;
+            while(cur < end && is_binary_digit(*cur)) 
                 ++cur;
+        }else if(*cur == '0' && (next_char == 'o' || next_char == 'O')) {
+            cur += 2;
+            while(cur < end && is_octal_digit(*cur)) 
+                ++cur;
+        }else {
+            // plain decimal, including a leading '0' such as "0" or "0.5"
+            cur = scan_->scan_digits(cur, end);
             //check for floating point
             if(cur < end && *cur == '.') {
                 is_float = true;
                 ++cur;
-                while(cur < end && is_digit(*cur)) 
-                    ++cur;
+                cur = scan_->scan_digits(cur, end);
             }
             //scientific notation
             if(cur < end && (*cur == 'e' || *cur == 'E')) {
@@ -199,8 +207,7 @@ namespace nova {
                 ++cur;
                 if(cur < end && (*cur == '+' || *cur == '-'))
                     ++cur;
-                while(cur < end && is_digit(*cur))
-                    ++cur;
+                cur = scan_->scan_digits(cur, end);
             }
         }
         buffer_ptr_ = cur;
@@ -215,15 +222,17 @@ namespace nova {
         const char* end = buffer_end_;
         cur++; //skip opening "
         while(cur < end) {
-            if(*cur == '"') {
+            // jump to the next closing quote or escape
+            cur = scan_->scan_string_body(cur, end, '"');
+            if(cur >= end) {
+                break;
+            }else if(*cur == '"') {
                 cur++;
                 break;
-            }else if(*cur == '\\') {
+            }else {
                 ++cur; //skip '\'
                 if(cur < buffer_end_) 
                     ++cur; //skip escaped char
-            } else {
-                ++cur;
             }
         }
         buffer_ptr_ = cur;
@@ -236,16 +245,17 @@ namespace nova {
         const char* end = buffer_end_;
         cur++;
         while(cur < end) {
-            if(*cur == '\'') {
+            cur = scan_->scan_string_body(cur, end, '\'');
+            if(cur >= end) {
+                break;
+            }else if(*cur == '\'') {
                 cur++;
                 //current char is closing '
                 break;
-            }else if(*cur == '\\') {
+            }else {
                 ++cur;
                 if(cur < buffer_end_)
                     ++cur;
-            }else {
-                ++cur;
             }
         }
         //token example: 'a', '\n', '\u1234'
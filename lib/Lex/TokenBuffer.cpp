@@ -0,0 +1,118 @@
+#include "nova/Lex/TokenBuffer.hpp"
+#include "nova/Lex/Lexer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace nova {
+    static_assert(static_cast<unsigned>(TokenKind::count) <= 256,
+                  "TokenBuffer stores kinds in one byte");
+
+    TokenBuffer::TokenBuffer(const SourceManager& sm, IdentifierTable& ids, FileID file_id)
+        : source_manager_(&sm), identifier_table_(&ids), file_id_(file_id) {
+            if(const FileEntry* file = sm.get_file(file_id)){
+                file_start_ = file->start_loc;
+            }
+    }
+
+    void TokenBuffer::reserve(size_t count){
+        kinds_.reserve(count);
+        flags_.reserve(count);
+        offsets_.reserve(count);
+        identifiers_.reserve(count);
+    }
+
+    void TokenBuffer::shrink_to_fit(){
+        kinds_.shrink_to_fit();
+        flags_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+        identifiers_.shrink_to_fit();
+    }
+
+    void TokenBuffer::clear(){
+        kinds_.clear();
+        flags_.clear();
+        offsets_.clear();
+        identifiers_.clear();
+    }
+
+    void TokenBuffer::push_back(const Token& tok){
+        assert(tok.get_location().get_raw_encoding() >= file_start_.get_raw_encoding() &&
+               "token does not belong to this buffer's file");
+        kinds_.push_back(static_cast<uint8_t>(tok.get_kind()));
+        flags_.push_back(static_cast<uint8_t>((tok.at_start_of_line() ? kAtStartOfLine : 0) |
+                                              (tok.has_leading_space() ? kHasLeadingSpace : 0)));
+        offsets_.push_back(static_cast<uint32_t>(tok.get_location().get_raw_encoding() -
+                                                 file_start_.get_raw_encoding()));
+        const IdentifierInfo* info = tok.get_identifier_info();
+        identifiers_.push_back(info ? info->id : kNoIdentifier);
+    }
+
+    void TokenBuffer::append(const TokenBuffer& other, size_t begin, size_t end, int64_t offset_delta){
+        assert(other.identifier_table_ == identifier_table_ && "identifier ids are per table");
+        if(begin >= end){
+            return;
+        }
+        kinds_.insert(kinds_.end(), other.kinds_.begin() + begin, other.kinds_.begin() + end);
+        flags_.insert(flags_.end(), other.flags_.begin() + begin, other.flags_.begin() + end);
+        identifiers_.insert(identifiers_.end(), other.identifiers_.begin() + begin,
+                            other.identifiers_.begin() + end);
+        const size_t first = offsets_.size();
+        offsets_.insert(offsets_.end(), other.offsets_.begin() + begin, other.offsets_.begin() + end);
+        for(size_t i = first; i < offsets_.size(); ++i){
+            offsets_[i] = static_cast<uint32_t>(offsets_[i] + offset_delta);
+        }
+    }
+
+    uint32_t TokenBuffer::get_length(size_t index) const{
+        const TokenKind kind = get_kind(index);
+        if(const unsigned fixed = get_fixed_token_length(kind)){
+            return fixed;
+        }
+        if(kind == TokenKind::eof){
+            return 0;
+        }
+        if(kind == TokenKind::identifier){
+            return get_identifier_info(index)->length;
+        }
+        // literals and unknown tokens: lexing is context free at a token
+        // start, so re-lexing that one token reproduces its length
+        Lexer lexer(*source_manager_, *identifier_table_, file_id_, offsets_[index]);
+        Token tok;
+        lexer.lex(tok);
+        return tok.get_length();
+    }
+
+    size_t TokenBuffer::find_kind(TokenKind kind, size_t from) const{
+        if(from >= kinds_.size()){
+            return kinds_.size();
+        }
+        const void* hit = std::memchr(kinds_.data() + from, static_cast<int>(kind), kinds_.size() - from);
+        return hit ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - kinds_.data()) : kinds_.size();
+    }
+
+    size_t TokenBuffer::find_offset(uint32_t offset) const{
+        return static_cast<size_t>(std::lower_bound(offsets_.begin(), offsets_.end(), offset) -
+                                   offsets_.begin());
+    }
+
+    size_t TokenBuffer::memory_bytes() const{
+        return kinds_.capacity() + flags_.capacity() + offsets_.capacity() * sizeof(uint32_t) +
+               identifiers_.capacity() * sizeof(uint32_t);
+    }
+
+    Token TokenRef::to_token() const{
+        Token tok;
+        tok.set_kind(get_kind());
+        tok.set_location(get_location());
+        tok.set_length(get_length());
+        tok.set_identifier_info(get_identifier_info());
+        if(at_start_of_line()){
+            tok.set_flag_at_start_of_line();
+        }
+        if(has_leading_space()){
+            tok.set_flag_has_leading_space();
+        }
+        return tok;
+    }
+}
@@ -32,6 +32,21 @@ static constexpr const char* kPunctuationSpellings[] = {
 #undef NOVA_KEYWORD
 };
 
+// length of the fixed spelling of keywords and punctuation, 0 otherwise
+static constexpr unsigned char kSpellingLengths[] = {
+#define NOVA_KEYWORD(name, spelling) sizeof(spelling) - 1,
+#define NOVA_TYPE_KEYWORD(name, spelling) sizeof(spelling) - 1,
+#define NOVA_PUNCT(name, spelling) sizeof(spelling) - 1,
+#define NOVA_LITERAL(name, token_name) 0,
+#define NOVA_TOKEN(name, token_name) 0,
+#include "nova/Lex/TokenKinds.def"
+#undef NOVA_TOKEN
+#undef NOVA_LITERAL
+#undef NOVA_PUNCT
+#undef NOVA_TYPE_KEYWORD
+#undef NOVA_KEYWORD
+};
+
 static constexpr unsigned kNumTokenKinds =
     static_cast<unsigned>(sizeof(kTokenNames) / sizeof(kTokenNames[0]));
 // TokenKind starts from 0 to count-1 and is continuous
@@ -59,4 +74,12 @@ const char* get_punctuation_spelling(TokenKind kind) {
     return kPunctuationSpellings[index];
 }
 
+unsigned get_fixed_token_length(TokenKind kind) {
+    auto index = static_cast<unsigned>(kind);
+    if (index >= kNumTokenKinds) {
+        return 0;
+    }
+    return kSpellingLengths[index];
+}
+
 } // namespace nova
@@ -0,0 +1,68 @@
+#include "nova/Lex/TokenStream.hpp"
+#include "nova/Lex/Lexer.hpp"
+
+namespace nova {
+    TokenStream TokenStream::lex(const SourceManager& sm, IdentifierTable& ids, FileID file_id) {
+        TokenStream stream;
+        stream.tokens_ = TokenBuffer(sm, ids, file_id);
+        const FileEntry* file = sm.get_file(file_id);
+        if(!file){
+            return stream;
+        }
+        // roughly one token per 5 bytes of typical source; avoids most regrowth
+        stream.tokens_.reserve(file->content.size() / 5 + 1);
+        Lexer lexer(sm, ids, file_id);
+        Token tok;
+        do {
+            lexer.lex(tok);
+            stream.tokens_.push_back(tok);
+        } while(!tok.is(TokenKind::eof));
+        stream.tokens_.shrink_to_fit();
+        return stream;
+    }
+
+    void TokenStreamCache::lex_all(ThreadPool& pool){
+        const size_t file_count = source_manager_.file_count();
+        std::vector<FileID> pending;
+        for(size_t i = 0; i < file_count; ++i){
+            if(i >= streams_.size() || streams_[i].empty()){
+                pending.push_back(static_cast<FileID>(i + 1));
+            }
+        }
+        streams_.resize(file_count);
+        auto lex_one = [&](size_t i){
+            const FileID file_id = pending[i];
+            streams_[file_id - 1] = TokenStream::lex(source_manager_, identifier_table_, file_id);
+        };
+        if(identifier_table_.is_concurrent()){
+            pool.parallel_for(pending.size(), lex_one);
+        }else{
+            for(size_t i = 0; i < pending.size(); ++i){
+                lex_one(i);
+            }
+        }
+    }
+
+    const TokenStream* TokenStreamCache::get(FileID file_id) const{
+        if(file_id == 0 || file_id > streams_.size() || streams_[file_id - 1].empty()){
+            return nullptr;
+        }
+        return &streams_[file_id - 1];
+    }
+
+    size_t TokenStreamCache::token_count() const{
+        size_t count = 0;
+        for(const TokenStream& stream : streams_){
+            count += stream.size();
+        }
+        return count;
+    }
+
+    size_t TokenStreamCache::memory_bytes() const{
+        size_t bytes = 0;
+        for(const TokenStream& stream : streams_){
+            bytes += stream.get_buffer().memory_bytes();
+        }
+        return bytes;
+    }
+}
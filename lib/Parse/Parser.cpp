@@ -1,4 +1,922 @@
-// TODO: Implement parser
+#include "nova/Parse/Parser.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <memory>
+
 namespace nova {
-    // Placeholder
+namespace {
+
+constexpr std::array<BinaryPrecedence, static_cast<size_t>(TokenKind::count)>
+    kBinaryPrecedence = [] {
+        std::array<BinaryPrecedence, static_cast<size_t>(TokenKind::count)> table{};
+        auto set = [&](TokenKind kind, BinaryPrecedence prec) {
+            table[static_cast<size_t>(kind)] = prec;
+        };
+        set(TokenKind::equal, BinaryPrecedence::Assignment);
+        set(TokenKind::pipepipe, BinaryPrecedence::LogicalOr);
+        set(TokenKind::ampamp, BinaryPrecedence::LogicalAnd);
+        set(TokenKind::equalequal, BinaryPrecedence::Equality);
+        set(TokenKind::exclaimequal, BinaryPrecedence::Equality);
+        set(TokenKind::less, BinaryPrecedence::Relational);
+        set(TokenKind::lessequal, BinaryPrecedence::Relational);
+        set(TokenKind::greater, BinaryPrecedence::Relational);
+        set(TokenKind::greaterequal, BinaryPrecedence::Relational);
+        set(TokenKind::plus, BinaryPrecedence::Additive);
+        set(TokenKind::minus, BinaryPrecedence::Additive);
+        set(TokenKind::star, BinaryPrecedence::Multiplicative);
+        set(TokenKind::slash, BinaryPrecedence::Multiplicative);
+        set(TokenKind::percent, BinaryPrecedence::Multiplicative);
+        return table;
+    }();
+
+ast::BinaryOp get_binary_op(TokenKind kind) {
+    switch (kind) {
+    case TokenKind::star: return ast::BinaryOp::Mul;
+    case TokenKind::slash: return ast::BinaryOp::Div;
+    case TokenKind::percent: return ast::BinaryOp::Rem;
+    case TokenKind::plus: return ast::BinaryOp::Add;
+    case TokenKind::minus: return ast::BinaryOp::Sub;
+    case TokenKind::less: return ast::BinaryOp::Lt;
+    case TokenKind::lessequal: return ast::BinaryOp::Le;
+    case TokenKind::greater: return ast::BinaryOp::Gt;
+    case TokenKind::greaterequal: return ast::BinaryOp::Ge;
+    case TokenKind::equalequal: return ast::BinaryOp::Eq;
+    case TokenKind::exclaimequal: return ast::BinaryOp::Ne;
+    case TokenKind::ampamp: return ast::BinaryOp::LogicalAnd;
+    default: return ast::BinaryOp::LogicalOr;
+    }
 }
+
+// all binary operators except '=' are left associative: the right operand
+// only takes operators that bind tighter
+BinaryPrecedence get_next_precedence(BinaryPrecedence prec) {
+    return static_cast<BinaryPrecedence>(static_cast<uint8_t>(prec) + 1);
+}
+
+const char* get_token_spelling(TokenKind kind) {
+    const char* spelling = get_punctuation_spelling(kind);
+    return spelling ? spelling : get_token_name(kind);
+}
+
+bool get_builtin_type_kind(TokenKind kind, ast::BuiltinType::Kind& out) {
+    using Kind = ast::BuiltinType::Kind;
+    switch (kind) {
+    case TokenKind::kw_i8: out = Kind::I8; return true;
+    case TokenKind::kw_i16: out = Kind::I16; return true;
+    case TokenKind::kw_i32: out = Kind::I32; return true;
+    case TokenKind::kw_i64: out = Kind::I64; return true;
+    case TokenKind::kw_u8: out = Kind::U8; return true;
+    case TokenKind::kw_u16: out = Kind::U16; return true;
+    case TokenKind::kw_u32: out = Kind::U32; return true;
+    case TokenKind::kw_u64: out = Kind::U64; return true;
+    case TokenKind::kw_f32: out = Kind::F32; return true;
+    case TokenKind::kw_f64: out = Kind::F64; return true;
+    case TokenKind::kw_bool: out = Kind::Bool; return true;
+    case TokenKind::kw_char: out = Kind::Char; return true;
+    default: return false;
+    }
+}
+
+int get_digit_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// `spelling` as lexed: decimal, or 0x/0b/0o prefixed. Returns null on
+// success, else what is wrong with the literal.
+const char* parse_integer(std::string_view spelling, uint64_t& value) {
+    unsigned base = 10;
+    if (spelling.size() >= 2 && spelling[0] == '0') {
+        switch (spelling[1]) {
+        case 'x': case 'X': base = 16; break;
+        case 'b': case 'B': base = 2; break;
+        case 'o': case 'O': base = 8; break;
+        default: break;
+        }
+        if (base != 10) {
+            spelling.remove_prefix(2);
+            if (spelling.empty()) {
+                return "expected a digit after the base prefix";
+            }
+        }
+    }
+    value = 0;
+    for (char c : spelling) {
+        const int digit = get_digit_value(c);
+        if (digit < 0 || static_cast<unsigned>(digit) >= base) {
+            return "invalid digit for the literal's base";
+        }
+        if (value > (std::numeric_limits<uint64_t>::max() - static_cast<uint64_t>(digit)) / base) {
+            return "integer literal is too large";
+        }
+        value = value * base + static_cast<uint64_t>(digit);
+    }
+    return nullptr;
+}
+
+// Value of the character literal `spelling` (quotes included): one UTF-8
+// encoded scalar or one escape sequence. Returns DiagnosticID::count on
+// success, else the error to report.
+DiagnosticID decode_char_literal(std::string_view spelling, uint32_t& value) {
+    if (spelling.size() < 2 || spelling.back() != '\'') {
+        return DiagnosticID::err_unterminated_char;
+    }
+    std::string_view body = spelling.substr(1, spelling.size() - 2);
+    if (body.empty()) {
+        return DiagnosticID::err_empty_char_literal;
+    }
+    const auto first = static_cast<unsigned char>(body[0]);
+    if (first == '\\') {
+        if (body.size() < 2) {
+            return DiagnosticID::err_invalid_escape_sequence;
+        }
+        switch (body[1]) {
+        case '\\': value = '\\'; break;
+        case '"': value = '"'; break;
+        case '\'': value = '\''; break;
+        case 'n': value = '\n'; break;
+        case 'r': value = '\r'; break;
+        case 't': value = '\t'; break;
+        case '0': value = 0; break;
+        case 'u': {
+            // \u{HEX}, 1 to 6 digits
+            if (body.size() < 5 || body[2] != '{' || body.back() != '}' || body.size() > 10) {
+                return DiagnosticID::err_invalid_escape_sequence;
+            }
+            value = 0;
+            for (char c : body.substr(3, body.size() - 4)) {
+                const int digit = get_digit_value(c);
+                if (digit < 0) {
+                    return DiagnosticID::err_invalid_escape_sequence;
+                }
+                value = value * 16 + static_cast<uint32_t>(digit);
+            }
+            if ((value >= 0xD800 && value <= 0xDFFF) || value > 0x10FFFF) {
+                return DiagnosticID::err_invalid_escape_sequence;
+            }
+            return DiagnosticID::count;
+        }
+        default: return DiagnosticID::err_invalid_escape_sequence;
+        }
+        return body.size() == 2 ? DiagnosticID::count : DiagnosticID::err_multichar_literal;
+    }
+    size_t length = 1;
+    value = first;
+    if (first >= 0xF0) {
+        length = 4;
+        value = first & 0x07;
+    } else if (first >= 0xE0) {
+        length = 3;
+        value = first & 0x0F;
+    } else if (first >= 0xC0) {
+        length = 2;
+        value = first & 0x1F;
+    }
+    if (body.size() < length) {
+        return DiagnosticID::err_invalid_escape_sequence;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        value = (value << 6) | (static_cast<unsigned char>(body[i]) & 0x3F);
+    }
+    return body.size() == length ? DiagnosticID::count : DiagnosticID::err_multichar_literal;
+}
+
+} // namespace
+
+BinaryPrecedence get_binary_precedence(TokenKind kind) {
+    return kBinaryPrecedence[static_cast<size_t>(kind)];
+}
+
+Parser::Parser(const TokenStream& tokens, ast::ASTContext& context, DiagnosticEngine& diags)
+    : tokens_(tokens), buffer_(tokens.get_buffer()), context_(context), diags_(diags) {
+    if (const SourceManager* sm = buffer_.get_source_manager()) {
+        source_ = sm->get_file(buffer_.get_file_id())->content;
+    }
+}
+
+std::string_view Parser::get_spelling(const TokenRef& tok) const {
+    return source_.substr(buffer_.get_offset(tok.get_index()), tok.get_length());
+}
+
+//===----------------------------------------------------------------------===//
+// Items
+//===----------------------------------------------------------------------===//
+
+ast::ModuleDecl* Parser::parse_module(IdentifierInfo* name) {
+    const SourceLocation loc = current_location();
+    std::vector<ast::Decl*> items;
+    while (!at_end()) {
+        const size_t start = index_;
+        if (ast::Decl* item = parse_item()) {
+            items.push_back(item);
+            continue;
+        }
+        if (index_ == start) {
+            consume();
+        }
+        skip_to_next_item();
+    }
+    return ast::ModuleDecl::create(context_, loc, name, items);
+}
+
+ast::Decl* Parser::parse_item() {
+    switch (peek_kind()) {
+    case TokenKind::kw_func:
+        return parse_func_decl();
+    case TokenKind::kw_use:
+        return parse_use_decl();
+    default:
+        report(DiagnosticID::err_invalid_declaration, current_location())
+            << ": expected 'func' or 'use'";
+        return nullptr;
+    }
+}
+
+// FuncDecl := "func" Ident "(" Params? ")" ("->" Type)? Block
+ast::FuncDecl* Parser::parse_func_decl() {
+    consume();
+    if (!peek().is(TokenKind::identifier)) {
+        report_expected(TokenKind::identifier);
+        return nullptr;
+    }
+    IdentifierInfo* name = peek().get_identifier_info();
+    const SourceLocation name_loc = consume();
+
+    if (!expect(TokenKind::l_paren)) {
+        return nullptr;
+    }
+    std::vector<ast::ParamDecl*> params;
+    while (!peek().is(TokenKind::r_paren)) {
+        ast::ParamDecl* param = parse_param_decl();
+        if (!param) {
+            return nullptr;
+        }
+        params.push_back(param);
+        if (!try_consume(TokenKind::comma)) {
+            break;
+        }
+    }
+    if (!expect(TokenKind::r_paren)) {
+        return nullptr;
+    }
+
+    const ast::Type* return_type = nullptr;
+    if (try_consume(TokenKind::arrow)) {
+        return_type = parse_type();
+        if (!return_type) {
+            return nullptr;
+        }
+    }
+
+    ast::FuncDecl* func = ast::FuncDecl::create(context_, name_loc, name, params, return_type);
+    if (!peek().is(TokenKind::l_brace)) {
+        report_expected(TokenKind::l_brace);
+        return nullptr;
+    }
+    if (skip_function_bodies_) {
+        const size_t close = find_matching_brace(index_);
+        if (close < buffer_.size()) {
+            func->set_skipped_body(static_cast<uint32_t>(index_));
+            index_ = close + 1;
+            return func;
+        }
+    }
+    ast::BlockExpr* body = parse_block();
+    if (!body) {
+        return nullptr;
+    }
+    func->set_body(body);
+    return func;
+}
+
+ast::BlockExpr* Parser::parse_function_body(ast::FuncDecl* func) {
+    if (!func->has_skipped_body()) {
+        return func->get_body();
+    }
+    const size_t saved = index_;
+    index_ = func->get_body_token_index();
+    ast::BlockExpr* body = parse_block();
+    index_ = saved;
+    func->set_body(body);
+    return body;
+}
+
+void Parser::parse_function_bodies(std::span<ast::FuncDecl* const> funcs, ThreadPool& pool) {
+    // a few chunks per thread balances uneven bodies while keeping each
+    // shard's arena reasonably full
+    const size_t chunk_count = std::min(funcs.size(), size_t{pool.size()} * 4);
+    std::vector<std::unique_ptr<ast::ASTContext>> shards(chunk_count);
+    std::vector<uint32_t> errors(chunk_count, 0);
+    pool.parallel_for(chunk_count, [&](size_t chunk) {
+        const size_t begin = funcs.size() * chunk / chunk_count;
+        const size_t end = funcs.size() * (chunk + 1) / chunk_count;
+        shards[chunk] = std::make_unique<ast::ASTContext>(&context_);
+        Parser parser(tokens_, *shards[chunk], diags_);
+        for (size_t i = begin; i < end; ++i) {
+            parser.parse_function_body(funcs[i]);
+        }
+        errors[chunk] = parser.get_error_count();
+    });
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        context_.adopt(*shards[chunk]);
+        error_count_ += errors[chunk];
+    }
+}
+
+// Param := Ident ":" Type
+ast::ParamDecl* Parser::parse_param_decl() {
+    if (!peek().is(TokenKind::identifier)) {
+        report_expected(TokenKind::identifier);
+        return nullptr;
+    }
+    IdentifierInfo* name = peek().get_identifier_info();
+    const SourceLocation loc = consume();
+    if (!expect(TokenKind::colon)) {
+        return nullptr;
+    }
+    const ast::Type* type = parse_type();
+    if (!type) {
+        return nullptr;
+    }
+    return context_.create<ast::ParamDecl>(loc, name, type);
+}
+
+// UseDecl := "use" Ident ("::" Ident)* ";"
+ast::UseDecl* Parser::parse_use_decl() {
+    const SourceLocation loc = consume();
+    std::vector<IdentifierInfo*> path;
+    do {
+        if (!peek().is(TokenKind::identifier)) {
+            report_expected(TokenKind::identifier);
+            return nullptr;
+        }
+        path.push_back(peek().get_identifier_info());
+        consume();
+    } while (try_consume(TokenKind::coloncolon));
+    if (!expect(TokenKind::semi)) {
+        return nullptr;
+    }
+    return ast::UseDecl::create(context_, loc, path);
+}
+
+//===----------------------------------------------------------------------===//
+// Types
+//===----------------------------------------------------------------------===//
+
+// Type := PrimType | "str" | "()" | "(" Type ("," Type)* ")" | "&" "mut"? Type
+//       | "[" Type (";" IntLit)? "]" | Ident ("::" Ident)*
+//
+// A path names a type declared elsewhere; until Sema resolves it, it is a
+// StructType with no declaration.
+const ast::Type* Parser::parse_type() {
+    ast::BuiltinType::Kind builtin;
+    if (get_builtin_type_kind(peek_kind(), builtin)) {
+        consume();
+        return context_.get_builtin_type(builtin);
+    }
+    switch (peek_kind()) {
+    case TokenKind::kw_str:
+        consume();
+        return context_.get_str_type();
+    case TokenKind::amp: {
+        consume();
+        const bool is_mutable = try_consume(TokenKind::kw_mut);
+        const ast::Type* pointee = parse_type();
+        return pointee ? context_.get_reference_type(pointee, is_mutable) : nullptr;
+    }
+    case TokenKind::l_square: {
+        consume();
+        const ast::Type* element = parse_type();
+        if (!element) {
+            return nullptr;
+        }
+        if (try_consume(TokenKind::semi)) {
+            uint64_t size = 0;
+            if (!peek().is(TokenKind::numeric_constant) ||
+                parse_integer(get_spelling(peek()), size) != nullptr) {
+                report(DiagnosticID::err_invalid_number_literal, current_location())
+                    << ": expected array length";
+                return nullptr;
+            }
+            consume();
+            return expect(TokenKind::r_square) ? context_.get_array_type(element, size)
+                                               : nullptr;
+        }
+        return expect(TokenKind::r_square) ? context_.get_slice_type(element) : nullptr;
+    }
+    case TokenKind::l_paren: {
+        consume();
+        std::vector<const ast::Type*> elements;
+        bool trailing_comma = false;
+        while (!peek().is(TokenKind::r_paren)) {
+            const ast::Type* element = parse_type();
+            if (!element) {
+                return nullptr;
+            }
+            elements.push_back(element);
+            trailing_comma = try_consume(TokenKind::comma);
+            if (!trailing_comma) {
+                break;
+            }
+        }
+        if (!expect(TokenKind::r_paren)) {
+            return nullptr;
+        }
+        // (T) is T; (T,) is a one-element tuple
+        if (elements.size() == 1 && !trailing_comma) {
+            return elements[0];
+        }
+        return context_.get_tuple_type(elements);
+    }
+    case TokenKind::identifier: {
+        IdentifierInfo* name = peek().get_identifier_info();
+        consume();
+        while (peek().is(TokenKind::coloncolon) && peek(1).is(TokenKind::identifier)) {
+            name = peek(1).get_identifier_info();
+            index_ += 2;
+        }
+        if (name->get_name() == "String") {
+            return context_.get_string_type();
+        }
+        return context_.get_struct_type(name, nullptr);
+    }
+    default:
+        report(DiagnosticID::err_expected_type, current_location()) << ": expected a type";
+        return nullptr;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Statements
+//===----------------------------------------------------------------------===//
+
+// Block := "{" Stmt* Expr? "}"
+ast::BlockExpr* Parser::parse_block() {
+    const SourceLocation loc = consume();
+    const size_t base = stmt_stack_.size();
+    ast::Expr* result = nullptr;
+    while (!peek().is_one_of(TokenKind::r_brace, TokenKind::eof)) {
+        if (try_consume(TokenKind::semi)) {
+            continue;
+        }
+        if (result) {
+            // an expression without ';' that was not the last thing in the
+            // block; keep it as a statement and report the missing ';'
+            report_expected(TokenKind::semi);
+            stmt_stack_.push_back(
+                context_.create<ast::ExprStmt>(result->get_location(), result, false));
+            result = nullptr;
+        }
+        const SourceLocation start = current_location();
+        switch (peek_kind()) {
+        case TokenKind::kw_let:
+        case TokenKind::kw_return:
+        case TokenKind::kw_while:
+        case TokenKind::kw_break:
+        case TokenKind::kw_continue:
+            if (ast::Stmt* stmt = parse_statement()) {
+                stmt_stack_.push_back(stmt);
+            } else {
+                skip_to_statement_end();
+            }
+            continue;
+        default:
+            break;
+        }
+
+        // Block-like expressions end a statement at their '}', so
+        // `if c { a } -x` is two statements.
+        const bool block_like = peek().is_one_of(TokenKind::l_brace, TokenKind::kw_if);
+        ast::Expr* expr = !block_like                   ? parse_expression()
+                          : peek().is(TokenKind::kw_if) ? parse_if_expr()
+                                                        : parse_block();
+        if (!expr) {
+            skip_to_statement_end();
+            continue;
+        }
+        if (try_consume(TokenKind::semi)) {
+            stmt_stack_.push_back(context_.create<ast::ExprStmt>(start, expr, true));
+        } else if (peek().is(TokenKind::r_brace)) {
+            result = expr;
+        } else if (block_like) {
+            stmt_stack_.push_back(context_.create<ast::ExprStmt>(start, expr, false));
+        } else {
+            result = expr;
+        }
+    }
+
+    SourceLocation r_brace_loc = current_location();
+    if (!try_consume(TokenKind::r_brace)) {
+        report_expected(TokenKind::r_brace);
+        r_brace_loc = SourceLocation::invalid();
+    }
+    const std::span<ast::Stmt* const> stmts(stmt_stack_.data() + base,
+                                            stmt_stack_.size() - base);
+    ast::BlockExpr* block = ast::BlockExpr::create(context_, loc, stmts, result, r_brace_loc);
+    stmt_stack_.resize(base);
+    return block;
+}
+
+ast::Stmt* Parser::parse_statement() {
+    while (try_consume(TokenKind::semi)) {
+    }
+    const SourceLocation loc = current_location();
+    switch (peek_kind()) {
+    case TokenKind::kw_let:
+        return parse_let_stmt();
+    case TokenKind::kw_return:
+        return parse_return_stmt();
+    case TokenKind::kw_while:
+        return parse_while_stmt();
+    case TokenKind::kw_break:
+        consume();
+        return expect(TokenKind::semi) ? context_.create<ast::BreakStmt>(loc) : nullptr;
+    case TokenKind::kw_continue:
+        consume();
+        return expect(TokenKind::semi) ? context_.create<ast::ContinueStmt>(loc) : nullptr;
+    default:
+        break;
+    }
+    const bool block_like = peek().is_one_of(TokenKind::l_brace, TokenKind::kw_if);
+    ast::Expr* expr = !block_like                   ? parse_expression()
+                      : peek().is(TokenKind::kw_if) ? parse_if_expr()
+                                                    : parse_block();
+    if (!expr) {
+        return nullptr;
+    }
+    const bool has_semicolon = try_consume(TokenKind::semi);
+    if (!has_semicolon && !block_like) {
+        report_expected(TokenKind::semi);
+        return nullptr;
+    }
+    return context_.create<ast::ExprStmt>(loc, expr, has_semicolon);
+}
+
+// LetStmt := "let" "mut"? Ident (":" Type)? ("=" Expr)? ";"
+ast::DeclStmt* Parser::parse_let_stmt() {
+    const SourceLocation let_loc = consume();
+    const bool is_mutable = try_consume(TokenKind::kw_mut);
+    if (!peek().is(TokenKind::identifier)) {
+        report_expected(TokenKind::identifier);
+        return nullptr;
+    }
+    IdentifierInfo* name = peek().get_identifier_info();
+    const SourceLocation name_loc = consume();
+
+    const ast::Type* declared_type = nullptr;
+    if (try_consume(TokenKind::colon)) {
+        declared_type = parse_type();
+        if (!declared_type) {
+            return nullptr;
+        }
+    }
+    ast::Expr* init = nullptr;
+    if (try_consume(TokenKind::equal)) {
+        init = parse_expression();
+        if (!init) {
+            return nullptr;
+        }
+    }
+    if (!expect(TokenKind::semi)) {
+        return nullptr;
+    }
+    auto* decl =
+        context_.create<ast::VarDecl>(name_loc, name, is_mutable, declared_type, init);
+    return context_.create<ast::DeclStmt>(let_loc, decl);
+}
+
+// ReturnStmt := "return" Expr? ";"
+ast::ReturnStmt* Parser::parse_return_stmt() {
+    const SourceLocation loc = consume();
+    ast::Expr* value = nullptr;
+    if (!peek().is(TokenKind::semi)) {
+        value = parse_expression();
+        if (!value) {
+            return nullptr;
+        }
+    }
+    if (!expect(TokenKind::semi)) {
+        return nullptr;
+    }
+    return context_.create<ast::ReturnStmt>(loc, value);
+}
+
+// WhileStmt := "while" Expr Block
+ast::WhileStmt* Parser::parse_while_stmt() {
+    const SourceLocation loc = consume();
+    ast::Expr* cond = parse_expression();
+    if (!cond) {
+        return nullptr;
+    }
+    if (!peek().is(TokenKind::l_brace)) {
+        report_expected(TokenKind::l_brace);
+        return nullptr;
+    }
+    ast::BlockExpr* body = parse_block();
+    return context_.create<ast::WhileStmt>(loc, cond, body);
+}
+
+//===----------------------------------------------------------------------===//
+// Expressions
+//===----------------------------------------------------------------------===//
+
+ast::Expr* Parser::parse_expression() { return parse_assignment(); }
+
+// AssignExpr := LogicOr ("=" AssignExpr)?
+ast::Expr* Parser::parse_assignment() {
+    ast::Expr* lhs = parse_binary(BinaryPrecedence::LogicalOr);
+    if (!lhs || !peek().is(TokenKind::equal)) {
+        return lhs;
+    }
+    const SourceLocation loc = consume();
+    ast::Expr* rhs = parse_assignment();
+    if (!rhs) {
+        return nullptr;
+    }
+    return context_.create<ast::AssignExpr>(loc, lhs, rhs);
+}
+
+// Precedence climbing: fold operators that bind at least as tightly as
+// `min_precedence` into lhs, parsing each right operand one level tighter.
+ast::Expr* Parser::parse_binary(BinaryPrecedence min_precedence) {
+    ast::Expr* lhs = parse_unary();
+    if (!lhs) {
+        return nullptr;
+    }
+    while (true) {
+        const TokenKind kind = peek_kind();
+        const BinaryPrecedence prec = get_binary_precedence(kind);
+        if (prec < min_precedence || prec == BinaryPrecedence::Assignment) {
+            return lhs;
+        }
+        const SourceLocation loc = consume();
+        ast::Expr* rhs = parse_binary(get_next_precedence(prec));
+        if (!rhs) {
+            return nullptr;
+        }
+        lhs = context_.create<ast::BinaryExpr>(loc, get_binary_op(kind), lhs, rhs);
+    }
+}
+
+// Unary := ("-" | "!") Unary | Postfix
+ast::Expr* Parser::parse_unary() {
+    if (peek().is_one_of(TokenKind::minus, TokenKind::exclaim)) {
+        const ast::UnaryOp op =
+            peek().is(TokenKind::minus) ? ast::UnaryOp::Neg : ast::UnaryOp::Not;
+        const SourceLocation loc = consume();
+        ast::Expr* operand = parse_unary();
+        if (!operand) {
+            return nullptr;
+        }
+        return context_.create<ast::UnaryExpr>(loc, op, operand);
+    }
+    ast::Expr* primary = parse_primary();
+    return primary ? parse_postfix(primary) : nullptr;
+}
+
+// Call := Postfix "(" Args? ")"
+ast::Expr* Parser::parse_postfix(ast::Expr* base) {
+    while (peek().is(TokenKind::l_paren)) {
+        const SourceLocation l_paren_loc = consume();
+        const size_t first = expr_stack_.size();
+        while (!peek().is(TokenKind::r_paren)) {
+            ast::Expr* arg = parse_expression();
+            if (!arg) {
+                expr_stack_.resize(first);
+                return nullptr;
+            }
+            expr_stack_.push_back(arg);
+            if (!try_consume(TokenKind::comma)) {
+                break;
+            }
+        }
+        const SourceLocation r_paren_loc = current_location();
+        if (!expect(TokenKind::r_paren)) {
+            expr_stack_.resize(first);
+            return nullptr;
+        }
+        const std::span<ast::Expr* const> args(expr_stack_.data() + first,
+                                               expr_stack_.size() - first);
+        base = ast::CallExpr::create(context_, l_paren_loc, base, args, r_paren_loc);
+        expr_stack_.resize(first);
+    }
+    return base;
+}
+
+// Primary := Literal | Ident | "(" Expr ")" | Block | IfExpr
+ast::Expr* Parser::parse_primary() {
+    switch (peek_kind()) {
+    case TokenKind::numeric_constant:
+    case TokenKind::floating_constant:
+    case TokenKind::string_literal:
+    case TokenKind::char_constant:
+    case TokenKind::kw_true:
+    case TokenKind::kw_false:
+        return parse_literal();
+    case TokenKind::identifier: {
+        IdentifierInfo* name = peek().get_identifier_info();
+        return context_.create<ast::IdentifierExpr>(consume(), name);
+    }
+    case TokenKind::l_paren: {
+        consume();
+        ast::Expr* inner = parse_expression();
+        if (!inner || !expect(TokenKind::r_paren)) {
+            return nullptr;
+        }
+        return inner;
+    }
+    case TokenKind::l_brace:
+        return parse_block();
+    case TokenKind::kw_if:
+        return parse_if_expr();
+    default:
+        report(DiagnosticID::err_expected_expression, current_location())
+            << ": expected an expression";
+        return nullptr;
+    }
+}
+
+// IfExpr := "if" Expr Block ("else" (IfExpr | Block))?
+ast::Expr* Parser::parse_if_expr() {
+    const SourceLocation loc = consume();
+    ast::Expr* cond = parse_expression();
+    if (!cond) {
+        return nullptr;
+    }
+    if (!peek().is(TokenKind::l_brace)) {
+        report_expected(TokenKind::l_brace);
+        return nullptr;
+    }
+    ast::BlockExpr* then_block = parse_block();
+    ast::Expr* else_branch = nullptr;
+    if (try_consume(TokenKind::kw_else)) {
+        if (peek().is(TokenKind::kw_if)) {
+            else_branch = parse_if_expr();
+        } else if (peek().is(TokenKind::l_brace)) {
+            else_branch = parse_block();
+        } else {
+            report_expected(TokenKind::l_brace);
+        }
+        if (!else_branch) {
+            return nullptr;
+        }
+    }
+    return context_.create<ast::IfExpr>(loc, cond, then_block, else_branch);
+}
+
+ast::Expr* Parser::parse_literal() {
+    const TokenRef tok = peek();
+    const SourceLocation loc = consume();
+    switch (tok.get_kind()) {
+    case TokenKind::kw_true:
+        return ast::LiteralExpr::create_bool(context_, loc, true);
+    case TokenKind::kw_false:
+        return ast::LiteralExpr::create_bool(context_, loc, false);
+    case TokenKind::numeric_constant: {
+        const std::string_view spelling = get_spelling(tok);
+        uint64_t value = 0;
+        if (const char* error = parse_integer(spelling, value)) {
+            report(DiagnosticID::err_invalid_number_literal, loc) << ": " << error;
+        }
+        return ast::LiteralExpr::create_integer(context_, loc, spelling, value);
+    }
+    case TokenKind::floating_constant: {
+        const std::string_view spelling = get_spelling(tok);
+        double value = 0.0;
+        const auto parsed = std::from_chars(spelling.data(), spelling.data() + spelling.size(),
+                                            value);
+        if (parsed.ec != std::errc()) {
+            report(DiagnosticID::err_invalid_number_literal, loc)
+                << ": '" << spelling << "' is not a valid floating-point literal";
+        }
+        return ast::LiteralExpr::create_float(context_, loc, spelling, value);
+    }
+    case TokenKind::char_constant: {
+        const std::string_view spelling = get_spelling(tok);
+        uint32_t value = 0;
+        const DiagnosticID error = decode_char_literal(spelling, value);
+        if (error != DiagnosticID::count) {
+            report(error, loc) << ": " << spelling;
+        }
+        return ast::LiteralExpr::create_char(context_, loc, spelling, value);
+    }
+    default: {
+        const std::string_view spelling = get_spelling(tok);
+        if (spelling.size() < 2 || spelling.back() != '"') {
+            report(DiagnosticID::err_unterminated_string, loc) << ": missing closing '\"'";
+        }
+        return ast::LiteralExpr::create_string(context_, loc, spelling);
+    }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Error handling
+//===----------------------------------------------------------------------===//
+
+DiagnosticBuilder Parser::report(DiagnosticID id, SourceLocation loc) {
+    ++error_count_;
+    return diags_.report(id, loc);
+}
+
+bool Parser::expect(TokenKind kind) {
+    if (try_consume(kind)) {
+        return true;
+    }
+    report_expected(kind);
+    return false;
+}
+
+void Parser::report_expected(TokenKind kind) {
+    const SourceLocation loc = current_location();
+    switch (kind) {
+    case TokenKind::semi:
+        report(DiagnosticID::err_expected_semicolon, loc) << ": ';'";
+        return;
+    case TokenKind::r_paren:
+        report(DiagnosticID::err_expected_closing_paren, loc) << ": ')'";
+        return;
+    case TokenKind::r_brace:
+        report(DiagnosticID::err_expected_closing_brace, loc) << ": '}'";
+        return;
+    case TokenKind::r_square:
+        report(DiagnosticID::err_expected_closing_bracket, loc) << ": ']'";
+        return;
+    case TokenKind::identifier:
+        report(DiagnosticID::err_expected_identifier, loc) << ": expected an identifier";
+        return;
+    default:
+        report(DiagnosticID::err_expected_token, loc) << ": '" << get_token_spelling(kind)
+                                                       << "'";
+        return;
+    }
+}
+
+void Parser::skip_to_statement_end() {
+    unsigned depth = 0;
+    while (!at_end()) {
+        switch (peek_kind()) {
+        case TokenKind::l_brace:
+            ++depth;
+            break;
+        case TokenKind::r_brace:
+            if (depth == 0) {
+                return;
+            }
+            --depth;
+            break;
+        case TokenKind::semi:
+            if (depth == 0) {
+                consume();
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+        consume();
+    }
+}
+
+size_t Parser::find_matching_brace(size_t open) const {
+    // a scan of the kind bytes; braces inside literals are part of the
+    // literal's token
+    const uint8_t* kinds = buffer_.kind_data();
+    const size_t size = buffer_.size();
+    size_t depth = 0;
+    for (size_t i = open; i < size; ++i) {
+        const auto kind = static_cast<TokenKind>(kinds[i]);
+        if (kind == TokenKind::l_brace) {
+            ++depth;
+        } else if (kind == TokenKind::r_brace && --depth == 0) {
+            return i;
+        }
+    }
+    return size;
+}
+
+void Parser::skip_to_next_item() {
+    unsigned depth = 0;
+    while (!at_end() && !(depth == 0 && peek().is_one_of(TokenKind::kw_func, TokenKind::kw_use))) {
+        if (peek().is(TokenKind::l_brace)) {
+            ++depth;
+        } else if (peek().is(TokenKind::r_brace) && depth > 0) {
+            --depth;
+        }
+        consume();
+    }
+}
+
+} // namespace nova
@@ -0,0 +1,35 @@
+#include "nova/Sema/Scope.hpp"
+#include <cassert>
+
+namespace nova {
+namespace sema {
+
+void ScopeStack::pop_scope() {
+    assert(!scope_marks_.empty() && "popping with no open scope");
+    const uint32_t mark = scope_marks_.back();
+    scope_marks_.pop_back();
+    while (undo_log_.size() > mark) {
+        const Symbol* symbol = undo_log_.back();
+        undo_log_.pop_back();
+        bindings_[symbol->get_name()->id] = symbol->get_shadowed();
+    }
+}
+
+Symbol* ScopeStack::insert(Symbol* symbol) {
+    assert(!scope_marks_.empty() && "declaring with no open scope");
+    const uint32_t id = symbol->get_name()->id;
+    if (id >= bindings_.size()) {
+        bindings_.resize(static_cast<size_t>(id) + 1, nullptr);
+    }
+    Symbol* previous = bindings_[id];
+    if (previous && previous->get_scope_depth() == get_depth()) {
+        return previous;
+    }
+    symbol->bind(previous, get_depth());
+    bindings_[id] = symbol;
+    undo_log_.push_back(symbol);
+    return nullptr;
+}
+
+} // namespace sema
+} // namespace nova
@@ -0,0 +1,624 @@
+#include "nova/Sema/TypeChecker.hpp"
+#include "nova/AST/Expr.hpp"
+#include "nova/AST/Stmt.hpp"
+#include "nova/AST/Type.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/Sema/Scope.hpp"
+#include <algorithm>
+#include <string>
+
+namespace nova {
+namespace sema {
+
+using namespace ast;
+
+namespace {
+
+using BuiltinKind = BuiltinType::Kind;
+
+bool is_builtin(const Type* type, BuiltinKind kind) {
+    const auto* builtin = dyn_cast_if_present<BuiltinType>(type);
+    return builtin && builtin->get_builtin_kind() == kind;
+}
+
+bool is_never(const Type* type) { return is_builtin(type, BuiltinKind::Never); }
+
+bool is_integer(const Type* type) {
+    const auto* builtin = dyn_cast_if_present<BuiltinType>(type);
+    return builtin && builtin->is_integer();
+}
+
+bool is_float(const Type* type) {
+    const auto* builtin = dyn_cast_if_present<BuiltinType>(type);
+    return builtin && builtin->is_float();
+}
+
+bool is_numeric(const Type* type) { return is_integer(type) || is_float(type); }
+
+bool is_unsigned(const Type* type) {
+    const auto* builtin = dyn_cast_if_present<BuiltinType>(type);
+    return builtin && builtin->get_builtin_kind() >= BuiltinKind::U8 &&
+           builtin->get_builtin_kind() <= BuiltinKind::U64;
+}
+
+// A diverging expression (type `!`) fits wherever a value is expected.
+bool coerces_to(const Type* actual, const Type* expected) {
+    return actual == expected || is_never(actual);
+}
+
+// The parser turns every path type into a StructType without a declaration;
+// Nova Core declares no nominal types, so any such type is undefined.
+const NominalType* find_unresolved_type(const Type* type) {
+    if (!type) {
+        return nullptr;
+    }
+    switch (type->get_kind()) {
+    case TypeKind::Pointer:
+        return find_unresolved_type(cast<PointerType>(type)->get_pointee());
+    case TypeKind::Reference:
+        return find_unresolved_type(cast<ReferenceType>(type)->get_pointee());
+    case TypeKind::Array:
+        return find_unresolved_type(cast<ArrayType>(type)->get_element());
+    case TypeKind::Slice:
+        return find_unresolved_type(cast<SliceType>(type)->get_element());
+    case TypeKind::Tuple:
+        for (const Type* element : cast<TupleType>(type)->get_elements()) {
+            if (const NominalType* unresolved = find_unresolved_type(element)) {
+                return unresolved;
+            }
+        }
+        return nullptr;
+    case TypeKind::Function: {
+        const auto* func = cast<FunctionType>(type);
+        for (const Type* param : func->get_params()) {
+            if (const NominalType* unresolved = find_unresolved_type(param)) {
+                return unresolved;
+            }
+        }
+        return find_unresolved_type(func->get_result());
+    }
+    default:
+        if (const auto* nominal = dyn_cast<NominalType>(type)) {
+            return nominal->get_decl() ? nullptr : nominal;
+        }
+        return nullptr;
+    }
+}
+
+/// Checks function bodies, one at a time. Everything it mutates (scopes,
+/// symbols, the loop depth, the error count) belongs to it, and the AST nodes
+/// it types belong to the body, so checkers on different threads run in
+/// parallel. Reusing one checker for many bodies reuses its binding table.
+class BodyChecker {
+private:
+    const TypeChecker& checker_;
+    ASTContext& context_;
+    DiagnosticEngine& diags_;
+    Arena symbols_;
+    ScopeStack scopes_;
+    const Type* return_type_ = nullptr;
+    uint32_t loop_depth_ = 0;
+    uint32_t error_count_ = 0;
+
+public:
+    explicit BodyChecker(const TypeChecker& checker)
+        : checker_(checker), context_(checker.get_context()), diags_(checker.get_diagnostics()) {}
+
+    /// Check the body of `func`; returns the number of errors reported.
+    uint32_t check(FuncDecl* func);
+
+private:
+    DiagnosticBuilder report(DiagnosticID id, SourceLocation loc) {
+        ++error_count_;
+        return diags_.report(id, loc);
+    }
+    void report_mismatch(DiagnosticID id, SourceLocation loc, const Type* expected,
+                         const Type* actual) {
+        report(id, loc) << ": expected '" << get_type_name(expected) << "', found '"
+                        << get_type_name(actual) << "'";
+    }
+    void report_redefinition(IdentifierInfo* name, SourceLocation loc, const Symbol* previous) {
+        report(DiagnosticID::err_redefinition, loc) << ": '" << name->get_name() << "'";
+        diags_.report(DiagnosticID::note_declared_here, previous->get_decl()->get_location())
+            << ": '" << name->get_name() << "' declared here";
+    }
+
+    Symbol* lookup(IdentifierInfo* name) const {
+        if (Symbol* local = scopes_.lookup(name)) {
+            return local;
+        }
+        return checker_.lookup_function(name);
+    }
+
+    // Statements
+    const Type* check_block(BlockExpr* block, const Type* expected);
+    /// True if the statement always leaves the enclosing block.
+    bool check_stmt(Stmt* stmt);
+    void check_let(VarDecl* var);
+
+    // Expressions; `expected` (may be null) types integer and float literals
+    const Type* check_expr(Expr* expr, const Type* expected);
+    const Type* check_literal(LiteralExpr* lit, const Type* expected);
+    const Type* check_identifier(IdentifierExpr* id);
+    const Type* check_binary(BinaryExpr* bin, const Type* expected);
+    const Type* check_unary(UnaryExpr* un, const Type* expected);
+    const Type* check_assign(AssignExpr* assign);
+    const Type* check_call(CallExpr* call);
+    const Type* check_if(IfExpr* if_expr, const Type* expected);
+    /// Check `expr` against `expected` exactly; false after reporting `id`.
+    bool check_operand(Expr* expr, const Type* expected, DiagnosticID id);
+};
+
+uint32_t BodyChecker::check(FuncDecl* func) {
+    BlockExpr* body = func->get_body();
+    if (!body) {
+        return 0;
+    }
+    return_type_ = func->get_return_type() ? func->get_return_type() : checker_.get_unit_type();
+    loop_depth_ = 0;
+    const uint32_t previous_errors = error_count_;
+
+    Scope params(scopes_);
+    for (ParamDecl* param : func->get_params()) {
+        Symbol* symbol = symbols_.create<Symbol>(Symbol::Kind::Param, param->get_name(), param,
+                                                 param->get_type());
+        if (const Symbol* previous = scopes_.insert(symbol)) {
+            report_redefinition(param->get_name(), param->get_location(), previous);
+        }
+    }
+
+    const Type* type = check_block(body, return_type_);
+    if (type && !coerces_to(type, return_type_)) {
+        const SourceLocation loc =
+            body->get_result() ? body->get_result()->get_location() : body->get_r_brace_location();
+        if (type == checker_.get_unit_type()) {
+            report(DiagnosticID::err_missing_return, loc)
+                << ": '" << func->get_name()->get_name() << "' must return '"
+                << get_type_name(return_type_) << "'";
+        } else {
+            report_mismatch(DiagnosticID::err_type_mismatch, loc, return_type_, type);
+        }
+    }
+    return error_count_ - previous_errors;
+}
+
+//===----------------------------------------------------------------------===//
+// Statements
+//===----------------------------------------------------------------------===//
+
+const Type* BodyChecker::check_block(BlockExpr* block, const Type* expected) {
+    Scope scope(scopes_);
+    bool diverges = false;
+    for (Stmt* stmt : block->get_stmts()) {
+        diverges |= check_stmt(stmt);
+    }
+    const Type* type = nullptr;
+    if (Expr* result = block->get_result()) {
+        type = check_expr(result, expected);
+    } else {
+        type = diverges ? context_.get_builtin_type(BuiltinKind::Never) : checker_.get_unit_type();
+    }
+    if (type) {
+        block->set_type(type);
+    }
+    return type;
+}
+
+bool BodyChecker::check_stmt(Stmt* stmt) {
+    switch (stmt->get_kind()) {
+    case ASTNodeKind::DeclStmt:
+        check_let(cast<DeclStmt>(stmt)->get_decl());
+        return false;
+    case ASTNodeKind::ExprStmt:
+        return is_never(check_expr(cast<ExprStmt>(stmt)->get_expr(), nullptr));
+    case ASTNodeKind::ReturnStmt: {
+        Expr* value = cast<ReturnStmt>(stmt)->get_value();
+        if (!value) {
+            if (return_type_ != checker_.get_unit_type()) {
+                report(DiagnosticID::err_missing_return, stmt->get_location())
+                    << ": expected a value of type '" << get_type_name(return_type_) << "'";
+            }
+            return true;
+        }
+        check_operand(value, return_type_, DiagnosticID::err_type_mismatch);
+        return true;
+    }
+    case ASTNodeKind::WhileStmt: {
+        auto* loop = cast<WhileStmt>(stmt);
+        check_operand(loop->get_cond(), context_.get_bool_type(), DiagnosticID::err_type_mismatch);
+        ++loop_depth_;
+        check_block(loop->get_body(), nullptr);
+        --loop_depth_;
+        return false;
+    }
+    case ASTNodeKind::BreakStmt:
+    case ASTNodeKind::ContinueStmt:
+        if (loop_depth_ == 0) {
+            report(DiagnosticID::err_break_outside_loop, stmt->get_location())
+                << ": '" << (isa<BreakStmt>(stmt) ? "break" : "continue")
+                << "' outside of a loop";
+            return false;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+// LetStmt: the name is bound after the initializer is checked, so
+// `let x = x + 1;` reads the outer `x`.
+void BodyChecker::check_let(VarDecl* var) {
+    const Type* type = var->get_declared_type();
+    if (const NominalType* unresolved = find_unresolved_type(type)) {
+        report(DiagnosticID::err_undefined_type, var->get_location())
+            << ": '" << unresolved->get_name()->get_name() << "'";
+        type = nullptr;
+    }
+    if (Expr* init = var->get_init()) {
+        if (var->get_declared_type()) {
+            if (type) {
+                check_operand(init, type, DiagnosticID::err_type_mismatch);
+            } else {
+                check_expr(init, nullptr);
+            }
+        } else {
+            type = check_expr(init, nullptr);
+            if (is_never(type)) {
+                // `let x = return;` binds nothing usable
+                type = checker_.get_unit_type();
+            }
+        }
+    } else if (!var->get_declared_type()) {
+        report(DiagnosticID::err_cannot_infer_type, var->get_location())
+            << ": '" << var->get_name()->get_name() << "' needs a type or an initializer";
+    }
+
+    Symbol* symbol = symbols_.create<Symbol>(Symbol::Kind::Var, var->get_name(), var, type,
+                                             var->is_mutable());
+    if (const Symbol* previous = scopes_.insert(symbol)) {
+        report_redefinition(var->get_name(), var->get_location(), previous);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Expressions
+//===----------------------------------------------------------------------===//
+
+const Type* BodyChecker::check_expr(Expr* expr, const Type* expected) {
+    const Type* type = nullptr;
+    switch (expr->get_kind()) {
+    case ASTNodeKind::LiteralExpr:
+        type = check_literal(cast<LiteralExpr>(expr), expected);
+        break;
+    case ASTNodeKind::IdentifierExpr:
+        type = check_identifier(cast<IdentifierExpr>(expr));
+        break;
+    case ASTNodeKind::BinaryExpr:
+        type = check_binary(cast<BinaryExpr>(expr), expected);
+        break;
+    case ASTNodeKind::UnaryExpr:
+        type = check_unary(cast<UnaryExpr>(expr), expected);
+        break;
+    case ASTNodeKind::AssignExpr:
+        type = check_assign(cast<AssignExpr>(expr));
+        break;
+    case ASTNodeKind::CallExpr:
+        type = check_call(cast<CallExpr>(expr));
+        break;
+    case ASTNodeKind::IfExpr:
+        type = check_if(cast<IfExpr>(expr), expected);
+        break;
+    case ASTNodeKind::BlockExpr:
+        // sets its own type
+        return check_block(cast<BlockExpr>(expr), expected);
+    default:
+        break;
+    }
+    if (type) {
+        expr->set_type(type);
+    }
+    return type;
+}
+
+bool BodyChecker::check_operand(Expr* expr, const Type* expected, DiagnosticID id) {
+    const Type* type = check_expr(expr, expected);
+    if (!type) {
+        return false;
+    }
+    if (!coerces_to(type, expected)) {
+        report_mismatch(id, expr->get_location(), expected, type);
+        return false;
+    }
+    return true;
+}
+
+// Integer and float literals take the expected type when it is of their
+// category and default to i64 and f64 otherwise (§6.2.1).
+const Type* BodyChecker::check_literal(LiteralExpr* lit, const Type* expected) {
+    switch (lit->get_literal_kind()) {
+    case LiteralExpr::LiteralKind::Integer:
+        return is_integer(expected) ? expected : context_.get_i64_type();
+    case LiteralExpr::LiteralKind::Float:
+        return is_float(expected) ? expected : context_.get_f64_type();
+    case LiteralExpr::LiteralKind::Bool:
+        return context_.get_bool_type();
+    case LiteralExpr::LiteralKind::Char:
+        return context_.get_builtin_type(BuiltinKind::Char);
+    case LiteralExpr::LiteralKind::String:
+        return checker_.get_str_ref_type();
+    }
+    return nullptr;
+}
+
+const Type* BodyChecker::check_identifier(IdentifierExpr* id) {
+    Symbol* symbol = lookup(id->get_name());
+    if (!symbol) {
+        report(DiagnosticID::err_undefined_variable, id->get_location())
+            << ": '" << id->get_name()->get_name() << "'";
+        return nullptr;
+    }
+    id->set_decl(symbol->get_decl());
+    return symbol->get_type();
+}
+
+const Type* BodyChecker::check_binary(BinaryExpr* bin, const Type* expected) {
+    const BinaryOp op = bin->get_op();
+    if (op == BinaryOp::LogicalAnd || op == BinaryOp::LogicalOr) {
+        const Type* bool_type = context_.get_bool_type();
+        const bool lhs_ok = check_operand(bin->get_lhs(), bool_type, DiagnosticID::err_type_mismatch);
+        const bool rhs_ok = check_operand(bin->get_rhs(), bool_type, DiagnosticID::err_type_mismatch);
+        return lhs_ok && rhs_ok ? bool_type : nullptr;
+    }
+
+    const bool arithmetic = op <= BinaryOp::Sub;
+    // the operands of a comparison have no type context of their own
+    const Type* operand_expected = arithmetic && is_numeric(expected) ? expected : nullptr;
+    // a literal operand takes its type from the other side: `1 + x` with
+    // `x: u64` is a u64 addition
+    Expr* first = bin->get_lhs();
+    Expr* second = bin->get_rhs();
+    if (isa<LiteralExpr>(first) && !isa<LiteralExpr>(second)) {
+        std::swap(first, second);
+    }
+    const Type* first_type = check_expr(first, operand_expected);
+    const Type* second_type =
+        check_expr(second, first_type && !is_never(first_type) ? first_type : operand_expected);
+    if (!first_type || !second_type) {
+        return nullptr;
+    }
+    const Type* type = is_never(first_type) ? second_type : first_type;
+    if (!coerces_to(second_type, type)) {
+        report(DiagnosticID::err_type_mismatch, bin->get_location())
+            << ": cannot apply '" << get_binary_op_spelling(op) << "' to '"
+            << get_type_name(bin->get_lhs()->get_type()) << "' and '"
+            << get_type_name(bin->get_rhs()->get_type()) << "'";
+        return nullptr;
+    }
+
+    bool valid;
+    switch (op) {
+    case BinaryOp::Rem:
+        valid = is_integer(type);
+        break;
+    case BinaryOp::Eq:
+    case BinaryOp::Ne:
+        valid = is_numeric(type) || is_builtin(type, BuiltinKind::Bool) ||
+                is_builtin(type, BuiltinKind::Char);
+        break;
+    default:
+        valid = is_numeric(type);
+        break;
+    }
+    if (!valid && !is_never(type)) {
+        report(DiagnosticID::err_invalid_operand, bin->get_location())
+            << ": cannot apply '" << get_binary_op_spelling(op) << "' to '" << get_type_name(type)
+            << "'";
+        return nullptr;
+    }
+    return arithmetic ? type : context_.get_bool_type();
+}
+
+const Type* BodyChecker::check_unary(UnaryExpr* un, const Type* expected) {
+    if (un->get_op() == UnaryOp::Not) {
+        const Type* bool_type = context_.get_bool_type();
+        return check_operand(un->get_operand(), bool_type, DiagnosticID::err_type_mismatch)
+                   ? bool_type
+                   : nullptr;
+    }
+    const Type* type = check_expr(un->get_operand(), is_numeric(expected) ? expected : nullptr);
+    if (!type) {
+        return nullptr;
+    }
+    if (!is_never(type) && (!is_numeric(type) || is_unsigned(type))) {
+        report(DiagnosticID::err_invalid_operand, un->get_location())
+            << ": cannot negate '" << get_type_name(type) << "'";
+        return nullptr;
+    }
+    return type;
+}
+
+// Only a `let mut` binding is assignable; the assignment has its type
+// (§6.5).
+const Type* BodyChecker::check_assign(AssignExpr* assign) {
+    auto* target = dyn_cast<IdentifierExpr>(assign->get_target());
+    if (!target) {
+        check_expr(assign->get_target(), nullptr);
+        check_expr(assign->get_value(), nullptr);
+        report(DiagnosticID::err_invalid_operand, assign->get_location())
+            << ": left side of '=' is not assignable";
+        return nullptr;
+    }
+    const Type* type = check_identifier(target);
+    if (!type) {
+        check_expr(assign->get_value(), nullptr);
+        return nullptr;
+    }
+    target->set_type(type);
+    const Symbol* symbol = lookup(target->get_name());
+    if (symbol->get_kind() != Symbol::Kind::Var || !symbol->is_mutable()) {
+        report(DiagnosticID::err_assign_to_immutable, target->get_location())
+            << ": '" << target->get_name()->get_name() << "'";
+        diags_.report(DiagnosticID::note_declared_here, symbol->get_decl()->get_location())
+            << ": '" << target->get_name()->get_name() << "' declared here";
+        check_expr(assign->get_value(), type);
+        return nullptr;
+    }
+    return check_operand(assign->get_value(), type, DiagnosticID::err_type_mismatch) ? type
+                                                                                      : nullptr;
+}
+
+const Type* BodyChecker::check_call(CallExpr* call) {
+    const Type* callee_type = check_expr(call->get_callee(), nullptr);
+    const auto* func_type = dyn_cast_if_present<FunctionType>(callee_type);
+    if (!func_type) {
+        if (callee_type) {
+            report(DiagnosticID::err_not_callable, call->get_callee()->get_location())
+                << ": '" << get_type_name(callee_type) << "'";
+        }
+        for (Expr* arg : call->get_args()) {
+            check_expr(arg, nullptr);
+        }
+        return nullptr;
+    }
+
+    const auto args = call->get_args();
+    const auto params = func_type->get_params();
+    bool ok = true;
+    if (args.size() != params.size()) {
+        report(DiagnosticID::err_wrong_argument_count, call->get_location())
+            << ": expected " << static_cast<int64_t>(params.size()) << ", found "
+            << static_cast<int64_t>(args.size());
+        ok = false;
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (i < params.size()) {
+            ok &= check_operand(args[i], params[i], DiagnosticID::err_wrong_argument_type);
+        } else {
+            check_expr(args[i], nullptr);
+        }
+    }
+    return ok ? func_type->get_result() : nullptr;
+}
+
+const Type* BodyChecker::check_if(IfExpr* if_expr, const Type* expected) {
+    check_operand(if_expr->get_cond(), context_.get_bool_type(), DiagnosticID::err_type_mismatch);
+    if (!if_expr->get_else()) {
+        check_block(if_expr->get_then(), nullptr);
+        return checker_.get_unit_type();
+    }
+    const Type* then_type = check_block(if_expr->get_then(), expected);
+    const Type* else_type =
+        check_expr(if_expr->get_else(),
+                   then_type && !is_never(then_type) ? then_type : expected);
+    if (!then_type || !else_type) {
+        return nullptr;
+    }
+    if (is_never(then_type)) {
+        return else_type;
+    }
+    if (!coerces_to(else_type, then_type)) {
+        report_mismatch(DiagnosticID::err_type_mismatch, if_expr->get_else()->get_location(),
+                        then_type, else_type);
+        return nullptr;
+    }
+    return then_type;
+}
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// TypeChecker
+//===----------------------------------------------------------------------===//
+
+TypeChecker::TypeChecker(ASTContext& context, DiagnosticEngine& diags)
+    : context_(context), diags_(diags), unit_type_(context.get_unit_type()),
+      str_ref_type_(context.get_reference_type(context.get_str_type(), false)) {}
+
+void TypeChecker::collect_signatures(ModuleDecl* module) {
+    std::vector<const Type*> param_types;
+    for (Decl* item : module->get_items()) {
+        auto* func = dyn_cast<FuncDecl>(item);
+        if (!func) {
+            continue;
+        }
+        bool valid = true;
+        param_types.clear();
+        for (ParamDecl* param : func->get_params()) {
+            if (const NominalType* unresolved = find_unresolved_type(param->get_type())) {
+                ++error_count_;
+                diags_.report(DiagnosticID::err_undefined_type, param->get_location())
+                    << ": '" << unresolved->get_name()->get_name() << "'";
+                valid = false;
+            }
+            param_types.push_back(param->get_type());
+        }
+        if (const NominalType* unresolved = find_unresolved_type(func->get_return_type())) {
+            ++error_count_;
+            diags_.report(DiagnosticID::err_undefined_type, func->get_location())
+                << ": '" << unresolved->get_name()->get_name() << "'";
+            valid = false;
+        }
+        const Type* result = func->get_return_type() ? func->get_return_type() : unit_type_;
+        const Type* type = valid ? context_.get_function_type(param_types, result) : nullptr;
+
+        Symbol* symbol = symbol_arena_.create<Symbol>(Symbol::Kind::Func, func->get_name(), func,
+                                                      type);
+        const uint32_t id = func->get_name()->id;
+        if (id >= functions_.size()) {
+            functions_.resize(static_cast<size_t>(id) + 1, nullptr);
+        }
+        if (const Symbol* previous = functions_[id]) {
+            ++error_count_;
+            diags_.report(DiagnosticID::err_redefinition, func->get_location())
+                << ": '" << func->get_name()->get_name() << "'";
+            diags_.report(DiagnosticID::note_declared_here, previous->get_decl()->get_location())
+                << ": '" << func->get_name()->get_name() << "' declared here";
+        } else {
+            functions_[id] = symbol;
+        }
+    }
+}
+
+uint32_t TypeChecker::check_function(FuncDecl* func) const {
+    BodyChecker checker(*this);
+    return checker.check(func);
+}
+
+void TypeChecker::check_module(ModuleDecl* module) {
+    collect_signatures(module);
+    BodyChecker checker(*this);
+    for (Decl* item : module->get_items()) {
+        if (auto* func = dyn_cast<FuncDecl>(item)) {
+            error_count_ += checker.check(func);
+        }
+    }
+}
+
+void TypeChecker::check_module(ModuleDecl* module, ThreadPool& pool) {
+    collect_signatures(module);
+    std::vector<FuncDecl*> funcs;
+    for (Decl* item : module->get_items()) {
+        if (auto* func = dyn_cast<FuncDecl>(item)) {
+            funcs.push_back(func);
+        }
+    }
+    // small chunks handed out dynamically balance uneven bodies; each chunk
+    // reuses one BodyChecker. Results are indexed by function and summed in
+    // source order.
+    const size_t chunk_count = std::min(funcs.size(), size_t{pool.size()} * 16);
+    std::vector<uint32_t> errors(funcs.size(), 0);
+    pool.parallel_for(chunk_count, [&](size_t chunk) {
+        BodyChecker checker(*this);
+        const size_t end = funcs.size() * (chunk + 1) / chunk_count;
+        for (size_t i = funcs.size() * chunk / chunk_count; i < end; ++i) {
+            errors[i] = checker.check(funcs[i]);
+        }
+    });
+    for (uint32_t count : errors) {
+        error_count_ += count;
+    }
+}
+
+} // namespace sema
+} // namespace nova
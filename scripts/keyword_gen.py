@@ -0,0 +1,75 @@
+import argparse
+import re
+
+
+def generate_keyword_switch(def_file_path: str) -> str:
+    keywords = []
+    # 匹配 NOVA_KEYWORD(name, spelling) / NOVA_TYPE_KEYWORD(name, spelling)
+    pattern = re.compile(r'NOVA_(?:TYPE_)?KEYWORD\s*\(\s*(\w+)\s*,\s*"([^"]+)"\s*\)')
+
+    with open(def_file_path, 'r') as f:
+        for line in f:
+            match = pattern.search(line)
+            if match:
+                keywords.append({'name': match.group(1), 'spelling': match.group(2)})
+
+    # 先按长度分桶，再按首字母分组：每个关键字最多只需比较一次剩余字符
+    buckets = {}
+    for k in keywords:
+        by_first = buckets.setdefault(len(k['spelling']), {})
+        by_first.setdefault(k['spelling'][0], []).append(k)
+
+    output = [
+        "//===----------------------------------------------------------------------===//",
+        "// This file is auto-generated by scripts/keyword_gen.py from TokenKinds.def.",
+        "// Do not edit by hand.",
+        "//===----------------------------------------------------------------------===//",
+        "",
+        "switch (text.size()) {",
+    ]
+
+    for length in sorted(buckets.keys()):
+        output.append(f"    case {length}:")
+        output.append("        switch (text[0]) {")
+        for char in sorted(buckets[length].keys()):
+            output.append(f"        case '{char}':")
+            for k in buckets[length][char]:
+                rest = k['spelling'][1:]
+                cond = " && ".join([f"text[{i + 1}] == '{c}'" for i, c in enumerate(rest)])
+                if cond:
+                    output.append(f"            if ({cond}) {{")
+                    output.append(f"                return TokenKind::{k['name']};")
+                    output.append("            }")
+                else:
+                    output.append(f"            return TokenKind::{k['name']};")
+            output.append("            break;")
+        output.append("        default: break;")
+        output.append("        }")
+        output.append("        break;")
+
+    output.append("    default: break;")
+    output.append("}")
+    return "\n".join(output)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--def",
+        dest="def_path",
+        default="include/nova/Lex/TokenKinds.def",
+        help="Path to TokenKinds.def",
+    )
+    parser.add_argument(
+        "--out",
+        dest="out_path",
+        default="include/nova/Lex/Keywords.inc",
+        help="Output path for generated Keywords.inc",
+    )
+    args = parser.parse_args()
+
+    code = generate_keyword_switch(args.def_path)
+    with open(args.out_path, "w") as f:
+        f.write(code)
+        f.write("\n")
+    print(f"{args.out_path} generated successfully!")
@@ -1,19 +1,42 @@
+#include "nova/AST/ASTContext.hpp"
+#include "nova/AST/Decl.hpp"
+#include "nova/Analysis/BorrowChecker.hpp"
+#include "nova/Analysis/CFG.hpp"
+#include "nova/Analysis/Dataflow.hpp"
+#include "nova/Analysis/Lifetime.hpp"
+#include "nova/Basic/CPUFeatures.hpp"
+#include "nova/Basic/DiagnosticEngine.hpp"
 #include "nova/Basic/IdentifierTable.hpp"
 #include "nova/Basic/SourceManager.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/IR/BinaryFormat.hpp"
+#include "nova/IR/IRBuilder.hpp"
+#include "nova/IR/Module.hpp"
+#include "nova/Lex/LexScan.hpp"
 #include "nova/Lex/Lexer.hpp"
 #include "nova/Lex/Token.hpp"
+#include "nova/Lex/TokenStream.hpp"
+#include "nova/Parse/Parser.hpp"
+#include "nova/Sema/TypeChecker.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <fstream>
+#include <cstdio>
 #include <iostream>
 #include <limits>
+#include <random>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
-//this benchmark measures the performance of the Lexer
+#include <vector>
+//this benchmark measures the performance of the Lexer (and, with
+//--stage=parse, check, flow, borrow, lifetimes or ir, of the Parser, the
+//TypeChecker, the dataflow analyses, the BorrowChecker, the lifetime solver
+//or the IR)
 namespace {
 
 struct Options {
@@ -21,15 +44,60 @@ struct Options {
     std::size_t bytes = 1 * 1024 * 1024;
     std::uint32_t repeat = 100;
     std::uint32_t warmup = 3;
+    std::string workload = "mixed";
+    std::string isa = "auto";
+    std::uint32_t files = 1;
+    std::uint32_t threads = 0;
+    std::string stage = "lex";
 };
 
 void print_usage(std::ostream& os, const char* argv0) {
     os << "Usage: " << argv0 << " [--file PATH] [--bytes N] [--repeat N] [--warmup N]\n"
+          "       [--workload mixed|tables|idents|funcs|nested|branches]\n"
+          "       [--isa auto|scalar|sse2|avx2] [--files N] [--threads N]\n"
+          "       [--stage lex|parse|check|flow|borrow|lifetimes|ir]\n"
           "\n"
           "Lexer micro-benchmark.\n"
           "\n"
+          "  --stage     'lex' (default) or 'parse': parse the pre-lexed tokens and\n"
+          "              report lines/s and AST memory, then time a skim pass that\n"
+          "              skips function bodies plus the bodies on 1, 2, 4, ... threads;\n"
+          "              or 'check': parse once, then type check the module with the\n"
+          "              function bodies on 1, 2, 4, ... threads; or 'flow': parse\n"
+          "              and check once, then time CFG construction, liveness and\n"
+          "              definite initialization over every function; or 'borrow':\n"
+          "              time the BorrowChecker from scratch, then again after an\n"
+          "              edit with the results of the first build cached; or\n"
+          "              'lifetimes': solve synthetic outlives-constraint graphs\n"
+          "              of growing size; or 'ir': build, walk and rewrite\n"
+          "              synthetic IR functions of growing size (both ignore the\n"
+          "              input)\n"
+          "  --workload  generated input: 'mixed' (statements + long comments) or\n"
+          "              'tables' (identifier tables with deep indentation) or\n"
+          "              'idents' (short statements, mostly identifiers and keywords) or\n"
+          "              'funcs' (small well-typed functions, for --stage check) or\n"
+          "              'nested' (deeply nested blocks of lets, for --stage check) or\n"
+          "              'branches' (loops around long if chains, for --stage flow)\n"
+          "  --isa       pin the scanning kernels to one SIMD level\n"
+          "  --files     also split the input into N files and lex them into\n"
+          "              TokenStreams on a thread pool (1, 2, 4, ... threads)\n"
+          "  --threads   largest thread count for --files and the parallel body\n"
+          "              parse (default: all cores)\n"
+          "\n"
+          "After the main run a per-kernel breakdown is printed for every SIMD\n"
+          "level the host supports, followed by keyword classification cost.\n"
+          "\n"
           "Examples:\n"
           "  " << argv0 << " --bytes 1000000 --repeat 200\n"
+          "  " << argv0 << " --workload tables --isa scalar\n"
+          "  " << argv0 << " --workload idents\n"
+          "  " << argv0 << " --files 64 --bytes 16000000 --repeat 5\n"
+          "  " << argv0 << " --stage parse --workload idents\n"
+          "  " << argv0 << " --stage check --workload funcs --threads 8\n"
+          "  " << argv0 << " --stage flow --workload branches\n"
+          "  " << argv0 << " --stage borrow --workload funcs\n"
+          "  " << argv0 << " --stage lifetimes --repeat 5\n"
+          "  " << argv0 << " --stage ir --repeat 5\n"
           "  " << argv0 << " --file examples/hello.nova --repeat 1000\n";
 }
 
@@ -116,6 +184,48 @@ bool parse_args(int argc, char** argv, Options& opts) {
             continue;
         }
 
+        if (arg == "--files" || arg == "--threads") {
+            std::string_view value = take_value(arg);
+            std::uint32_t& out = (arg == "--files") ? opts.files : opts.threads;
+            if (value.empty() || !parse_u32(value, out) || (arg == "--files" && out == 0)) {
+                std::cerr << "Invalid " << arg << " value: " << value << "\n";
+                return false;
+            }
+            continue;
+        }
+
+        if (arg == "--stage" || arg.rfind("--stage=", 0) == 0) {
+            opts.stage = arg == "--stage" ? std::string(take_value("--stage"))
+                                          : std::string(arg.substr(8));
+            if (opts.stage != "lex" && opts.stage != "parse" && opts.stage != "check" &&
+                opts.stage != "flow" && opts.stage != "borrow" &&
+                opts.stage != "lifetimes" && opts.stage != "ir") {
+                std::cerr << "Invalid --stage value: " << opts.stage << "\n";
+                return false;
+            }
+            continue;
+        }
+
+        if (arg == "--workload") {
+            opts.workload = std::string(take_value("--workload"));
+            if (opts.workload != "mixed" && opts.workload != "tables" &&
+                opts.workload != "idents" && opts.workload != "funcs" &&
+                opts.workload != "nested" && opts.workload != "branches") {
+                std::cerr << "Invalid --workload value: " << opts.workload << "\n";
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--isa") {
+            opts.isa = std::string(take_value("--isa"));
+            if (opts.isa != "auto" && opts.isa != "scalar" && opts.isa != "sse2" &&
+                opts.isa != "avx2") {
+                std::cerr << "Invalid --isa value: " << opts.isa << "\n";
+                return false;
+            }
+            continue;
+        }
+
         std::cerr << "Unknown argument: " << arg << "\n";
         return false;
     }
@@ -123,27 +233,7 @@ bool parse_args(int argc, char** argv, Options& opts) {
     return true;
 }
 
-std::string read_file(std::string_view path) {
-    std::ifstream in(std::string(path), std::ios::binary);
-    if (!in) {
-        return {};
-    }
-    std::string data;
-    in.seekg(0, std::ios::end);
-    std::streamsize size = in.tellg();
-    if (size < 0) {
-        return {};
-    }
-    data.resize(static_cast<std::size_t>(size));
-    in.seekg(0, std::ios::beg);
-    in.read(data.data(), size);
-    if (!in) {
-        return {};
-    }
-    return data;
-}
-
-std::string generate_source(std::size_t target_bytes) {
+std::string generate_mixed_source(std::size_t target_bytes) {
     constexpr std::size_t kCommentPayloadBytes = 4 * 1024;
     const std::string& chunk = [] {
         std::string out;
@@ -168,12 +258,134 @@ std::string generate_source(std::size_t target_bytes) {
     return out;
 }
 
+// Mimics generated code: wide tables of identifiers and deeply indented blocks.
+std::string generate_table_source(std::size_t target_bytes) {
+    const std::string& chunk = [] {
+        std::string out;
+        out.append("func lookup_table_entry_0123(index_value: i64) -> i64 {\n");
+        for (int row = 0; row < 8; ++row) {
+            out.append(16, ' ');
+            out.append("let generated_row_identifier_");
+            out.append(std::to_string(row));
+            out.append(" = first_column_value + second_column_value * third_column_value;\n");
+        }
+        out.append(32, ' ');
+        out.append("return table_entry_result_value_with_long_name + 1234567890;\n");
+        out.append("}\n");
+        return out;
+    }();
+
+    std::string out;
+    out.reserve(target_bytes + chunk.size());
+    while (out.size() < target_bytes) {
+        out.append(chunk);
+    }
+    return out;
+}
+
+// Identifier-heavy code: short names, frequent keywords, few literals.
+std::string generate_ident_source(std::size_t target_bytes) {
+    static constexpr const char* kNames[] = {"a",     "idx",  "count", "node",  "next",
+                                             "value", "left", "right", "state", "result"};
+    static constexpr std::size_t kNumNames = std::size(kNames);
+    std::string out;
+    out.reserve(target_bytes + 256);
+    for (std::size_t i = 0; out.size() < target_bytes; ++i) {
+        std::string suffix = "_";
+        suffix += std::to_string(i % 61);
+        const char* a = kNames[i % kNumNames];
+        const char* b = kNames[(i * 7 + 3) % kNumNames];
+        const char* c = kNames[(i * 3 + 1) % kNumNames];
+        out.append("func ").append(a).append(suffix).append("(").append(b).append(": i64, ");
+        out.append(c).append(": bool) -> i64 {\n");
+        out.append("    let mut ").append(c).append(suffix).append(" = ").append(b);
+        out.append(" + ").append(a).append(suffix).append(";\n");
+        out.append("    if ").append(c).append(" { return ").append(b).append("; } else { ");
+        out.append(a).append(" = ").append(b).append(suffix).append("; }\n");
+        out.append("    while ").append(c).append(" { ").append(a).append("; continue; }\n");
+        out.append("    return ").append(c).append(suffix).append(";\n}\n");
+    }
+    return out;
+}
+
+// Many small, well-typed functions, each calling the previous one; the input
+// for --stage=check, which needs code that type checks.
+std::string generate_function_source(std::size_t target_bytes) {
+    std::string out;
+    out.reserve(target_bytes + 512);
+    for (std::size_t i = 0; out.size() < target_bytes; ++i) {
+        const std::string name = "step_" + std::to_string(i);
+        out.append("func ").append(name).append("(a: i64, b: u64, c: bool) -> i64 {\n");
+        out.append("    let mut acc = a;\n");
+        out.append("    let mut n: u64 = b % 16;\n");
+        out.append("    while n > 0 {\n");
+        out.append("        if c && acc % 2 == 0 { acc = acc / 2; } else { acc = acc * 3 + 1; }\n");
+        out.append("        n = n - 1;\n");
+        out.append("    }\n");
+        if (i > 0) {
+            out.append("    acc = acc + step_").append(std::to_string(i - 1));
+            out.append("(acc, b + 1, !c);\n");
+        }
+        out.append("    acc\n}\n");
+    }
+    return out;
+}
+
+// Deeply nested blocks, each binding a few names and reading names bound
+// several levels out; stresses scope push/pop and lookup in --stage=check.
+std::string generate_nested_source(std::size_t target_bytes) {
+    constexpr int kDepth = 48;
+    constexpr int kLetsPerBlock = 4;
+    std::string out;
+    out.reserve(target_bytes + 64 * 1024);
+    for (std::size_t i = 0; out.size() < target_bytes; ++i) {
+        out.append("func nest_").append(std::to_string(i)).append("(seed: i64) -> i64 {\n");
+        out.append("    let v0_0 = seed;\n");
+        for (int depth = 1; depth <= kDepth; ++depth) {
+            const std::string indent(4 * static_cast<std::size_t>(depth), ' ');
+            out.append(indent).append("{\n");
+            for (int k = 0; k < kLetsPerBlock; ++k) {
+                const int outer = depth > 8 ? depth - 8 : 0;
+                out.append(indent).append("    let v").append(std::to_string(depth));
+                out.append("_").append(std::to_string(k)).append(" = v");
+                out.append(std::to_string(outer)).append("_0 + v0_0 + seed;\n");
+            }
+        }
+        for (int depth = kDepth; depth >= 1; --depth) {
+            out.append(4 * static_cast<std::size_t>(depth), ' ').append("}\n");
+        }
+        out.append("    v0_0\n}\n");
+    }
+    return out;
+}
+
+// Few large functions: a loop around a chain of if/else on several variables,
+// so each CFG has thousands of blocks; the input for --stage=flow.
+std::string generate_branch_source(std::size_t target_bytes) {
+    constexpr int kBranches = 1000;
+    std::string out;
+    out.reserve(target_bytes + 128 * 1024);
+    for (std::size_t i = 0; out.size() < target_bytes; ++i) {
+        out.append("func branch_").append(std::to_string(i)).append("(n: i64) -> i64 {\n");
+        out.append("    let mut a = 0;\n    let mut b = 1;\n    let mut c: i64;\n");
+        out.append("    let mut i = 0;\n    while i < n {\n");
+        for (int k = 0; k < kBranches; ++k) {
+            const std::string value = std::to_string(k);
+            out.append("        if i % 7 == ").append(std::to_string(k % 7));
+            out.append(" && a < ").append(value).append(" { c = a + b; a = c; }");
+            out.append(" else { b = b + ").append(value).append("; }\n");
+        }
+        out.append("        i = i + 1;\n    }\n    a + b\n}\n");
+    }
+    return out;
+}
+
 struct RunResult {
     std::uint64_t token_count = 0;
     std::uint64_t checksum = 0;
 };
 
-RunResult lex_all(nova::SourceManager& sm, nova::IdentifierTable& ids, std::uint16_t file_id) {
+RunResult lex_all(nova::SourceManager& sm, nova::IdentifierTable& ids, nova::FileID file_id) {
     nova::Lexer lexer(sm, ids, file_id);
     nova::Token token;
 
@@ -191,6 +403,757 @@ RunResult lex_all(nova::SourceManager& sm, nova::IdentifierTable& ids, std::uint
     return result;
 }
 
+bool parse_simd_level(std::string_view name, nova::SIMDLevel& out) {
+    if (name == "scalar") {
+        out = nova::SIMDLevel::Scalar;
+    } else if (name == "sse2") {
+        out = nova::SIMDLevel::SSE2;
+    } else if (name == "avx2") {
+        out = nova::SIMDLevel::AVX2;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Each kernel is timed only on the runs it would see in the lexer: run starts
+// are collected up front so that the timed loop is pure kernel calls.
+enum class KernelKind { Whitespace, Identifier, Digits, StringBody };
+
+std::vector<const char*> collect_run_starts(KernelKind kind, std::string_view text) {
+    std::vector<const char*> starts;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    const nova::LexScanKernels& scalar = nova::get_lex_scan_kernels(nova::SIMDLevel::Scalar);
+    while (p < end) {
+        const char c = *p;
+        const char* q = p + 1;
+        switch (kind) {
+        case KernelKind::Whitespace:
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                starts.push_back(p);
+                bool saw_newline = false;
+                q = scalar.scan_whitespace(p, end, saw_newline);
+            }
+            break;
+        case KernelKind::Identifier:
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+                starts.push_back(p);
+                q = scalar.scan_identifier(p, end);
+            }
+            break;
+        case KernelKind::Digits:
+            if (c >= '0' && c <= '9') {
+                starts.push_back(p);
+                q = scalar.scan_digits(p, end);
+            }
+            break;
+        case KernelKind::StringBody:
+            if (c == '"') {
+                starts.push_back(p + 1);
+                q = scalar.scan_string_body(p + 1, end, '"');
+                q = (q < end) ? q + 1 : q;
+            }
+            break;
+        }
+        p = q;
+    }
+    return starts;
+}
+
+std::uint64_t run_kernel(const nova::LexScanKernels& k, KernelKind kind,
+                         const std::vector<const char*>& starts, const char* end) {
+    std::uint64_t covered = 0;
+    for (const char* p : starts) {
+        const char* q = p;
+        switch (kind) {
+        case KernelKind::Whitespace: {
+            bool saw_newline = false;
+            q = k.scan_whitespace(p, end, saw_newline);
+            break;
+        }
+        case KernelKind::Identifier:
+            q = k.scan_identifier(p, end);
+            break;
+        case KernelKind::Digits:
+            q = k.scan_digits(p, end);
+            break;
+        case KernelKind::StringBody:
+            q = k.scan_string_body(p, end, '"');
+            break;
+        }
+        covered += static_cast<std::uint64_t>(q - p);
+    }
+    return covered;
+}
+
+double mib_per_sec(std::size_t bytes, std::uint32_t repeat, double seconds) {
+    const double total_mb =
+        static_cast<double>(bytes) * static_cast<double>(repeat) / (1024.0 * 1024.0);
+    return (seconds > 0.0) ? (total_mb / seconds) : 0.0;
+}
+
+void print_kernel_breakdown(nova::SourceManager& sm, nova::IdentifierTable& ids,
+                            nova::FileID file_id, std::string_view text,
+                            std::uint32_t repeat) {
+    static constexpr std::pair<KernelKind, const char*> kKernels[] = {
+        {KernelKind::Whitespace, "whitespace"},
+        {KernelKind::Identifier, "identifier"},
+        {KernelKind::Digits, "digits"},
+        {KernelKind::StringBody, "string"},
+    };
+    const nova::SIMDLevel saved = nova::get_active_simd_level();
+    const auto host = static_cast<std::uint8_t>(nova::get_host_simd_level());
+
+    std::vector<std::vector<const char*>> starts;
+    for (const auto& entry : kKernels) {
+        starts.push_back(collect_run_starts(entry.first, text));
+    }
+    const char* end = text.data() + text.size();
+
+    std::cout << "kernels (lexer: MiB/s of input; kernels: MiB/s of bytes inside runs):\n";
+    for (std::uint8_t raw = 0; raw <= host; ++raw) {
+        const auto level = static_cast<nova::SIMDLevel>(raw);
+        nova::set_active_simd_level(level);
+        const nova::LexScanKernels& kernels = nova::get_lex_scan_kernels(level);
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0; i < repeat; ++i) {
+            (void)lex_all(sm, ids, file_id);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "  [" << nova::get_simd_level_name(level) << "] lexer "
+                  << mib_per_sec(text.size(), repeat, elapsed.count());
+
+        for (std::size_t k = 0; k < std::size(kKernels); ++k) {
+            std::uint64_t covered = 0;
+            start = std::chrono::steady_clock::now();
+            for (std::uint32_t i = 0; i < repeat; ++i) {
+                covered += run_kernel(kernels, kKernels[k].first, starts[k], end);
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+            const std::size_t run_bytes = static_cast<std::size_t>(covered / repeat);
+            std::cout << " | " << kKernels[k].second << " "
+                      << mib_per_sec(run_bytes, repeat, elapsed.count()) << " ("
+                      << starts[k].size() << " runs, " << run_bytes << " B)";
+        }
+        std::cout << "\n";
+    }
+    nova::set_active_simd_level(saved);
+}
+
+// Keyword classification cost per identifier: the generated switch
+// (nova::get_keyword_kind) against the hash-table probe the lexer used to do.
+void print_keyword_breakdown(std::string_view text, std::uint32_t repeat) {
+    std::vector<std::string_view> words;
+    const char* end = text.data() + text.size();
+    const nova::LexScanKernels& scalar = nova::get_lex_scan_kernels(nova::SIMDLevel::Scalar);
+    for (const char* p : collect_run_starts(KernelKind::Identifier, text)) {
+        words.emplace_back(p, static_cast<std::size_t>(scalar.scan_identifier(p, end) - p));
+    }
+    if (words.empty()) {
+        return;
+    }
+
+    nova::IdentifierTable ids;
+    for (std::string_view word : words) {
+        (void)ids.intern(word);
+    }
+
+    std::uint64_t keywords = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < repeat; ++i) {
+        for (std::string_view word : words) {
+            const nova::IdentifierInfo* info = ids.get(word);
+            keywords += (info && info->is_keyword) ? 1 : 0;
+        }
+    }
+    std::chrono::duration<double> hash_elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t switch_keywords = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < repeat; ++i) {
+        for (std::string_view word : words) {
+            switch_keywords += (nova::get_keyword_kind(word) != nova::TokenKind::identifier) ? 1 : 0;
+        }
+    }
+    std::chrono::duration<double> switch_elapsed = std::chrono::steady_clock::now() - start;
+
+    const double lookups = static_cast<double>(words.size()) * static_cast<double>(repeat);
+    auto ns_per_lookup = [&](double seconds) { return seconds * 1e9 / lookups; };
+    std::cout << "keywords (" << words.size() << " identifiers, "
+              << (100.0 * static_cast<double>(keywords) / lookups) << "% keywords): hash "
+              << ns_per_lookup(hash_elapsed.count()) << " ns/id | switch "
+              << ns_per_lookup(switch_elapsed.count()) << " ns/id"
+              << (keywords == switch_keywords ? "" : " (MISMATCH)") << "\n";
+}
+
+std::string generate_source(const Options& opts, std::size_t bytes) {
+    if (opts.workload == "tables") {
+        return generate_table_source(bytes);
+    }
+    if (opts.workload == "idents") {
+        return generate_ident_source(bytes);
+    }
+    if (opts.workload == "funcs") {
+        return generate_function_source(bytes);
+    }
+    if (opts.workload == "nested") {
+        return generate_nested_source(bytes);
+    }
+    if (opts.workload == "branches") {
+        return generate_branch_source(bytes);
+    }
+    return generate_mixed_source(bytes);
+}
+
+// Multi-file front end: the input is split into opts.files files that are
+// lexed into TokenStreams, one file per pool task, sharing one concurrent
+// IdentifierTable.
+void print_parallel_breakdown(const Options& opts) {
+    nova::SourceManager sm;
+    std::size_t input_bytes = 0;
+    for (std::uint32_t i = 0; i < opts.files; ++i) {
+        const nova::FileID file_id =
+            sm.add_file("<generated-" + std::to_string(i) + ">",
+                        generate_source(opts, opts.bytes / opts.files));
+        input_bytes += sm.get_file(file_id)->content.size();
+    }
+    const unsigned max_threads =
+        opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "parallel (" << opts.files << " files, " << input_bytes << " bytes):\n";
+    double base_seconds = 0.0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        nova::ThreadPool pool(threads);
+        std::size_t tokens = 0;
+        std::size_t token_bytes = 0;
+        double seconds = 0.0;
+        for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+            nova::IdentifierTable ids(/*concurrent=*/true);
+            nova::TokenStreamCache cache(sm, ids);
+            const auto start = std::chrono::steady_clock::now();
+            cache.lex_all(pool);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (i >= opts.warmup) {
+                seconds += elapsed.count();
+            }
+            tokens = cache.token_count();
+            token_bytes = cache.memory_bytes();
+        }
+        if (threads == 1) {
+            base_seconds = seconds;
+        }
+        std::cout << "  threads=" << threads << " " << mib_per_sec(input_bytes, opts.repeat, seconds)
+                  << " MiB/s, " << tokens << " tokens ("
+                  << static_cast<double>(token_bytes) / static_cast<double>(tokens)
+                  << " B/token, Token is " << sizeof(nova::Token) << " B), speedup "
+                  << (seconds > 0.0 ? base_seconds / seconds : 0.0) << "x\n";
+        if (threads >= max_threads) {
+            break;
+        }
+    }
+}
+
+// Two-phase parse: a skim pass that skips function bodies, then the bodies
+// on a thread pool (1, 2, 4, ... threads).
+void run_parse_bodies(const Options& opts, const nova::SourceManager& sm,
+                      const nova::TokenStream& tokens) {
+    const unsigned max_threads =
+        opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "skim + parallel bodies:\n";
+    double base_seconds = 0.0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        nova::ThreadPool pool(threads);
+        std::size_t funcs = 0;
+        double skim_seconds = 0.0;
+        double body_seconds = 0.0;
+        for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+            nova::ast::ASTContext ctx;
+            nova::DiagnosticEngine diags(&sm);
+            diags.set_deferred(true);
+            const auto start = std::chrono::steady_clock::now();
+            nova::Parser parser(tokens, ctx, diags);
+            parser.set_skip_function_bodies(true);
+            nova::ast::ModuleDecl* module = parser.parse_module(nullptr);
+            std::vector<nova::ast::FuncDecl*> bodies;
+            for (nova::ast::Decl* item : module->get_items()) {
+                if (auto* func = nova::dyn_cast<nova::ast::FuncDecl>(item)) {
+                    bodies.push_back(func);
+                }
+            }
+            const auto skimmed = std::chrono::steady_clock::now();
+            parser.parse_function_bodies(bodies, pool);
+            const auto end = std::chrono::steady_clock::now();
+            if (i >= opts.warmup) {
+                skim_seconds += std::chrono::duration<double>(skimmed - start).count();
+                body_seconds += std::chrono::duration<double>(end - skimmed).count();
+            }
+            funcs = bodies.size();
+        }
+        const double seconds = skim_seconds + body_seconds;
+        if (threads == 1) {
+            base_seconds = seconds;
+        }
+        const double runs = static_cast<double>(opts.repeat);
+        std::cout << "  threads=" << threads << " " << funcs << " functions, skim "
+                  << skim_seconds / runs * 1e3 << " ms, bodies " << body_seconds / runs * 1e3
+                  << " ms, speedup " << (seconds > 0.0 ? base_seconds / seconds : 0.0) << "x\n";
+        if (threads >= max_threads) {
+            break;
+        }
+    }
+}
+
+// Parser throughput over tokens lexed once up front: every run parses the
+// whole file into a fresh ASTContext.
+int run_parse_stage(const Options& opts, const nova::SourceManager& sm, nova::FileID file_id) {
+    const std::string_view text = sm.get_file(file_id)->content;
+    const auto lines =
+        static_cast<std::uint64_t>(std::count(text.begin(), text.end(), '\n')) + 1;
+
+    nova::IdentifierTable ids;
+    const nova::TokenStream tokens = nova::TokenStream::lex(sm, ids, file_id);
+
+    std::size_t nodes = 0;
+    std::size_t ast_bytes = 0;
+    std::uint32_t errors = 0;
+    double seconds = 0.0;
+    for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+        nova::ast::ASTContext ctx;
+        nova::DiagnosticEngine diags(&sm);
+        diags.set_diagnostic_limit(1);
+        const auto start = std::chrono::steady_clock::now();
+        nova::Parser parser(tokens, ctx, diags);
+        parser.parse_module(nullptr);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (i >= opts.warmup) {
+            seconds += elapsed.count();
+        }
+        nodes = ctx.node_count();
+        ast_bytes = ctx.bytes_allocated();
+        errors = parser.get_error_count();
+        if (i + 1 == opts.warmup + opts.repeat) {
+            std::cout.flush();
+            ctx.print_stats(stdout);
+            std::fflush(stdout);
+        }
+    }
+
+    const double runs = static_cast<double>(opts.repeat);
+    std::cout << "parser: bytes=" << text.size() << " lines=" << lines
+              << " tokens=" << tokens.size() << " repeat=" << opts.repeat
+              << " warmup=" << opts.warmup << "\n";
+    std::cout << "elapsed: " << seconds << " s\n";
+    std::cout << "throughput: " << (seconds > 0.0 ? static_cast<double>(lines) * runs / seconds : 0.0)
+              << " lines/s, " << mib_per_sec(text.size(), opts.repeat, seconds) << " MiB/s\n";
+    std::cout << "ast: " << nodes << " nodes, " << ast_bytes << " bytes ("
+              << (nodes ? static_cast<double>(ast_bytes) / static_cast<double>(nodes) : 0.0)
+              << " B/node, " << static_cast<double>(ast_bytes) / static_cast<double>(text.size())
+              << " B/source byte)\n";
+    std::cout << "errors: " << errors << "\n";
+    run_parse_bodies(opts, sm, tokens);
+    return errors == 0 ? 0 : 1;
+}
+
+// Type checking of one parsed module, with the function bodies on a pool of
+// 1, 2, 4, ... threads. Every run re-checks the same AST.
+int run_check_stage(const Options& opts, const nova::SourceManager& sm, nova::FileID file_id) {
+    nova::IdentifierTable ids;
+    const nova::TokenStream tokens = nova::TokenStream::lex(sm, ids, file_id);
+    nova::ast::ASTContext ctx;
+    nova::DiagnosticEngine parse_diags(&sm);
+    parse_diags.set_diagnostic_limit(1);
+    nova::Parser parser(tokens, ctx, parse_diags);
+    nova::ast::ModuleDecl* module = parser.parse_module(nullptr);
+    if (parser.get_error_count() != 0) {
+        std::cerr << "input does not parse: " << parser.get_error_count() << " errors\n";
+        return 1;
+    }
+
+    const unsigned max_threads =
+        opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "type check (" << module->get_items().size() << " items, "
+              << sm.get_file(file_id)->content.size() << " bytes, repeat=" << opts.repeat
+              << "):\n";
+    std::uint32_t errors = 0;
+    double base_seconds = 0.0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        nova::ThreadPool pool(threads);
+        double seconds = 0.0;
+        for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+            nova::DiagnosticEngine diags(&sm);
+            diags.set_deferred(true);
+            diags.set_diagnostic_limit(1);
+            nova::sema::TypeChecker checker(ctx, diags);
+            const auto start = std::chrono::steady_clock::now();
+            checker.check_module(module, pool);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (i >= opts.warmup) {
+                seconds += elapsed.count();
+            }
+            errors = checker.get_error_count();
+            if (threads == 1 && i + 1 == opts.warmup + opts.repeat) {
+                diags.flush();
+            }
+        }
+        if (threads == 1) {
+            base_seconds = seconds;
+        }
+        std::cout << "  threads=" << threads << " " << seconds / opts.repeat * 1e3
+                  << " ms/check, speedup " << (seconds > 0.0 ? base_seconds / seconds : 0.0)
+                  << "x\n";
+        if (threads >= max_threads) {
+            break;
+        }
+    }
+    std::cout << "errors: " << errors << "\n";
+    return errors == 0 ? 0 : 1;
+}
+
+// CFG construction and the two Nova Core dataflow analyses over every
+// function of one checked module. Every run rebuilds the CFGs.
+int run_flow_stage(const Options& opts, const nova::SourceManager& sm, nova::FileID file_id) {
+    nova::IdentifierTable ids;
+    const nova::TokenStream tokens = nova::TokenStream::lex(sm, ids, file_id);
+    nova::ast::ASTContext ctx;
+    nova::DiagnosticEngine diags(&sm);
+    diags.set_diagnostic_limit(1);
+    nova::Parser parser(tokens, ctx, diags);
+    nova::ast::ModuleDecl* module = parser.parse_module(nullptr);
+    nova::sema::TypeChecker checker(ctx, diags);
+    checker.check_module(module);
+    if (parser.get_error_count() + checker.get_error_count() != 0) {
+        std::cerr << "input does not type check: "
+                  << parser.get_error_count() + checker.get_error_count() << " errors\n";
+        return 1;
+    }
+    std::vector<const nova::ast::FuncDecl*> funcs;
+    for (nova::ast::Decl* item : module->get_items()) {
+        if (const auto* func = nova::dyn_cast<nova::ast::FuncDecl>(item)) {
+            funcs.push_back(func);
+        }
+    }
+
+    double build_seconds = 0.0;
+    double solve_seconds = 0.0;
+    std::uint64_t blocks = 0;
+    std::uint64_t visits = 0;
+    std::uint64_t checksum = 0;
+    for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+        blocks = 0;
+        visits = 0;
+        for (const nova::ast::FuncDecl* func : funcs) {
+            const auto start = std::chrono::steady_clock::now();
+            const nova::analysis::CFG cfg = nova::analysis::CFGBuilder::build(func);
+            const nova::analysis::VariableIndex vars(func, cfg);
+            const auto built = std::chrono::steady_clock::now();
+            const nova::analysis::DataflowResult live = nova::analysis::compute_liveness(cfg, vars);
+            const nova::analysis::DataflowResult init =
+                nova::analysis::compute_definite_initialization(cfg, vars);
+            const auto solved = std::chrono::steady_clock::now();
+            if (i >= opts.warmup) {
+                build_seconds += std::chrono::duration<double>(built - start).count();
+                solve_seconds += std::chrono::duration<double>(solved - built).count();
+            }
+            blocks += cfg.size();
+            visits += live.get_visit_count() + init.get_visit_count();
+            checksum += live.get_block_entry(nova::analysis::CFG::kEntry).count() +
+                        init.get_block_entry(nova::analysis::CFG::kExit).count();
+        }
+    }
+
+    std::cout << "dataflow (" << funcs.size() << " functions, " << blocks << " blocks, repeat="
+              << opts.repeat << "):\n";
+    std::cout << "  cfg build  " << build_seconds / opts.repeat * 1e3 << " ms\n";
+    std::cout << "  liveness + definite init  " << solve_seconds / opts.repeat * 1e3 << " ms, "
+              << (blocks ? static_cast<double>(visits) / static_cast<double>(2 * blocks) : 0.0)
+              << " visits/block\n";
+    std::cout << "checksum: " << checksum << "\n";
+    return 0;
+}
+
+// One build of `source` for --stage=borrow: parsed and type checked into its
+// own context, which the BorrowChecker runs over.
+struct BorrowBuild {
+    nova::SourceManager sm;
+    nova::IdentifierTable ids;
+    nova::ast::ASTContext ctx;
+    nova::DiagnosticEngine diags{&sm};
+    nova::TokenStream tokens;
+    nova::ast::ModuleDecl* module = nullptr;
+
+    bool build(std::string source) {
+        diags.set_diagnostic_limit(1);
+        const nova::FileID file_id = sm.add_file("<generated>", std::move(source));
+        tokens = nova::TokenStream::lex(sm, ids, file_id);
+        nova::Parser parser(tokens, ctx, diags);
+        module = parser.parse_module(nullptr);
+        nova::sema::TypeChecker checker(ctx, diags);
+        checker.check_module(module);
+        return parser.get_error_count() + checker.get_error_count() == 0;
+    }
+};
+
+// Borrow checking from scratch against an incremental rebuild: the second
+// build moves every function down a line and adds one, and reuses the
+// results cached by the first.
+int run_borrow_stage(const Options& opts, const nova::SourceManager& sm, nova::FileID file_id) {
+    const std::string source(sm.get_file(file_id)->content);
+    BorrowBuild first;
+    BorrowBuild second;
+    if (!first.build(source) ||
+        !second.build("\n" + source + "func edited_(n: i64) -> i64 { let mut m: i64; m = n; m }\n")) {
+        std::cerr << "input does not type check\n";
+        return 1;
+    }
+
+    double scratch_seconds = 0.0;
+    double cached_seconds = 0.0;
+    std::uint32_t checked = 0;
+    std::uint32_t reused = 0;
+    std::uint32_t errors = 0;
+    for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+        nova::analysis::BorrowCheckCache cache;
+        nova::analysis::BorrowChecker cold(first.diags, &cache);
+        const auto cold_start = std::chrono::steady_clock::now();
+        cold.check_module(first.module);
+        const auto cold_done = std::chrono::steady_clock::now();
+        nova::analysis::BorrowChecker warm(second.diags, &cache);
+        const auto warm_start = std::chrono::steady_clock::now();
+        warm.check_module(second.module);
+        const auto warm_done = std::chrono::steady_clock::now();
+        if (i >= opts.warmup) {
+            scratch_seconds += std::chrono::duration<double>(cold_done - cold_start).count();
+            cached_seconds += std::chrono::duration<double>(warm_done - warm_start).count();
+        }
+        checked = warm.get_checked_count();
+        reused = warm.get_reused_count();
+        errors = cold.get_error_count() + warm.get_error_count();
+    }
+    std::cout << "borrow check (" << reused + checked << " functions, repeat=" << opts.repeat
+              << "):\n";
+    std::cout << "  from scratch  " << scratch_seconds / opts.repeat * 1e3 << " ms\n";
+    std::cout << "  after edit    " << cached_seconds / opts.repeat * 1e3 << " ms (" << checked
+              << " checked, " << reused << " reused)\n";
+    std::cout << "errors: " << errors << "\n";
+    return errors == 0 ? 0 : 1;
+}
+
+// Synthetic outlives constraints shaped like generic-heavy code: long chains
+// of lifetimes threaded through nested calls, short cycles from invariant
+// positions and short forward edges between nearby chains, with constraints
+// in reverse chain order
+// as a constraint generator walking the body tends to emit them. The live
+// points also go to `live`, the starting values for iteration.
+void build_lifetime_graph(nova::analysis::LifetimeSolver& solver, std::uint32_t count,
+                          std::uint32_t seed, std::vector<nova::BitVector>& live) {
+    constexpr std::uint32_t kChainLength = 1000;
+    std::mt19937 rng(seed);
+    live.assign(count, nova::BitVector(solver.get_point_count()));
+    for (std::uint32_t id = 0; id < count; ++id) {
+        const nova::analysis::Lifetime lifetime = solver.create_lifetime();
+        if (rng() % 4 == 0) {
+            const std::uint32_t point = rng() % solver.get_point_count();
+            solver.add_live_point(lifetime, point);
+            live[id].set(point);
+        }
+    }
+    for (std::uint32_t id = count; id-- > 1;) {
+        if (id % kChainLength != 0) {
+            solver.add_outlives(nova::analysis::Lifetime(id), nova::analysis::Lifetime(id - 1));
+        }
+        if (id % 16 == 0 && id >= 3) {
+            solver.add_outlives(nova::analysis::Lifetime(id - 3), nova::analysis::Lifetime(id));
+        }
+        const std::uint32_t longer = id + 1 + rng() % 64;
+        if (longer < count) {
+            solver.add_outlives(nova::analysis::Lifetime(longer), nova::analysis::Lifetime(id));
+        }
+    }
+}
+
+// The approach the solver replaces: apply every constraint until nothing
+// changes. Returns the number of passes.
+std::uint32_t solve_lifetimes_by_iteration(const nova::analysis::LifetimeSolver& solver,
+                                           std::vector<nova::BitVector>& values) {
+    std::uint32_t passes = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        ++passes;
+        for (const nova::analysis::LifetimeConstraint& constraint : solver.get_constraints()) {
+            changed |= values[constraint.longer.get_id()].union_with(
+                values[constraint.shorter.get_id()]);
+        }
+    }
+    return passes;
+}
+
+int run_lifetime_stage(const Options& opts) {
+    constexpr std::uint32_t kPoints = 256;
+    // iteration is only timed while it finishes in reasonable time
+    constexpr std::uint32_t kIterationLimit = 100000;
+    std::cout << "lifetime constraints (" << kPoints << " points, repeat=" << opts.repeat
+              << "):\n";
+    for (std::uint32_t count = 1000; count <= 1000000; count *= 10) {
+        double scc_seconds = 0.0;
+        double iteration_seconds = 0.0;
+        std::uint32_t components = 0;
+        std::uint32_t passes = 0;
+        std::size_t constraints = 0;
+        for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+            nova::analysis::LifetimeSolver solver(kPoints);
+            std::vector<nova::BitVector> values;
+            build_lifetime_graph(solver, count, i, values);
+            constraints = solver.get_constraints().size();
+            const auto start = std::chrono::steady_clock::now();
+            solver.solve();
+            const auto solved = std::chrono::steady_clock::now();
+            components = solver.get_component_count();
+            if (i >= opts.warmup) {
+                scc_seconds += std::chrono::duration<double>(solved - start).count();
+            }
+            if (count > kIterationLimit) {
+                continue;
+            }
+            const auto iterate_start = std::chrono::steady_clock::now();
+            passes = solve_lifetimes_by_iteration(solver, values);
+            const auto iterated = std::chrono::steady_clock::now();
+            if (i >= opts.warmup) {
+                iteration_seconds += std::chrono::duration<double>(iterated - iterate_start).count();
+            }
+            for (std::uint32_t id = 0; id < count; ++id) {
+                if (values[id] != solver.get_value(nova::analysis::Lifetime(id))) {
+                    std::cerr << "solvers disagree on lifetime " << id << "\n";
+                    return 1;
+                }
+            }
+        }
+        std::cout << "  lifetimes=" << count << " constraints=" << constraints
+                  << " components=" << components << ": scc " << scc_seconds / opts.repeat * 1e3
+                  << " ms";
+        if (count <= kIterationLimit) {
+            std::cout << ", iteration " << iteration_seconds / opts.repeat * 1e3 << " ms ("
+                      << passes << " passes)";
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+// Straight-line function of `count` instructions: a few constants, then
+// arithmetic on random earlier values, so each constant has many users.
+nova::ir::Function* build_ir_function(nova::ir::Module& module, std::uint32_t count,
+                                      std::uint32_t seed) {
+    constexpr std::uint32_t kConstants = 64;
+    std::mt19937 rng(seed);
+    const nova::ir::Type params[] = {nova::ir::Type::I64};
+    nova::ir::Function* func = module.create_function("f", params, nova::ir::Type::I64);
+    nova::ir::IRBuilder builder(func->create_block("entry"));
+    std::vector<nova::ir::Value*> values;
+    values.reserve(count);
+    values.push_back(func->get_arg(0));
+    for (std::uint32_t i = 0; i < kConstants; ++i) {
+        values.push_back(builder.create_const_i64(i));
+    }
+    while (values.size() < count) {
+        nova::ir::Value* lhs = values[rng() % values.size()];
+        // one operand is always a constant
+        nova::ir::Value* rhs = values[1 + rng() % kConstants];
+        values.push_back(rng() % 2 ? builder.create_add(lhs, rhs) : builder.create_mul(lhs, rhs));
+    }
+    builder.create_ret(values.back());
+    return func;
+}
+
+int run_ir_stage(const Options& opts) {
+    std::cout << "IR (repeat=" << opts.repeat << "):\n";
+    for (std::uint32_t count = 1000; count <= 1000000; count *= 10) {
+        double build_seconds = 0.0;
+        double walk_seconds = 0.0;
+        double rauw_seconds = 0.0;
+        double write_seconds = 0.0;
+        double load_seconds = 0.0;
+        std::size_t bytes = 0;
+        std::size_t encoded_bytes = 0;
+        std::uint64_t operands = 0;
+        std::uint64_t replaced = 0;
+        for (std::uint32_t i = 0; i < opts.warmup + opts.repeat; ++i) {
+            nova::ir::Module module("bench");
+            const auto start = std::chrono::steady_clock::now();
+            nova::ir::Function* func = build_ir_function(module, count, i);
+            const auto built = std::chrono::steady_clock::now();
+
+            // what a pass does: visit every instruction and operand
+            operands = 0;
+            for (nova::ir::BasicBlock* block : func->get_blocks()) {
+                for (nova::ir::Instruction* inst : block->get_instructions()) {
+                    for (const nova::ir::Use& use : inst->get_operands()) {
+                        operands += use.get() != nullptr;
+                    }
+                }
+            }
+            const auto walked = std::chrono::steady_clock::now();
+
+            // replace every constant by a fresh one, then drop the old ones
+            std::vector<nova::ir::Instruction*> constants;
+            nova::ir::Instruction* rest = func->get_entry_block()->get_first();
+            for (; rest->is_constant(); rest = rest->get_next()) {
+                constants.push_back(rest);
+            }
+            nova::ir::IRBuilder builder;
+            builder.set_insert_point(rest);
+            replaced = 0;
+            for (nova::ir::Instruction* inst : constants) {
+                replaced += inst->get_use_count();
+                inst->replace_all_uses_with(builder.create_const_i64(inst->get_i64()));
+                inst->erase_from_parent();
+            }
+            const auto rewritten = std::chrono::steady_clock::now();
+
+            // cache the result in the binary format and load it back
+            std::string encoded;
+            nova::ir::write_module(module, encoded);
+            const auto written = std::chrono::steady_clock::now();
+            nova::ir::ModuleReader reader;
+            if (!reader.load_buffer(encoded) || !reader.materialize_all()) {
+                std::cerr << "cannot load the written module: " << reader.get_error() << "\n";
+                return 1;
+            }
+            const auto loaded = std::chrono::steady_clock::now();
+            // erased constants leave no gaps in the loaded numbering
+            std::uint32_t live = 0;
+            for (std::uint32_t id = 0; id < func->get_value_count(); ++id) {
+                live += func->get_value(id) != nullptr;
+            }
+            if (reader.get_module()->get_function("f")->get_value_count() != live) {
+                std::cerr << "loaded module differs from the written one\n";
+                return 1;
+            }
+            bytes = func->get_bytes_allocated();
+            encoded_bytes = encoded.size();
+            if (i >= opts.warmup) {
+                build_seconds += std::chrono::duration<double>(built - start).count();
+                walk_seconds += std::chrono::duration<double>(walked - built).count();
+                rauw_seconds += std::chrono::duration<double>(rewritten - walked).count();
+                write_seconds += std::chrono::duration<double>(written - rewritten).count();
+                load_seconds += std::chrono::duration<double>(loaded - written).count();
+            }
+        }
+        const double per_inst = 1e9 / opts.repeat / count;
+        std::cout << "  instructions=" << count << " (" << bytes / count
+                  << " B each): build " << build_seconds * per_inst << " ns/inst, walk "
+                  << walk_seconds * per_inst << " ns/inst (" << operands
+                  << " operands), replace " << rauw_seconds / opts.repeat * 1e3 << " ms ("
+                  << replaced << " uses)\n"
+                  << "    binary " << static_cast<double>(encoded_bytes) / count
+                  << " B/inst: write " << write_seconds * per_inst << " ns/inst, load "
+                  << load_seconds * per_inst << " ns/inst\n";
+    }
+    return 0;
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -199,23 +1162,48 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::string input;
-    std::string virtual_filename = "<generated>";
+    nova::SourceManager sm;
+    nova::FileID file_id = 0;
     if (!opts.file_path.empty()) {
-        input = read_file(opts.file_path);
-        if (input.empty()) {
+        // zero-copy: the lexer reads straight from the mapped pages
+        file_id = sm.add_file_mapped(opts.file_path);
+        if (file_id == 0 || sm.get_file(file_id)->content.empty()) {
             std::cerr << "Failed to read file: " << opts.file_path << "\n";
             return 2;
         }
-        virtual_filename = opts.file_path;
     } else {
-        input = generate_source(opts.bytes);
+        file_id = sm.add_file("<generated>", generate_source(opts, opts.bytes));
     }
 
-    const std::size_t input_bytes = input.size();
+    if (opts.isa != "auto") {
+        nova::SIMDLevel requested = nova::SIMDLevel::Scalar;
+        (void)parse_simd_level(opts.isa, requested);
+        if (nova::set_active_simd_level(requested) != requested) {
+            std::cerr << "Requested --isa " << opts.isa << " is not supported on this host; using "
+                      << nova::get_simd_level_name(nova::get_active_simd_level()) << "\n";
+        }
+    }
 
-    nova::SourceManager sm;
-    const std::uint16_t file_id = sm.add_file(std::move(virtual_filename), std::move(input));
+    if (opts.stage == "parse") {
+        return run_parse_stage(opts, sm, file_id);
+    }
+    if (opts.stage == "check") {
+        return run_check_stage(opts, sm, file_id);
+    }
+    if (opts.stage == "flow") {
+        return run_flow_stage(opts, sm, file_id);
+    }
+    if (opts.stage == "borrow") {
+        return run_borrow_stage(opts, sm, file_id);
+    }
+    if (opts.stage == "lifetimes") {
+        return run_lifetime_stage(opts);
+    }
+    if (opts.stage == "ir") {
+        return run_ir_stage(opts);
+    }
+
+    const std::size_t input_bytes = sm.get_file(file_id)->content.size();
 
     nova::IdentifierTable ids;
     for (std::uint32_t i = 0; i < opts.warmup; ++i) {
@@ -241,10 +1229,17 @@ int main(int argc, char** argv) {
         (seconds > 0.0) ? (static_cast<double>(total_tokens) / seconds) : 0.0;
 
     std::cout << "lexer: bytes=" << input_bytes << " repeat=" << opts.repeat
-              << " warmup=" << opts.warmup << "\n";
+              << " warmup=" << opts.warmup
+              << " isa=" << nova::get_simd_level_name(nova::get_active_simd_level()) << "\n";
     std::cout << "elapsed: " << seconds << " s\n";
     std::cout << "throughput: " << mb_per_sec << " MiB/s\n";
     std::cout << "tokens: " << total_tokens << " (" << tokens_per_sec << " tokens/s)\n";
     std::cout << "checksum: " << total_checksum << "\n";
+
+    print_kernel_breakdown(sm, ids, file_id, sm.get_file(file_id)->content, opts.repeat);
+    print_keyword_breakdown(sm.get_file(file_id)->content, opts.repeat);
+    if (opts.files > 1) {
+        print_parallel_breakdown(opts);
+    }
     return 0;
 }
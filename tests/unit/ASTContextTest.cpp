@@ -0,0 +1,113 @@
+#include "nova/AST/ASTContext.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace nova {
+namespace ast {
+namespace {
+
+struct TestBinary {
+    static constexpr ASTNodeKind kKind = ASTNodeKind::BinaryExpr;
+    uint32_t op;
+    const TestBinary* lhs;
+    const TestBinary* rhs;
+
+    TestBinary(uint32_t op, const TestBinary* lhs, const TestBinary* rhs)
+        : op(op), lhs(lhs), rhs(rhs) {}
+};
+
+struct TestCall {
+    static constexpr ASTNodeKind kKind = ASTNodeKind::CallExpr;
+    size_t arg_count;
+
+    explicit TestCall(size_t arg_count) : arg_count(arg_count) {}
+    const TestBinary** args() { return reinterpret_cast<const TestBinary**>(this + 1); }
+};
+
+} // namespace
+
+TEST(ASTContextTest, CountsNodesPerKind) {
+    ASTContext ctx;
+    const TestBinary* leaf = ctx.create<TestBinary>(0, nullptr, nullptr);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        leaf = ctx.create<TestBinary>(i, leaf, leaf);
+    }
+    EXPECT_EQ(leaf->op, 999u);
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::BinaryExpr).count, 1001u);
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::BinaryExpr).bytes, 1001u * sizeof(TestBinary));
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::CallExpr).count, 0u);
+    EXPECT_EQ(ctx.node_count(), 1001u);
+    EXPECT_GE(ctx.bytes_reserved(), ctx.bytes_allocated());
+    EXPECT_GT(ctx.slab_count(), 1u);
+}
+
+TEST(ASTContextTest, TrailingObjectsArraysAndStrings) {
+    ASTContext ctx;
+    const TestBinary* arg = ctx.create<TestBinary>(1, nullptr, nullptr);
+    TestCall* call = ctx.create_with_trailing<TestCall, const TestBinary*>(3, 3);
+    for (size_t i = 0; i < call->arg_count; ++i) {
+        call->args()[i] = arg;
+    }
+    EXPECT_EQ(call->args()[2], arg);
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::CallExpr).bytes,
+              sizeof(TestCall) + 3 * sizeof(const TestBinary*));
+
+    const uint32_t ids[] = {4, 5, 6};
+    uint32_t* copy = ctx.copy_array(ids, 3);
+    EXPECT_EQ(copy[1], 5u);
+    EXPECT_EQ(ctx.array_bytes(), sizeof(ids));
+
+    std::string name = "temporary";
+    std::string_view kept = ctx.copy_string(name);
+    name.assign("overwritten");
+    EXPECT_EQ(kept, "temporary");
+    EXPECT_EQ(ctx.string_bytes(), 9u);
+
+    std::FILE* out = std::tmpfile();
+    ASSERT_NE(out, nullptr);
+    ctx.print_stats(out);
+    std::rewind(out);
+    char line[256];
+    std::string text;
+    while (std::fgets(line, sizeof(line), out)) {
+        text += line;
+    }
+    std::fclose(out);
+    EXPECT_NE(text.find("CallExpr"), std::string::npos);
+    EXPECT_EQ(text.find("IfExpr"), std::string::npos);
+}
+
+TEST(ASTContextTest, ShardsShareTypesAndAreAdopted) {
+    ASTContext ctx;
+    const TestBinary* root = ctx.create<TestBinary>(0, nullptr, nullptr);
+    const size_t types = ctx.type_count();
+
+    const TestBinary* leaf;
+    {
+        ASTContext shard(&ctx);
+        EXPECT_EQ(shard.get_i64_type(), ctx.get_i64_type());
+        EXPECT_EQ(shard.get_slice_type(shard.get_i64_type()),
+                  ctx.get_slice_type(ctx.get_i64_type()));
+        EXPECT_EQ(ctx.type_count(), types + 1);
+
+        leaf = shard.create<TestBinary>(1, root, root);
+        for (uint32_t i = 2; i < 1000; ++i) {
+            leaf = shard.create<TestBinary>(i, leaf, root);
+        }
+        shard.copy_string("shard");
+        ctx.adopt(shard);
+        EXPECT_EQ(shard.node_count(), 0u);
+        EXPECT_EQ(shard.bytes_allocated(), 0u);
+    }
+    // the shard is gone but its nodes now belong to ctx
+    EXPECT_EQ(leaf->op, 999u);
+    EXPECT_EQ(leaf->rhs, root);
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::BinaryExpr).count, 1000u);
+    EXPECT_EQ(ctx.string_bytes(), 5u);
+    EXPECT_GE(ctx.bytes_allocated(), 1000u * sizeof(TestBinary));
+}
+
+} // namespace ast
+} // namespace nova
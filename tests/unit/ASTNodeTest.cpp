@@ -0,0 +1,124 @@
+#include "nova/AST/ASTContext.hpp"
+#include "nova/AST/ASTVisitor.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+namespace nova {
+namespace ast {
+namespace {
+
+#if !defined(NOVA_LARGE_SOURCE_LOCATIONS)
+static_assert(sizeof(void*) != 8 || sizeof(BinaryExpr) == 32, "BinaryExpr grew");
+static_assert(sizeof(void*) != 8 || sizeof(IdentifierExpr) == 32, "IdentifierExpr grew");
+static_assert(sizeof(void*) != 8 || sizeof(CallExpr) == 32, "CallExpr grew");
+static_assert(sizeof(void*) != 8 || sizeof(ExprStmt) == 16, "ExprStmt grew");
+#endif
+
+// folds integer arithmetic, returning the value of the expression
+class Evaluator : public ASTVisitor<Evaluator, int64_t> {
+public:
+    int64_t visit_literal_expr(LiteralExpr* e) { return static_cast<int64_t>(e->get_integer()); }
+    int64_t visit_unary_expr(UnaryExpr* e) { return -visit(e->get_operand()); }
+    int64_t visit_binary_expr(BinaryExpr* e) {
+        const int64_t lhs = visit(e->get_lhs());
+        const int64_t rhs = visit(e->get_rhs());
+        switch (e->get_op()) {
+        case BinaryOp::Add: return lhs + rhs;
+        case BinaryOp::Sub: return lhs - rhs;
+        case BinaryOp::Mul: return lhs * rhs;
+        default: return 0;
+        }
+    }
+    int64_t visit_block_expr(BlockExpr* e) { return e->get_result() ? visit(e->get_result()) : 0; }
+    // anything else is unsupported
+    int64_t visit_expr(Expr*) { return -1000; }
+};
+
+// collects identifiers in source order
+class NameCollector : public ASTWalker<NameCollector> {
+public:
+    std::vector<std::string_view> names;
+
+    void visit_identifier_expr(IdentifierExpr* e) { names.push_back(e->get_name()->get_name()); }
+    void visit_var_decl(VarDecl* d) {
+        names.push_back(d->get_name()->get_name());
+        ASTWalker::visit_var_decl(d);
+    }
+};
+
+LiteralExpr* int_lit(ASTContext& ctx, uint64_t value) {
+    return LiteralExpr::create_integer(ctx, SourceLocation(), "0", value);
+}
+
+} // namespace
+
+TEST(ASTNodeTest, CastingFollowsKindTag) {
+    ASTContext ctx;
+    Expr* lit = int_lit(ctx, 2);
+    Expr* neg = ctx.create<UnaryExpr>(SourceLocation(), UnaryOp::Neg, lit);
+    EXPECT_TRUE(isa<LiteralExpr>(lit));
+    EXPECT_FALSE(isa<UnaryExpr>(lit));
+    EXPECT_TRUE((isa<BinaryExpr, UnaryExpr>(neg)));
+    EXPECT_EQ(dyn_cast<BinaryExpr>(neg), nullptr);
+    EXPECT_EQ(cast<UnaryExpr>(neg)->get_operand(), lit);
+    const Expr* const_neg = neg;
+    const UnaryExpr* unary = dyn_cast<UnaryExpr>(const_neg);
+    ASSERT_NE(unary, nullptr);
+    EXPECT_EQ(unary->get_op(), UnaryOp::Neg);
+    EXPECT_EQ(dyn_cast_if_present<UnaryExpr>(static_cast<Expr*>(nullptr)), nullptr);
+}
+
+TEST(ASTNodeTest, VisitorDispatchesOnKind) {
+    ASTContext ctx;
+    IdentifierTable ids;
+    // { 1 + 2 * -3 }
+    Expr* mul = ctx.create<BinaryExpr>(SourceLocation(), BinaryOp::Mul, int_lit(ctx, 2),
+                                       ctx.create<UnaryExpr>(SourceLocation(), UnaryOp::Neg,
+                                                             int_lit(ctx, 3)));
+    Expr* add = ctx.create<BinaryExpr>(SourceLocation(), BinaryOp::Add, int_lit(ctx, 1), mul);
+    BlockExpr* block = BlockExpr::create(ctx, SourceLocation(), {}, add, SourceLocation());
+    Evaluator eval;
+    EXPECT_EQ(eval.visit(block), -5);
+
+    Expr* callee = ctx.create<IdentifierExpr>(SourceLocation(), ids.intern("f"));
+    Expr* args[] = {int_lit(ctx, 1), add};
+    CallExpr* call = CallExpr::create(ctx, SourceLocation(), callee, args, SourceLocation());
+    ASSERT_EQ(call->get_args().size(), 2u);
+    EXPECT_EQ(call->get_args()[1], add);
+    EXPECT_EQ(eval.visit(call), -1000);
+}
+
+TEST(ASTNodeTest, WalkerVisitsChildrenInOrder) {
+    ASTContext ctx;
+    IdentifierTable ids;
+    // func main() { let mut x = a + b; x = c; x }
+    auto ident = [&](const char* name) {
+        return ctx.create<IdentifierExpr>(SourceLocation(), ids.intern(name));
+    };
+    VarDecl* x = ctx.create<VarDecl>(SourceLocation(), ids.intern("x"), true, nullptr,
+                                     ctx.create<BinaryExpr>(SourceLocation(), BinaryOp::Add,
+                                                            ident("a"), ident("b")));
+    Stmt* stmts[] = {
+        ctx.create<DeclStmt>(SourceLocation(), x),
+        ctx.create<ExprStmt>(SourceLocation(),
+                             ctx.create<AssignExpr>(SourceLocation(), ident("x"), ident("c")),
+                             true),
+    };
+    BlockExpr* body = BlockExpr::create(ctx, SourceLocation(), stmts, ident("x"), SourceLocation());
+    FuncDecl* main = FuncDecl::create(ctx, SourceLocation(), ids.intern("main"), {}, nullptr);
+    main->set_body(body);
+    Decl* items[] = {main};
+    ModuleDecl* module = ModuleDecl::create(ctx, SourceLocation(), nullptr, items);
+
+    EXPECT_TRUE(x->is_mutable());
+    EXPECT_TRUE(cast<ExprStmt>(stmts[1])->has_semicolon());
+    NameCollector names;
+    names.visit(module);
+    EXPECT_EQ(names.names, (std::vector<std::string_view>{"x", "a", "b", "x", "c", "x"}));
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::IdentifierExpr).count, 5u);
+}
+
+} // namespace ast
+} // namespace nova
@@ -0,0 +1,187 @@
+#include "nova/Basic/Casting.hpp"
+#include "nova/IR/BinaryFormat.hpp"
+#include "nova/IR/IRBuilder.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+namespace nova {
+namespace {
+
+using namespace ir;
+
+// Three functions that call each other, with a loop, every constant kind
+// and a unit function; values are created in layout order.
+void build_module(Module& module) {
+    const Type sum_params[] = {Type::I64};
+    Function* sum = module.create_function("sum", sum_params, Type::I64);
+    BasicBlock* entry = sum->create_block("entry");
+    BasicBlock* loop = sum->create_block("loop");
+    BasicBlock* exit = sum->create_block("exit");
+    IRBuilder builder(entry);
+    Instruction* zero = builder.create_const_i64(-7);
+    Instruction* one = builder.create_const_i64(1);
+    builder.create_br(loop);
+    builder.set_insert_point(loop);
+    Instruction* i = builder.create_phi(Type::I64, 2);
+    Instruction* total = builder.create_phi(Type::I64, 2);
+    Instruction* next_total = builder.create_add(total, i);
+    Instruction* next_i = builder.create_add(i, one);
+    Instruction* more = builder.create_icmp(CmpPredicate::Slt, next_i, sum->get_arg(0));
+    builder.create_cond_br(more, loop, exit);
+    i->set_incoming(0, zero, entry);
+    i->set_incoming(1, next_i, loop);
+    total->set_incoming(0, zero, entry);
+    total->set_incoming(1, next_total, loop);
+    builder.set_insert_point(exit);
+    builder.create_ret(next_total);
+
+    const Type scale_params[] = {Type::F64, Type::U64, Type::Bool};
+    Function* scale = module.create_function("scale", scale_params, Type::F64);
+    builder.set_insert_point(scale->create_block("entry"));
+    Instruction* factor = builder.create_const_f64(-0.1);
+    Instruction* product = builder.create_fmul(scale->get_arg(0), factor);
+    builder.create_const_u64(UINT64_MAX);
+    builder.create_const_bool(true);
+    builder.create_fcmp(CmpPredicate::Oge, product, factor);
+    builder.create_ret(product);
+
+    Function* main = module.create_function("main", {}, Type::Unit);
+    builder.set_insert_point(main->create_block(""));
+    Value* args[] = {builder.create_const_i64(10)};
+    builder.create_call(sum, args);
+    builder.create_const_unit();
+    builder.create_ret();
+    builder.set_insert_point(main->create_block("dead"));
+    builder.create_unreachable();
+}
+
+std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(BinaryFormatTest, RoundTripsThroughFile) {
+    Module module("round trip");
+    build_module(module);
+    const std::string path = temp_path("nova_ir_round_trip.novair");
+    ASSERT_TRUE(write_module_file(module, path));
+
+    ModuleReader reader;
+    ASSERT_TRUE(reader.load_file(path)) << reader.get_error();
+    ASSERT_TRUE(reader.materialize_all()) << reader.get_error();
+    Module* loaded = reader.get_module();
+    EXPECT_EQ(loaded->get_name(), "round trip");
+    EXPECT_EQ(loaded->print(), module.print());
+
+    // writing the loaded module gives the same bytes
+    std::string first;
+    std::string second;
+    write_module(module, first);
+    write_module(*loaded, second);
+    EXPECT_EQ(first, second);
+
+    // use lists are rebuilt, including the phis' forward references
+    const Function* sum = loaded->get_function("sum");
+    EXPECT_EQ(sum->get_value(1)->get_use_count(), 2u);
+    EXPECT_EQ(sum->get_value(7)->get_use_count(), 2u);
+    std::remove(path.c_str());
+}
+
+TEST(BinaryFormatTest, MaterializesFunctionsOnDemand) {
+    Module module("lazy");
+    build_module(module);
+    std::string bytes;
+    write_module(module, bytes);
+
+    ModuleReader reader;
+    ASSERT_TRUE(reader.load_buffer(bytes)) << reader.get_error();
+    Module* loaded = reader.get_module();
+    ASSERT_EQ(loaded->get_functions().size(), 3u);
+    Function* main = loaded->get_function("main");
+    Function* sum = loaded->get_function("sum");
+    EXPECT_EQ(reader.get_materialized_count(), 0u);
+    EXPECT_TRUE(main->get_blocks().empty());
+    EXPECT_EQ(sum->get_param_types().size(), 1u);
+
+    ASSERT_TRUE(reader.materialize(main));
+    EXPECT_TRUE(reader.is_materialized(main));
+    EXPECT_FALSE(reader.is_materialized(sum));
+    EXPECT_EQ(reader.get_materialized_count(), 1u);
+    // the call refers to the signature-only callee
+    const Instruction* call = cast<Instruction>(main->get_value(1));
+    ASSERT_EQ(call->get_opcode(), Opcode::Call);
+    EXPECT_EQ(call->get_callee(), sum);
+    EXPECT_TRUE(sum->get_blocks().empty());
+
+    ASSERT_TRUE(reader.materialize(main)); // no-op
+    EXPECT_EQ(reader.get_materialized_count(), 1u);
+}
+
+TEST(BinaryFormatTest, RenumbersValuesInLayoutOrder) {
+    Module module("renumber");
+    Function* func = module.create_function("f", {}, Type::I64);
+    BasicBlock* entry = func->create_block("entry");
+    BasicBlock* exit = func->create_block("exit");
+    IRBuilder builder(exit);
+    // created first, laid out last
+    Instruction* two = builder.create_const_i64(2);
+    builder.create_ret(two);
+    builder.set_insert_point(entry);
+    Instruction* dead = builder.create_const_i64(1);
+    builder.create_br(exit);
+    dead->erase_from_parent();
+
+    std::string bytes;
+    write_module(module, bytes);
+    ModuleReader reader;
+    ASSERT_TRUE(reader.load_buffer(bytes));
+    ASSERT_TRUE(reader.materialize_all());
+    EXPECT_EQ(reader.get_module()->print(), "func @f() -> i64 {\n"
+                                            "entry:\n"
+                                            "  br exit\n"
+                                            "exit:\n"
+                                            "  %1 = const i64 2\n"
+                                            "  ret %1\n"
+                                            "}\n");
+    EXPECT_EQ(reader.get_module()->get_function("f")->get_value_count(), 3u);
+}
+
+TEST(BinaryFormatTest, RejectsMalformedInput) {
+    Module module("bad");
+    build_module(module);
+    std::string bytes;
+    write_module(module, bytes);
+
+    ModuleReader reader;
+    EXPECT_FALSE(reader.load_buffer("NOVADIAG"));
+    EXPECT_EQ(reader.get_error(), "not a Nova IR module");
+    std::string future = bytes;
+    future[8] = 9;
+    EXPECT_FALSE(reader.load_buffer(future));
+    EXPECT_EQ(reader.get_error(), "unsupported Nova IR module version 9");
+    EXPECT_FALSE(reader.load_file(temp_path("nova_ir_missing.novair")));
+
+    // every truncation is caught by the tables or by the function table's
+    // body sizes
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        EXPECT_FALSE(reader.load_buffer(bytes.substr(0, size))) << size;
+    }
+
+    // flipped bytes may decode to other valid IR, but never crash
+    std::mt19937 rng(7);
+    for (int round = 0; round < 2000; ++round) {
+        std::string corrupt = bytes;
+        for (int flips = 1 + rng() % 3; flips > 0; --flips) {
+            corrupt[rng() % corrupt.size()] ^= static_cast<char>(1 + rng() % 255);
+        }
+        if (reader.load_buffer(corrupt)) {
+            reader.materialize_all();
+            (void)reader.get_module()->print();
+        }
+    }
+}
+
+} // namespace
+} // namespace nova
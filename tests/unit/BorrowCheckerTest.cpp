@@ -0,0 +1,93 @@
+#include "CheckedModule.hpp"
+#include "nova/Analysis/BorrowChecker.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace nova {
+namespace {
+
+using analysis::BorrowCheckCache;
+
+TEST(BorrowCheckerTest, ReportsUseOfUninitializedVariable) {
+    CheckedModule checked;
+    const auto errors = checked.borrow_check("func f(c: bool) -> i64 {\n"
+                                             "    let mut x: i64;\n"
+                                             "    let mut y: i64;\n"
+                                             "    if c { x = 1; y = 2; } else { x = 3; }\n"
+                                             "    x + y + y\n"
+                                             "}\n"
+                                             "func g(n: i64) -> i64 {\n"
+                                             "    let mut z: i64;\n"
+                                             "    while n > 0 { z = n; }\n"
+                                             "    z = 0;\n"
+                                             "    z\n"
+                                             "}\n");
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_EQ(errors[0], "5:9 E0509: 'y'");
+    EXPECT_EQ(errors[1], "3:13 N0001: 'y' declared here");
+    EXPECT_EQ(checked.borrow_checker->get_error_count(), 1u);
+    EXPECT_EQ(checked.borrow_checker->get_checked_count(), 2u);
+}
+
+TEST(BorrowCheckerTest, CacheReusesUnchangedFunctions) {
+    const std::string bad = "func bad(c: bool) -> i64 { let mut v: i64; if c { v = 1; } v }\n";
+    const std::string same = "func same(a: i64) -> i64 { a * 2 }\n";
+    BorrowCheckCache cache;
+    CheckedModule first;
+    const auto before =
+        first.borrow_check(bad + same + "func edited(a: i64) -> i64 { a }\n", &cache);
+    ASSERT_EQ(before.size(), 2u);
+    EXPECT_EQ(before[0], "1:60 E0509: 'v'");
+    EXPECT_EQ(first.borrow_checker->get_checked_count(), 3u);
+    EXPECT_EQ(cache.size(), 3u);
+
+    // a fresh context: one function edited, everything moved down a line
+    const std::string edited =
+        "\n" + bad + same + "func edited(a: i64) -> i64 { let mut w: i64; w + same(1) }\n";
+    CheckedModule second;
+    const auto after = second.borrow_check(edited, &cache);
+    EXPECT_EQ(second.borrow_checker->get_reused_count(), 2u);
+    EXPECT_EQ(second.borrow_checker->get_checked_count(), 1u);
+    EXPECT_EQ(second.borrow_checker->get_error_count(), 2u);
+
+    // the same diagnostics as checking from scratch, at the moved locations
+    CheckedModule scratch;
+    EXPECT_EQ(after, scratch.borrow_check(edited));
+    ASSERT_EQ(after.size(), 4u);
+    EXPECT_EQ(after[0], "2:60 E0509: 'v'");
+
+    // a changed callee signature invalidates its callers
+    CheckedModule third;
+    third.borrow_check("\n" + bad + "func same(a: i32) -> i64 { 2 }\n" +
+                           "func edited(a: i64) -> i64 { let mut w: i64; w + same(1) }\n",
+                       &cache);
+    EXPECT_EQ(third.borrow_checker->get_reused_count(), 1u);
+    EXPECT_EQ(third.borrow_checker->get_checked_count(), 2u);
+}
+
+TEST(BorrowCheckerTest, ParallelCheckMatchesSerial) {
+    std::string source;
+    for (int i = 0; i < 100; ++i) {
+        const std::string n = std::to_string(i);
+        source += "func step" + n + "(c: bool) -> i64 { let mut v: i64; ";
+        // every fifth body reads `v` on a path that never assigns it
+        source += i % 5 == 0 ? "if c { v = " + n + "; } v }\n" : "v = " + n + "; v }\n";
+    }
+
+    CheckedModule serial;
+    const auto expected = serial.borrow_check(source);
+    EXPECT_EQ(expected.size(), 2u * 20u);
+
+    BorrowCheckCache cache;
+    ThreadPool pool(4);
+    CheckedModule parallel;
+    EXPECT_EQ(parallel.borrow_check(source, &cache, &pool), expected);
+    CheckedModule cached;
+    EXPECT_EQ(cached.borrow_check(source, &cache, &pool), expected);
+    EXPECT_EQ(cached.borrow_checker->get_reused_count(), 100u);
+}
+
+} // namespace
+} // namespace nova
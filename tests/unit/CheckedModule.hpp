@@ -0,0 +1,81 @@
+#pragma once
+#include "nova/Analysis/BorrowChecker.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/Parse/Parser.hpp"
+#include "nova/Sema/TypeChecker.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nova {
+
+// One file parsed and checked into its own context; diagnostics are
+// deferred and collected as "line:column code: arguments".
+struct CheckedModule {
+    SourceManager sm;
+    IdentifierTable ids;
+    ast::ASTContext ctx;
+    DiagnosticEngine diags{&sm};
+    TokenStream tokens;
+    std::vector<std::string> messages;
+    std::unique_ptr<sema::TypeChecker> checker;
+    std::unique_ptr<analysis::BorrowChecker> borrow_checker;
+
+    CheckedModule() {
+        diags.set_deferred(true);
+        diags.set_handler([this](const DiagnosticMessage& diag) {
+            uint32_t line = 0;
+            uint32_t column = 0;
+            sm.get_line_column(diag.location, line, column);
+            messages.push_back(std::to_string(line) + ":" + std::to_string(column) + " " +
+                               get_diagnostic_code(diag.id) + diag.message);
+        });
+    }
+
+    // parse (expecting no errors) and type check
+    std::vector<std::string> check(const std::string& source, ThreadPool* pool = nullptr) {
+        type_check(source, pool);
+        diags.flush();
+        return messages;
+    }
+
+    // parse and type check (expecting no errors), then borrow check
+    std::vector<std::string> borrow_check(const std::string& source,
+                                          analysis::BorrowCheckCache* cache = nullptr,
+                                          ThreadPool* pool = nullptr) {
+        ast::ModuleDecl* module = type_check(source, pool);
+        EXPECT_EQ(checker->get_error_count(), 0u) << source;
+        borrow_checker = std::make_unique<analysis::BorrowChecker>(diags, cache);
+        if (pool) {
+            borrow_checker->check_module(module, *pool);
+        } else {
+            borrow_checker->check_module(module);
+        }
+        diags.flush();
+        return messages;
+    }
+
+    ast::FuncDecl* func(const char* name) const {
+        sema::Symbol* symbol = checker->lookup_function(ids.get(name));
+        return symbol ? cast<ast::FuncDecl>(symbol->get_decl()) : nullptr;
+    }
+
+private:
+    ast::ModuleDecl* type_check(const std::string& source, ThreadPool* pool) {
+        const FileID file_id = sm.add_file("test.nova", source);
+        tokens = TokenStream::lex(sm, ids, file_id);
+        Parser parser(tokens, ctx, diags);
+        ast::ModuleDecl* module = parser.parse_module(nullptr);
+        EXPECT_EQ(parser.get_error_count(), 0u) << source;
+        checker = std::make_unique<sema::TypeChecker>(ctx, diags);
+        if (pool) {
+            checker->check_module(module, *pool);
+        } else {
+            checker->check_module(module);
+        }
+        return module;
+    }
+};
+
+} // namespace nova
@@ -0,0 +1,174 @@
+#include "nova/AST/Decl.hpp"
+#include "nova/AST/Expr.hpp"
+#include "nova/Analysis/CFG.hpp"
+#include "nova/Analysis/Dataflow.hpp"
+#include "nova/Basic/BitVector.hpp"
+#include "nova/Parse/Parser.hpp"
+#include "nova/Sema/TypeChecker.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace nova {
+namespace {
+
+using namespace ast;
+using namespace analysis;
+
+// One function parsed and type checked, with its CFG and variables.
+class DataflowTest : public ::testing::Test {
+protected:
+    SourceManager sm;
+    IdentifierTable ids;
+    ASTContext ctx;
+    DiagnosticEngine diags{&sm};
+    TokenStream tokens;
+    FuncDecl* func = nullptr;
+    CFG cfg;
+
+    void build(const std::string& source) {
+        const FileID file_id = sm.add_file("test.nova", source);
+        tokens = TokenStream::lex(sm, ids, file_id);
+        Parser parser(tokens, ctx, diags);
+        ModuleDecl* module = parser.parse_module(nullptr);
+        sema::TypeChecker checker(ctx, diags);
+        checker.check_module(module);
+        ASSERT_EQ(parser.get_error_count() + checker.get_error_count(), 0u) << source;
+        func = cast<FuncDecl>(module->get_items().back());
+        cfg = CFGBuilder::build(func);
+    }
+
+    // Names of the variables set in `bits`, in bit order.
+    std::vector<std::string> names(const VariableIndex& vars, const BitVector& bits) const {
+        std::vector<std::string> result;
+        bits.for_each_set_bit([&](size_t bit) {
+            result.emplace_back(vars.get_decl(static_cast<uint32_t>(bit))->get_name()->get_name());
+        });
+        return result;
+    }
+};
+
+using Names = std::vector<std::string>;
+
+TEST(BitVectorTest, WordOperations) {
+    BitVector a(130);
+    EXPECT_FALSE(a.any());
+    a.set(0);
+    a.set(64);
+    a.set(129);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_TRUE(a.test(64));
+    EXPECT_FALSE(a.test(65));
+
+    BitVector b(130, /*value=*/true);
+    EXPECT_EQ(b.count(), 130u);
+    EXPECT_FALSE(b.union_with(a));
+    EXPECT_TRUE(b.intersect_with(a));
+    EXPECT_EQ(b, a);
+    EXPECT_FALSE(b.intersect_with(a));
+
+    BitVector kill(130);
+    kill.set(64);
+    BitVector gen(130);
+    gen.set(1);
+    BitVector out(130);
+    EXPECT_TRUE(out.assign_transfer(gen, a, kill));
+    std::vector<size_t> bits;
+    out.for_each_set_bit([&](size_t bit) { bits.push_back(bit); });
+    EXPECT_EQ(bits, (std::vector<size_t>{0, 1, 129}));
+    EXPECT_FALSE(out.assign_transfer(gen, a, kill));
+
+    out.subtract(a);
+    EXPECT_EQ(out.count(), 1u);
+    out.reset_all();
+    EXPECT_FALSE(out.any());
+}
+
+TEST_F(DataflowTest, BuildsBranchesAndLoops) {
+    build("func f(n: i64) -> i64 {\n"
+          "    let mut i = 0;\n"
+          "    while i < n { if i == 3 { break; } i = i + 1; }\n"
+          "    if n > 0 && i > 0 { i } else { n }\n"
+          "}\n");
+    const CFGBlock& entry = cfg.get_entry();
+    ASSERT_EQ(entry.get_succs().size(), 1u);
+    const CFGBlock& header = cfg.get_block(entry.get_succs()[0]);
+    ASSERT_EQ(header.get_succs().size(), 2u);
+    EXPECT_NE(header.get_branch_condition(), nullptr);
+    // the loop body and the continue edge both come back to the header
+    EXPECT_EQ(header.get_preds().size(), 2u);
+    // `break` leaves an unreachable block behind, which RPO leaves out
+    const std::vector<uint32_t> rpo = cfg.compute_reverse_postorder();
+    EXPECT_EQ(rpo.front(), CFG::kEntry);
+    EXPECT_LT(rpo.size(), cfg.size());
+    std::vector<uint32_t> position(cfg.size(), UINT32_MAX);
+    for (uint32_t i = 0; i < rpo.size(); ++i) {
+        position[rpo[i]] = i;
+    }
+    for (uint32_t id : rpo) {
+        for (uint32_t succ : cfg.get_block(id).get_succs()) {
+            // only the loop's back edge points backwards
+            if (position[succ] <= position[id]) {
+                EXPECT_EQ(succ, header.get_id());
+            }
+        }
+    }
+    EXPECT_EQ(cfg.get_exit().get_succs().size(), 0u);
+    EXPECT_TRUE(cfg.get_exit().get_elements().empty());
+}
+
+TEST_F(DataflowTest, LivenessAcrossLoop) {
+    build("func one() -> i64 { 1 }\n"
+          "func f(a: i64, b: i64, c: i64) -> i64 {\n"
+          "    let mut x = a;\n"
+          "    let unused = c;\n"
+          "    while x < b { x = x + one(); }\n"
+          "    x\n"
+          "}\n");
+    const VariableIndex vars(func, cfg);
+    ASSERT_EQ(vars.size(), 5u);
+    const DataflowResult live = compute_liveness(cfg, vars);
+    EXPECT_EQ(names(vars, live.get_block_entry(CFG::kEntry)), (Names{"a", "b", "c"}));
+    const uint32_t header = cfg.get_entry().get_succs()[0];
+    EXPECT_EQ(names(vars, live.get_block_entry(header)), (Names{"b", "x"}));
+    EXPECT_FALSE(live.get_block_entry(CFG::kExit).any());
+}
+
+TEST_F(DataflowTest, DefiniteInitializationMeetsOnEveryPath) {
+    build("func f(c: bool) -> i64 {\n"
+          "    let mut x: i64;\n"
+          "    let mut y: i64;\n"
+          "    if c { x = 1; y = 2; } else { x = 3; }\n"
+          "    x\n"
+          "}\n");
+    const VariableIndex vars(func, cfg);
+    const DataflowResult init = compute_definite_initialization(cfg, vars);
+    EXPECT_EQ(names(vars, init.get_block_entry(CFG::kEntry)), (Names{"c"}));
+    EXPECT_EQ(names(vars, init.get_block_exit(CFG::kEntry)), (Names{"c"}));
+    EXPECT_EQ(names(vars, init.get_block_entry(CFG::kExit)), (Names{"c", "x"}));
+}
+
+TEST_F(DataflowTest, LargeFunctionConvergesInFewPasses) {
+    // thousands of blocks: a loop around a long chain of branches
+    std::string source = "func f(n: i64) -> i64 {\n    let mut s = 0;\n    let mut i = 0;\n"
+                         "    while i < n {\n";
+    for (int k = 0; k < 1000; ++k) {
+        source += "        if i == " + std::to_string(k) + " { s = s + i; } else { s = s - 1; }\n";
+    }
+    source += "        i = i + 1;\n    }\n    s\n}\n";
+    build(source);
+    ASSERT_GT(cfg.size(), 3000u);
+
+    const VariableIndex vars(func, cfg);
+    const DataflowResult live = compute_liveness(cfg, vars);
+    EXPECT_EQ(names(vars, live.get_block_entry(CFG::kEntry)), (Names{"n"}));
+    const DataflowResult init = compute_definite_initialization(cfg, vars);
+    EXPECT_EQ(names(vars, init.get_block_entry(CFG::kExit)), (Names{"n", "s", "i"}));
+    // each block is visited a bounded number of times, not once per bit or
+    // per loop iteration
+    EXPECT_LE(live.get_visit_count(), 3u * cfg.size());
+    EXPECT_LE(init.get_visit_count(), 3u * cfg.size());
+}
+
+} // namespace
+} // namespace nova
@@ -1,17 +1,403 @@
 #include"nova/Basic/DiagnosticEngine.hpp"
+#include"nova/Basic/DiagnosticSink.hpp"
 #include"nova/Basic/SourceLocation.hpp"
 #include"nova/Basic/SourceManager.hpp"
+#include"nova/Basic/ThreadPool.hpp"
 #include"gtest/gtest.h"
+#include<algorithm>
+#include<cstdio>
+#include<filesystem>
+#include<string>
+#include<thread>
+#include<vector>
 namespace nova {
+namespace {
+    std::string read_all(std::FILE* file) {
+        std::rewind(file);
+        std::string data;
+        char chunk[4096];
+        size_t n;
+        while((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0){
+            data.append(chunk, n);
+        }
+        return data;
+    }
+
+    uint32_t read_le(const std::string& data, size_t& pos, size_t bytes) {
+        uint32_t value = 0;
+        for(size_t i = 0; i < bytes; ++i){
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+        }
+        pos += bytes;
+        return value;
+    }
+}
+
     TEST(DiagnosticEngineTest, ReportDiagnostic) {
         SourceManager sm;
         // error: immutable variable 'x' assigned
-        sm.add_file("test.nova", "let x = 10\nx = x + 1;\n");
+        FileID file_id = sm.add_file("test.nova", "let x = 10\nx = x + 1;\n");
         DiagnosticEngine de(&sm);
-        auto loc = SourceLocation::create(1,12);
+        auto loc = sm.get_location(file_id,12);
         auto db = de.report(DiagnosticID::err_assign_to_immutable, loc);
         db << "x";
         db.emit();
         EXPECT_EQ(de.error_count(), 1);
     }
-}
\ No newline at end of file
+
+    TEST(DiagnosticEngineTest, DeferredFlushIsSortedAndKeepsNotes) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("test.nova", "let x = 10\nx = x + 1;\nlet y = 2\n");
+        DiagnosticEngine de(&sm);
+        de.set_deferred(true);
+        std::vector<DiagnosticMessage> seen;
+        de.set_handler([&](const DiagnosticMessage& diag) { seen.push_back(diag); });
+
+        de.report(DiagnosticID::err_assign_to_immutable, sm.get_location(file_id, 11)) << "x";
+        de.report(DiagnosticID::note_declared_here, sm.get_location(file_id, 4)) << "x";
+        de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, 26)) << "y";
+        de.report(DiagnosticID::err_assign_to_immutable, sm.get_location(file_id, 0)) << "let";
+
+        // counted when recorded, printed only on flush
+        EXPECT_EQ(de.error_count(), 2u);
+        EXPECT_EQ(de.warning_count(), 1u);
+        EXPECT_TRUE(seen.empty());
+        EXPECT_EQ(de.pending_count(), 4u);
+
+        de.flush();
+        ASSERT_EQ(seen.size(), 4u);
+        EXPECT_EQ(seen[0].message, "let");
+        EXPECT_EQ(seen[1].id, DiagnosticID::err_assign_to_immutable);
+        EXPECT_EQ(seen[1].message, "x");
+        // the note follows its error even though it points earlier
+        EXPECT_EQ(seen[2].id, DiagnosticID::note_declared_here);
+        EXPECT_EQ(seen[3].id, DiagnosticID::warn_unused_variable);
+        EXPECT_EQ(de.pending_count(), 0u);
+    }
+
+    TEST(DiagnosticEngineTest, DeferredArgumentsOutliveCaller) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("test.nova", "let x = 10\n");
+        DiagnosticEngine de(&sm);
+        de.set_deferred(true);
+        {
+            auto db = de.report(DiagnosticID::err_type_mismatch, sm.get_location(file_id, 8));
+            for(int i = 0; i < 6; ++i){
+                db << std::string(1, static_cast<char>('a' + i)) << int64_t{i};
+            }
+            db << SourceRange(sm.get_location(file_id, 8), sm.get_location(file_id, 10));
+        }
+        std::vector<DiagnosticMessage> seen;
+        de.set_handler([&](const DiagnosticMessage& diag) { seen.push_back(diag); });
+        de.flush();
+        ASSERT_EQ(seen.size(), 1u);
+        EXPECT_EQ(seen[0].message, "a0b1c2d3e4f5");
+        ASSERT_EQ(seen[0].ranges.size(), 1u);
+        EXPECT_EQ(seen[0].ranges[0].end(), sm.get_location(file_id, 10));
+    }
+
+    TEST(DiagnosticEngineTest, DeferredSuppressedWarningDropsItsNotes) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("test.nova", "let x = 10\n");
+        DiagnosticEngine de(&sm);
+        de.set_deferred(true);
+        de.set_suppress_warnings(true);
+        de.report(DiagnosticID::note_declared_here, sm.get_location(file_id, 0));
+        de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, 4)) << "x";
+        de.report(DiagnosticID::note_declared_here, sm.get_location(file_id, 4));
+        EXPECT_EQ(de.warning_count(), 0u);
+        EXPECT_EQ(de.pending_count(), 1u);
+    }
+
+    TEST(DiagnosticEngineTest, ParallelDeferredOutputIsDeterministic) {
+        SourceManager sm;
+        std::string text(4096, ' ');
+        FileID file_id = sm.add_file("test.nova", text);
+
+        auto run = [&](unsigned threads) {
+            DiagnosticEngine de(&sm);
+            de.set_deferred(true);
+            std::vector<std::string> lines;
+            de.set_handler([&](const DiagnosticMessage& diag) {
+                lines.push_back(std::to_string(diag.location.get_raw_encoding()) + diag.message);
+            });
+            ThreadPool pool(threads);
+            pool.parallel_for(64, [&](size_t task) {
+                for(uint32_t i = 0; i < 32; ++i){
+                    const uint32_t offset = static_cast<uint32_t>((task * 61 + i * 127) % text.size());
+                    de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, offset))
+                        << "v" << static_cast<int64_t>(task);
+                }
+            });
+            EXPECT_EQ(de.warning_count(), 64u * 32u);
+            de.flush();
+            return lines;
+        };
+        const std::vector<std::string> serial = run(1);
+        ASSERT_EQ(serial.size(), 64u * 32u);
+        EXPECT_EQ(run(4), serial);
+    }
+
+    TEST(DiagnosticEngineTest, DuplicatesAndPerIdLimitsAreSuppressed) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("gen.nova", std::string(1024, ' '));
+        DiagnosticEngine de(&sm);
+        de.set_deduplicate(true);
+        de.set_diagnostic_limit(DiagnosticID::warn_unused_variable, 3);
+        std::vector<DiagnosticMessage> seen;
+        de.set_handler([&](const DiagnosticMessage& diag) { seen.push_back(diag); });
+
+        for(int i = 0; i < 1000; ++i){
+            de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, 7)) << "tmp";
+            de.report(DiagnosticID::note_declared_here, sm.get_location(file_id, 1));
+        }
+        for(uint32_t i = 0; i < 10; ++i){
+            de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, 100 + i))
+                << "tmp";
+        }
+        // a different argument is a different diagnostic
+        de.report(DiagnosticID::err_type_mismatch, sm.get_location(file_id, 7)) << "a";
+        de.report(DiagnosticID::err_type_mismatch, sm.get_location(file_id, 7)) << "b";
+        de.report(DiagnosticID::err_type_mismatch, sm.get_location(file_id, 7)) << "a";
+
+        // one warning with its note, two more warnings up to the cap, two errors
+        ASSERT_EQ(seen.size(), 6u);
+        EXPECT_EQ(seen[1].id, DiagnosticID::note_declared_here);
+        EXPECT_EQ(de.suppressed_count(DiagnosticID::warn_unused_variable), 999u + 8u);
+        EXPECT_EQ(de.suppressed_count(DiagnosticID::err_type_mismatch), 1u);
+
+        de.flush();
+        ASSERT_EQ(seen.size(), 7u);
+        EXPECT_EQ(seen.back().id, DiagnosticID::note_diagnostics_suppressed);
+        EXPECT_EQ(seen.back().message, "1008 diagnostics suppressed: E0002 x1, W0901 x1007");
+        // nothing new to summarize
+        de.flush();
+        EXPECT_EQ(seen.size(), 7u);
+    }
+
+    TEST(DiagnosticEngineTest, DeferredFilteringIsDeterministicAcrossThreads) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("gen.nova", std::string(1024, ' '));
+
+        auto run = [&](unsigned threads) {
+            DiagnosticEngine de(&sm);
+            de.set_deferred(true);
+            de.set_deduplicate(true);
+            de.set_diagnostic_limit(5);
+            std::vector<std::string> lines;
+            de.set_handler([&](const DiagnosticMessage& diag) {
+                lines.push_back(std::string(get_diagnostic_code(diag.id)) + " " +
+                                std::to_string(diag.location.get_raw_encoding()) + diag.message);
+            });
+            ThreadPool pool(threads);
+            pool.parallel_for(16, [&](size_t) {
+                // every task reports the same generated warnings
+                for(uint32_t i = 0; i < 200; ++i){
+                    de.report(DiagnosticID::warn_unused_variable,
+                              sm.get_location(file_id, i % 8)) << "gen";
+                }
+            });
+            de.flush();
+            EXPECT_EQ(de.suppressed_count(), 16u * 200u - 5u);
+            return lines;
+        };
+        const std::vector<std::string> serial = run(1);
+        ASSERT_EQ(serial.size(), 6u);
+        EXPECT_EQ(run(4), serial);
+    }
+
+    TEST(DiagnosticEngineTest, DeferredLimitsKeepTheFirstByLocation) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("gen.nova", std::string(1024, ' '));
+
+        // `split` tells which of two threads reports each offset
+        auto run = [&](const std::vector<uint32_t>& offsets, const std::vector<int>& split) {
+            DiagnosticEngine de(&sm);
+            de.set_deferred(true);
+            de.set_diagnostic_limit(DiagnosticID::warn_unused_variable, 1);
+            std::vector<uint32_t> shown;
+            de.set_handler([&](const DiagnosticMessage& diag) {
+                if(diag.id == DiagnosticID::warn_unused_variable){
+                    shown.push_back(diag.location.get_raw_encoding() -
+                                    sm.get_location(file_id, 0).get_raw_encoding());
+                }
+            });
+            auto report = [&](int part) {
+                for(size_t i = 0; i < offsets.size(); ++i){
+                    if(split[i] == part){
+                        de.report(DiagnosticID::warn_unused_variable,
+                                  sm.get_location(file_id, offsets[i])) << "v";
+                    }
+                }
+            };
+            report(0);
+            std::thread other(report, 1);
+            other.join();
+            de.flush();
+            EXPECT_EQ(de.suppressed_count(), offsets.size() - 1);
+            return shown;
+        };
+        EXPECT_EQ(run({50, 10, 30}, {0, 0, 0}), std::vector<uint32_t>{10});
+        EXPECT_EQ(run({50, 10, 30}, {0, 0, 1}), std::vector<uint32_t>{10});
+        EXPECT_EQ(run({50, 10, 30}, {1, 0, 1}), std::vector<uint32_t>{10});
+
+        std::vector<uint32_t> offsets;
+        std::vector<int> split;
+        for(uint32_t i = 0; i < 200; ++i){
+            offsets.push_back((i * 389 + 7) % 1000 + 5);
+            split.push_back(static_cast<int>(i % 3 == 0));
+        }
+        const uint32_t first = *std::min_element(offsets.begin(), offsets.end());
+        EXPECT_EQ(run(offsets, split), std::vector<uint32_t>{first});
+    }
+
+    TEST(DiagnosticEngineTest, FatalFlushesDeferredDiagnostics) {
+        // pending diagnostics and the summary come out before the fatal
+        EXPECT_DEATH({
+            SourceManager sm;
+            FileID file_id = sm.add_file("d.nova", "let x = 10\n");
+            DiagnosticEngine de(&sm);
+            de.set_deferred(true);
+            de.set_deduplicate(true);
+            for(int i = 0; i < 2; ++i){
+                de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, 4))
+                    << "x";
+            }
+            de.report(DiagnosticID::err_type_mismatch, sm.get_location(file_id, 8)) << "int";
+            de.report(DiagnosticID::fatal_internal_compiler_error) << "boom";
+        }, "Warning W0901: d.nova:x at 1:5\n"
+           "Error E0002: d.nova:int at 1:9\n"
+           "Note N0005: 1 diagnostics suppressed: W0901 x1\n"
+           "Fatal Error F0001: boom");
+    }
+
+    TEST(DiagnosticSinkTest, JsonOneObjectPerLine) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("dir/a.nova", "let x = 10\nx = \"q\";\n");
+        std::FILE* file = std::tmpfile();
+        ASSERT_NE(file, nullptr);
+        {
+            DiagnosticSink sink(&sm, file, DiagnosticSink::Format::Json);
+            DiagnosticEngine de(&sm);
+            de.set_sink(&sink);
+            de.report(DiagnosticID::err_assign_to_immutable, sm.get_location(file_id, 11))
+                << "x \"quoted\"\n"
+                << SourceRange(sm.get_location(file_id, 11), sm.get_location(file_id, 12));
+            de.report(DiagnosticID::warn_unused_variable) << "y";
+            EXPECT_EQ(de.error_count(), 1u);
+            EXPECT_EQ(de.warning_count(), 1u);
+            EXPECT_EQ(sink.written_count(), 2u);
+        }
+        const std::string out = read_all(file);
+        std::fclose(file);
+        EXPECT_EQ(out,
+                  "{\"code\":\"E0006\",\"severity\":\"error\",\"message\":\"x \\\"quoted\\\"\\n\","
+                  "\"file\":\"dir/a.nova\",\"line\":2,\"column\":1,\"ranges\":[{\"line\":2,"
+                  "\"column\":1,\"end_line\":2,\"end_column\":2}]}\n"
+                  "{\"code\":\"W0901\",\"severity\":\"warning\",\"message\":\"y\",\"ranges\":[]}\n");
+    }
+
+    TEST(DiagnosticSinkTest, BinaryRecordsAreSelfDescribing) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("b.nova", "let x = 10\n");
+        std::FILE* file = std::tmpfile();
+        ASSERT_NE(file, nullptr);
+        {
+            DiagnosticSink sink(&sm, file, DiagnosticSink::Format::Binary);
+            DiagnosticEngine de(&sm);
+            de.set_deferred(true);
+            de.set_sink(&sink);
+            for(uint32_t i = 0; i < 3000; ++i){
+                de.report(DiagnosticID::err_type_mismatch, sm.get_location(file_id, 4 + i % 4))
+                    << "i" << static_cast<int64_t>(i);
+            }
+            de.flush();
+        }
+        const std::string out = read_all(file);
+        std::fclose(file);
+        ASSERT_GE(out.size(), 12u);
+        EXPECT_EQ(out.substr(0, 8), "NOVADIAG");
+        size_t pos = 8;
+        EXPECT_EQ(read_le(out, pos, 4), DiagnosticSink::kBinaryVersion);
+        size_t records = 0;
+        uint32_t last_column = 0;
+        while(pos < out.size()){
+            const uint32_t size = read_le(out, pos, 4);
+            const size_t end = pos + size;
+            EXPECT_EQ(read_le(out, pos, 1), static_cast<uint32_t>(DiagnosticSeverity::Error));
+            const uint32_t code_length = read_le(out, pos, 1);
+            EXPECT_EQ(out.substr(pos, code_length), "E0002");
+            pos += code_length;
+            const uint32_t file_length = read_le(out, pos, 2);
+            EXPECT_EQ(out.substr(pos, file_length), "b.nova");
+            pos += file_length;
+            EXPECT_EQ(read_le(out, pos, 4), 1u);
+            const uint32_t column = read_le(out, pos, 4);
+            // flushed in location order
+            EXPECT_GE(column, last_column);
+            last_column = column;
+            const uint32_t message_length = read_le(out, pos, 4);
+            EXPECT_EQ(out[pos], 'i');
+            pos += message_length;
+            EXPECT_EQ(read_le(out, pos, 2), 0u);
+            ASSERT_EQ(pos, end);
+            ++records;
+        }
+        EXPECT_EQ(records, 3000u);
+    }
+
+    TEST(DiagnosticSinkTest, BinaryRangeCountMatchesPayload) {
+        SourceManager sm;
+        FileID file_id = sm.add_file("c.nova", "let x = 10\n");
+        std::FILE* file = std::tmpfile();
+        ASSERT_NE(file, nullptr);
+        {
+            DiagnosticSink sink(&sm, file, DiagnosticSink::Format::Binary);
+            DiagnosticMessage diag{DiagnosticID::err_type_mismatch, DiagnosticSeverity::Error,
+                                   sm.get_location(file_id, 4), "x", {}};
+            diag.ranges.assign(70000, SourceRange(sm.get_location(file_id, 4),
+                                                  sm.get_location(file_id, 5)));
+            sink.write(diag);
+        }
+        const std::string out = read_all(file);
+        std::fclose(file);
+        size_t pos = 12;
+        const uint32_t size = read_le(out, pos, 4);
+        ASSERT_EQ(pos + size, out.size());
+        pos += 2 + 5;
+        const uint32_t file_length = read_le(out, pos, 2);
+        pos += file_length + 8;
+        const uint32_t message_length = read_le(out, pos, 4);
+        pos += message_length;
+        const uint32_t ranges = read_le(out, pos, 2);
+        EXPECT_EQ(ranges, 65535u);
+        EXPECT_EQ(pos + ranges * 16u, out.size());
+    }
+
+    TEST(DiagnosticSinkTest, FatalFlushesTheSink) {
+        const std::string path =
+            (std::filesystem::temp_directory_path() / "nova_diag_fatal.jsonl").string();
+        std::remove(path.c_str());
+        // a named file, as the death test may run in a re-executed process
+        EXPECT_DEATH({
+            SourceManager sm;
+            FileID file_id = sm.add_file("f.nova", "let x = 10\n");
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            DiagnosticSink sink(&sm, file, DiagnosticSink::Format::Json);
+            DiagnosticEngine de(&sm);
+            de.set_sink(&sink);
+            de.report(DiagnosticID::warn_unused_variable, sm.get_location(file_id, 4)) << "x";
+            de.report(DiagnosticID::fatal_internal_compiler_error) << "boom";
+        }, "");
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        ASSERT_NE(file, nullptr);
+        const std::string out = read_all(file);
+        std::fclose(file);
+        std::remove(path.c_str());
+        EXPECT_EQ(out,
+                  "{\"code\":\"W0901\",\"severity\":\"warning\",\"message\":\"x\","
+                  "\"file\":\"f.nova\",\"line\":1,\"column\":5,\"ranges\":[]}\n"
+                  "{\"code\":\"F0001\",\"severity\":\"fatal\",\"message\":\"boom\","
+                  "\"ranges\":[]}\n");
+    }
+}
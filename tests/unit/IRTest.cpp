@@ -0,0 +1,179 @@
+#include "nova/Basic/Casting.hpp"
+#include "nova/IR/IRBuilder.hpp"
+#include "nova/IR/Module.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace nova {
+namespace {
+
+using namespace ir;
+
+// func @sum(%0: i64) -> i64: adds 0..n-1 in a loop.
+Function* build_sum(Module& module) {
+    const Type params[] = {Type::I64};
+    Function* func = module.create_function("sum", params, Type::I64);
+    BasicBlock* entry = func->create_block("entry");
+    BasicBlock* loop = func->create_block("loop");
+    BasicBlock* exit = func->create_block("exit");
+
+    IRBuilder builder(entry);
+    Instruction* zero = builder.create_const_i64(0);
+    Instruction* one = builder.create_const_i64(1);
+    builder.create_br(loop);
+
+    builder.set_insert_point(loop);
+    Instruction* i = builder.create_phi(Type::I64, 2);
+    Instruction* total = builder.create_phi(Type::I64, 2);
+    Instruction* next_total = builder.create_add(total, i);
+    Instruction* next_i = builder.create_add(i, one);
+    Instruction* more = builder.create_icmp(CmpPredicate::Slt, next_i, func->get_arg(0));
+    builder.create_cond_br(more, loop, exit);
+    i->set_incoming(0, zero, entry);
+    i->set_incoming(1, next_i, loop);
+    total->set_incoming(0, zero, entry);
+    total->set_incoming(1, next_total, loop);
+
+    builder.set_insert_point(exit);
+    builder.create_ret(next_total);
+    return func;
+}
+
+TEST(IRTest, BuildsAndPrintsLoop) {
+    Module module("test");
+    Function* sum = build_sum(module);
+    const Type params[] = {Type::F64, Type::U64};
+    Function* other = module.create_function("other", params, Type::Unit);
+    EXPECT_EQ(module.create_function("sum", {}, Type::Unit), nullptr);
+    EXPECT_EQ(module.get_function("other"), other);
+
+    IRBuilder builder(other->create_block(""));
+    Instruction* half = builder.create_const_f64(0.5);
+    builder.create_fcmp(CmpPredicate::Olt, half, other->get_arg(0));
+    Value* args[] = {builder.create_const_i64(-3)};
+    builder.create_call(sum, args);
+    builder.create_ret();
+
+    EXPECT_EQ(module.print(), "func @sum(%0: i64) -> i64 {\n"
+                              "entry:\n"
+                              "  %1 = const i64 0\n"
+                              "  %2 = const i64 1\n"
+                              "  br loop\n"
+                              "loop:\n"
+                              "  %4 = phi i64 [%1, entry], [%7, loop]\n"
+                              "  %5 = phi i64 [%1, entry], [%6, loop]\n"
+                              "  %6 = add i64 %5, %4\n"
+                              "  %7 = add i64 %4, %2\n"
+                              "  %8 = icmp slt %7, %0\n"
+                              "  condbr %8, loop, exit\n"
+                              "exit:\n"
+                              "  ret %6\n"
+                              "}\n"
+                              "\n"
+                              "func @other(%0: f64, %1: u64) -> unit {\n"
+                              "bb0:\n"
+                              "  %2 = const f64 0.5\n"
+                              "  %3 = fcmp olt %2, %0\n"
+                              "  %4 = const i64 -3\n"
+                              "  %5 = call i64 @sum(%4)\n"
+                              "  ret\n"
+                              "}\n");
+
+    const BasicBlock* loop = sum->get_blocks()[1];
+    ASSERT_EQ(loop->get_successors().size(), 2u);
+    EXPECT_EQ(loop->get_successors()[0], loop);
+    EXPECT_EQ(loop->get_terminator()->get_opcode(), Opcode::CondBr);
+    EXPECT_TRUE(isa<Argument>(sum->get_value(0)));
+    EXPECT_EQ(cast<Instruction>(sum->get_value(8))->get_predicate(), CmpPredicate::Slt);
+}
+
+TEST(IRTest, UseListsFollowOperands) {
+    Module module("test");
+    Function* func = build_sum(module);
+    auto* zero = cast<Instruction>(func->get_value(1));
+    auto* one = cast<Instruction>(func->get_value(2));
+    auto* next_i = cast<Instruction>(func->get_value(7));
+    EXPECT_EQ(zero->get_use_count(), 2u);
+    EXPECT_TRUE(next_i->has_uses());
+
+    // every use names its user and operand slot
+    for (Use* use : zero->get_uses()) {
+        EXPECT_EQ(use->get_user()->get_opcode(), Opcode::Phi);
+        EXPECT_EQ(use->get_operand_no(), 0u);
+        EXPECT_EQ(use->get(), zero);
+    }
+
+    // moving one operand moves one use
+    next_i->set_operand(1, zero);
+    EXPECT_EQ(zero->get_use_count(), 3u);
+    EXPECT_FALSE(one->has_uses());
+    one->erase_from_parent();
+    EXPECT_EQ(func->get_value(2), nullptr);
+    EXPECT_EQ(func->get_value_count(), 11u); // terminators are numbered too
+}
+
+TEST(IRTest, ReplaceAllUsesWithSplicesUseLists) {
+    Module module("test");
+    Function* func = build_sum(module);
+    auto* zero = cast<Instruction>(func->get_value(1));
+    auto* total = cast<Instruction>(func->get_value(5));
+    auto* next_total = cast<Instruction>(func->get_value(6));
+    Argument* n = func->get_arg(0);
+
+    zero->replace_all_uses_with(n);
+    EXPECT_FALSE(zero->has_uses());
+    EXPECT_EQ(n->get_use_count(), 3u);
+    EXPECT_EQ(total->get_incoming_value(0), n);
+    for (Use* use : n->get_uses()) {
+        EXPECT_EQ(use->get(), n);
+    }
+    zero->erase_from_parent();
+    EXPECT_EQ(func->get_entry_block()->get_first()->get_opcode(), Opcode::ConstI64);
+
+    // a value with uses of its own keeps them after taking over others
+    next_total->replace_all_uses_with(total);
+    EXPECT_EQ(total->get_use_count(), 3u);
+    EXPECT_TRUE(total->has_uses());
+    EXPECT_EQ(func->get_blocks()[2]->get_terminator()->get_operand(0), total);
+    // erasing the dead add drops its use of the phi
+    EXPECT_FALSE(next_total->has_uses());
+    next_total->erase_from_parent();
+    EXPECT_EQ(total->get_use_count(), 2u);
+}
+
+TEST(IRTest, InsertBeforeAndManyUsers) {
+    Module module("test");
+    Function* func = module.create_function("wide", {}, Type::I64);
+    IRBuilder builder(func->create_block("entry"));
+    Instruction* seed = builder.create_const_i64(1);
+    Instruction* ret = builder.create_ret(seed);
+
+    // insert before the terminator
+    builder.set_insert_point(ret);
+    constexpr uint32_t kUsers = 100000;
+    std::vector<Instruction*> users;
+    users.reserve(kUsers);
+    for (uint32_t i = 0; i < kUsers; ++i) {
+        users.push_back(builder.create_add(seed, seed));
+    }
+    EXPECT_EQ(func->get_entry_block()->get_last(), ret);
+    EXPECT_EQ(seed->get_use_count(), 2 * kUsers + 1);
+
+    Instruction* replacement = builder.create_const_i64(2);
+    seed->replace_all_uses_with(replacement);
+    EXPECT_EQ(replacement->get_use_count(), 2 * kUsers + 1);
+    EXPECT_EQ(users[kUsers / 2]->get_operand(1), replacement);
+    EXPECT_EQ(ret->get_operand(0), replacement);
+
+    // IDs are dense, so a side table is a plain vector
+    std::vector<bool> is_add(func->get_value_count(), false);
+    for (const Instruction* inst : func->get_entry_block()->get_instructions()) {
+        is_add[inst->get_id()] = inst->get_opcode() == Opcode::Add;
+    }
+    EXPECT_TRUE(is_add[users.back()->get_id()]);
+    EXPECT_GE(func->get_bytes_allocated(), kUsers * (sizeof(Instruction) + 2 * sizeof(Use)));
+}
+
+} // namespace
+} // namespace nova
@@ -0,0 +1,116 @@
+#include "nova/Basic/IdentifierTable.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nova {
+
+TEST(IdentifierTableTest, InternIsUnique) {
+    IdentifierTable ids;
+    IdentifierInfo* a = ids.intern("counter");
+    EXPECT_EQ(ids.intern(std::string("counter")), a);
+    EXPECT_EQ(ids.get("counter"), a);
+    EXPECT_NE(ids.intern("counter2"), a);
+    EXPECT_EQ(a->get_name(), "counter");
+    EXPECT_EQ(std::strlen(a->get_name_data()), a->length);
+    EXPECT_EQ(a->token_kind, TokenKind::identifier);
+    EXPECT_FALSE(a->is_keyword);
+    EXPECT_EQ(ids.get("missing"), nullptr);
+}
+
+TEST(IdentifierTableTest, KeywordsArePreInterned) {
+    IdentifierTable ids;
+    IdentifierInfo* kw = ids.intern("while");
+    EXPECT_TRUE(kw->is_keyword);
+    EXPECT_EQ(kw->token_kind, TokenKind::kw_while);
+    EXPECT_EQ(ids.get_keyword_info(TokenKind::kw_while), kw);
+}
+
+TEST(IdentifierTableTest, GrowKeepsPointersAndIds) {
+    IdentifierTable ids;
+    const size_t keywords = ids.size();
+    std::vector<IdentifierInfo*> infos;
+    for (int i = 0; i < 20000; ++i) {
+        infos.push_back(ids.intern("name_" + std::to_string(i)));
+    }
+    EXPECT_EQ(ids.size(), keywords + infos.size());
+    for (int i = 0; i < 20000; ++i) {
+        const std::string name = "name_" + std::to_string(i);
+        ASSERT_EQ(ids.intern(name), infos[static_cast<size_t>(i)]);
+        ASSERT_EQ(infos[static_cast<size_t>(i)]->get_name(), name);
+        ASSERT_EQ(infos[static_cast<size_t>(i)]->id, keywords + static_cast<size_t>(i));
+        ASSERT_EQ(ids.get_identifier(infos[static_cast<size_t>(i)]->id), infos[static_cast<size_t>(i)]);
+    }
+    // a map node, a separate info and two std::strings used to cost ~128 bytes
+    EXPECT_LT(ids.memory_bytes() / ids.size(), 96u);
+}
+
+TEST(IdentifierTableTest, HashIsUsableForPrecomputedIntern) {
+    IdentifierTable ids;
+    const std::string name = "a_rather_long_identifier_name_spanning_several_words";
+    IdentifierInfo* info = ids.intern(name, IdentifierTable::hash(name));
+    EXPECT_EQ(ids.intern(name), info);
+    EXPECT_NE(IdentifierTable::hash("ab"), IdentifierTable::hash("ba"));
+    EXPECT_NE(IdentifierTable::hash("a"), IdentifierTable::hash(std::string("a\0", 2)));
+}
+
+TEST(IdentifierTableTest, ConcurrentInternIsGloballyUnique) {
+    IdentifierTable ids(/*concurrent=*/true);
+    EXPECT_TRUE(ids.is_concurrent());
+    constexpr int kThreads = 8;
+    constexpr int kNames = 5000;
+    // every thread interns the same names in a different order
+    std::vector<std::vector<IdentifierInfo*>> seen(kThreads, std::vector<IdentifierInfo*>(kNames));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int k = 0; k < kNames; ++k) {
+                const int i = (k * 7919 + t * 131) % kNames;
+                seen[t][i] = ids.intern("shared_" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint32_t> id_list;
+    for (int i = 0; i < kNames; ++i) {
+        for (int t = 1; t < kThreads; ++t) {
+            ASSERT_EQ(seen[t][i], seen[0][i]);
+        }
+        EXPECT_EQ(seen[0][i]->get_name(), "shared_" + std::to_string(i));
+        EXPECT_EQ(ids.get("shared_" + std::to_string(i)), seen[0][i]);
+        EXPECT_EQ(ids.get_identifier(seen[0][i]->id), seen[0][i]);
+        id_list.push_back(seen[0][i]->id);
+    }
+    // ids stay dense: keywords first, then every name exactly once
+    std::sort(id_list.begin(), id_list.end());
+    EXPECT_EQ(ids.size(), id_list.back() + 1u);
+    EXPECT_EQ(std::adjacent_find(id_list.begin(), id_list.end()), id_list.end());
+    EXPECT_EQ(ids.size() - id_list.size(), IdentifierTable().size());
+}
+
+TEST(ArenaTest, AlignmentAndLargeAllocations) {
+    Arena arena;
+    for (size_t align : {1u, 2u, 8u, 16u, 64u}) {
+        void* p = arena.allocate(3, align);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0u);
+    }
+    void* big = arena.allocate(Arena::kMaxSlabSize * 2, 8);
+    std::memset(big, 0xAB, Arena::kMaxSlabSize * 2);
+    // the current slab is still used after a dedicated one
+    const size_t slabs = arena.slab_count();
+    (void)arena.allocate(8, 8);
+    EXPECT_EQ(arena.slab_count(), slabs);
+    EXPECT_GE(arena.bytes_reserved(), arena.bytes_allocated());
+
+    arena.reset();
+    EXPECT_EQ(arena.slab_count(), 0u);
+    EXPECT_EQ(arena.bytes_allocated(), 0u);
+}
+
+} // namespace nova
@@ -0,0 +1,122 @@
+#include "nova/Lex/IncrementalLexer.hpp"
+#include "nova/Lex/TokenStream.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+namespace nova {
+namespace {
+
+void expect_same_tokens(const TokenBuffer& actual, const TokenBuffer& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(actual.get_kind(i), expected.get_kind(i)) << i;
+        ASSERT_EQ(actual.get_offset(i), expected.get_offset(i)) << i;
+        ASSERT_EQ(actual.get_length(i), expected.get_length(i)) << i;
+        ASSERT_EQ(actual.get_identifier_info(i), expected.get_identifier_info(i)) << i;
+        ASSERT_EQ(actual.at_start_of_line(i), expected.at_start_of_line(i)) << i;
+        ASSERT_EQ(actual.has_leading_space(i), expected.has_leading_space(i)) << i;
+    }
+}
+
+} // namespace
+
+TEST(IncrementalLexerTest, MatchesFullRelexOnRandomEdits) {
+    static const char* kPieces[] = {"let ", "x", "value_1", " = ", "42", "0x1F", "3.5e2", ";\n",
+                                    "\"str\"", "'c'", "/*", "*/", "//", "\n", "\"", "'",
+                                    "+", "=", "-", ">", " ", "\t", "func", "{", "}", "@", "\\"};
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> piece(0, std::size(kPieces) - 1);
+
+    SourceManager sm;
+    IdentifierTable ids;
+    std::string text;
+    for (int i = 0; i < 400; ++i) {
+        text += kPieces[piece(rng)];
+    }
+    FileID file_id = sm.add_file("v0.nova", text);
+    TokenBuffer tokens = TokenStream::lex(sm, ids, file_id).get_buffer();
+
+    for (int step = 0; step < 300; ++step) {
+        std::uniform_int_distribution<uint32_t> at(0, static_cast<uint32_t>(text.size()));
+        TextEdit edit;
+        edit.offset = at(rng);
+        std::uniform_int_distribution<uint32_t> len(0, std::min<uint32_t>(
+                                                           6, static_cast<uint32_t>(text.size()) - edit.offset));
+        edit.removed_length = len(rng);
+        std::string inserted;
+        for (int k = static_cast<int>(rng() % 3); k > 0; --k) {
+            inserted += kPieces[piece(rng)];
+        }
+        edit.inserted_text = inserted;
+
+        text = apply_text_edit(text, edit);
+        ASSERT_TRUE(sm.apply_edit(file_id, edit));
+        ASSERT_EQ(sm.get_file(file_id)->content, text);
+        RelexStats stats;
+        TokenBuffer relexed = relex_after_edit(tokens, sm, ids, file_id, edit, &stats);
+        TokenBuffer full = TokenStream::lex(sm, ids, file_id).get_buffer();
+        ASSERT_NO_FATAL_FAILURE(expect_same_tokens(relexed, full)) << "step " << step;
+        EXPECT_EQ(stats.reused_prefix + stats.relexed + stats.reused_suffix, full.size());
+        tokens = std::move(relexed);
+    }
+    // edits reuse the file instead of adding a version per keystroke
+    EXPECT_EQ(sm.file_count(), 1u);
+}
+
+TEST(IncrementalLexerTest, SmallEditRelexesFewTokens) {
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+        text += "let name_" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+    }
+    SourceManager sm;
+    IdentifierTable ids;
+    FileID v0 = sm.add_file("v0.nova", text);
+    TokenBuffer tokens = TokenStream::lex(sm, ids, v0).get_buffer();
+
+    const auto offset = static_cast<uint32_t>(text.find("name_1000"));
+    TextEdit edit{offset + 5, 4, "renamed"};
+    FileID v1 = sm.add_file("v1.nova", apply_text_edit(text, edit));
+    RelexStats stats;
+    TokenBuffer relexed = relex_after_edit(tokens, sm, ids, v1, edit, &stats);
+    expect_same_tokens(relexed, TokenStream::lex(sm, ids, v1).get_buffer());
+    EXPECT_LE(stats.relexed, 4u);
+    IdentifierInfo* renamed = relexed.get_identifier_info(relexed.find_offset(offset));
+    ASSERT_NE(renamed, nullptr);
+    EXPECT_EQ(renamed->get_name(), "name_renamed");
+}
+
+TEST(IncrementalLexerTest, OpeningBlockCommentSwallowsUntilClose) {
+    const std::string text = "a b c d e f\nlet z = 1; */ g h\n";
+    SourceManager sm;
+    IdentifierTable ids;
+    FileID v0 = sm.add_file("v0.nova", text);
+    TokenBuffer tokens = TokenStream::lex(sm, ids, v0).get_buffer();
+
+    TextEdit edit{2, 0, "/*"};
+    FileID v1 = sm.add_file("v1.nova", apply_text_edit(text, edit));
+    RelexStats stats;
+    TokenBuffer relexed = relex_after_edit(tokens, sm, ids, v1, edit, &stats);
+    expect_same_tokens(relexed, TokenStream::lex(sm, ids, v1).get_buffer());
+    // a, then g h eof reused after the comment closes
+    EXPECT_EQ(relexed.size(), 4u);
+    EXPECT_GT(stats.reused_suffix, 0u);
+}
+
+TEST(IncrementalLexerTest, EditBeforeFirstTokenRelexesFromStart) {
+    const std::string text = "// comment\nfoo";
+    SourceManager sm;
+    IdentifierTable ids;
+    FileID file_id = sm.add_file("v0.nova", text);
+    TokenBuffer tokens = TokenStream::lex(sm, ids, file_id).get_buffer();
+
+    // splits the comment, so "comment" becomes a token ahead of "foo"
+    TextEdit edit{5, 0, "\n"};
+    ASSERT_TRUE(sm.apply_edit(file_id, edit));
+    TokenBuffer relexed = relex_after_edit(tokens, sm, ids, file_id, edit);
+    TokenBuffer full = TokenStream::lex(sm, ids, file_id).get_buffer();
+    ASSERT_EQ(full.size(), 3u);
+    expect_same_tokens(relexed, full);
+}
+
+} // namespace nova
@@ -0,0 +1,130 @@
+#include "nova/Basic/CPUFeatures.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Basic/SourceManager.hpp"
+#include "nova/Lex/LexScan.hpp"
+#include "nova/Lex/Lexer.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nova {
+namespace {
+
+// Random text biased towards the byte classes the kernels care about,
+// including bytes >= 0x80 which must never match an ASCII class.
+std::string make_random_text(std::mt19937& rng, size_t size) {
+    static const char kAlphabet[] = " \t\n\r_azAZ09\"'\\/*.;@[`{\x80\xff";
+    std::uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 2);
+    std::uniform_int_distribution<int> run(1, 40);
+    std::string out;
+    while (out.size() < size) {
+        out.append(static_cast<size_t>(run(rng)), kAlphabet[pick(rng)]);
+    }
+    out.resize(size);
+    return out;
+}
+
+std::vector<SIMDLevel> supported_levels() {
+    std::vector<SIMDLevel> levels;
+    for (uint8_t raw = 0; raw <= static_cast<uint8_t>(get_host_simd_level()); ++raw) {
+        levels.push_back(static_cast<SIMDLevel>(raw));
+    }
+    return levels;
+}
+
+} // namespace
+
+TEST(LexScanTest, VectorKernelsMatchScalar) {
+    std::mt19937 rng(1234);
+    const LexScanKernels& scalar = get_lex_scan_kernels(SIMDLevel::Scalar);
+    for (int iter = 0; iter < 200; ++iter) {
+        const std::string text = make_random_text(rng, 1 + static_cast<size_t>(iter) * 7);
+        const char* end = text.data() + text.size();
+        for (SIMDLevel level : supported_levels()) {
+            const LexScanKernels& k = get_lex_scan_kernels(level);
+            EXPECT_EQ(k.level, level);
+            for (const char* p = text.data(); p < end; ++p) {
+                bool nl_expected = false;
+                bool nl_actual = false;
+                ASSERT_EQ(k.scan_whitespace(p, end, nl_actual),
+                          scalar.scan_whitespace(p, end, nl_expected));
+                ASSERT_EQ(nl_actual, nl_expected);
+                ASSERT_EQ(k.scan_identifier(p, end), scalar.scan_identifier(p, end));
+                ASSERT_EQ(k.scan_digits(p, end), scalar.scan_digits(p, end));
+                ASSERT_EQ(k.scan_string_body(p, end, '"'), scalar.scan_string_body(p, end, '"'));
+                ASSERT_EQ(k.scan_string_body(p, end, '\''),
+                          scalar.scan_string_body(p, end, '\''));
+            }
+        }
+    }
+}
+
+TEST(LexScanTest, KernelsStopAtEnd) {
+    // The run continues past `end`; kernels must not look at it.
+    const std::string text(100, ' ');
+    for (SIMDLevel level : supported_levels()) {
+        const LexScanKernels& k = get_lex_scan_kernels(level);
+        bool saw_newline = false;
+        EXPECT_EQ(k.scan_whitespace(text.data(), text.data() + 37, saw_newline), text.data() + 37);
+        EXPECT_FALSE(saw_newline);
+    }
+}
+
+TEST(LexScanTest, LexerTokensIdenticalAcrossLevels) {
+    std::string code;
+    for (int i = 0; i < 50; ++i) {
+        code += "func very_long_generated_identifier_" + std::to_string(i) + "() {\n";
+        code += std::string(40, ' ') + "let x = 1234567890123456789 + 0 + 0.5;\n";
+        code += "\t\t/* block */ let s = \"a long string body with \\\"escapes\\\" inside\";\n";
+        code += "}\n";
+    }
+    SourceManager sm;
+    FileID file_id = sm.add_file("levels.nova", code);
+
+    auto lex_with = [&](SIMDLevel level) {
+        set_active_simd_level(level);
+        IdentifierTable ids;
+        Lexer lexer(sm, ids, file_id);
+        std::vector<std::tuple<TokenKind, uint32_t, uint32_t, bool, bool>> out;
+        Token tok;
+        do {
+            tok = Token();
+            lexer.lex(tok);
+            out.emplace_back(tok.get_kind(), sm.get_file_offset(tok.get_location()), tok.get_length(),
+                             tok.at_start_of_line(), tok.has_leading_space());
+        } while (!tok.is(TokenKind::eof));
+        return out;
+    };
+
+    const SIMDLevel saved = get_active_simd_level();
+    const auto expected = lex_with(SIMDLevel::Scalar);
+    for (SIMDLevel level : supported_levels()) {
+        EXPECT_EQ(lex_with(level), expected);
+    }
+    set_active_simd_level(saved);
+}
+
+TEST(LexScanTest, LeadingZeroDecimal) {
+    SourceManager sm;
+    FileID file_id = sm.add_file("zero.nova", "0; 0.5 07");
+    IdentifierTable ids;
+    Lexer lexer(sm, ids, file_id);
+    Token tok;
+    lexer.lex(tok);
+    EXPECT_EQ(tok.get_kind(), TokenKind::numeric_constant);
+    EXPECT_EQ(tok.get_length(), 1u);
+    lexer.lex(tok);
+    EXPECT_EQ(tok.get_kind(), TokenKind::semi);
+    lexer.lex(tok);
+    EXPECT_EQ(tok.get_kind(), TokenKind::floating_constant);
+    EXPECT_EQ(tok.get_length(), 3u);
+    lexer.lex(tok);
+    EXPECT_EQ(tok.get_kind(), TokenKind::numeric_constant);
+    EXPECT_EQ(tok.get_length(), 2u);
+    lexer.lex(tok);
+    EXPECT_EQ(tok.get_kind(), TokenKind::eof);
+}
+
+} // namespace nova
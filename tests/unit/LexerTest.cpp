@@ -2,16 +2,6 @@
 #include "nova/Lex/Lexer.hpp"
 #include "nova/Basic/SourceManager.hpp"
 #include "nova/Basic/IdentifierTable.hpp"
-#define NOVA_SNIPPET R"(
-        // This is a comment
-        func main() {
-            let x = 42;
-            let y = 0x2A;
-            let z = "Hello, World!";
-            let c = 'a';
-
-        }
-        )"
 
 namespace nova {
     TEST(LexerTest, BasicLexing) {
@@ -28,7 +18,7 @@ namespace nova {
 
         }
         )";
-        uint16_t file_id = sm.add_file("test.nova", code);
+        FileID file_id = sm.add_file("test.nova", code);
         IdentifierTable id_table;
         Lexer lexer(sm, id_table, file_id);
         Token token;
@@ -77,7 +67,7 @@ namespace nova {
             let c4 = '\U0001F600'; // Grinning face emoji
         }
         )";
-        uint16_t file_id = sm.add_file("unicode_test.nova", code);
+        FileID file_id = sm.add_file("unicode_test.nova", code);
         IdentifierTable id_table;
         Lexer lexer(sm, id_table, file_id);
         Token token;
@@ -0,0 +1,127 @@
+#include "nova/Analysis/Lifetime.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace nova {
+namespace {
+
+using analysis::Lifetime;
+using analysis::LifetimeSolver;
+
+// Reference answer: apply every constraint until nothing changes.
+std::vector<BitVector> solve_by_iteration(const LifetimeSolver& solver,
+                                          const std::vector<std::vector<uint32_t>>& live) {
+    std::vector<BitVector> values(solver.get_lifetime_count(),
+                                  BitVector(solver.get_point_count()));
+    for (uint32_t id = 0; id < live.size(); ++id) {
+        for (uint32_t point : live[id]) {
+            values[id].set(point);
+        }
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& constraint : solver.get_constraints()) {
+            changed |= values[constraint.longer.get_id()].union_with(
+                values[constraint.shorter.get_id()]);
+        }
+    }
+    return values;
+}
+
+TEST(LifetimeTest, CyclesAreMergedAndPointsFlowToLongerLifetimes) {
+    LifetimeSolver solver(8);
+    const Lifetime a = solver.create_lifetime();
+    const Lifetime b = solver.create_lifetime();
+    const Lifetime c = solver.create_lifetime();
+    const Lifetime outer = solver.create_lifetime();
+    const Lifetime inner = solver.create_lifetime();
+    const Lifetime alone = solver.create_lifetime();
+    solver.add_live_point(a, 1);
+    solver.add_live_point(b, 2);
+    solver.add_live_point(inner, 7);
+    solver.add_live_point(outer, 0);
+    solver.add_live_point(alone, 5);
+    // a: b: c: a is a cycle, so all three are equal
+    solver.add_outlives(a, b);
+    solver.add_outlives(b, c);
+    solver.add_outlives(c, a);
+    solver.add_outlives(outer, a);
+    solver.add_outlives(c, inner);
+    solver.solve();
+
+    EXPECT_TRUE(solver.are_merged(a, c));
+    EXPECT_FALSE(solver.are_merged(a, outer));
+    EXPECT_EQ(solver.get_component_count(), 4u);
+    EXPECT_EQ(solver.get_value(b).count(), 3u); // 1, 2 and 7 from `inner`
+    EXPECT_TRUE(solver.get_value(b).test(7));
+    EXPECT_EQ(solver.get_value(outer).count(), 4u);
+    EXPECT_EQ(solver.get_value(inner).count(), 1u);
+    EXPECT_EQ(solver.get_value(alone).count(), 1u);
+}
+
+TEST(LifetimeTest, EqualLifetimesShareOneValue) {
+    LifetimeSolver solver(4);
+    const Lifetime a = solver.create_lifetime();
+    const Lifetime b = solver.create_lifetime();
+    const Lifetime c = solver.create_lifetime();
+    solver.add_equal(a, b);
+    solver.add_live_point(a, 0);
+    solver.add_live_point(c, 3);
+    solver.add_outlives(b, c);
+    solver.solve();
+    EXPECT_TRUE(solver.are_merged(a, b));
+    EXPECT_EQ(&solver.get_value(a), &solver.get_value(b));
+    EXPECT_EQ(solver.get_value(a).count(), 2u);
+    EXPECT_EQ(solver.get_value(c).count(), 1u);
+}
+
+TEST(LifetimeTest, MatchesFixpointIterationOnRandomGraphs) {
+    std::mt19937 rng(42);
+    for (int round = 0; round < 20; ++round) {
+        const uint32_t count = 50 + rng() % 200;
+        LifetimeSolver solver(100);
+        std::vector<std::vector<uint32_t>> live(count);
+        for (uint32_t id = 0; id < count; ++id) {
+            solver.create_lifetime();
+            for (uint32_t k = rng() % 3; k > 0; --k) {
+                live[id].push_back(rng() % 100);
+                solver.add_live_point(Lifetime(id), live[id].back());
+            }
+        }
+        for (uint32_t k = 0; k < count * 2; ++k) {
+            solver.add_outlives(Lifetime(rng() % count), Lifetime(rng() % count));
+        }
+        solver.solve();
+
+        const std::vector<BitVector> expected = solve_by_iteration(solver, live);
+        for (uint32_t id = 0; id < count; ++id) {
+            ASSERT_EQ(solver.get_value(Lifetime(id)), expected[id]) << "round " << round;
+        }
+    }
+}
+
+TEST(LifetimeTest, LongChainNeedsNoRecursion) {
+    constexpr uint32_t kCount = 200000;
+    LifetimeSolver solver(64);
+    Lifetime previous = solver.create_lifetime();
+    solver.add_live_point(previous, 63);
+    const Lifetime first = previous;
+    for (uint32_t i = 1; i < kCount; ++i) {
+        const Lifetime next = solver.create_lifetime();
+        solver.add_outlives(next, previous);
+        previous = next;
+    }
+    solver.solve();
+    EXPECT_EQ(solver.get_component_count(), kCount);
+    EXPECT_TRUE(solver.get_value(previous).test(63));
+    // closing the chain into one cycle merges every lifetime
+    solver.add_outlives(first, previous);
+    solver.solve();
+    EXPECT_EQ(solver.get_component_count(), 1u);
+    EXPECT_TRUE(solver.are_merged(first, previous));
+}
+
+} // namespace
+} // namespace nova
@@ -0,0 +1,319 @@
+#include "nova/AST/ASTVisitor.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/Parse/Parser.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nova {
+namespace {
+
+using namespace ast;
+
+// s-expression form of an expression, e.g. "(+ 1 (* 2 3))"
+std::string print(const Expr* e) {
+    if (!e) {
+        return "<null>";
+    }
+    if (const auto* lit = dyn_cast<LiteralExpr>(e)) {
+        return std::string(lit->get_spelling());
+    }
+    if (const auto* id = dyn_cast<IdentifierExpr>(e)) {
+        return std::string(id->get_name()->get_name());
+    }
+    if (const auto* bin = dyn_cast<BinaryExpr>(e)) {
+        return std::string("(") + get_binary_op_spelling(bin->get_op()) + " " +
+               print(bin->get_lhs()) + " " + print(bin->get_rhs()) + ")";
+    }
+    if (const auto* un = dyn_cast<UnaryExpr>(e)) {
+        return std::string("(") + get_unary_op_spelling(un->get_op()) + " " +
+               print(un->get_operand()) + ")";
+    }
+    if (const auto* assign = dyn_cast<AssignExpr>(e)) {
+        return "(= " + print(assign->get_target()) + " " + print(assign->get_value()) + ")";
+    }
+    if (const auto* call = dyn_cast<CallExpr>(e)) {
+        std::string out = "(call " + print(call->get_callee());
+        for (const Expr* arg : call->get_args()) {
+            out += " " + print(arg);
+        }
+        return out + ")";
+    }
+    if (const auto* if_expr = dyn_cast<IfExpr>(e)) {
+        std::string out = "(if " + print(if_expr->get_cond()) + " " + print(if_expr->get_then());
+        if (if_expr->get_else()) {
+            out += " " + print(if_expr->get_else());
+        }
+        return out + ")";
+    }
+    if (const auto* block = dyn_cast<BlockExpr>(e)) {
+        std::string out = "{";
+        out += std::to_string(block->get_stmts().size());
+        if (block->get_result()) {
+            out += " " + print(block->get_result());
+        }
+        return out + "}";
+    }
+    return "?";
+}
+
+class ParserTest : public ::testing::Test {
+protected:
+    SourceManager sm;
+    IdentifierTable ids;
+    ASTContext ctx;
+    DiagnosticEngine diags{&sm};
+    TokenStream tokens;
+    std::unique_ptr<Parser> parser;
+
+    Parser& parse(const std::string& source) {
+        const FileID file_id = sm.add_file("test.nova", source);
+        tokens = TokenStream::lex(sm, ids, file_id);
+        parser = std::make_unique<Parser>(tokens, ctx, diags);
+        return *parser;
+    }
+
+    std::string parse_expr(const std::string& source) {
+        Expr* e = parse(source).parse_expression();
+        EXPECT_TRUE(parser->at_end()) << source;
+        return print(e);
+    }
+};
+
+TEST(BinaryPrecedenceTest, FollowsLanguageSpec) {
+    EXPECT_LT(get_binary_precedence(TokenKind::equal), get_binary_precedence(TokenKind::pipepipe));
+    EXPECT_LT(get_binary_precedence(TokenKind::pipepipe), get_binary_precedence(TokenKind::ampamp));
+    EXPECT_LT(get_binary_precedence(TokenKind::ampamp),
+              get_binary_precedence(TokenKind::equalequal));
+    EXPECT_LT(get_binary_precedence(TokenKind::exclaimequal),
+              get_binary_precedence(TokenKind::lessequal));
+    EXPECT_LT(get_binary_precedence(TokenKind::greater), get_binary_precedence(TokenKind::minus));
+    EXPECT_LT(get_binary_precedence(TokenKind::plus), get_binary_precedence(TokenKind::percent));
+    EXPECT_EQ(get_binary_precedence(TokenKind::semi), BinaryPrecedence::None);
+}
+
+TEST_F(ParserTest, BinaryOperatorsAreLeftAssociative) {
+    EXPECT_EQ(parse_expr("1 + 2 * 3 - 4"), "(- (+ 1 (* 2 3)) 4)");
+    EXPECT_EQ(parse_expr("a / b % c * d"), "(* (% (/ a b) c) d)");
+    EXPECT_EQ(parse_expr("a < b == c >= d"), "(== (< a b) (>= c d))");
+    EXPECT_EQ(parse_expr("a || b && c || d"), "(|| (|| a (&& b c)) d)");
+    EXPECT_EQ(parse_expr("(1 + 2) * 3"), "(* (+ 1 2) 3)");
+}
+
+TEST_F(ParserTest, AssignmentIsRightAssociativeAndLowest) {
+    EXPECT_EQ(parse_expr("a = b = c || d"), "(= a (= b (|| c d)))");
+}
+
+TEST_F(ParserTest, UnaryAndCallsBindTightest) {
+    EXPECT_EQ(parse_expr("-f(x, 1 + 2)(y) * !b"), "(* (- (call (call f x (+ 1 2)) y)) (! b))");
+    EXPECT_EQ(parse_expr("--x"), "(- (- x))");
+    EXPECT_EQ(parse_expr("f()"), "(call f)");
+}
+
+TEST_F(ParserTest, IfAndBlockExpressions) {
+    EXPECT_EQ(parse_expr("if a { 1 } else if b { 2 } else { 3 }"),
+              "(if a {0 1} (if b {0 2} {0 3}))");
+    EXPECT_EQ(parse_expr("{ let x = 1; x + 1 }"), "{1 (+ x 1)}");
+}
+
+TEST_F(ParserTest, BlockLikeStatementsEndAtTheirBrace) {
+    // `if ... {}` followed by `-x` is a statement and a tail expression,
+    // not a subtraction
+    EXPECT_EQ(parse_expr("{ if c { 1 } -x }"), "{1 (- x)}");
+    EXPECT_EQ(parse_expr("{ if c { 1 } else { 2 } }"), "{0 (if c {0 1} {0 2})}");
+    EXPECT_EQ(parse_expr("{ f(); }"), "{1}");
+}
+
+TEST_F(ParserTest, ParsesModule) {
+    Parser& p = parse("use std::io;\n"
+                      "func add(a: i64, b: i64) -> i64 {\n"
+                      "    let mut sum = a;\n"
+                      "    while sum < b { sum = sum + 1; if sum == 3 { break; } continue; }\n"
+                      "    return sum;\n"
+                      "}\n"
+                      "func main() { add(1, 2); }\n");
+    ModuleDecl* module = p.parse_module(nullptr);
+    EXPECT_EQ(p.get_error_count(), 0u);
+    ASSERT_EQ(module->get_items().size(), 3u);
+
+    const auto* use = dyn_cast<UseDecl>(module->get_items()[0]);
+    ASSERT_NE(use, nullptr);
+    ASSERT_EQ(use->get_path().size(), 2u);
+    EXPECT_EQ(use->get_name()->get_name(), "io");
+
+    const auto* add = dyn_cast<FuncDecl>(module->get_items()[1]);
+    ASSERT_NE(add, nullptr);
+    EXPECT_EQ(add->get_name()->get_name(), "add");
+    ASSERT_EQ(add->get_params().size(), 2u);
+    EXPECT_EQ(add->get_params()[1]->get_type(), ctx.get_i64_type());
+    EXPECT_EQ(add->get_return_type(), ctx.get_i64_type());
+
+    const auto stmts = add->get_body()->get_stmts();
+    ASSERT_EQ(stmts.size(), 3u);
+    const auto* let = dyn_cast<DeclStmt>(stmts[0]);
+    ASSERT_NE(let, nullptr);
+    EXPECT_TRUE(let->get_decl()->is_mutable());
+    const auto* loop = dyn_cast<WhileStmt>(stmts[1]);
+    ASSERT_NE(loop, nullptr);
+    EXPECT_EQ(print(loop->get_cond()), "(< sum b)");
+    ASSERT_EQ(loop->get_body()->get_stmts().size(), 3u);
+    EXPECT_TRUE(isa<ContinueStmt>(loop->get_body()->get_stmts()[2]));
+    EXPECT_TRUE(isa<ReturnStmt>(stmts[2]));
+
+    const auto* main = cast<FuncDecl>(module->get_items()[2]);
+    EXPECT_EQ(main->get_return_type(), nullptr);
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::FuncDecl).count, 2u);
+}
+
+TEST_F(ParserTest, ParsesTypes) {
+    Parser& p = parse("&[i64] &mut [bool; 4] () (u64,) (str, String) Point");
+    EXPECT_EQ(p.parse_type(), ctx.get_reference_type(ctx.get_slice_type(ctx.get_i64_type()), false));
+    EXPECT_EQ(get_type_name(p.parse_type()), "&mut [bool; 4]");
+    EXPECT_EQ(p.parse_type(), ctx.get_unit_type());
+    EXPECT_EQ(get_type_name(p.parse_type()), "(u64,)");
+    EXPECT_EQ(get_type_name(p.parse_type()), "(str, String)");
+    EXPECT_TRUE(isa<StructType>(p.parse_type()));
+    EXPECT_TRUE(p.at_end());
+    EXPECT_EQ(p.get_error_count(), 0u);
+}
+
+TEST_F(ParserTest, DecodesLiterals) {
+    Parser& p = parse("0x2A 0b101 1.5e3 '\\n' '\\u{1F600}' \"hi\" true");
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_integer(), 42u);
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_integer(), 5u);
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_float(), 1500.0);
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_char(), uint32_t('\n'));
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_char(), 0x1F600u);
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_spelling(), "\"hi\"");
+    EXPECT_TRUE(cast<LiteralExpr>(p.parse_expression())->get_bool());
+    EXPECT_EQ(p.get_error_count(), 0u);
+}
+
+TEST_F(ParserTest, RejectsMalformedIntegerLiterals) {
+    std::vector<std::string> messages;
+    diags.set_handler([&](const DiagnosticMessage& diag) { messages.push_back(diag.message); });
+    // the lexer ends a number at the first digit outside its base, so only
+    // an empty digit run or an overflow reaches the parser
+    Parser& p = parse("0x 0b 0o 18446744073709551616 0o17");
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(p.parse_expression(), nullptr);
+    }
+    EXPECT_EQ(cast<LiteralExpr>(p.parse_expression())->get_integer(), 15u);
+    EXPECT_TRUE(p.at_end());
+    EXPECT_EQ(messages, (std::vector<std::string>{
+                            ": expected a digit after the base prefix",
+                            ": expected a digit after the base prefix",
+                            ": expected a digit after the base prefix",
+                            ": integer literal is too large"}));
+}
+
+TEST_F(ParserTest, BacktracksByIndex) {
+    Parser& p = parse("a + b; c");
+    const size_t start = p.get_position();
+    EXPECT_EQ(print(p.parse_expression()), "(+ a b)");
+    EXPECT_EQ(p.get_position(), start + 3);
+    p.set_position(start);
+    Stmt* stmt = p.parse_statement();
+    ASSERT_NE(stmt, nullptr);
+    EXPECT_TRUE(cast<ExprStmt>(stmt)->has_semicolon());
+    EXPECT_EQ(print(p.parse_expression()), "c");
+}
+
+TEST_F(ParserTest, RecoversAtStatementAndItemBoundaries) {
+    Parser& p = parse("func f() { let = 1; let y = 2 + ; let z = 3; }\n"
+                      "func (x: i64) {}\n"
+                      "func g() { h(1; }\n"
+                      "func k() {}\n");
+    ModuleDecl* module = p.parse_module(nullptr);
+    EXPECT_EQ(p.get_error_count(), 4u);
+    EXPECT_EQ(diags.error_count(), 4u);
+    ASSERT_EQ(module->get_items().size(), 3u);
+    const auto* f = cast<FuncDecl>(module->get_items()[0]);
+    ASSERT_EQ(f->get_body()->get_stmts().size(), 1u);
+    EXPECT_EQ(cast<DeclStmt>(f->get_body()->get_stmts()[0])->get_decl()->get_name()->get_name(),
+              "z");
+    EXPECT_EQ(cast<FuncDecl>(module->get_items()[2])->get_name()->get_name(), "k");
+}
+
+TEST_F(ParserTest, ErrorsSayWhatWasExpected) {
+    std::vector<std::string> messages;
+    diags.set_handler([&](const DiagnosticMessage& diag) { messages.push_back(diag.message); });
+    Parser& p = parse("func f() { let c = ''; let x: = 1; g(; let y = 2 }\n"
+                      "func (a: i64) {}\n");
+    p.parse_module(nullptr);
+    EXPECT_EQ(messages, (std::vector<std::string>{": ''", ": expected a type",
+                                                  ": expected an expression", ": ';'",
+                                                  ": expected an identifier"}));
+}
+
+TEST_F(ParserTest, SkipsFunctionBodiesAndParsesThemLazily) {
+    Parser& p = parse("func f(a: i64) -> i64 { if a { { a } } else { a + \"}\" } }\n"
+                      "use std::io;\n"
+                      "func g() { f(1); }\n");
+    p.set_skip_function_bodies(true);
+    ModuleDecl* module = p.parse_module(nullptr);
+    EXPECT_EQ(p.get_error_count(), 0u);
+    ASSERT_EQ(module->get_items().size(), 3u);
+    auto* f = cast<FuncDecl>(module->get_items()[0]);
+    auto* g = cast<FuncDecl>(module->get_items()[2]);
+    EXPECT_TRUE(f->has_skipped_body());
+    EXPECT_EQ(f->get_body(), nullptr);
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::IfExpr).count, 0u);
+
+    const size_t position = p.get_position();
+    BlockExpr* body = p.parse_function_body(f);
+    EXPECT_EQ(p.get_position(), position);
+    EXPECT_EQ(print(body), "{0 (if a {0 {0 a}} {0 (+ a \"}\")})}");
+    EXPECT_EQ(f->get_body(), body);
+    EXPECT_FALSE(f->has_skipped_body());
+    EXPECT_EQ(p.parse_function_body(f), body);
+    EXPECT_TRUE(g->has_skipped_body());
+}
+
+TEST_F(ParserTest, UnbalancedBodyIsParsedInFull) {
+    Parser& p = parse("func f() { let x = 1;\n");
+    p.set_skip_function_bodies(true);
+    ModuleDecl* module = p.parse_module(nullptr);
+    EXPECT_EQ(p.get_error_count(), 1u);
+    ASSERT_EQ(module->get_items().size(), 1u);
+    EXPECT_FALSE(cast<FuncDecl>(module->get_items()[0])->has_skipped_body());
+}
+
+TEST_F(ParserTest, ParsesSkippedBodiesInParallel) {
+    std::string source;
+    for (int i = 0; i < 64; ++i) {
+        source += "func step" + std::to_string(i) + "(n: i64) -> i64 { let x = n * " +
+                  std::to_string(i) + "; while x > 0 { x = x - 1; } x }\n";
+    }
+    source += "func broken() { let = 1; }\n";
+    diags.set_deferred(true);
+    Parser& p = parse(source);
+    p.set_skip_function_bodies(true);
+    ModuleDecl* module = p.parse_module(nullptr);
+    ASSERT_EQ(module->get_items().size(), 65u);
+    std::vector<FuncDecl*> funcs;
+    for (Decl* item : module->get_items()) {
+        funcs.push_back(cast<FuncDecl>(item));
+    }
+
+    ThreadPool pool(4);
+    p.parse_function_bodies(funcs, pool);
+    diags.flush();
+    EXPECT_EQ(p.get_error_count(), 1u);
+    EXPECT_EQ(diags.error_count(), 1u);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_NE(funcs[i]->get_body(), nullptr);
+        EXPECT_EQ(print(funcs[i]->get_body()), "{2 x}");
+        EXPECT_EQ(print(cast<DeclStmt>(funcs[i]->get_body()->get_stmts()[0])
+                            ->get_decl()
+                            ->get_init()),
+                  "(* n " + std::to_string(i) + ")");
+    }
+    EXPECT_EQ(funcs[64]->get_body()->get_stmts().size(), 0u);
+    // the shards' nodes and statistics now belong to ctx
+    EXPECT_EQ(ctx.get_node_stats(ASTNodeKind::WhileStmt).count, 64u);
+}
+
+} // namespace
+} // namespace nova
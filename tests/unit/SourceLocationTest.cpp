@@ -1,35 +1,75 @@
 #include "nova/Basic/SourceLocation.hpp"
+#include "nova/Basic/SourceManager.hpp"
 #include <gtest/gtest.h>
+#include <string>
 
-TEST(SourceLocationTest, CreateAndAccessors) {
-    uint16_t file_id =42;
-    uint32_t offset = 123456;
+TEST(SourceLocationTest, FileAndOffsetRoundTrip) {
     using namespace nova;
-    SourceLocation loc = SourceLocation::create(file_id,offset);
-    EXPECT_EQ(loc.get_file_id(), file_id);
-    EXPECT_EQ(loc.get_offset(), offset);
+    SourceManager sm;
+    FileID first = sm.add_file("a.nova", "let a = 1;\n");
+    FileID second = sm.add_file("b.nova", "let b = 2;\n");
+    SourceLocation loc = sm.get_location(second, 4);
     EXPECT_TRUE(loc.is_valid());
     EXPECT_FALSE(loc.is_invalid());
+    EXPECT_EQ(sm.get_file_id(loc), second);
+    EXPECT_EQ(sm.get_file_offset(loc), 4u);
+    EXPECT_EQ(sm.get_char(loc), 'b');
+
+    // the EOF position still belongs to its own file
+    SourceLocation eof = sm.get_location(first, 11);
+    EXPECT_EQ(sm.get_file_id(eof), first);
+    EXPECT_EQ(sm.get_file_offset(eof), 11u);
+    EXPECT_LT(eof, sm.get_location(second, 0));
+
+    EXPECT_TRUE(sm.get_location(first, 12).is_invalid());
+    EXPECT_TRUE(sm.get_location(3, 0).is_invalid());
 }
 
 TEST(SourceLocationTest, OffsetLocation) {
-    uint16_t file_id = 5;
-    uint32_t offset = 1000;
     using namespace nova;
-    SourceLocation loc = SourceLocation::create(file_id, offset);
+    SourceManager sm;
+    FileID file_id = sm.add_file("c.nova", std::string(2000, 'x'));
+    SourceLocation loc = sm.get_location(file_id, 1000);
     int32_t offset_delta = 500;
     SourceLocation new_loc = loc.get_offset_location(offset_delta);
-    EXPECT_EQ(new_loc.get_file_id(), file_id);
-    EXPECT_EQ(new_loc.get_offset(), offset + offset_delta);
+    EXPECT_EQ(sm.get_file_id(new_loc), file_id);
+    EXPECT_EQ(sm.get_file_offset(new_loc), 1000u + offset_delta);
+    EXPECT_EQ(new_loc.get_offset_location(-offset_delta), loc);
 }
 
+// the old 12-bit file id / 20-bit offset split capped these at 4095 files and
+// 1 MiB per file
+TEST(SourceLocationTest, ManyFilesAndLargeFiles) {
+    using namespace nova;
+    SourceManager sm;
+    FileID last = 0;
+    for (int i = 0; i < 70000; ++i) {
+        last = sm.add_file("f" + std::to_string(i) + ".nova", "x;");
+        ASSERT_NE(last, 0u);
+    }
+    EXPECT_EQ(sm.file_count(), 70000u);
+    SourceLocation loc = sm.get_location(last, 1);
+    EXPECT_EQ(sm.get_file_id(loc), last);
+    EXPECT_EQ(sm.get_char(loc), ';');
+
+    FileID big = sm.add_file("big.nova", std::string(3u << 20, 'y') + "z");
+    SourceLocation tail = sm.get_location(big, 3u << 20);
+    EXPECT_EQ(sm.get_file_id(tail), big);
+    EXPECT_EQ(sm.get_file_offset(tail), 3u << 20);
+    EXPECT_EQ(sm.get_char(tail), 'z');
+    // earlier files are still found after the cache moved on
+    EXPECT_EQ(sm.get_file_id(sm.get_location(1, 0)), 1u);
+}
 
 //test the invalid location
 TEST(SourceLocationTest, InvalidLocation) {
     using namespace nova;
     SourceLocation loc = SourceLocation::invalid();
-    EXPECT_EQ(loc.get_file_id(), 0);
-    EXPECT_EQ(loc.get_offset(), 0);
+    EXPECT_EQ(loc.get_raw_encoding(), 0u);
     EXPECT_FALSE(loc.is_valid());
     EXPECT_TRUE(loc.is_invalid());
-}
\ No newline at end of file
+
+    SourceManager sm;
+    EXPECT_EQ(sm.get_file_id(loc), 0u);
+    EXPECT_EQ(sm.get_file(sm.get_file_id(loc)), nullptr);
+}
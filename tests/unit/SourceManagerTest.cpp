@@ -0,0 +1,182 @@
+#include "nova/Basic/SourceManager.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nova {
+namespace {
+
+std::string write_temp_file(const std::string& name, const std::string& data) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << data;
+    return path.string();
+}
+
+} // namespace
+
+TEST(SourceManagerTest, AddFileMapped) {
+    const std::string data = "func main() {\n    let x = 1;\n}\n";
+    const std::string path = write_temp_file("nova_sm_mapped.nova", data);
+    SourceManager sm;
+    FileID file_id = sm.add_file_mapped(path);
+    ASSERT_NE(file_id, 0);
+    const FileEntry* file = sm.get_file(file_id);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->content, data);
+    EXPECT_EQ(file->filename, path);
+    EXPECT_EQ(file->content.data()[file->content.size()], '\0');
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_TRUE(file->is_mapped());
+#endif
+
+    uint32_t line = 0, column = 0;
+    sm.get_line_column(sm.get_location(file_id, 18), line, column);
+    EXPECT_EQ(line, 2u);
+    EXPECT_EQ(column, 5u);
+    std::remove(path.c_str());
+}
+
+TEST(SourceManagerTest, AddFileMappedFallsBackWithoutSentinelRoom) {
+    // exactly one page: no zero-filled tail to act as the sentinel
+    const std::string data(4096, 'x');
+    const std::string path = write_temp_file("nova_sm_page.nova", data);
+    SourceManager sm;
+    FileID file_id = sm.add_file_mapped(path);
+    ASSERT_NE(file_id, 0);
+    const FileEntry* file = sm.get_file(file_id);
+    EXPECT_EQ(file->content, data);
+    EXPECT_EQ(file->content.data()[file->content.size()], '\0');
+    std::remove(path.c_str());
+}
+
+TEST(SourceManagerTest, AddFileMappedEmptyAndMissing) {
+    const std::string path = write_temp_file("nova_sm_empty.nova", "");
+    SourceManager sm;
+    FileID file_id = sm.add_file_mapped(path);
+    ASSERT_NE(file_id, 0);
+    EXPECT_TRUE(sm.get_file(file_id)->content.empty());
+    EXPECT_EQ(sm.get_file(file_id)->content.data()[0], '\0');
+    std::remove(path.c_str());
+
+    EXPECT_EQ(sm.add_file_mapped(path + ".does-not-exist"), 0);
+}
+
+TEST(SourceManagerTest, ApplyEditInPlace) {
+    SourceManager sm;
+    FileID before = sm.add_file("before.nova", "x");
+    FileID file_id = sm.add_file("edited.nova", "let a = 1;\n");
+    FileID after = sm.add_file("after.nova", "y");
+    const SourceLocation old_start = sm.get_file(file_id)->start_loc;
+    // force a line table, which the edit must not keep
+    uint32_t line = 0, column = 0;
+    sm.get_line_column(sm.get_location(file_id, 4), line, column);
+
+    ASSERT_TRUE(sm.apply_edit(file_id, TextEdit{4, 1, "b\nlet c"}));
+    const FileEntry* file = sm.get_file(file_id);
+    EXPECT_EQ(file->content, "let b\nlet c = 1;\n");
+    EXPECT_EQ(file->content.data()[file->content.size()], '\0');
+    EXPECT_EQ(file->filename, "edited.nova");
+    EXPECT_EQ(sm.file_count(), 3u);
+    sm.get_line_column(sm.get_location(file_id, 10), line, column);
+    EXPECT_EQ(line, 2u);
+    EXPECT_EQ(column, 5u);
+
+    // the file grew past its addresses and moved; its old ones resolve to
+    // no file, and its neighbours are unaffected
+    EXPECT_NE(file->start_loc, old_start);
+    EXPECT_EQ(sm.get_file_id(old_start), 0u);
+    EXPECT_EQ(sm.get_file_id(sm.get_location(file_id, 17)), file_id);
+    EXPECT_EQ(sm.get_char(sm.get_location(before, 0)), 'x');
+    EXPECT_EQ(sm.get_char(sm.get_location(after, 0)), 'y');
+
+    EXPECT_FALSE(sm.apply_edit(file_id, TextEdit{17, 2, ""}));
+    EXPECT_FALSE(sm.apply_edit(9, TextEdit{}));
+}
+
+TEST(SourceManagerTest, RepeatedEditsRarelyMoveTheFile) {
+    SourceManager sm;
+    FileID file_id = sm.add_file("typing.nova", "");
+    std::vector<SourceLocation> starts;
+    std::string text;
+    for (int i = 0; i < 20000; ++i) {
+        const char c[] = {static_cast<char>('a' + i % 26)};
+        ASSERT_TRUE(sm.apply_edit(file_id, TextEdit{static_cast<uint32_t>(text.size()), 0,
+                                                    std::string_view(c, 1)}));
+        text.push_back(c[0]);
+        const SourceLocation start = sm.get_file(file_id)->start_loc;
+        if (starts.empty() || starts.back() != start) {
+            starts.push_back(start);
+        }
+    }
+    EXPECT_EQ(sm.get_file(file_id)->content, text);
+    EXPECT_LE(starts.size(), 4u);
+    // deleting never moves it
+    ASSERT_TRUE(sm.apply_edit(file_id, TextEdit{0, 10000, ""}));
+    EXPECT_EQ(sm.get_file(file_id)->start_loc, starts.back());
+    EXPECT_EQ(sm.get_char(sm.get_location(file_id, 0)), text[10000]);
+}
+
+TEST(LineTableTest, MatchesNaiveLineColumn) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> len(0, 200);
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text.append(static_cast<size_t>(len(rng)), 'a');
+        text.push_back('\n');
+    }
+    // one line too long for a 16-bit delta
+    text.append(70000, 'b');
+    text.append("\ntail");
+
+    std::vector<uint32_t> starts = {0};
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') {
+            starts.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+    LineTable table = LineTable::build(text);
+    ASSERT_EQ(table.line_count(), starts.size());
+    for (uint32_t i = 0; i < starts.size(); ++i) {
+        EXPECT_EQ(table.get_line_start(i), starts[i]);
+    }
+    for (uint32_t offset = 0; offset <= text.size(); offset += 7) {
+        auto it = std::upper_bound(starts.begin(), starts.end(), offset) - 1;
+        uint32_t line = 0, column = 0;
+        table.get_line_column(offset, line, column);
+        ASSERT_EQ(line, static_cast<uint32_t>(it - starts.begin()) + 1) << offset;
+        ASSERT_EQ(column, offset - *it + 1) << offset;
+    }
+    EXPECT_LT(table.memory_bytes(), starts.size() * sizeof(uint32_t));
+}
+
+TEST(LineTableTest, BuiltLazilyOnFirstQuery) {
+    SourceManager sm;
+    FileID file_id = sm.add_file("lazy.nova", "a\nb\nc\n");
+    const FileEntry* file = sm.get_file(file_id);
+    EXPECT_FALSE(file->has_line_table());
+
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> lines(4);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        threads.emplace_back([&, i] {
+            uint32_t column = 0;
+            sm.get_line_column(sm.get_location(file_id, 4), lines[i], column);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_TRUE(file->has_line_table());
+    for (uint32_t line : lines) {
+        EXPECT_EQ(line, 3u);
+    }
+}
+
+} // namespace nova
@@ -0,0 +1,40 @@
+#include "nova/Basic/IdentifierTable.hpp"
+#include "nova/Lex/TokenKinds.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace nova {
+
+static_assert(get_keyword_kind("func") == TokenKind::kw_func);
+static_assert(get_keyword_kind("u64") == TokenKind::kw_u64);
+static_assert(get_keyword_kind("funcs") == TokenKind::identifier);
+
+// Fails when Keywords.inc is stale: rerun scripts/keyword_gen.py.
+TEST(TokenKindsTest, KeywordSwitchMatchesDef) {
+    IdentifierTable ids;
+#define NOVA_KEYWORD(name, spelling)                                                              \
+    EXPECT_EQ(get_keyword_kind(spelling), TokenKind::name) << spelling;                          \
+    EXPECT_EQ(ids.get_keyword_info(TokenKind::name), ids.get(spelling));
+#define NOVA_TYPE_KEYWORD(name, spelling) NOVA_KEYWORD(name, spelling)
+#define NOVA_PUNCT(name, spelling)
+#define NOVA_LITERAL(name, token_name)
+#define NOVA_TOKEN(name, token_name)
+#include "nova/Lex/TokenKinds.def"
+#undef NOVA_TOKEN
+#undef NOVA_LITERAL
+#undef NOVA_PUNCT
+#undef NOVA_TYPE_KEYWORD
+#undef NOVA_KEYWORD
+    EXPECT_EQ(ids.get_keyword_info(TokenKind::identifier), nullptr);
+}
+
+TEST(TokenKindsTest, NonKeywordsAreIdentifiers) {
+    for (const char* text : {"", "i", "f", "fun", "funcs", "Func", "i128", "u9", "lett", "_let",
+                             "true_", "mutable", "str2"}) {
+        EXPECT_EQ(get_keyword_kind(text), TokenKind::identifier) << text;
+    }
+    // embedded NUL must not match a shorter keyword
+    EXPECT_EQ(get_keyword_kind(std::string("if\0", 3)), TokenKind::identifier);
+}
+
+} // namespace nova
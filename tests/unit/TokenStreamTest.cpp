@@ -0,0 +1,158 @@
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/Lex/Lexer.hpp"
+#include "nova/Lex/TokenBuffer.hpp"
+#include "nova/Lex/TokenStream.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace nova {
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallel_for(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+    for (auto& h : hits) {
+        EXPECT_EQ(h.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+    ThreadPool pool(3);
+    std::atomic<int> total{0};
+    pool.parallel_for(8, [&](size_t) {
+        pool.parallel_for(16, [&](size_t) { total.fetch_add(1); });
+    });
+    EXPECT_EQ(total.load(), 8 * 16);
+
+    std::atomic<int> submitted{0};
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&] { submitted.fetch_add(1); });
+    }
+    pool.wait();
+    EXPECT_EQ(submitted.load(), 10);
+}
+
+TEST(TokenStreamTest, MatchesLexer) {
+    SourceManager sm;
+    FileID file_id = sm.add_file("stream.nova", "func f(x: i32) -> i32 { return x + 1; }");
+    IdentifierTable ids;
+    TokenStream stream = TokenStream::lex(sm, ids, file_id);
+    ASSERT_FALSE(stream.empty());
+    EXPECT_EQ(stream.get_file_id(), file_id);
+
+    Lexer lexer(sm, ids, file_id);
+    size_t index = 0;
+    Token tok;
+    do {
+        lexer.lex(tok);
+        ASSERT_LT(index, stream.size());
+        EXPECT_EQ(stream[index].get_kind(), tok.get_kind());
+        EXPECT_EQ(stream[index].get_location(), tok.get_location());
+        EXPECT_EQ(stream[index].get_identifier_info(), tok.get_identifier_info());
+        ++index;
+    } while (!tok.is(TokenKind::eof));
+    EXPECT_EQ(index, stream.size());
+    // lookahead past the end stays on eof
+    EXPECT_TRUE(stream.get(stream.size() + 10).is(TokenKind::eof));
+}
+
+TEST(TokenBufferTest, RoundTripsLexerTokens) {
+    SourceManager sm;
+    FileID file_id = sm.add_file(
+        "soa.nova", "func f(x: i32) -> f64 {\n  let s = \"str \\\" lit\"; let c = '\\n';\n"
+                    "  return 0x1F + 3.25e2 + 007 + x; @@@ } /* tail */");
+    IdentifierTable ids;
+    TokenBuffer buffer(sm, ids, file_id);
+    std::vector<Token> expected;
+    Lexer lexer(sm, ids, file_id);
+    Token tok;
+    do {
+        lexer.lex(tok);
+        expected.push_back(tok);
+        buffer.push_back(tok);
+    } while (!tok.is(TokenKind::eof));
+
+    ASSERT_EQ(buffer.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const Token t = buffer[i].to_token();
+        EXPECT_EQ(t.get_kind(), expected[i].get_kind()) << i;
+        EXPECT_EQ(t.get_location(), expected[i].get_location()) << i;
+        EXPECT_EQ(t.get_length(), expected[i].get_length()) << i;
+        EXPECT_EQ(t.get_identifier_info(), expected[i].get_identifier_info()) << i;
+        EXPECT_EQ(t.at_start_of_line(), expected[i].at_start_of_line()) << i;
+        EXPECT_EQ(t.has_leading_space(), expected[i].has_leading_space()) << i;
+    }
+    // 10 bytes per token instead of sizeof(Token)
+    buffer.shrink_to_fit();
+    EXPECT_LE(buffer.memory_bytes(), buffer.size() * 10);
+    EXPECT_LT(buffer.memory_bytes() * 2, buffer.size() * sizeof(Token));
+}
+
+TEST(TokenBufferTest, FindKindAndIdentifierIds) {
+    SourceManager sm;
+    FileID file_id = sm.add_file("find.nova", "a; b; c { d; }");
+    IdentifierTable ids;
+    TokenStream stream = TokenStream::lex(sm, ids, file_id);
+    const TokenBuffer& buffer = stream.get_buffer();
+    EXPECT_EQ(buffer.find_kind(TokenKind::semi, 0), 1u);
+    EXPECT_EQ(buffer.find_kind(TokenKind::semi, 2), 3u);
+    EXPECT_EQ(buffer.find_kind(TokenKind::l_brace, 0), 5u);
+    EXPECT_EQ(buffer.find_kind(TokenKind::kw_func, 0), buffer.size());
+    EXPECT_EQ(buffer.find_kind(TokenKind::semi, 100), buffer.size());
+
+    IdentifierInfo* d = ids.get("d");
+    ASSERT_NE(d, nullptr);
+    EXPECT_EQ(ids.get_identifier(d->id), d);
+    EXPECT_EQ(stream[6].get_identifier_info(), d);
+    EXPECT_EQ(ids.get_identifier(static_cast<uint32_t>(ids.size())), nullptr);
+}
+
+TEST(TokenStreamTest, ParallelCacheMatchesSerial) {
+    SourceManager sm;
+    for (int i = 0; i < 40; ++i) {
+        std::string code;
+        for (int j = 0; j <= i; ++j) {
+            code += "let shared_name = local_" + std::to_string(j) + " + " + std::to_string(i) +
+                    ";\n";
+        }
+        sm.add_file("f" + std::to_string(i) + ".nova", code);
+    }
+
+    IdentifierTable serial_ids;
+    TokenStreamCache serial(sm, serial_ids);
+    ThreadPool one(1);
+    serial.lex_all(one);
+
+    IdentifierTable shared_ids(/*concurrent=*/true);
+    TokenStreamCache parallel(sm, shared_ids);
+    ThreadPool pool(4);
+    parallel.lex_all(pool);
+    EXPECT_EQ(parallel.token_count(), serial.token_count());
+    EXPECT_EQ(parallel.get(0), nullptr);
+    EXPECT_EQ(parallel.get(41), nullptr);
+
+    const IdentifierInfo* shared = shared_ids.get("shared_name");
+    ASSERT_NE(shared, nullptr);
+    for (FileID file_id = 1; file_id <= 40; ++file_id) {
+        const TokenStream* a = serial.get(file_id);
+        const TokenStream* b = parallel.get(file_id);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+        ASSERT_EQ(a->size(), b->size());
+        for (size_t i = 0; i < a->size(); ++i) {
+            ASSERT_EQ((*a)[i].get_kind(), (*b)[i].get_kind());
+            ASSERT_EQ((*a)[i].get_location(), (*b)[i].get_location());
+            if ((*b)[i].get_identifier_info()) {
+                ASSERT_EQ((*a)[i].get_identifier_info()->get_name(),
+                          (*b)[i].get_identifier_info()->get_name());
+            }
+        }
+        // the same name lexed on different threads is the same pointer
+        EXPECT_EQ((*b)[1].get_identifier_info(), shared);
+    }
+}
+
+} // namespace nova
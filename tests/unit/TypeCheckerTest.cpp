@@ -0,0 +1,206 @@
+#include "CheckedModule.hpp"
+#include "nova/AST/Expr.hpp"
+#include "nova/AST/Stmt.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/Sema/Scope.hpp"
+#include "nova/Sema/TypeChecker.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace nova {
+namespace {
+
+using namespace ast;
+using sema::Scope;
+using sema::ScopeStack;
+using sema::Symbol;
+
+class TypeCheckerTest : public ::testing::Test, protected CheckedModule {};
+
+TEST(ScopeTest, InnerScopesShadowAndPopRestores) {
+    IdentifierTable ids;
+    IdentifierInfo* x = ids.intern("x");
+    IdentifierInfo* y = ids.intern("y");
+    Symbol outer_x(Symbol::Kind::Var, x, nullptr, nullptr);
+    Symbol inner_x(Symbol::Kind::Var, x, nullptr, nullptr, /*is_mutable=*/true);
+    Symbol duplicate_x(Symbol::Kind::Var, x, nullptr, nullptr);
+    Symbol outer_y(Symbol::Kind::Param, y, nullptr, nullptr);
+
+    ScopeStack stack;
+    EXPECT_EQ(stack.lookup(x), nullptr);
+    {
+        Scope outer(stack);
+        EXPECT_EQ(stack.insert(&outer_x), nullptr);
+        EXPECT_EQ(stack.insert(&outer_y), nullptr);
+        EXPECT_EQ(stack.insert(&duplicate_x), &outer_x);
+        {
+            Scope inner(stack);
+            EXPECT_EQ(stack.get_depth(), 2u);
+            EXPECT_EQ(stack.insert(&inner_x), nullptr);
+            EXPECT_EQ(stack.lookup(x), &inner_x);
+            EXPECT_EQ(inner_x.get_shadowed(), &outer_x);
+            EXPECT_EQ(stack.lookup(y), &outer_y);
+        }
+        EXPECT_EQ(stack.lookup(x), &outer_x);
+    }
+    EXPECT_EQ(stack.get_depth(), 0u);
+    EXPECT_EQ(stack.lookup(x), nullptr);
+    EXPECT_EQ(stack.lookup(y), nullptr);
+}
+
+TEST(ScopeTest, DeepNestingUnwindsInOrder) {
+    IdentifierTable ids;
+    IdentifierInfo* names[] = {ids.intern("a"), ids.intern("b"), ids.intern("c")};
+    constexpr uint32_t kDepth = 10000;
+    std::vector<Symbol> symbols;
+    symbols.reserve(kDepth);
+    for (uint32_t i = 0; i < kDepth; ++i) {
+        symbols.emplace_back(Symbol::Kind::Var, names[i % 3], nullptr, nullptr);
+    }
+
+    ScopeStack stack;
+    for (uint32_t i = 0; i < kDepth; ++i) {
+        stack.push_scope();
+        ASSERT_EQ(stack.insert(&symbols[i]), nullptr);
+    }
+    EXPECT_EQ(stack.lookup(names[0]), &symbols[9999]);
+    EXPECT_EQ(stack.lookup(names[1]), &symbols[9997]);
+    for (uint32_t i = kDepth; i > 1; --i) {
+        stack.pop_scope();
+        ASSERT_EQ(stack.lookup(names[(i - 2) % 3]), &symbols[i - 2]);
+    }
+    stack.pop_scope();
+    EXPECT_EQ(stack.lookup(names[0]), nullptr);
+}
+
+TEST_F(TypeCheckerTest, TypesWellFormedModule) {
+    const auto errors = check("func add(a: u64, b: u64) -> u64 { a + b }\n"
+                              "func main() -> i64 {\n"
+                              "    let mut n = 0;\n"
+                              "    let big: u64 = add(1, 2) * 3;\n"
+                              "    while n < 10 { if n == 5 { break; } n = n + 1; }\n"
+                              "    let s = \"hi\";\n"
+                              "    let f = if big > 7 { 1.5 } else { -2.0 };\n"
+                              "    return n;\n"
+                              "}\n");
+    EXPECT_TRUE(errors.empty()) << errors[0];
+    EXPECT_EQ(checker->get_error_count(), 0u);
+
+    const FuncDecl* main = func("main");
+    ASSERT_NE(main, nullptr);
+    const auto stmts = main->get_body()->get_stmts();
+    const auto init = [&](size_t i) { return cast<DeclStmt>(stmts[i])->get_decl()->get_init(); };
+    EXPECT_EQ(init(0)->get_type(), ctx.get_i64_type());
+    // the call's literal arguments take the parameter type
+    const auto* mul = cast<BinaryExpr>(init(1));
+    EXPECT_EQ(mul->get_type(), ctx.get_u64_type());
+    EXPECT_EQ(cast<CallExpr>(mul->get_lhs())->get_args()[0]->get_type(), ctx.get_u64_type());
+    EXPECT_EQ(mul->get_rhs()->get_type(), ctx.get_u64_type());
+    EXPECT_EQ(get_type_name(init(3)->get_type()), "&str");
+    EXPECT_EQ(init(4)->get_type(), ctx.get_f64_type());
+    const auto* add = cast<BinaryExpr>(func("add")->get_body()->get_result());
+    EXPECT_EQ(cast<IdentifierExpr>(add->get_lhs())->get_decl(), func("add")->get_params()[0]);
+}
+
+TEST_F(TypeCheckerTest, LiteralTakesTypeFromOtherOperand) {
+    const auto errors = check("func f(x: u64) -> bool { 1 + x > 2 }\n");
+    EXPECT_TRUE(errors.empty()) << errors[0];
+    const auto* cmp = cast<BinaryExpr>(func("f")->get_body()->get_result());
+    EXPECT_EQ(cmp->get_type(), ctx.get_bool_type());
+    EXPECT_EQ(cast<BinaryExpr>(cmp->get_lhs())->get_lhs()->get_type(), ctx.get_u64_type());
+    EXPECT_EQ(cmp->get_rhs()->get_type(), ctx.get_u64_type());
+}
+
+TEST_F(TypeCheckerTest, ReportsTypeErrors) {
+    const auto errors = check("func f(x: u64, y: i64) -> i64 {\n"
+                              "    let a = x + y;\n"
+                              "    let b = -x;\n"
+                              "    let c = 1.5 % 2.0;\n"
+                              "    if y { 1 } else { 2 };\n"
+                              "    let d: bool = 3;\n"
+                              "    x\n"
+                              "}\n");
+    ASSERT_EQ(errors.size(), 6u);
+    EXPECT_EQ(errors[0], "2:15 E0002: cannot apply '+' to 'u64' and 'i64'");
+    EXPECT_EQ(errors[1], "3:13 E0402: cannot negate 'u64'");
+    EXPECT_EQ(errors[2], "4:17 E0402: cannot apply '%' to 'f64'");
+    EXPECT_EQ(errors[3], "5:8 E0002: expected 'bool', found 'i64'");
+    EXPECT_EQ(errors[4], "6:19 E0002: expected 'bool', found 'i64'");
+    EXPECT_EQ(errors[5], "7:5 E0002: expected 'i64', found 'u64'");
+    EXPECT_EQ(checker->get_error_count(), 6u);
+}
+
+TEST_F(TypeCheckerTest, ReportsNameAndCallErrors) {
+    const auto errors = check("func g(a: i64) {}\n"
+                              "func f() {\n"
+                              "    let x = 1;\n"
+                              "    x = 2;\n"
+                              "    g(1, 2);\n"
+                              "    g(true);\n"
+                              "    x(1);\n"
+                              "    y;\n"
+                              "    let x = 3;\n"
+                              "    break;\n"
+                              "}\n"
+                              "func g() {}\n");
+    ASSERT_EQ(errors.size(), 11u);
+    // notes stay after the error they belong to
+    EXPECT_EQ(errors[0], "4:5 E0006: 'x'");
+    EXPECT_EQ(errors[1], "3:9 N0001: 'x' declared here");
+    EXPECT_EQ(errors[2], "5:6 E0005: expected 1, found 2");
+    EXPECT_EQ(errors[3], "6:7 E0306: expected 'i64', found 'bool'");
+    EXPECT_EQ(errors[4], "7:5 E0004: 'i64'");
+    EXPECT_EQ(errors[5], "8:5 E0001: 'y'");
+    EXPECT_EQ(errors[6], "9:9 E0003: 'x'");
+    EXPECT_EQ(errors[7], "3:9 N0001: 'x' declared here");
+    EXPECT_EQ(errors[8], "10:5 E0404: 'break' outside of a loop");
+    EXPECT_EQ(errors[9], "12:6 E0003: 'g'");
+    EXPECT_EQ(errors[10], "1:6 N0001: 'g' declared here");
+    EXPECT_EQ(diags.error_count(), 8u);
+    EXPECT_EQ(checker->get_error_count(), 8u);
+}
+
+TEST_F(TypeCheckerTest, ShadowingInInnerScopeAndDivergence) {
+    const auto errors = check("func f(c: bool) -> i64 {\n"
+                              "    let x = true;\n"
+                              "    { let x = 1; x + 1; }\n"
+                              "    if c { return 1; } else { 2 }\n"
+                              "}\n"
+                              "func g(c: bool) -> i64 { if c { return 0; } }\n"
+                              "func h() -> i64 { return; }\n"
+                              "func k() -> i64 { return 1; }\n"
+                              "func m(p: Point) {}\n");
+    ASSERT_EQ(errors.size(), 3u);
+    EXPECT_EQ(errors[0], "6:26 E0009: 'g' must return 'i64'");
+    EXPECT_EQ(errors[1], "7:19 E0009: expected a value of type 'i64'");
+    EXPECT_EQ(errors[2], "9:8 E0001: 'Point'");
+}
+
+TEST_F(TypeCheckerTest, ParallelCheckMatchesSerial) {
+    std::string source;
+    for (int i = 0; i < 200; ++i) {
+        const std::string n = std::to_string(i);
+        source += "func step" + n + "(x: u64) -> u64 { let mut y = x * " + n +
+                  "; while y > 0 { y = y - 1; } ";
+        // every seventh body has errors
+        source += i % 7 == 0 ? "let z: bool = y; y + true }\n" : "y }\n";
+    }
+
+    const std::vector<std::string> serial = check(source);
+    ASSERT_EQ(serial.size(), 2u * 29u);
+    const uint32_t serial_errors = checker->get_error_count();
+
+    // same source in a fresh context, bodies checked on four threads
+    CheckedModule parallel;
+    ThreadPool pool(4);
+    EXPECT_EQ(parallel.check(source, &pool), serial);
+    EXPECT_EQ(parallel.checker->get_error_count(), serial_errors);
+    const BlockExpr* body = parallel.func("step199")->get_body();
+    EXPECT_EQ(body->get_type(), parallel.ctx.get_u64_type());
+    EXPECT_EQ(cast<WhileStmt>(body->get_stmts()[1])->get_cond()->get_type(),
+              parallel.ctx.get_bool_type());
+}
+
+} // namespace
+} // namespace nova
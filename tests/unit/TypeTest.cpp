@@ -0,0 +1,121 @@
+#include "nova/AST/ASTContext.hpp"
+#include "nova/Basic/IdentifierTable.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace nova {
+namespace ast {
+
+TEST(TypeTest, BuiltinsAreSingletons) {
+    ASTContext ctx;
+    EXPECT_EQ(ctx.get_i64_type(), ctx.get_builtin_type(BuiltinType::Kind::I64));
+    EXPECT_NE(ctx.get_i64_type(), ctx.get_builtin_type(BuiltinType::Kind::U64));
+    EXPECT_EQ(ctx.get_i64_type()->get_builtin_kind(), BuiltinType::Kind::I64);
+    EXPECT_TRUE(ctx.get_i64_type()->is_integer());
+    EXPECT_TRUE(ctx.get_f64_type()->is_float());
+    EXPECT_TRUE(isa<StrType>(ctx.get_str_type()));
+    EXPECT_TRUE(isa<StringType>(ctx.get_string_type()));
+}
+
+TEST(TypeTest, StructuralTypesAreUniqued) {
+    ASTContext ctx;
+    const Type* i64 = ctx.get_i64_type();
+
+    const Type* a = ctx.get_reference_type(ctx.get_slice_type(i64), false);
+    const Type* b = ctx.get_reference_type(ctx.get_slice_type(i64), false);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, ctx.get_reference_type(ctx.get_slice_type(i64), true));
+    EXPECT_NE(a, ctx.get_pointer_type(ctx.get_slice_type(i64), false));
+    EXPECT_NE(ctx.get_array_type(i64, 4), ctx.get_array_type(i64, 5));
+    EXPECT_EQ(ctx.get_array_type(i64, 4), ctx.get_array_type(i64, 4));
+
+    const Type* pair[] = {i64, ctx.get_bool_type()};
+    const Type* swapped[] = {ctx.get_bool_type(), i64};
+    EXPECT_EQ(ctx.get_tuple_type(pair), ctx.get_tuple_type(pair));
+    EXPECT_NE(ctx.get_tuple_type(pair), ctx.get_tuple_type(swapped));
+    EXPECT_EQ(ctx.get_tuple_type({}), ctx.get_unit_type());
+
+    const FunctionType* fn = ctx.get_function_type(pair, i64);
+    EXPECT_EQ(fn, ctx.get_function_type(pair, i64));
+    EXPECT_NE(fn, ctx.get_function_type(pair, ctx.get_unit_type()));
+    EXPECT_NE(fn, ctx.get_function_type(swapped, i64));
+    ASSERT_EQ(fn->get_params().size(), 2u);
+    EXPECT_EQ(fn->get_params()[1], ctx.get_bool_type());
+}
+
+TEST(TypeTest, NominalTypesAreUniquedByNameAndDecl) {
+    ASTContext ctx;
+    IdentifierTable idents;
+    IdentifierInfo* point = idents.intern("Point");
+    IdentifierInfo* color = idents.intern("Color");
+
+    EXPECT_EQ(ctx.get_struct_type(point, nullptr), ctx.get_struct_type(point, nullptr));
+    EXPECT_NE(static_cast<const Type*>(ctx.get_struct_type(point, nullptr)),
+              static_cast<const Type*>(ctx.get_enum_type(point, nullptr)));
+    EXPECT_NE(ctx.get_enum_type(point, nullptr), ctx.get_enum_type(color, nullptr));
+    EXPECT_TRUE(isa<NominalType>(ctx.get_trait_type(point, nullptr)));
+    EXPECT_FALSE(isa<NominalType>(ctx.get_generic_type(point, 0)));
+    EXPECT_NE(ctx.get_generic_type(point, 0), ctx.get_generic_type(point, 1));
+}
+
+TEST(TypeTest, RepeatedTypesCostNoMemory) {
+    ASTContext ctx;
+    ctx.get_reference_type(ctx.get_slice_type(ctx.get_i64_type()), false);
+    const size_t count = ctx.type_count();
+    const size_t bytes = ctx.type_bytes();
+    for (int i = 0; i < 10000; ++i) {
+        ctx.get_reference_type(ctx.get_slice_type(ctx.get_i64_type()), false);
+    }
+    EXPECT_EQ(ctx.type_count(), count);
+    EXPECT_EQ(ctx.type_bytes(), bytes);
+}
+
+TEST(TypeTest, TableGrowthKeepsIdentity) {
+    ASTContext ctx;
+    std::vector<const ArrayType*> arrays;
+    for (uint64_t size = 0; size < 5000; ++size) {
+        arrays.push_back(ctx.get_array_type(ctx.get_u64_type(), size));
+    }
+    for (uint64_t size = 0; size < 5000; ++size) {
+        EXPECT_EQ(ctx.get_array_type(ctx.get_u64_type(), size), arrays[size]);
+    }
+}
+
+TEST(TypeTest, ConcurrentInterningYieldsOneType) {
+    ASTContext ctx;
+    constexpr int kThreads = 4;
+    std::vector<std::vector<const Type*>> seen(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&ctx, &seen, t] {
+            for (uint64_t size = 0; size < 500; ++size) {
+                const Type* element = ctx.get_array_type(ctx.get_i64_type(), size);
+                seen[t].push_back(ctx.get_reference_type(ctx.get_slice_type(element), true));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int t = 1; t < kThreads; ++t) {
+        EXPECT_EQ(seen[t], seen[0]);
+    }
+}
+
+TEST(TypeTest, PrintsSourceSpelling) {
+    ASTContext ctx;
+    IdentifierTable idents;
+    const Type* i64 = ctx.get_i64_type();
+    EXPECT_EQ(get_type_name(ctx.get_reference_type(ctx.get_slice_type(i64), false)), "&[i64]");
+    EXPECT_EQ(get_type_name(ctx.get_pointer_type(ctx.get_array_type(i64, 3), true)),
+              "*mut [i64; 3]");
+    const Type* one[] = {ctx.get_str_type()};
+    EXPECT_EQ(get_type_name(ctx.get_tuple_type(one)), "(str,)");
+    const Type* params[] = {i64, ctx.get_struct_type(idents.intern("Point"), nullptr)};
+    EXPECT_EQ(get_type_name(ctx.get_function_type(params, ctx.get_unit_type())),
+              "fn(i64, Point) -> ()");
+}
+
+} // namespace ast
+} // namespace nova
@@ -1,12 +1,77 @@
-#include "nova/Basic/SourceManager.hpp"
+#include "nova/AST/ASTContext.hpp"
+#include "nova/Analysis/BorrowChecker.hpp"
+#include "nova/Basic/DiagnosticEngine.hpp"
 #include "nova/Basic/IdentifierTable.hpp"
-#include "nova/Lex/Lexer.hpp"
-#include "nova/Lex/Token.hpp"
+#include "nova/Basic/SourceManager.hpp"
+#include "nova/Basic/ThreadPool.hpp"
+#include "nova/Lex/TokenStream.hpp"
+#include "nova/Parse/Parser.hpp"
+#include "nova/Sema/TypeChecker.hpp"
+#include <cstdio>
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+void print_usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [--ast-stats] <file.nova>\n"
+              << "\n"
+              << "  --ast-stats  print AST node counts and memory to stderr after checking\n";
+}
+
+} // namespace
 
 int main(int argc, char** argv) {
-    std::cout<<"Nova Compiler v0.1\n";
-    return 0;
+    std::string path;
+    bool ast_stats = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--ast-stats") {
+            ast_stats = true;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        } else {
+            path = std::string(arg);
+        }
+    }
+    if (path.empty()) {
+        std::cout << "Nova Compiler v0.1\n";
+        return 0;
+    }
+
+    nova::SourceManager sm;
+    const nova::FileID file_id = sm.add_file_mapped(path);
+    if (file_id == 0) {
+        std::cerr << "Failed to read file: " << path << "\n";
+        return 1;
+    }
+
+    nova::IdentifierTable ids;
+    nova::DiagnosticEngine diags(&sm);
+    // function bodies are checked on several threads; deferred diagnostics
+    // come out sorted by location regardless
+    diags.set_deferred(true);
+    const nova::TokenStream tokens = nova::TokenStream::lex(sm, ids, file_id);
+    nova::ast::ASTContext ctx;
+    nova::Parser parser(tokens, ctx, diags);
+    nova::ast::ModuleDecl* module = parser.parse_module(nullptr);
+    nova::ThreadPool pool;
+    nova::sema::TypeChecker checker(ctx, diags);
+    checker.check_module(module, pool);
+    // the borrow checker relies on a well-typed AST
+    if (!diags.has_errors()) {
+        nova::analysis::BorrowChecker borrow_checker(diags);
+        borrow_checker.check_module(module, pool);
+    }
+    diags.flush();
+
+    if (ast_stats) {
+        ctx.print_stats(stderr);
+    }
+    return diags.has_errors() ? 1 : 0;
 }